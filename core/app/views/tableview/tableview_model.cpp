@@ -42,6 +42,7 @@
 #include "itemfiltermodel.h"
 #include "itemfiltersettings.h"
 #include "iteminfo.h"
+#include "iteminfolist.h"
 #include "tableview_columnfactory.h"
 #include "tableview_selection_model_syncer.h"
 
@@ -122,6 +123,30 @@ public:
         cachedItemInfos(),
         outdated(true)
     {
+        // The fields shown by the item and file property columns, and used when sorting by them
+
+        prefetchFields |= DatabaseFields::Category         |
+                          DatabaseFields::ModificationDate |
+                          DatabaseFields::FileSize;
+
+        prefetchFields |= DatabaseFields::Rating           |
+                          DatabaseFields::CreationDate     |
+                          DatabaseFields::Orientation      |
+                          DatabaseFields::Width            |
+                          DatabaseFields::Height           |
+                          DatabaseFields::Format;
+    }
+
+    /**
+     * Load the fields of the items used by the filter and the columns with a few queries,
+     * instead of one query per item and column.
+     */
+    void loadFields(const QList<ItemInfo>& infos) const
+    {
+        DatabaseFields::Set fields = prefetchFields;
+        fields.setFields(imageFilterSettings.watchFlags());
+
+        ItemInfoList(infos).loadFields(fields);
     }
 
     QList<TableViewColumn*>     columnObjects;
@@ -133,6 +158,7 @@ public:
     GroupingMode                groupingMode;
     QHash<qlonglong, ItemInfo>  cachedItemInfos;
     bool                        outdated;
+    DatabaseFields::Set         prefetchFields;
 };
 
 TableViewModel::TableViewModel(TableViewShared* const sharedObject, QObject* const parent)
@@ -494,6 +520,15 @@ void TableViewModel::slotSourceRowsInserted(const QModelIndex& parent, int start
         return;
     }
 
+    QList<ItemInfo> infos;
+
+    for (int i = start ; i <= end ; ++i)
+    {
+        infos << s->imageModel->imageInfo(s->imageModel->index(i, 0, parent));
+    }
+
+    d->loadFields(infos);
+
     for (int i = start ; i <= end ; ++i)
     {
         const QModelIndex sourceIndex = s->imageModel->index(i, 0, parent);
@@ -796,6 +831,8 @@ void TableViewModel::slotPopulateModel(const bool sendNotifications)
 
     const int sourceRowCount = s->imageModel->rowCount(QModelIndex());
 
+    d->loadFields(s->imageModel->imageInfos());
+
     for (int i = 0 ; i < sourceRowCount ; ++i)
     {
         const QModelIndex sourceModelIndex = s->imageModel->index(i, 0);
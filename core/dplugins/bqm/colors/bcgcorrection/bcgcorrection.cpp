@@ -105,8 +105,8 @@ bool BCGCorrection::toolOperations()
     prm.contrast   = settings()[QLatin1String("Contrast")].toDouble();
     prm.gamma      = settings()[QLatin1String("Gamma")].toDouble();
 
-    BCGFilter bcg(&image(), nullptr, prm);
-    applyFilter(&bcg);
+    BCGFilter bcg(nullptr, nullptr, prm);
+    applyFilterInStrips(&bcg);
 
     return (savefromDImg());
 }
@@ -174,8 +174,8 @@ bool ChannelMixer::toolOperations()
     prm.blackGreenGain = settings()[QLatin1String("blackGreenGain")].toDouble();
     prm.blackBlueGain  = settings()[QLatin1String("blackBlueGain")].toDouble();
 
-    MixerFilter mixer(&image(), nullptr, prm);
-    applyFilter(&mixer);
+    MixerFilter mixer(nullptr, nullptr, prm);
+    applyFilterInStrips(&mixer);
 
     return (savefromDImg());
 }
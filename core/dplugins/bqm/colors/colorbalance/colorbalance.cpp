@@ -109,8 +109,8 @@ bool ColorBalance::toolOperations()
     prm.green = settings()[QLatin1String("Green")].toDouble();
     prm.blue  = settings()[QLatin1String("Blue")].toDouble();
 
-    CBFilter cb(&image(), nullptr, prm);
-    applyFilter(&cb);
+    CBFilter cb(nullptr, nullptr, prm);
+    applyFilterInStrips(&cb);
 
     return (savefromDImg());
 }
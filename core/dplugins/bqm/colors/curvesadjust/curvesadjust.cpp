@@ -182,8 +182,8 @@ bool CurvesAdjust::toolOperations()
     prm.values[BlueChannel]       = settings()[QLatin1String("values[BlueChannel]")].value<QPolygon>();
     prm.values[AlphaChannel]      = settings()[QLatin1String("values[AlphaChannel]")].value<QPolygon>();
 
-    CurvesFilter curves(&image(), nullptr, prm);
-    applyFilter(&curves);
+    CurvesFilter curves(nullptr, nullptr, prm);
+    applyFilterInStrips(&curves);
 
     return (savefromDImg());
 }
@@ -109,8 +109,8 @@ bool HSLCorrection::toolOperations()
     prm.lightness  = settings()[QLatin1String("Lightness")].toDouble();
     prm.vibrance   = settings()[QLatin1String("Vibrance")].toDouble();
 
-    HSLFilter hsl(&image(), nullptr, prm);
-    applyFilter(&hsl);
+    HSLFilter hsl(nullptr, nullptr, prm);
+    applyFilterInStrips(&hsl);
 
     return (savefromDImg());
 }
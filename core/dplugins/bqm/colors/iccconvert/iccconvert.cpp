@@ -112,8 +112,8 @@ bool IccConvert::toolOperations()
     transform.setInputProfile(in);
     transform.setOutputProfile(out);
 
-    IccTransformFilter icc(&image(), nullptr, transform);
-    applyFilter(&icc);
+    IccTransformFilter icc(nullptr, nullptr, transform);
+    applyFilterInStrips(&icc);
 
     image().setIccProfile(icc.getTargetImage().getIccProfile());
 
@@ -55,8 +55,8 @@ bool Invert::toolOperations()
         return false;
     }
 
-    InvertFilter inv(&image(), nullptr);
-    applyFilter(&inv);
+    InvertFilter inv(nullptr, nullptr);
+    applyFilterInStrips(&inv);
 
     return (savefromDImg());
 }
@@ -862,6 +862,9 @@ bool WaterMark::toolOperations()
 
     // TODO: Create watermark filter, move code there, implement FilterAction
 
+    // The watermark is blended in place into image(), so it is not applied by strips
+    // as the filters with applyFilterInStrips(): it only uses the memory of the watermark layer.
+
     delete composer;
     LoadSaveThread::reverseExifRotate(image(), inputUrl().toLocalFile());
     return (savefromDImg());
@@ -24,6 +24,10 @@
 
 #include "sharpen.h"
 
+// C++ includes
+
+#include <cmath>
+
 // Qt includes
 
 #include <QLabel>
@@ -179,8 +183,9 @@ bool Sharpen::toolOperations()
                 sigma = sqrt(radius);
             }
 
-            SharpenFilter filter(&image(), nullptr, radius, sigma);
-            applyFilter(&filter);
+            // The convolution kernel has a half width of radius pixels.
+            SharpenFilter filter(nullptr, nullptr, radius, sigma);
+            applyFilterInStrips(&filter, (int)ceil(radius) + 1);
             break;
         }
 
@@ -191,8 +196,9 @@ bool Sharpen::toolOperations()
             double th = settings()[QLatin1String("UnsharpMaskThreshold")].toDouble();
             bool    l = settings()[QLatin1String("UnsharpMaskLuma")].toBool();
 
-            UnsharpMaskFilter filter(&image(), nullptr, r, a, th, l);
-            applyFilter(&filter);
+            // The blur of the mask has a radius of r * 10 pixels.
+            UnsharpMaskFilter filter(nullptr, nullptr, r, a, th, l);
+            applyFilterInStrips(&filter, (int)(r * 10.0) + 1);
             break;
         }
 
@@ -388,6 +388,22 @@ bool AlbumManager::setDatabase(const DbEngineParameters& params, bool priority,
     DbEngineGuiErrorHandler* const thumbnailsDBHandler = new DbEngineGuiErrorHandler(ThumbsDbAccess::parameters());
     ThumbsDbAccess::initDbEngineErrorHandler(thumbnailsDBHandler);
 
+    // Optionally, serve the thumbnails from a memory-mapped pack file instead of the database.
+    // The pack is a cache: it is stored next to a SQLite database, else in the cache location.
+
+    if (ApplicationSettings::instance()->getUseThumbnailsPackFile())
+    {
+        DbEngineParameters thumbsParams = CoreDbAccess::parameters().thumbnailParameters();
+        QString packDir                 = thumbsParams.isSQLite() ? QFileInfo(thumbsParams.databaseNameThumbnails).absolutePath()
+                                                                  : QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(packDir);
+
+        if (!ThumbnailLoadThread::initializeThumbnailPack(packDir + QLatin1String("/thumbnails-digikam.pack")))
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnails pack file cannot be used. Thumbnails database is used instead.";
+        }
+    }
+
     // Activate the similarity database.
 
     SimilarityDbAccess::setParameters(params.similarityParameters());
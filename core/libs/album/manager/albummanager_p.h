@@ -67,10 +67,14 @@ extern "C"
 #include <QMessageBox>
 #include <QCheckBox>
 #include <QSet>
+#include <QFileInfo>
+#include <QStandardPaths>
 
 // KDE includes
 
 #include <klocalizedstring.h>
+#include <ksharedconfig.h>
+#include <kconfiggroup.h>
 
 // Local includes
 
@@ -0,0 +1,343 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-29
+ * Description : Album directory fingerprints and change journal
+ *               for incremental collection scans.
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "collectionscanjournal.h"
+
+// C ANSI includes
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// Qt includes
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <qplatformdefs.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+AlbumFingerprint::AlbumFingerprint()
+    : modificationTime(0),
+      changeTime(0),
+      inode(0),
+      linkCount(0),
+      size(0),
+      entryCount(0)
+{
+}
+
+AlbumFingerprint AlbumFingerprint::read(const QString& dirPath)
+{
+    AlbumFingerprint fingerprint;
+    QT_STATBUF st;
+
+    if (QT_STAT(QFile::encodeName(dirPath).constData(), &st) != 0)
+    {
+        return fingerprint;
+    }
+
+    // The times have a resolution of one second here. A directory modified in the current second
+    // can be modified again without a visible change: do not trust it.
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    if (((now - (qint64)st.st_mtime) < 2) || ((now - (qint64)st.st_ctime) < 2))
+    {
+        return fingerprint;
+    }
+
+    fingerprint.modificationTime = st.st_mtime;
+    fingerprint.changeTime       = st.st_ctime;
+    fingerprint.inode            = st.st_ino;
+    fingerprint.linkCount        = st.st_nlink;
+    fingerprint.size             = st.st_size;
+
+    return fingerprint;
+}
+
+bool AlbumFingerprint::isNull() const
+{
+    return (modificationTime == 0);
+}
+
+bool AlbumFingerprint::operator==(const AlbumFingerprint& other) const
+{
+    return ((modificationTime == other.modificationTime) &&
+            (changeTime       == other.changeTime)       &&
+            (inode            == other.inode)            &&
+            (linkCount        == other.linkCount)        &&
+            (size             == other.size));
+}
+
+bool AlbumFingerprint::operator!=(const AlbumFingerprint& other) const
+{
+    return !operator==(other);
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN CollectionScanJournal::Private
+{
+public:
+
+    explicit Private()
+      : magic(0x64694b46),   // "diKF"
+        version(1)
+    {
+        QString dir     = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(dir);
+
+        fingerprintPath = dir + QLatin1String("/albumfingerprints.dat");
+        journalPath     = dir + QLatin1String("/albumchanges.journal");
+    }
+
+    /// The journal content after mark. The mutex must be held.
+    QByteArray journalTail(qint64 mark) const
+    {
+        QFile file(journalPath);
+
+        if (!file.open(QIODevice::ReadOnly) || (file.size() <= mark))
+        {
+            return QByteArray();
+        }
+
+        file.seek(mark);
+
+        return file.readAll();
+    }
+
+public:
+
+    const quint32  magic;
+    const qint32   version;
+
+    QString        fingerprintPath;
+    QString        journalPath;
+
+    mutable QMutex mutex;
+
+    /// The directories already appended to the journal.
+    QSet<QString>  recorded;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN CollectionScanJournalCreator
+{
+public:
+
+    CollectionScanJournal object;
+};
+
+Q_GLOBAL_STATIC(CollectionScanJournalCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+CollectionScanJournal* CollectionScanJournal::instance()
+{
+    return &creator->object;
+}
+
+CollectionScanJournal::CollectionScanJournal()
+    : d(new Private)
+{
+}
+
+CollectionScanJournal::~CollectionScanJournal()
+{
+    delete d;
+}
+
+void CollectionScanJournal::recordChange(const QString& dirPath)
+{
+    QMutexLocker locker(&d->mutex);
+
+    if (d->recorded.contains(dirPath))
+    {
+        return;
+    }
+
+    QFile file(d->journalPath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot write the album change journal" << d->journalPath;
+        return;
+    }
+
+    file.write(dirPath.toUtf8() + '\n');
+    d->recorded << dirPath;
+}
+
+qint64 CollectionScanJournal::journalMark() const
+{
+    QMutexLocker locker(&d->mutex);
+
+    return QFileInfo(d->journalPath).size();
+}
+
+bool CollectionScanJournal::load(const QString& databaseIdentifier,
+                                 const QString& settingsIdentifier,
+                                 QHash<QString, AlbumFingerprint>* const fingerprints,
+                                 QSet<QString>* const changedDirectories,
+                                 qint64* const mark)
+{
+    QMutexLocker locker(&d->mutex);
+
+    fingerprints->clear();
+    changedDirectories->clear();
+
+    QByteArray journal = d->journalTail(0);
+    *mark              = journal.size();
+
+    foreach (const QByteArray& line, journal.split('\n'))
+    {
+        if (!line.isEmpty())
+        {
+            *changedDirectories << QString::fromUtf8(line);
+        }
+    }
+
+    QFile file(d->fingerprintPath);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic   = 0;
+    qint32  version = 0;
+    QString dbId;
+    QString settingsId;
+    qint32  count   = 0;
+
+    stream >> magic >> version >> dbId >> settingsId >> count;
+
+    if ((magic != d->magic) || (version != d->version) ||
+        (dbId != databaseIdentifier) || (settingsId != settingsIdentifier))
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Album fingerprints do not match the database or the settings";
+        return false;
+    }
+
+    fingerprints->reserve(count);
+
+    for (int i = 0 ; (i < count) && (stream.status() == QDataStream::Ok) ; ++i)
+    {
+        QString          path;
+        AlbumFingerprint fingerprint;
+
+        stream >> path
+               >> fingerprint.modificationTime
+               >> fingerprint.changeTime
+               >> fingerprint.inode
+               >> fingerprint.linkCount
+               >> fingerprint.size
+               >> fingerprint.entryCount
+               >> fingerprint.subDirectories;
+
+        fingerprints->insert(path, fingerprint);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Album fingerprints file is damaged" << d->fingerprintPath;
+        fingerprints->clear();
+        return false;
+    }
+
+    return true;
+}
+
+void CollectionScanJournal::storeFingerprints(const QString& databaseIdentifier,
+                                              const QString& settingsIdentifier,
+                                              const QHash<QString, AlbumFingerprint>& fingerprints,
+                                              qint64 mark)
+{
+    QMutexLocker locker(&d->mutex);
+
+    QSaveFile file(d->fingerprintPath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot write album fingerprints" << d->fingerprintPath;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << d->magic << d->version << databaseIdentifier << settingsIdentifier << (qint32)fingerprints.count();
+
+    for (QHash<QString, AlbumFingerprint>::const_iterator it = fingerprints.constBegin() ;
+         it != fingerprints.constEnd() ; ++it)
+    {
+        stream << it.key()
+               << it.value().modificationTime
+               << it.value().changeTime
+               << it.value().inode
+               << it.value().linkCount
+               << it.value().size
+               << it.value().entryCount
+               << it.value().subDirectories;
+    }
+
+    if (!file.commit())
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot write album fingerprints" << d->fingerprintPath;
+        return;
+    }
+
+    // Keep the changes recorded while the scan was running
+
+    QByteArray tail = d->journalTail(mark);
+    QSaveFile journal(d->journalPath);
+
+    if (journal.open(QIODevice::WriteOnly))
+    {
+        journal.write(tail);
+        journal.commit();
+    }
+
+    d->recorded.clear();
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Stored" << fingerprints.count() << "album fingerprints";
+}
+
+} // namespace Digikam
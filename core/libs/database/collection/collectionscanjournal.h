@@ -0,0 +1,139 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-29
+ * Description : Album directory fingerprints and change journal
+ *               for incremental collection scans.
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_COLLECTION_SCAN_JOURNAL_H
+#define DIGIKAM_COLLECTION_SCAN_JOURNAL_H
+
+// Qt includes
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/** The state of an album directory, as given by the file system for the directory itself.
+ *  Adding, removing or renaming an entry of the directory changes its fingerprint.
+ *  Modifying the content of a file does not.
+ */
+class DIGIKAM_DATABASE_EXPORT AlbumFingerprint
+{
+public:
+
+    explicit AlbumFingerprint();
+
+    /** Read the fingerprint of the directory. It is null if the directory cannot be read,
+     *  or if it was modified too recently to be compared reliably.
+     */
+    static AlbumFingerprint read(const QString& dirPath);
+
+    bool isNull() const;
+
+    /// Compares the file system attributes only.
+    bool operator==(const AlbumFingerprint& other) const;
+    bool operator!=(const AlbumFingerprint& other) const;
+
+public:
+
+    qint64      modificationTime;
+    qint64      changeTime;
+    quint64     inode;
+    quint64     linkCount;
+    qint64      size;
+
+    /// Recorded by the scan: number of entries and scanned subdirectories.
+    int         entryCount;
+    QStringList subDirectories;
+};
+
+// --------------------------------------------------------------------------
+
+/** Persistent storage for incremental collection scans.
+ *
+ *  A complete scan stores the fingerprint of each scanned album directory.
+ *  While the application runs, the directories reported changed by the file watch
+ *  are appended to a journal file at once, so they are known even after a crash.
+ *  An incremental scan skips the albums whose directory has the same fingerprint
+ *  as stored and which are not in the journal.
+ *
+ *  The files are in the cache directory. The fingerprints are bound to the identifier
+ *  of the database and to the scan settings they were recorded with.
+ *  All methods are thread-safe.
+ */
+class DIGIKAM_DATABASE_EXPORT CollectionScanJournal
+{
+public:
+
+    static CollectionScanJournal* instance();
+
+    /** Record that the content of the directory changed.
+     */
+    void recordChange(const QString& dirPath);
+
+    /** Load the fingerprints stored for the database and settings identifiers,
+     *  and the directories recorded changed since. Returns false if none were stored.
+     *  The mark identifies the changes read, for storeFingerprints().
+     */
+    bool load(const QString& databaseIdentifier,
+              const QString& settingsIdentifier,
+              QHash<QString, AlbumFingerprint>* const fingerprints,
+              QSet<QString>* const changedDirectories,
+              qint64* const mark);
+
+    /** Replace the stored fingerprints, and forget the changes read up to the mark.
+     *  Changes recorded after the mark are kept for the next scan.
+     */
+    void storeFingerprints(const QString& databaseIdentifier,
+                           const QString& settingsIdentifier,
+                           const QHash<QString, AlbumFingerprint>& fingerprints,
+                           qint64 mark);
+
+    /** The current end of the journal, to use as mark if load() was not called.
+     */
+    qint64 journalMark() const;
+
+private:
+
+    explicit CollectionScanJournal();
+    ~CollectionScanJournal();
+
+    CollectionScanJournal(const CollectionScanJournal&); // Disable
+
+private:
+
+    friend class CollectionScanJournalCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_COLLECTION_SCAN_JOURNAL_H
@@ -80,4 +80,14 @@ QStringList CollectionScanner::deferredAlbumPaths() const
     return d->deferredAlbumPaths.toList();
 }
 
+void CollectionScanner::setPipelinedScanning(bool on)
+{
+    d->pipelinedScanning = on;
+}
+
+void CollectionScanner::setIncrementalScan(bool on)
+{
+    d->incrementalScan = on;
+}
+
 } // namespace Digikam
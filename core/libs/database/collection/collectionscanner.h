@@ -114,6 +114,23 @@ public:
     void setDeferredFileScanning(bool defer);
     QStringList deferredAlbumPaths() const;
 
+    /**
+     * Call this to scan albums with a pipeline of threads: a thread walks the directories
+     * ahead of the scan, a pool of threads reads the files to scan from disk,
+     * and the calling thread writes the results to the database in batched transactions.
+     * Default is off.
+     */
+    void setPipelinedScanning(bool on);
+
+    /**
+     * Call this to let completeScan() skip the albums whose directory did not change
+     * since the last complete scan, as told by the fingerprints stored by CollectionScanJournal,
+     * and which were not reported changed while the application was running.
+     * Files modified in place while the application was not running are not found.
+     * Default is off.
+     */
+    void setIncrementalScan(bool on);
+
     // -----------------------------------------------------------------------------
 
     /** @name Scan operations
@@ -282,6 +299,8 @@ Q_SIGNALS:
 
 private:
 
+    friend class CollectionScannerPipeline;
+
     class Private;
     Private* const d;
 };
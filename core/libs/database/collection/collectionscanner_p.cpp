@@ -45,6 +45,29 @@ bool s_modificationDateEquals(const QDateTime& a, const QDateTime& b)
     return true;
 }
 
+bool s_albumUnchanged(const QHash<QString, AlbumFingerprint>& fingerprints,
+                      const QSet<QString>& changedDirectories,
+                      const QString& dirPath,
+                      const AlbumFingerprint& current,
+                      AlbumFingerprint* const stored)
+{
+    if (current.isNull() || changedDirectories.contains(dirPath))
+    {
+        return false;
+    }
+
+    QHash<QString, AlbumFingerprint>::const_iterator it = fingerprints.constFind(dirPath);
+
+    if ((it == fingerprints.constEnd()) || (it.value() != current))
+    {
+        return false;
+    }
+
+    *stored = it.value();
+
+    return true;
+}
+
 // --------------------------------------------------------------------
 
 NewlyAppearedFile::NewlyAppearedFile()
@@ -217,6 +240,11 @@ CollectionScanner::Private::Private()
       updatingHashHint(false),
       recordHistoryIds(false),
       deferredFileScanning(false),
+      pipelinedScanning(false),
+      pipeline(nullptr),
+      incrementalScan(false),
+      recordFingerprints(false),
+      journalMark(0),
       observer(nullptr)
 {
 }
@@ -260,10 +288,49 @@ void CollectionScanner::Private::finishScanner(ItemScanner& scanner)
         scanner.commit();
     }
 
+    if (pipeline)
+    {
+        pipeline->itemCommitted();
+    }
+
     if (recordHistoryIds && scanner.hasHistoryToResolve())
     {
         needResolveHistorySet << scanner.id();
     }
 }
 
+ItemScanner* CollectionScanner::Private::createItemScanner(const QFileInfo& info,
+                                                           const ItemScanInfo& scanInfo,
+                                                           DatabaseItem::Category category)
+{
+    ItemScanner* scanner = nullptr;
+
+    if (pipeline)
+    {
+        scanner = pipeline->takeItemScanner(info, scanInfo.id);
+    }
+
+    if (!scanner)
+    {
+        scanner = scanInfo.isNull() ? new ItemScanner(info)
+                                    : new ItemScanner(info, scanInfo);
+        scanner->setCategory(category);
+    }
+
+    return scanner;
+}
+
+QString CollectionScanner::Private::scanSettingsIdentifier() const
+{
+    QStringList filters = nameFilters.toList();
+    QStringList ignored = ignoreDirectory.toList();
+    filters.sort();
+    ignored.sort();
+
+    QByteArray settings = filters.join(QLatin1Char(';')).toUtf8() + '|' +
+                          ignored.join(QLatin1Char(';')).toUtf8();
+
+    return QString::fromLatin1(QCryptographicHash::hash(settings, QCryptographicHash::Md5).toHex());
+}
+
 } // namespace Digikam
@@ -36,10 +36,13 @@
 
 // Qt includes
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFileInfo>
+#include <QList>
 #include <QReadWriteLock>
 #include <QReadLocker>
+#include <QScopedPointer>
 #include <QStringList>
 #include <QSet>
 #include <QTime>
@@ -53,6 +56,7 @@
 #include "collectionmanager.h"
 #include "collectionlocation.h"
 #include "collectionscannerobserver.h"
+#include "collectionscanjournal.h"
 #include "coredbaccess.h"
 #include "coredbbackend.h"
 #include "coredbtransaction.h"
@@ -65,12 +69,23 @@
 #include "tagscache.h"
 #include "thumbsdbaccess.h"
 #include "thumbsdb.h"
+#include "thumbsdbwritequeue.h"
 
 namespace Digikam
 {
 
 bool s_modificationDateEquals(const QDateTime& a, const QDateTime& b);
 
+/**
+ * Returns true if the current fingerprint of the album directory is the stored one,
+ * and the directory was not recorded as changed. Returns the stored fingerprint in stored.
+ */
+bool s_albumUnchanged(const QHash<QString, AlbumFingerprint>& fingerprints,
+                      const QSet<QString>& changedDirectories,
+                      const QString& dirPath,
+                      const AlbumFingerprint& current,
+                      AlbumFingerprint* const stored);
+
 // --------------------------------------------------------------------
 
 class Q_DECL_HIDDEN NewlyAppearedFile
@@ -130,6 +145,62 @@ public:
 
 // --------------------------------------------------------------------
 
+/**
+ * The threads of a pipelined scan of an album and its subalbums.
+ *
+ * A walker thread lists the directories in the order of the scan, and reads the file infos.
+ * The scanning thread takes these listings instead of reading the directories itself.
+ * The files which will need a scan are given in advance to a pool of threads,
+ * which create their ItemScanner and load them from disk. The scanning thread takes
+ * these loaded scanners, so it only has to write to the database.
+ * The writes are grouped in transactions of several items.
+ *
+ * All methods are called from the scanning thread.
+ */
+class Q_DECL_HIDDEN CollectionScannerPipeline
+{
+public:
+
+    explicit CollectionScannerPipeline(CollectionScanner* const scanner,
+                                       const CollectionLocation& location,
+                                       const QString& album);
+    ~CollectionScannerPipeline();
+
+    /**
+     * Returns the entries of the directory and their file infos as read by the walker.
+     * Returns false if the walker did not list this directory: the caller lists it itself.
+     */
+    bool takeListing(const QString& dirPath, QStringList* const entries, QList<QFileInfo>* const infos);
+
+    /**
+     * Returns the scanner loaded in advance for the file, if it was created for the same image id
+     * (0 for a new file), else nullptr. The caller takes ownership.
+     */
+    ItemScanner* takeItemScanner(const QFileInfo& info, qlonglong imageId);
+
+    /**
+     * Discards the scanners loaded in advance for files of the directory which were not used.
+     */
+    void finishedDirectory(const QString& dirPath);
+
+    /**
+     * Call after each item written to the database. Commits the current transaction when due.
+     */
+    void itemCommitted();
+
+private:
+
+    CollectionScannerPipeline(const CollectionScannerPipeline&); // Disable
+
+    friend class CollectionScannerWalker;
+    friend class CollectionScannerPreloadTask;
+
+    class Private;
+    Private* const d;
+};
+
+// --------------------------------------------------------------------
+
 class Q_DECL_HIDDEN CollectionScanner::Private
 {
 
@@ -147,6 +218,19 @@ public:
 
     void finishScanner(ItemScanner& scanner);
 
+    /**
+     * Returns the scanner preloaded by the pipeline if any, else a new scanner.
+     * Pass a null scan info for a new file. The caller takes ownership.
+     */
+    ItemScanner* createItemScanner(const QFileInfo& info,
+                                   const ItemScanInfo& scanInfo,
+                                   DatabaseItem::Category category);
+
+    /**
+     * Identifies the settings which decide what a scan records: the name filters and the ignored directories.
+     */
+    QString scanSettingsIdentifier() const;
+
 public:
 
     QSet<QString>                                 nameFilters;
@@ -172,6 +256,18 @@ public:
     bool                                          deferredFileScanning;
     QSet<QString>                                 deferredAlbumPaths;
 
+    bool                                          pipelinedScanning;
+    CollectionScannerPipeline*                    pipeline;
+
+    bool                                          incrementalScan;
+    bool                                          recordFingerprints;
+    QString                                       databaseIdentifier;
+    QString                                       settingsIdentifier;
+    QHash<QString, AlbumFingerprint>              storedFingerprints;
+    QHash<QString, AlbumFingerprint>              scannedFingerprints;
+    QSet<QString>                                 changedDirectories;
+    qint64                                        journalMark;
+
     CollectionScannerObserver*                    observer;
 };
 
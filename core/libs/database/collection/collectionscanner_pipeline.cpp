@@ -0,0 +1,694 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-28
+ * Description : Collection scanning to database - pipelined scan threads.
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "collectionscanner_p.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN CollectionScannerListing
+{
+public:
+
+    explicit CollectionScannerListing()
+      : classified(false)
+    {
+    }
+
+    QString          album;
+    QString          dirPath;
+    QStringList      entries;
+    QList<QFileInfo> infos;
+
+    /// The files to scan were given to the preload queue.
+    bool             classified;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/** A file which will need a scan, and the scanner loading it in a thread of the pool.
+ */
+class Q_DECL_HIDDEN CollectionScannerPreload
+{
+public:
+
+    explicit CollectionScannerPreload()
+      : imageId(0),
+        category(DatabaseItem::UndefinedCategory),
+        scanner(nullptr),
+        done(false)
+    {
+    }
+
+    QString                filePath;
+    QString                dirPath;
+    ItemScanInfo           scanInfo;
+    qlonglong              imageId;
+    DatabaseItem::Category category;
+
+    ItemScanner*           scanner;
+
+    /// Protected by the mutex of the pipeline.
+    bool                   done;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN CollectionScannerWalker : public QThread
+{
+public:
+
+    explicit CollectionScannerWalker(CollectionScannerPipeline::Private* const d)
+      : d(d)
+    {
+    }
+
+protected:
+
+    void run() override;
+
+private:
+
+    void walk(const QString& album);
+
+private:
+
+    CollectionScannerPipeline::Private* const d;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN CollectionScannerPreloadTask : public QRunnable
+{
+public:
+
+    explicit CollectionScannerPreloadTask(CollectionScannerPipeline::Private* const d,
+                                          CollectionScannerPreload* const preload)
+      : d(d),
+        preload(preload)
+    {
+    }
+
+    void run() override;
+
+private:
+
+    CollectionScannerPipeline::Private* const d;
+    CollectionScannerPreload* const           preload;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN CollectionScannerPipeline::Private
+{
+public:
+
+    explicit Private()
+      : scanner(nullptr),
+        deferredFileScanning(false),
+        incrementalScan(false),
+        maxListedEntries(20000),
+        maxPreloads(qMax(16, 4 * QThread::idealThreadCount())),
+        itemsPerTransaction(100),
+        listedEntries(0),
+        walkerFinished(false),
+        walkerWaiting(false),
+        stop(false),
+        walker(nullptr),
+        group(nullptr),
+        committedItems(0)
+    {
+    }
+
+    /// Called by the walker. Returns false if the pipeline is stopped.
+    bool pushListing(const CollectionScannerListing& listing);
+
+    /// Gives files to the pool until it holds maxPreloads of them.
+    void preloadAhead();
+
+    /// Finds the files of the listing which will need a scan and appends them to the candidates.
+    void classify(CollectionScannerListing& listing);
+
+public:
+
+    CollectionScanner*                          scanner;
+    CollectionLocation                          location;
+    QString                                     album;
+
+    /// Copies of the scanner settings, read by the walker.
+    QSet<QString>                               nameFilters;
+    QSet<QString>                               ignoreDirectory;
+    bool                                        deferredFileScanning;
+    bool                                        incrementalScan;
+    QHash<QString, AlbumFingerprint>            storedFingerprints;
+    QSet<QString>                               changedDirectories;
+
+    const int                                   maxListedEntries;
+    const int                                   maxPreloads;
+    const int                                   itemsPerTransaction;
+
+    /// Protects the listings, the walker state and the done flags of the preloads.
+    QMutex                                      mutex;
+    QWaitCondition                              condVar;
+
+    /// The listings of the walker in walk order, waiting to be taken by the scanning thread.
+    QList<CollectionScannerListing>             listings;
+    int                                         listedEntries;
+    bool                                        walkerFinished;
+    bool                                        walkerWaiting;
+    bool                                        stop;
+
+    CollectionScannerWalker*                    walker;
+    QThreadPool                                 pool;
+
+    /// Only used from the scanning thread.
+    QQueue<CollectionScannerPreload*>           candidates;
+    QHash<QString, CollectionScannerPreload*>   queued;
+    QHash<QString, CollectionScannerPreload*>   preloads;
+
+    CoreDbOperationGroup*                       group;
+    int                                         committedItems;
+};
+
+bool CollectionScannerPipeline::Private::pushListing(const CollectionScannerListing& listing)
+{
+    QMutexLocker locker(&mutex);
+
+    // Do not walk too far ahead of the scan
+
+    while (!stop && !listings.isEmpty() && (listedEntries >= maxListedEntries))
+    {
+        walkerWaiting = true;
+        condVar.wakeAll();
+        condVar.wait(&mutex);
+    }
+
+    walkerWaiting = false;
+
+    if (stop)
+    {
+        return false;
+    }
+
+    listings      << listing;
+    listedEntries += listing.entries.count();
+    condVar.wakeAll();
+
+    return true;
+}
+
+void CollectionScannerPipeline::Private::classify(CollectionScannerListing& listing)
+{
+    listing.classified = true;
+
+    QHash<QString, ItemScanInfo> scanInfos;
+
+    {
+        CoreDbAccess access;
+        int albumId = access.db()->getAlbumForPath(location.id(), listing.album, false);
+
+        if (albumId != -1)
+        {
+            foreach (const ItemScanInfo& scanInfo, access.db()->getItemScanInfos(albumId))
+            {
+                scanInfos.insert(scanInfo.itemName, scanInfo);
+            }
+        }
+    }
+
+    // Same decisions as CollectionScanner::scanAlbum() and scanFileNormal(), without the hints.
+    // A file missed here is loaded by the scanning thread itself.
+
+    for (int i = 0 ; i < listing.infos.size() ; ++i)
+    {
+        const QFileInfo& info = listing.infos.at(i);
+
+        if (!info.isFile() || !nameFilters.contains(info.suffix().toLower()))
+        {
+            continue;
+        }
+
+        QHash<QString, ItemScanInfo>::const_iterator it = scanInfos.constFind(info.fileName());
+        ItemScanInfo scanInfo;
+
+        if (it == scanInfos.constEnd())
+        {
+            if (deferredFileScanning ||
+                info.completeSuffix().contains(QLatin1String("digikamtempfile.")))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            scanInfo = it.value();
+
+            if (!scanInfo.modificationDate.isNull()                                   &&
+                s_modificationDateEquals(info.lastModified(), scanInfo.modificationDate) &&
+                (info.size() == scanInfo.fileSize))
+            {
+                continue;
+            }
+        }
+
+        CollectionScannerPreload* const preload = new CollectionScannerPreload;
+        preload->filePath                       = info.filePath();
+        preload->dirPath                        = listing.dirPath;
+        preload->scanInfo                       = scanInfo;
+        preload->imageId                        = scanInfo.id;
+        preload->category                       = scanner->category(info);
+
+        candidates.enqueue(preload);
+        queued.insert(preload->filePath, preload);
+    }
+}
+
+void CollectionScannerPipeline::Private::preloadAhead()
+{
+    while (preloads.count() < maxPreloads)
+    {
+        if (candidates.isEmpty())
+        {
+            // Look for the next listing of the walker which was not classified yet
+
+            CollectionScannerListing listing;
+
+            {
+                QMutexLocker locker(&mutex);
+
+                for (int i = 0 ; i < listings.size() ; ++i)
+                {
+                    if (!listings.at(i).classified)
+                    {
+                        listings[i].classified = true;
+                        listing                = listings.at(i);
+                        break;
+                    }
+                }
+            }
+
+            if (listing.dirPath.isNull())
+            {
+                return;
+            }
+
+            classify(listing);
+            continue;
+        }
+
+        CollectionScannerPreload* const preload = candidates.dequeue();
+
+        if (queued.value(preload->filePath) != preload)
+        {
+            // The file was already scanned, or its directory finished
+
+            delete preload;
+            continue;
+        }
+
+        queued.remove(preload->filePath);
+
+        // The scanner gets its own file info: the ones of the listings are not shared between threads.
+
+        preload->scanner = preload->scanInfo.isNull() ? new ItemScanner(QFileInfo(preload->filePath))
+                                                      : new ItemScanner(QFileInfo(preload->filePath), preload->scanInfo);
+        preload->scanner->setCategory(preload->category);
+
+        preloads.insert(preload->filePath, preload);
+        pool.start(new CollectionScannerPreloadTask(this, preload));
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+void CollectionScannerWalker::run()
+{
+    walk(d->album);
+
+    QMutexLocker locker(&d->mutex);
+    d->walkerFinished = true;
+    d->condVar.wakeAll();
+}
+
+void CollectionScannerWalker::walk(const QString& album)
+{
+    // Same order and same filters as CollectionScanner::scanAlbum()
+
+    QDir dir(d->location.albumRootPath() + album);
+
+    if (!dir.exists() || !dir.isReadable())
+    {
+        return;
+    }
+
+    if (d->incrementalScan)
+    {
+        // The scanning thread does not list an album which did not change
+
+        const QString dirPath = QDir::cleanPath(dir.path());
+        AlbumFingerprint stored;
+
+        if (s_albumUnchanged(d->storedFingerprints, d->changedDirectories, dirPath,
+                             AlbumFingerprint::read(dirPath), &stored))
+        {
+            foreach (const QString& subDirectory, stored.subDirectories)
+            {
+                walk((album == QLatin1String("/") ? QString() : album) +
+                     QLatin1Char('/') + subDirectory);
+            }
+
+            return;
+        }
+    }
+
+    CollectionScannerListing listing;
+    listing.album   = album;
+    listing.dirPath = dir.path();
+    listing.entries = dir.entryList(QDir::Dirs    |
+                                    QDir::Files   |
+                                    QDir::NoDotAndDotDot,
+                                    QDir::Name | QDir::DirsLast);
+
+    QStringList subAlbums;
+
+    foreach (const QString& entry, listing.entries)
+    {
+        QFileInfo info(dir.path() + QLatin1Char('/') + entry);
+
+        // Read the file attributes here, QFileInfo caches them
+
+        if (info.isFile())
+        {
+            info.lastModified();
+            info.size();
+        }
+        else if (info.isDir())
+        {
+
+#ifdef Q_OS_WIN
+            if (!info.fileName().startsWith(QLatin1Char('.')) &&
+                !d->ignoreDirectory.contains(info.fileName()))
+#else
+            if (!d->ignoreDirectory.contains(info.fileName()))
+#endif
+            {
+                QString subAlbum = album;
+
+                if (subAlbum != QLatin1String("/"))
+                {
+                    subAlbum += QLatin1Char('/');
+                }
+
+                subAlbums << subAlbum + info.fileName();
+            }
+        }
+
+        listing.infos << info;
+    }
+
+    if (!d->pushListing(listing))
+    {
+        return;
+    }
+
+    foreach (const QString& subAlbum, subAlbums)
+    {
+        walk(subAlbum);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+void CollectionScannerPreloadTask::run()
+{
+    preload->scanner->loadFromDisk();
+
+    QMutexLocker locker(&d->mutex);
+    preload->done = true;
+    d->condVar.wakeAll();
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+CollectionScannerPipeline::CollectionScannerPipeline(CollectionScanner* const scanner,
+                                                     const CollectionLocation& location,
+                                                     const QString& album)
+    : d(new Private)
+{
+    d->scanner              = scanner;
+    d->location             = location;
+    d->album                = album;
+    d->nameFilters          = scanner->d->nameFilters;
+    d->ignoreDirectory      = scanner->d->ignoreDirectory;
+    d->deferredFileScanning = scanner->d->deferredFileScanning;
+    d->incrementalScan      = scanner->d->incrementalScan && scanner->d->recordFingerprints;
+
+    if (d->incrementalScan)
+    {
+        d->storedFingerprints = scanner->d->storedFingerprints;
+        d->changedDirectories = scanner->d->changedDirectories;
+    }
+
+    // Cache this setting now: the loading threads then do not need to query the database.
+    CoreDbAccess().db()->isUniqueHashV2();
+
+    d->pool.setMaxThreadCount(QThread::idealThreadCount());
+    d->group  = new CoreDbOperationGroup;
+    d->walker = new CollectionScannerWalker(d);
+    d->walker->start(QThread::LowPriority);
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Pipelined scan of" << location.albumRootPath() + album
+                                  << "with" << d->pool.maxThreadCount() << "loading threads";
+}
+
+CollectionScannerPipeline::~CollectionScannerPipeline()
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->stop = true;
+        d->condVar.wakeAll();
+    }
+
+    d->walker->wait();
+    delete d->walker;
+
+    d->pool.waitForDone();
+
+    foreach (CollectionScannerPreload* const preload, d->preloads)
+    {
+        delete preload->scanner;
+        delete preload;
+    }
+
+    qDeleteAll(d->candidates);
+
+    // Commit the last transaction
+    delete d->group;
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Pipelined scan wrote" << d->committedItems << "items";
+
+    delete d;
+}
+
+bool CollectionScannerPipeline::takeListing(const QString& dirPath,
+                                            QStringList* const entries,
+                                            QList<QFileInfo>* const infos)
+{
+    CollectionScannerListing listing;
+    QStringList skipped;
+    bool found = false;
+
+    {
+        QMutexLocker locker(&d->mutex);
+
+        forever
+        {
+            for (int i = 0 ; i < d->listings.size() ; ++i)
+            {
+                if (d->listings.at(i).dirPath == dirPath)
+                {
+                    // The scan follows the walk order: the directories listed before were skipped.
+
+                    for (int j = 0 ; j < i ; ++j)
+                    {
+                        CollectionScannerListing old = d->listings.takeFirst();
+                        d->listedEntries            -= old.entries.count();
+                        skipped                     << old.dirPath;
+                    }
+
+                    listing            = d->listings.takeFirst();
+                    d->listedEntries  -= listing.entries.count();
+                    found              = true;
+                    break;
+                }
+            }
+
+            // If the walker waits for room and did not list this directory, it never will.
+
+            if (found || d->walkerFinished || d->walkerWaiting)
+            {
+                break;
+            }
+
+            d->condVar.wait(&d->mutex);
+        }
+
+        d->condVar.wakeAll();
+    }
+
+    foreach (const QString& path, skipped)
+    {
+        finishedDirectory(path);
+    }
+
+    if (!found)
+    {
+        return false;
+    }
+
+    if (!listing.classified)
+    {
+        d->classify(listing);
+    }
+
+    d->preloadAhead();
+
+    *entries = listing.entries;
+    *infos   = listing.infos;
+
+    return true;
+}
+
+ItemScanner* CollectionScannerPipeline::takeItemScanner(const QFileInfo& info, qlonglong imageId)
+{
+    QString filePath                  = info.filePath();
+    CollectionScannerPreload* preload = d->preloads.take(filePath);
+
+    if (!preload)
+    {
+        // Not loaded yet: the scanning thread loads it itself.
+        d->queued.remove(filePath);
+        d->preloadAhead();
+
+        return nullptr;
+    }
+
+    {
+        QMutexLocker locker(&d->mutex);
+
+        while (!preload->done)
+        {
+            d->condVar.wait(&d->mutex);
+        }
+    }
+
+    ItemScanner* scanner = preload->scanner;
+
+    if (preload->imageId != imageId)
+    {
+        delete scanner;
+        scanner = nullptr;
+    }
+
+    delete preload;
+    d->preloadAhead();
+
+    return scanner;
+}
+
+void CollectionScannerPipeline::finishedDirectory(const QString& dirPath)
+{
+    QHash<QString, CollectionScannerPreload*>::iterator it = d->queued.begin();
+
+    while (it != d->queued.end())
+    {
+        if (it.value()->dirPath == dirPath)
+        {
+            // Deleted when dequeued
+            it = d->queued.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    QList<CollectionScannerPreload*> unused;
+
+    for (QHash<QString, CollectionScannerPreload*>::iterator it2 = d->preloads.begin() ;
+         it2 != d->preloads.end() ; )
+    {
+        if (it2.value()->dirPath == dirPath)
+        {
+            unused << it2.value();
+            it2 = d->preloads.erase(it2);
+        }
+        else
+        {
+            ++it2;
+        }
+    }
+
+    foreach (CollectionScannerPreload* const preload, unused)
+    {
+        {
+            QMutexLocker locker(&d->mutex);
+
+            while (!preload->done)
+            {
+                d->condVar.wait(&d->mutex);
+            }
+        }
+
+        delete preload->scanner;
+        delete preload;
+    }
+
+    if (!unused.isEmpty())
+    {
+        d->preloadAhead();
+    }
+}
+
+void CollectionScannerPipeline::itemCommitted()
+{
+    ++d->committedItems;
+
+    if ((d->committedItems % d->itemsPerTransaction) == 0)
+    {
+        d->group->lift();
+    }
+}
+
+} // namespace Digikam
@@ -41,6 +41,29 @@ void CollectionScanner::completeScan()
     mainEntryPoint(true);
     d->resetRemovedItemsTime();
 
+    // Albums scanned with deferred file scanning are not complete: do not record them.
+    d->recordFingerprints = !d->deferredFileScanning;
+    d->scannedFingerprints.clear();
+    d->storedFingerprints.clear();
+    d->changedDirectories.clear();
+    d->databaseIdentifier = CoreDbAccess().db()->databaseUuid().toString();
+    d->settingsIdentifier = d->scanSettingsIdentifier();
+
+    if (d->incrementalScan)
+    {
+        CollectionScanJournal::instance()->load(d->databaseIdentifier, d->settingsIdentifier,
+                                                &d->storedFingerprints, &d->changedDirectories,
+                                                &d->journalMark);
+
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Incremental scan with" << d->storedFingerprints.count()
+                                      << "album fingerprints and" << d->changedDirectories.count()
+                                      << "changed directories";
+    }
+    else
+    {
+        d->journalMark = CollectionScanJournal::instance()->journalMark();
+    }
+
     //TODO: Implement a mechanism to watch for album root changes while we keep this list
     QList<CollectionLocation> allLocations = CollectionManager::instance()->allAvailableLocations();
 
@@ -101,6 +124,14 @@ void CollectionScanner::completeScan()
         return;
     }
 
+    if (d->recordFingerprints)
+    {
+        CollectionScanJournal::instance()->storeFingerprints(d->databaseIdentifier, d->settingsIdentifier,
+                                                             d->scannedFingerprints, d->journalMark);
+        d->recordFingerprints = false;
+        d->scannedFingerprints.clear();
+    }
+
     completeScanCleanupPart();
 
     qCDebug(DIGIKAM_DATABASE_LOG) << "Complete scan took:" << time.elapsed() << "msecs.";
@@ -117,6 +148,8 @@ void CollectionScanner::finishCompleteScan(const QStringList& albumPaths)
         d->resetRemovedItemsTime();
     }
 
+    d->recordFingerprints = false;
+
     if (!d->checkObserver())
     {
         emit cancelled();
@@ -244,6 +277,7 @@ void CollectionScanner::partialScan(const QString& albumRoot, const QString& alb
 
     mainEntryPoint(false);
     d->resetRemovedItemsTime();
+    d->recordFingerprints = false;
 
     CollectionLocation location = CollectionManager::instance()->locationForAlbumRootPath(albumRoot);
 
@@ -564,6 +598,18 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
     // + Adds files if they do not yet exist in the db.
     // + Marks stale files as removed
 
+    if (d->pipelinedScanning && !d->pipeline)
+    {
+        // Scan the album and its subalbums with the threads of the pipeline
+
+        CollectionScannerPipeline pipeline(this, location, album);
+        d->pipeline = &pipeline;
+        scanAlbum(location, album);
+        d->pipeline = nullptr;
+
+        return;
+    }
+
     QDir dir(location.albumRootPath() + album);
 
     if (!dir.exists() || !dir.isReadable())
@@ -573,6 +619,39 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         return;
     }
 
+    // In an incremental scan, an album whose directory did not change is not listed again.
+    // Its subalbums are checked one by one.
+
+    const QString dirPath    = QDir::cleanPath(dir.path());
+    AlbumFingerprint current = d->recordFingerprints ? AlbumFingerprint::read(dirPath)
+                                                     : AlbumFingerprint();
+    AlbumFingerprint stored;
+
+    if (d->incrementalScan && d->recordFingerprints &&
+        s_albumUnchanged(d->storedFingerprints, d->changedDirectories, dirPath, current, &stored))
+    {
+        d->scannedAlbums << checkAlbum(location, album);
+        d->scannedFingerprints.insert(dirPath, stored);
+
+        if (d->wantSignals && stored.entryCount)
+        {
+            emit scannedFiles(stored.entryCount);
+        }
+
+        foreach (const QString& subDirectory, stored.subDirectories)
+        {
+            if (!d->checkObserver())
+            {
+                return;
+            }
+
+            scanAlbum(location, (album == QLatin1String("/") ? QString() : album) +
+                                QLatin1Char('/') + subDirectory);
+        }
+
+        return;
+    }
+
     if (d->wantSignals)
     {
         emit startScanningAlbum(location.albumRootPath(), album);
@@ -592,15 +671,22 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         itemIdSet << scanInfos.at(i).id;
     }
 
-    const QStringList& list = dir.entryList(QDir::Dirs    |
-                                            QDir::Files   |
-                                            QDir::NoDotAndDotDot,
-                                            QDir::Name | QDir::DirsLast);
+    QStringList      list;
+    QList<QFileInfo> infos;
+
+    if (!d->pipeline || !d->pipeline->takeListing(dir.path(), &list, &infos))
+    {
+        list = dir.entryList(QDir::Dirs    |
+                             QDir::Files   |
+                             QDir::NoDotAndDotDot,
+                             QDir::Name | QDir::DirsLast);
+    }
 
     const QString xmpExt(QLatin1String(".xmp"));
     int counter = -1;
+    QStringList subDirectories;
 
-    foreach (const QString& entry, list)
+    for (int i = 0 ; i < list.size() ; ++i)
     {
         if (!d->checkObserver())
         {
@@ -615,7 +701,8 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
             counter = 0;
         }
 
-        QFileInfo info(dir.path() + QLatin1Char('/') + entry);
+        QFileInfo info = infos.isEmpty() ? QFileInfo(dir.path() + QLatin1Char('/') + list.at(i))
+                                         : infos.at(i);
 
         if (info.isFile())
         {
@@ -682,6 +769,7 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
                 subAlbum += QLatin1Char('/');
             }
 
+            subDirectories << info.fileName();
             scanAlbum(location, subAlbum + info.fileName());
         }
     }
@@ -691,6 +779,11 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         emit scannedFiles(counter);
     }
 
+    if (d->pipeline)
+    {
+        d->pipeline->finishedDirectory(dir.path());
+    }
+
     // Mark items in the db which we did not see on disk.
     if (!itemIdSet.isEmpty())
     {
@@ -703,6 +796,13 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
     // mark album as scanned
     d->scannedAlbums << albumID;
 
+    if (d->recordFingerprints && !current.isNull())
+    {
+        current.entryCount     = list.count();
+        current.subDirectories = subDirectories;
+        d->scannedFingerprints.insert(dirPath, current);
+    }
+
     if (d->wantSignals)
     {
         emit finishedScanningAlbum(location.albumRootPath(), album, list.count());
@@ -807,8 +907,7 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
         return -1;
     }
 
-    ItemScanner scanner(info);
-    scanner.setCategory(category(info));
+    QScopedPointer<ItemScanner> scanner(d->createItemScanner(info, ItemScanInfo(), category(info)));
 
     // Check copy/move hints for single items
     qlonglong srcId = 0;
@@ -821,7 +920,7 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
 
     if (srcId != 0)
     {
-        scanner.copiedFrom(albumId, srcId);
+        scanner->copiedFrom(albumId, srcId);
     }
     else
     {
@@ -836,18 +935,18 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
 
         if (srcId != 0)
         {
-            scanner.copiedFrom(albumId, srcId);
+            scanner->copiedFrom(albumId, srcId);
         }
         else
         {
             // Establishing identity with the unique hsah
-            scanner.newFile(albumId);
+            scanner->newFile(albumId);
         }
     }
 
-    d->finishScanner(scanner);
+    d->finishScanner(*scanner);
 
-    return scanner.id();
+    return scanner->id();
 }
 
 qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albumId)
@@ -857,12 +956,11 @@ qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albu
         return -1;
     }
 
-    ItemScanner scanner(info);
-    scanner.setCategory(category(info));
-    scanner.newFileFullScan(albumId);
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createItemScanner(info, ItemScanInfo(), category(info)));
+    scanner->newFileFullScan(albumId);
+    d->finishScanner(*scanner);
 
-    return scanner.id();
+    return scanner->id();
 }
 
 void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -872,10 +970,9 @@ void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanIn
         return;
     }
 
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createItemScanner(info, scanInfo, category(info)));
+    scanner->fileModified();
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info, const ItemScanInfo& scanInfo,
@@ -885,15 +982,16 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
     qlonglong oldSize = scanInfo.fileSize;
 
     // same code as scanModifiedFile
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
+    QScopedPointer<ItemScanner> scanner(d->createItemScanner(info, scanInfo, category(info)));
+    scanner->fileModified();
 
-    QString newHash   = scanner.itemScanInfo().uniqueHash;
-    qlonglong newSize = scanner.itemScanInfo().fileSize;
+    QString newHash   = scanner->itemScanInfo().uniqueHash;
+    qlonglong newSize = scanner->itemScanInfo().fileSize;
 
     if (ThumbsDbAccess::isInitialized())
     {
+        ThumbsDbWriteQueue::instance()->flush();
+
         if (fileWasEdited)
         {
             // The file was edited in such a way that we know that the pixel content did not change, so we can reuse the thumbnail.
@@ -904,7 +1002,7 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
             if (thumbDbInfo.id != -1)
             {
                 ThumbsDbAccess().db()->insertUniqueHash(newHash, newSize, thumbDbInfo.id);
-                ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner.itemScanInfo().modificationDate);
+                ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner->itemScanInfo().modificationDate);
                 // TODO: also update details thumbnails (by file path and URL scheme)
             }
         }
@@ -914,7 +1012,7 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
         }
     }
 
-    d->finishScanner(scanner);
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -924,10 +1022,9 @@ void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& sc
         return;
     }
 
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.rescan();
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createItemScanner(info, scanInfo, category(info)));
+    scanner->rescan();
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::completeHistoryScanning()
@@ -199,6 +199,27 @@ int CollectionScanner::countItemsInFolder(const QString& directory)
         return 0;
     }
 
+    if (d->incrementalScan && d->recordFingerprints)
+    {
+        // Use the number of entries recorded by the last scan for the albums which did not change
+
+        const QString dirPath = QDir::cleanPath(dir.path());
+        AlbumFingerprint stored;
+
+        if (s_albumUnchanged(d->storedFingerprints, d->changedDirectories, dirPath,
+                             AlbumFingerprint::read(dirPath), &stored))
+        {
+            items += stored.entryCount;
+
+            foreach (const QString& subDirectory, stored.subDirectories)
+            {
+                items += countItemsInFolder(dirPath + QLatin1Char('/') + subDirectory);
+            }
+
+            return items;
+        }
+    }
+
     const QFileInfoList& list = dir.entryInfoList(QDir::Dirs    |
                                                   QDir::Files   |
                                                   QDir::NoDotAndDotDot);
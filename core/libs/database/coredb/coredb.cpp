@@ -1647,6 +1647,113 @@ QVariantList CoreDB::getItemInformation(qlonglong imageID, DatabaseFields::ItemI
     return values;
 }
 
+QHash<qlonglong, QVariantList> CoreDB::getImagesFields(const QList<qlonglong>& imageIDs,
+                                                       DatabaseFields::Images fields) const
+{
+    if ((fields == DatabaseFields::ImagesNone) || imageIDs.isEmpty())
+    {
+        return QHash<qlonglong, QVariantList>();
+    }
+
+    QStringList fieldNames                = imagesFieldList(fields);
+    QHash<qlonglong, QVariantList> result = getFieldsForImages(QLatin1String("Images"), QLatin1String("id"),
+                                                               fieldNames, imageIDs);
+
+    // Convert date times to QDateTime, they come as QString
+    if (fields & DatabaseFields::ModificationDate)
+    {
+        int index = fieldNames.indexOf(QLatin1String("modificationDate"));
+
+        for (QHash<qlonglong, QVariantList>::iterator it = result.begin() ; it != result.end() ; ++it)
+        {
+            (*it)[index] = it->at(index).toDateTime();
+        }
+    }
+
+    return result;
+}
+
+QHash<qlonglong, QVariantList> CoreDB::getItemInformation(const QList<qlonglong>& imageIDs,
+                                                          DatabaseFields::ItemInformation fields) const
+{
+    if ((fields == DatabaseFields::ItemInformationNone) || imageIDs.isEmpty())
+    {
+        return QHash<qlonglong, QVariantList>();
+    }
+
+    QStringList fieldNames                = imageInformationFieldList(fields);
+    QHash<qlonglong, QVariantList> result = getFieldsForImages(QLatin1String("ImageInformation"), QLatin1String("imageid"),
+                                                               fieldNames, imageIDs);
+
+    // Convert date times to QDateTime, they come as QString
+    QList<int> dateIndexes;
+
+    if (fields & DatabaseFields::CreationDate)
+    {
+        dateIndexes << fieldNames.indexOf(QLatin1String("creationDate"));
+    }
+
+    if (fields & DatabaseFields::DigitizationDate)
+    {
+        dateIndexes << fieldNames.indexOf(QLatin1String("digitizationDate"));
+    }
+
+    if (!dateIndexes.isEmpty())
+    {
+        for (QHash<qlonglong, QVariantList>::iterator it = result.begin() ; it != result.end() ; ++it)
+        {
+            foreach (int index, dateIndexes)
+            {
+                (*it)[index] = it->at(index).toDateTime();
+            }
+        }
+    }
+
+    return result;
+}
+
+QHash<qlonglong, QVariantList> CoreDB::getFieldsForImages(const QString& table, const QString& idColumn,
+                                                          const QStringList& fieldNames,
+                                                          const QList<qlonglong>& imageIDs) const
+{
+    QHash<qlonglong, QVariantList> result;
+    result.reserve(imageIDs.size());
+
+    QString select = QString::fromUtf8("SELECT %1, %2 FROM %3 WHERE %1 IN (")
+                     .arg(idColumn)
+                     .arg(fieldNames.join(QString::fromUtf8(", ")))
+                     .arg(table);
+
+    // SQLite allows no more than 999 parameters
+    const int maxParams   = d->db->maximumBoundValues();
+    const int columnCount = fieldNames.size() + 1;
+
+    for (int i = 0 ; i < imageIDs.size() ; i += maxParams)
+    {
+        QList<qlonglong> chunk = imageIDs.mid(i, maxParams);
+        QVariantList     boundValues;
+        QVariantList     values;
+
+        foreach (const qlonglong& id, chunk)
+        {
+            boundValues << id;
+        }
+
+        QString query = select;
+        addBoundValuePlaceholders(query, chunk.size());
+        query        += QString::fromUtf8(");");
+
+        d->db->execSql(query, boundValues, &values);
+
+        for (int j = 0 ; (j + columnCount) <= values.size() ; j += columnCount)
+        {
+            result.insert(values.at(j).toLongLong(), values.mid(j + 1, columnCount - 1));
+        }
+    }
+
+    return result;
+}
+
 QVariantList CoreDB::getImageMetadata(qlonglong imageID, DatabaseFields::ImageMetadata fields) const
 {
     QVariantList values;
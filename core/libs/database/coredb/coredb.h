@@ -35,6 +35,7 @@
 #include <QDateTime>
 #include <QPair>
 #include <QMap>
+#include <QHash>
 #include <QUuid>
 
 // Local includes
@@ -799,6 +800,15 @@ public:
      */
     QVariantList getImagesFields(qlonglong imageID, DatabaseFields::Images imagesFields) const;
 
+    /**
+     * Read the fields of the Images table for a list of items, with a few queries
+     * for the whole list instead of one query per item.
+     * Returns the values, as for the method above, hashed by image id.
+     * Items not found in the table are not in the hash.
+     */
+    QHash<qlonglong, QVariantList> getImagesFields(const QList<qlonglong>& imageIDs,
+                                                   DatabaseFields::Images imagesFields) const;
+
     /**
      * Add (or replace) the ItemInformation of the specified item.
      * If there is already an entry, it will be discarded.
@@ -834,6 +844,14 @@ public:
     QVariantList getItemInformation(qlonglong imageID,
                                     DatabaseFields::ItemInformation infoFields = DatabaseFields::ItemInformationAll) const;
 
+    /**
+     * Read image information for a list of items, with a few queries for the whole list.
+     * Returns the values, as for the method above, hashed by image id.
+     * Items without image information are not in the hash.
+     */
+    QHash<qlonglong, QVariantList> getItemInformation(const QList<qlonglong>& imageIDs,
+                                                      DatabaseFields::ItemInformation infoFields) const;
+
     /**
      * Add (or replace) the ImageMetadata of the specified item.
      * If there is already an entry, it will be discarded.
@@ -1396,6 +1414,14 @@ protected:
     QList<qlonglong> getRelatedImages(qlonglong id, bool fromOrTo, DatabaseRelation::Type type, bool boolean) const;
     QVector<QList<qlonglong> > getRelatedImages(QList<qlonglong> ids, bool fromOrTo, DatabaseRelation::Type type, bool boolean) const;
 
+    /**
+     * Select the fields from the table for the items, by chunks of ids. The id column is selected first
+     * and used as hash key, the returned lists contain the values of the fields only.
+     */
+    QHash<qlonglong, QVariantList> getFieldsForImages(const QString& table, const QString& idColumn,
+                                                      const QStringList& fieldNames,
+                                                      const QList<qlonglong>& imageIDs) const;
+
 private:
 
     CoreDB(const CoreDB&); // Disable
@@ -43,6 +43,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "haarkernels.h"
 
 using namespace std;
 
@@ -167,12 +168,10 @@ Calculator::~Calculator()
 /** Do the Haar tensorial 2d transform itself.
     Here input is RGB data [0..255] in Unit arrays
     Computation is (almost) in-situ.
+    Rows are decomposed first, then columns, using the vectorized kernels.
 */
 void Calculator::haar2D(Unit a[])
 {
-    int  i;
-    Unit t[NumberOfPixels >> 1];
-
     // scale by 1/sqrt(128) = 0.08838834764831843:
     /*
     for (i = 0; i < NUM_PIXELS_SQUARED; ++i)
@@ -180,69 +179,10 @@ void Calculator::haar2D(Unit a[])
     */
 
     // Decompose rows:
-    for (i = 0; i < NumberOfPixelsSquared; i += NumberOfPixels)
-    {
-        int h, h1;
-        Unit C = 1;
-
-        for (h = NumberOfPixels; h > 1; h = h1)
-        {
-            int j1, j2, k;
-
-            h1 = h >> 1;        // h = 2*h1
-            C *= 0.7071;        // 1/sqrt(2)
-
-            for (k = 0, j1 = j2 = i; k < h1; ++k, ++j1, j2 += 2)
-            {
-                int j21 = j2+1;
-                t[k]    = (a[j2] - a[j21]) * C;
-                a[j1]   = (a[j2] + a[j21]);
-            }
-
-            // Write back subtraction results:
-            memcpy(a+i+h1, t, h1*sizeof(a[0]));
-        }
-
-        // Fix first element of each row:
-        a[i] *= C;  // C = 1/sqrt(NUM_PIXELS)
-    }
-
-    // scale by 1/sqrt(128) = 0.08838834764831843:
-    /*
-    for (i = 0; i < NUM_PIXELS_SQUARED; ++i)
-        a[i] *= 0.08838834764831843;
-    */
+    Kernels::haarRows(a);
 
     // Decompose columns:
-    for (i = 0; i < NumberOfPixels; ++i)
-    {
-        Unit C = 1;
-        int  h, h1;
-
-        for (h = NumberOfPixels; h > 1; h = h1)
-        {
-            int j1, j2, k;
-
-            h1 = h >> 1;
-            C *= 0.7071;       // 1/sqrt(2) = 0.7071
-
-            for (k = 0, j1 = j2 = i; k < h1; ++k, j1 += NumberOfPixels, j2 += 2*NumberOfPixels)
-            {
-                int j21 = j2+NumberOfPixels;
-                t[k]    = (a[j2] - a[j21]) * C;
-                a[j1]   = (a[j2] + a[j21]);
-            }
-
-            // Write back subtraction results:
-            for (k = 0, j1 = i+h1*NumberOfPixels; k < h1; ++k, j1 += NumberOfPixels)
-            {
-                a[j1] = t[k];
-            }
-        }
-
-        // Fix first element of each column:
-        a[i] *= C;
-    }
+    Kernels::haarColumns(a);
 }
 
 /** Do the Haar tensorial 2d transform itself.
@@ -259,17 +199,7 @@ void Calculator::transform(ImageData* const data)
     Unit* b = data->data2;
     Unit* c = data->data3;
 
-    for (int i = 0; i < NumberOfPixelsSquared; ++i)
-    {
-        Unit Y, I, Q;
-
-        Y    = 0.299 * a[i] + 0.587 * b[i] + 0.114 * c[i];
-        I    = 0.596 * a[i] - 0.275 * b[i] - 0.321 * c[i];
-        Q    = 0.212 * a[i] - 0.523 * b[i] + 0.311 * c[i];
-        a[i] = Y;
-        b[i] = I;
-        c[i] = Q;
-    }
+    Kernels::rgbToYiq(a, b, c, NumberOfPixelsSquared);
 
     haar2D(a);
     haar2D(b);
@@ -303,20 +233,16 @@ void Calculator::getmLargests(Unit* const cdata, Idx* const sig)
 
     // Queue is full (size is NUM_COEFS)
 
-    for (/*i = NUM_COEFS+1*/; i < NumberOfPixelsSquared; ++i)
+    // Skip quickly over all values not larger than the smallest entry.
+    while ((i = Kernels::nextAbove(cdata, i, NumberOfPixelsSquared, vq.top().d)) < NumberOfPixelsSquared)
     {
+        // Make room by dropping smallest entry:
+        vq.pop();
+        // Insert val as new entry:
+        val.i = i;
         val.d = fabs(cdata[i]);
-
-        if (val.d > vq.top().d)
-        {
-            // Make room by dropping smallest entry:
-            vq.pop();
-            // Insert val as new entry:
-            val.i = i;
-            vq.push(val);
-        }
-
-        // else discard: do nothing
+        vq.push(val);
+        ++i;
     }
 
     // Empty the (non-empty) queue and fill-in sig:
@@ -38,6 +38,10 @@
 
 #include <QtGlobal>
 
+// Local includes
+
+#include "digikam_export.h"
+
 class QImage;
 
 namespace Digikam
@@ -95,7 +99,7 @@ typedef qint32 Idx;
 
 // ---------------------------------------------------------------------------------
 
-class ImageData
+class DIGIKAM_DATABASE_EXPORT ImageData
 {
 public:
 
@@ -242,7 +246,7 @@ private:
 
 // ---------------------------------------------------------------------------------
 
-class Calculator
+class DIGIKAM_DATABASE_EXPORT Calculator
 {
 
 public:
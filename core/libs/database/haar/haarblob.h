@@ -0,0 +1,126 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2003-01-17
+ * Description : Haar signature database blob
+ *
+ * Copyright (C) 2003      by Ricardo Niederberger Cabral <nieder at mail dot ru>
+ * Copyright (C) 2009-2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ * Copyright (C) 2009-2013 by Marcel Wiesweg <marcel dot wiesweg at gmx dot de>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_BLOB_H
+#define DIGIKAM_HAAR_BLOB_H
+
+// Qt includes
+
+#include <QByteArray>
+#include <QDataStream>
+
+// Local includes
+
+#include "haar.h"
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+/** This class encapsulates the Haar signature in a QByteArray
+ *  that can be stored as a BLOB in the database.
+ *
+ *  Reading and writing is done in a platform-independent manner, which
+ *  induces a certain overhead, but which is necessary IMO.
+ */
+class Q_DECL_HIDDEN DatabaseBlob
+{
+public:
+
+    enum
+    {
+        Version = 1
+    };
+
+public:
+
+    DatabaseBlob() = default;
+
+    /** Read the QByteArray into the Haar::SignatureData.
+     */
+    void read(const QByteArray& array, Haar::SignatureData* const data)
+    {
+        QDataStream stream(array);
+
+        // check version
+        qint32 version;
+        stream >> version;
+
+        if (version != Version)
+        {
+            qCDebug(DIGIKAM_DATABASE_LOG) << "Unsupported binary version of Haar Blob in database";
+            return;
+        }
+
+        stream.setVersion(QDataStream::Qt_4_3);
+
+        // read averages
+        for (int i = 0 ; i < 3 ; ++i)
+        {
+            stream >> data->avg[i];
+        }
+
+        // read coefficients
+        for (int i = 0 ; i < 3 ; ++i)
+        {
+            for (int j = 0 ; j < Haar::NumberOfCoefficients ; ++j)
+            {
+                stream >> data->sig[i][j];
+            }
+        }
+    }
+
+    QByteArray write(Haar::SignatureData* const data)
+    {
+        QByteArray array;
+        array.reserve(sizeof(qint32) + 3*sizeof(double) + 3*sizeof(qint32)*Haar::NumberOfCoefficients);
+        QDataStream stream(&array, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_4_3);
+
+        // write version
+        stream << (qint32)Version;
+
+        // write averages
+        for (int i = 0 ; i < 3 ; ++i)
+        {
+            stream << data->avg[i];
+        }
+
+        // write coefficients
+        for (int i = 0 ; i < 3 ; ++i)
+        {
+            for (int j = 0 ; j < Haar::NumberOfCoefficients ; ++j)
+            {
+                stream << data->sig[i][j];
+            }
+        }
+
+        return array;
+    }
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_HAAR_BLOB_H
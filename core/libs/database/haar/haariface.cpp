@@ -40,11 +40,18 @@
 #include <QImage>
 #include <QImageReader>
 #include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 
 // Local includes
 
 #include "digikam_debug.h"
-#include "jpegutils.h"
 #include "dimg.h"
 #include "iteminfo.h"
 #include "coredbaccess.h"
@@ -55,6 +62,7 @@
 #include "dbenginesqlquery.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
+#include "haarblob.h"
 
 using namespace std;
 
@@ -63,89 +71,172 @@ using namespace std;
 namespace Digikam
 {
 
-typedef QMap<qlonglong, Haar::SignatureData> SignatureCache;
-typedef QMap<qlonglong, int>                 AlbumCache;
+/// Image id -> (album root id, album id)
+typedef QHash<qlonglong, QPair<int, int> > AlbumCache;
 
-/** This class encapsulates the Haar signature in a QByteArray
- *  that can be stored as a BLOB in the database.
- *
- *  Reading and writing is done in a platform-independent manner, which
- *  induces a certain overhead, but which is necessary IMO.
+/** Fills the shared signature index from the similarity database.
  */
-class Q_DECL_HIDDEN DatabaseBlob
+class Q_DECL_HIDDEN HaarSignatureIndexDbLoader : public HaarSignatureIndex::Loader
 {
 public:
 
-    enum
+    void load(HaarSignatureIndex* const index) override
     {
-        Version = 1
-    };
+        DatabaseBlob        blob;
+        Haar::SignatureData targetSig;
 
-public:
+        DbEngineSqlQuery query = SimilarityDbAccess().backend()->prepareQuery(
+                                     QString::fromUtf8("SELECT imageid, matrix FROM ImageHaarMatrix;"));
 
-    DatabaseBlob() = default;
+        if (!SimilarityDbAccess().backend()->exec(query))
+        {
+            return;
+        }
 
-    /** Read the QByteArray into the Haar::SignatureData.
-     */
-    void read(const QByteArray& array, Haar::SignatureData* const data)
-    {
-        QDataStream stream(array);
+        // We don't use SimilarityDb's convenience calls, as the result set is large
+        // and we try to avoid copying in a temporary QList<QVariant>
+        while (query.next())
+        {
+            blob.read(query.value(1).toByteArray(), &targetSig);
+            index->addSignature(query.value(0).toLongLong(), targetSig);
+        }
+    }
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/** The images taking part in a duplicates search, shared read-only by all search threads.
+ *  Images are dropped from the targets or marked as members of a duplicates group
+ *  through atomic flags, so no lock is needed while scoring.
+ */
+class Q_DECL_HIDDEN HaarSearchScope
+{
+public:
 
-        // check version
-        qint32 version;
-        stream >> version;
+    explicit HaarSearchScope(const QSet<qlonglong>& imageIds)
+        : excluded(imageIds.count()),
+          clustered(imageIds.count())
+    {
+        int position = 0;
+        positions.reserve(imageIds.count());
 
-        if (version != Version)
+        foreach (const qlonglong& id, imageIds)
         {
-            qCDebug(DIGIKAM_DATABASE_LOG) << "Unsupported binary version of Haar Blob in database";
-            return;
+            positions.insert(id, position++);
         }
+    }
+
+    /// True if the image is a possible target of the search.
+    bool contains(qlonglong imageId) const
+    {
+        int position = positions.value(imageId, -1);
+
+        return ((position != -1) && !excluded.at(position).load());
+    }
 
-        stream.setVersion(QDataStream::Qt_4_3);
+    /// Remove an image from the targets of all further searches.
+    void exclude(qlonglong imageId)
+    {
+        int position = positions.value(imageId, -1);
 
-        // read averages
-        for (int i = 0 ; i < 3 ; ++i)
+        if (position != -1)
         {
-            stream >> data->avg[i];
+            excluded[position].store(1);
         }
+    }
+
+    /// True if the image already belongs to a group of duplicates.
+    bool isClustered(qlonglong imageId) const
+    {
+        int position = positions.value(imageId, -1);
+
+        return ((position != -1) && clustered.at(position).load());
+    }
+
+    void setClustered(qlonglong imageId)
+    {
+        int position = positions.value(imageId, -1);
 
-        // read coefficients
-        for (int i = 0 ; i < 3 ; ++i)
+        if (position != -1)
         {
-            for (int j = 0 ; j < Haar::NumberOfCoefficients ; ++j)
-            {
-                stream >> data->sig[i][j];
-            }
+            clustered[position].store(1);
         }
     }
 
-    QByteArray write(Haar::SignatureData* const data)
+private:
+
+    QHash<qlonglong, int> positions;
+    QVector<QAtomicInt>   excluded;
+    QVector<QAtomicInt>   clustered;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/** Accepts the indexed images which fulfill the restrictions of a search.
+ */
+class Q_DECL_HIDDEN HaarRestrictionsFilter : public HaarSignatureIndexFilter
+{
+public:
+
+    explicit HaarRestrictionsFilter(HaarIface* const iface,
+                                    const AlbumCache& albumCache,
+                                    const QSet<int>& albumRootsToSearch,
+                                    const HaarSearchScope* const searchScope,
+                                    const QList<int>& targetAlbums,
+                                    HaarIface::DuplicatesSearchRestrictions searchResultRestriction,
+                                    qlonglong originalImageId,
+                                    int originalAlbumId)
+        : iface(iface),
+          albumCache(albumCache),
+          albumRootsToSearch(albumRootsToSearch),
+          searchScope(searchScope),
+          targetAlbums(targetAlbums),
+          searchResultRestriction(searchResultRestriction),
+          originalImageId(originalImageId),
+          originalAlbumId(originalAlbumId)
+    {
+    }
+
+    bool accept(qlonglong imageId) const override
     {
-        QByteArray array;
-        array.reserve(sizeof(qint32) + 3*sizeof(double) + 3*sizeof(qint32)*Haar::NumberOfCoefficients);
-        QDataStream stream(&array, QIODevice::WriteOnly);
-        stream.setVersion(QDataStream::Qt_4_3);
+        AlbumCache::const_iterator it = albumCache.constFind(imageId);
 
-        // write version
-        stream << (qint32)Version;
+        // Not in the core database, or deleted.
+        if (it == albumCache.constEnd())
+        {
+            return false;
+        }
 
-        // write averages
-        for (int i = 0 ; i < 3 ; ++i)
+        if (!albumRootsToSearch.isEmpty() && !albumRootsToSearch.contains(it.value().first))
         {
-            stream << data->avg[i];
+            return false;
         }
 
-        // write coefficients
-        for (int i = 0 ; i < 3 ; ++i)
+        if (searchScope && !searchScope->contains(imageId))
         {
-            for (int j = 0 ; j < Haar::NumberOfCoefficients ; ++j)
-            {
-                stream << data->sig[i][j];
-            }
+            return false;
         }
 
-        return array;
+        // If the image is the original one or
+        // No restrictions apply or
+        // SameAlbum restriction applies and the albums are equal or
+        // DifferentAlbum restriction applies and the albums differ
+        // then calculate the score.
+        // Also, restrict to target album
+        return iface->fulfillsRestrictions(imageId, it.value().second, originalImageId,
+                                           originalAlbumId, targetAlbums, searchResultRestriction);
     }
+
+private:
+
+    HaarIface* const                        iface;
+    const AlbumCache&                       albumCache;
+    const QSet<int>&                        albumRootsToSearch;
+    const HaarSearchScope* const            searchScope;
+    const QList<int>&                       targetAlbums;
+    HaarIface::DuplicatesSearchRestrictions searchResultRestriction;
+    qlonglong                               originalImageId;
+    int                                     originalAlbumId;
 };
 
 // -----------------------------------------------------------------------------------------------------
@@ -158,19 +249,16 @@ public:
     {
         data              = nullptr;
         bin               = nullptr;
-        signatureCache    = nullptr;
         albumCache        = nullptr;
-        useSignatureCache = false;
-
-        signatureQuery    = QString::fromUtf8("SELECT imageid, matrix FROM ImageHaarMatrix;");
+        searchScope       = nullptr;
     }
 
     ~Private()
     {
         delete data;
         delete bin;
-        delete signatureCache;
         delete albumCache;
+        delete searchScope;
     }
 
     void createLoadingBuffer()
@@ -189,6 +277,24 @@ public:
         }
     }
 
+    /** Returns the shared signature index, filled from the database on first use.
+     */
+    HaarSignatureIndex* signatureIndex() const
+    {
+        HaarSignatureIndex* const index = HaarSignatureIndex::instance();
+
+        if (!index->isLoaded())
+        {
+            HaarSignatureIndexDbLoader loader;
+            index->load(&loader);
+        }
+
+        return index;
+    }
+
+    /** When enabled, the album of all items is read once and the searches
+     *  are restricted to imageIds, as needed by the duplicates search.
+     */
     void setSignatureCacheEnabled(bool cache, const QSet<qlonglong>& imageIds)
     {
         setSignatureCacheEnabled(cache);
@@ -199,86 +305,165 @@ public:
             return;
         }
 
-        // Remove all ids from the fully created signatureCache that are not needed for the duplicates search.
-        // This is usually faster then starting a query for every single id in imageIds.
-        for (SignatureCache::iterator it = signatureCache->begin() ;
-             it != signatureCache->end() ; )
-        {
-            if (!imageIds.contains(it.key()))
-            {
-                it = signatureCache->erase(it);
-            }
-            else
-            {
-                ++it;
-            }
-        }
+        searchScope = new HaarSearchScope(imageIds);
     }
 
     void setSignatureCacheEnabled(bool cache)
     {
-        delete signatureCache;
-        signatureCache = nullptr;
         delete albumCache;
-        albumCache     = nullptr;
+        albumCache  = nullptr;
+        delete searchScope;
+        searchScope = nullptr;
 
         if (cache)
         {
-            signatureCache = new SignatureCache();
-            albumCache     = new AlbumCache();
+            albumCache = new AlbumCache(CoreDbAccess().db()->getAllItemsWithAlbum());
         }
+    }
 
-        useSignatureCache = cache;
+    Haar::ImageData* data;
+    Haar::WeightBin* bin;
+    AlbumCache*      albumCache;
+    HaarSearchScope* searchScope;
 
-        // stop here if we disable cached signatures
-        if (!cache)
-        {
-            return;
-        }
+    QSet<int>        albumRootsToSearch;
+};
 
-        // Variables for data read from DB
-        DatabaseBlob        blob;
-        qlonglong           imageid;
-        int                 albumid;
-        Haar::SignatureData targetSig;
+// -----------------------------------------------------------------------------------------------------
 
-        // reference for easier access
-        SignatureCache& signatureCache = *this->signatureCache;
-        AlbumCache&     albumCache     = *this->albumCache;
+/** The state of a duplicates search shared by all worker threads.
+ */
+class Q_DECL_HIDDEN HaarDuplicatesSearch
+{
+public:
 
-        DbEngineSqlQuery query = SimilarityDbAccess().backend()->prepareQuery(signatureQuery);
+    enum
+    {
+        /// Number of reference images taken at once by a worker.
+        ChunkSize = 16
+    };
 
-        if (!SimilarityDbAccess().backend()->exec(query))
+public:
+
+    explicit HaarDuplicatesSearch()
+      : iface(nullptr),
+        scope(nullptr),
+        requiredPercentage(0.0),
+        maximumPercentage(0.0),
+        searchResultRestriction(HaarIface::None)
+    {
+    }
+
+    HaarIface*                                        iface;
+    HaarSearchScope*                                  scope;
+    QList<qlonglong>                                  images;
+    double                                            requiredPercentage;
+    double                                            maximumPercentage;
+    HaarIface::DuplicatesSearchRestrictions           searchResultRestriction;
+
+    QAtomicInt                                        next;
+    QAtomicInt                                        processed;
+    QAtomicInt                                        canceled;
+
+    QMutex                                            mutex;
+    QMap<double, QMap<qlonglong, QList<qlonglong> > > resultsMap;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN HaarDuplicatesWorker : public QRunnable
+{
+public:
+
+    explicit HaarDuplicatesWorker(HaarDuplicatesSearch* const search)
+        : search(search)
+    {
+    }
+
+    void run() override
+    {
+        const int count = search->images.count();
+
+        forever
         {
-            return;
+            int start = search->next.fetchAndAddOrdered(HaarDuplicatesSearch::ChunkSize);
+
+            if ((start >= count) || search->canceled.load())
+            {
+                return;
+            }
+
+            int end = qMin(start + (int)HaarDuplicatesSearch::ChunkSize, count);
+
+            for (int i = start ; i < end ; ++i)
+            {
+                processImage(search->images.at(i));
+                search->processed.ref();
+            }
         }
+    }
 
-        const QHash<qlonglong, QPair<int, int> >& itemAlbumHash = CoreDbAccess().db()->getAllItemsWithAlbum();
+private:
 
-        while (query.next())
+    void processImage(qlonglong id)
+    {
+        HaarSearchScope* const scope = search->scope;
+
+        if (!scope->isClustered(id))
         {
-            imageid = query.value(0).toLongLong();
+            QList<int> targetAlbums;
+
+            // find images with required similarity
+            QPair<double, QMap<qlonglong, double> > bestMatches =
+                search->iface->bestMatchesForImageWithThreshold(id,
+                                                                search->requiredPercentage,
+                                                                search->maximumPercentage,
+                                                                targetAlbums,
+                                                                search->searchResultRestriction,
+                                                                HaarIface::ScannedSketch);
+
+            // We need only the image ids from the best matches map.
+            QList<qlonglong> imageIdList = bestMatches.second.keys();
 
-            if (itemAlbumHash.contains(imageid))
+            // the list will usually contain one image: the original. Filter out.
+            if (!imageIdList.isEmpty() && !(imageIdList.count() == 1 && imageIdList.first() == id))
             {
-                blob.read(query.value(1).toByteArray(), &targetSig);
-                albumid                 = itemAlbumHash.value(imageid).second;
-                signatureCache[imageid] = targetSig;
-                albumCache[imageid]     = albumid;
+                QMutexLocker locker(&search->mutex);
+
+                // Another thread may have put the image in a group in the meantime.
+                if (!scope->isClustered(id))
+                {
+                    // make a lookup for the average similarity
+                    // If there is an entry for this similarity, add the result set.
+                    // Else, create a new similarity entry.
+                    search->resultsMap[bestMatches.first].insert(id, imageIdList);
+
+                    scope->setClustered(id);
+
+                    foreach (const qlonglong& candidate, imageIdList)
+                    {
+                        scope->setClustered(candidate);
+                    }
+                }
             }
         }
+
+        // if an imageid is not a results candidate, remove it
+        // from the search scope as well,
+        // to greatly improve speed
+        if (!scope->isClustered(id))
+        {
+            scope->exclude(id);
+        }
     }
 
-    bool             useSignatureCache;
-    Haar::ImageData* data;
-    Haar::WeightBin* bin;
-    SignatureCache*  signatureCache;
-    AlbumCache*      albumCache;
+private:
 
-    QString          signatureQuery;
-    QSet<int>        albumRootsToSearch;
+    HaarDuplicatesSearch* const search;
 };
 
+// -----------------------------------------------------------------------------------------------------
+
 HaarIface::HaarIface()
     : d(new Private())
 {
@@ -387,6 +572,8 @@ bool HaarIface::indexImage(qlonglong imageid)
                                                                   " (imageid, modificationDate, uniqueHash, matrix) "
                                                                   " VALUES(?, ?, ?, ?);"),
                                                 imageid, info.modDateTime(), info.uniqueHash(), array);
+
+        HaarSignatureIndex::instance()->insert(imageid, sig);
     }
 
     return true;
@@ -476,26 +663,16 @@ QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesForImageWithThresh
                                                                                       searchResultRestriction,
                                                                                     SketchType type)
 {
-    if (!d->useSignatureCache || (d->signatureCache->isEmpty() && d->useSignatureCache))
-    {
-        Haar::SignatureData sig;
-
-        if (!retrieveSignatureFromDB(imageid, &sig))
-        {
-            return QPair<double, QMap<qlonglong, double> >();
-        }
+    Haar::SignatureData sig;
 
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage,
-                                        targetAlbums, searchResultRestriction, type);
-    }
-    else
+    // The signature index is always loaded at this point when the duplicates search is running.
+    if (!d->signatureIndex()->signature(imageid, &sig) && !retrieveSignatureFromDB(imageid, &sig))
     {
-        // reference for easier access
-        SignatureCache& signatureCache = *d->signatureCache;
-        Haar::SignatureData& sig       = signatureCache[imageid];
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage,
-                                        targetAlbums, searchResultRestriction, type);
+        return QPair<double, QMap<qlonglong, double> >();
     }
+
+    return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage,
+                                    targetAlbums, searchResultRestriction, type);
 }
 
 QList<qlonglong> HaarIface::bestMatchesForFile(const QString& filename,
@@ -538,7 +715,7 @@ QMap<qlonglong,double> HaarIface::bestMatchesForSignature(const QString& signatu
 QMultiMap<double, qlonglong> HaarIface::bestMatches(Haar::SignatureData* const querySig,
                                                     int numberOfResults, const QList<int>& targetAlbums, SketchType type)
 {
-    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums);
+    HaarSignatureIndex::ScoreList scores = searchDatabase(querySig, type, targetAlbums);
 
     // Find out the best matches, those with the lowest score
     // We make use of the feature that QMap keys are sorted in ascending order
@@ -548,10 +725,10 @@ QMultiMap<double, qlonglong> HaarIface::bestMatches(Haar::SignatureData* const q
     double                       score, worstScore, bestScore;
     qlonglong                    id;
 
-    for (QMap<qlonglong, double>::const_iterator it = scores.constBegin() ; it != scores.constEnd() ; ++it)
+    for (HaarSignatureIndex::ScoreList::const_iterator it = scores.constBegin() ; it != scores.constEnd() ; ++it)
     {
-        score = it.value();
-        id    = it.key();
+        score = it->second;
+        id    = it->first;
 
         if (!initialFill)
         {
@@ -602,9 +779,8 @@ QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesWithThreshold(qlon
                                                                               searchResultRestriction,
                                                                             SketchType type)
 {
-    int albumId = CoreDbAccess().db()->getItemAlbum(imageid);
-    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums,
-                                                    searchResultRestriction, imageid, albumId);
+    int albumId = d->albumCache ? d->albumCache->value(imageid).second
+                                : CoreDbAccess().db()->getItemAlbum(imageid);
     double lowest, highest;
     getBestAndWorstPossibleScore(querySig, type, &lowest, &highest);
     // The range between the highest (worst) and lowest (best) score
@@ -622,15 +798,20 @@ QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesWithThreshold(qlon
     // with similarity 50,x.
     double supremum = (floor(maximumPercentage*100 + 1.0))/100;
 
+    // Only the images reaching the required score are returned by the index.
+    HaarSignatureIndex::ScoreList scores = searchDatabase(querySig, type, targetAlbums,
+                                                          searchResultRestriction, imageid, albumId,
+                                                          requiredScore);
+
     QMap<qlonglong, double> bestMatches;
     double score, percentage, avgPercentage = 0.0;
     QPair<double, QMap<qlonglong, double> > result;
     qlonglong id;
 
-    for (QMap<qlonglong, double>::const_iterator it = scores.constBegin() ; it != scores.constEnd() ; ++it)
+    for (HaarSignatureIndex::ScoreList::const_iterator it = scores.constBegin() ; it != scores.constEnd() ; ++it)
     {
-        score = it.value();
-        id    = it.key();
+        score = it->second;
+        id    = it->first;
 
         // If the score of the picture is at most the required (maximum) score and
         if (score <= requiredScore)
@@ -699,151 +880,50 @@ bool HaarIface::fulfillsRestrictions(qlonglong imageId, int albumId,
 }
 
 /// This method is the core functionality: It assigns a score to every image in the db
-QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const querySig,
-                                                  SketchType type, const QList<int>& targetAlbums,
-                                                  DuplicatesSearchRestrictions searchResultRestriction,
-                                                  qlonglong originalImageId, int originalAlbumId)
+HaarSignatureIndex::ScoreList HaarIface::searchDatabase(Haar::SignatureData* const querySig,
+                                                        SketchType type, const QList<int>& targetAlbums,
+                                                        DuplicatesSearchRestrictions searchResultRestriction,
+                                                        qlonglong originalImageId, int originalAlbumId,
+                                                        double maximumScore)
 {
-    d->createWeightBin();
-
-    // The table of constant weight factors applied to each channel and bin
-    Haar::Weights weights((Haar::Weights::SketchType)type);
-
-    // layout the query signature for fast lookup
-    Haar::SignatureMap queryMapY, queryMapI, queryMapQ;
-    queryMapY.fill(querySig->sig[0]);
-    queryMapI.fill(querySig->sig[1]);
-    queryMapQ.fill(querySig->sig[2]);
-    Haar::SignatureMap* queryMaps[3] = { &queryMapY, &queryMapI, &queryMapQ };
-
-    // Map imageid -> score. Lowest score is best.
-    // any newly inserted value will be initialized with a score of 0, as required
-    QMap<qlonglong, double> scores;
-
-    // Variables for data read from DB
-    DatabaseBlob        blob;
-    qlonglong           imageid;
-    int                 albumid;
-    Haar::SignatureData targetSig;
-
-    // reference for easier access
-    SignatureCache& signatureCache = *d->signatureCache;
-    AlbumCache&     albumCache     = *d->albumCache;
+    HaarSignatureIndex* const index = d->signatureIndex();
 
-    bool filterByAlbumRoots = !d->albumRootsToSearch.isEmpty();
+    // Outside of the duplicates search, read the current album of all items for each search,
+    // as items may have been moved or deleted since the last one.
+    AlbumCache itemAlbumHash;
 
-    // if no cache is used or the cache signature map is empty, query the database
-    if (!d->useSignatureCache || (signatureCache.isEmpty() && d->useSignatureCache))
+    if (!d->albumCache)
     {
-        DbEngineSqlQuery query = SimilarityDbAccess().backend()->prepareQuery(d->signatureQuery);
-
-        if (!SimilarityDbAccess().backend()->exec(query))
-        {
-            return scores;
-        }
-
-        const QHash<qlonglong, QPair<int, int> >& itemAlbumHash = CoreDbAccess().db()->getAllItemsWithAlbum();
-
-        // We don't use SimilarityDb's convenience calls, as the result set is large
-        // and we try to avoid copying in a temporary QList<QVariant>
-        while (query.next())
-        {
-            imageid = query.value(0).toLongLong();
-
-            if (itemAlbumHash.contains(imageid))
-            {
-                QPair<int, int> albumPair = itemAlbumHash.value(imageid);
-
-                if (filterByAlbumRoots)
-                {
-                    if (!d->albumRootsToSearch.contains(albumPair.first))
-                    {
-                        continue;
-                    }
-                }
-
-                blob.read(query.value(1).toByteArray(), &targetSig);
-                albumid = albumPair.second;
-
-                if (d->useSignatureCache)
-                {
-                    signatureCache[imageid] = targetSig;
-                    albumCache[imageid]     = albumid;
-                }
-
-                // If the image is the original one or
-                // No restrictions apply or
-                // SameAlbum restriction applies and the albums are equal or
-                // DifferentAlbum restriction applies and the albums differ
-                // then calculate the score.
-                // Also, restrict to target album
-                if (fulfillsRestrictions(imageid, albumid, originalImageId,
-                                         originalAlbumId, targetAlbums, searchResultRestriction))
-                {
-                    double& score             = scores[imageid];
-                    Haar::SignatureData& qSig = *querySig;
-                    Haar::SignatureData& tSig = targetSig;
-
-                    score = calculateScore(qSig, tSig, weights, queryMaps);
-                }
-            }
-        }
+        itemAlbumHash = CoreDbAccess().db()->getAllItemsWithAlbum();
     }
-    // read cached signature map if possible
-    else
-    {
-        foreach (const qlonglong& imageid, signatureCache.keys())
-        {
-            albumid = albumCache[imageid];
-
-            // If the image is the original one or
-            // No restrictions apply or
-            // SameAlbum restriction applies and the albums are equal or
-            // DifferentAlbum restriction applies and the albums differ
-            // then calculate the score.
-            if (fulfillsRestrictions(imageid, albumid, originalImageId,
-                                     originalAlbumId, targetAlbums, searchResultRestriction))
-            {
-                double& score             = scores[imageid];
-                Haar::SignatureData& qSig = *querySig;
-                Haar::SignatureData& tSig = signatureCache[imageid];
 
-                score = calculateScore(qSig, tSig, weights, queryMaps);
-            }
-        }
-    }
+    HaarRestrictionsFilter filter(this,
+                                  d->albumCache ? *d->albumCache : itemAlbumHash,
+                                  d->albumRootsToSearch,
+                                  d->searchScope,
+                                  targetAlbums,
+                                  searchResultRestriction,
+                                  originalImageId,
+                                  originalAlbumId);
 
-    return scores;
+    // Map imageid -> score. Lowest score is best.
+    return index->scores(*querySig, (Haar::Weights::SketchType)type, &filter, maximumScore);
 }
 
 QImage HaarIface::loadQImage(const QString& filename)
 {
-    // NOTE: Can be optimized using DImg.
+    // Only a small image is needed for the signature: JPEG, PGF and RAW files
+    // are decoded directly at a reduced size, other formats at full size.
 
-    QImage image;
+    DImg image;
+    image.setScaledLoadingSize(Haar::NumberOfPixels);
 
-    if (JPEGUtils::isJpegImage(filename))
-    {
-        // use fast jpeg loading
-        if (!JPEGUtils::loadJPEGScaled(image, filename, Haar::NumberOfPixels))
-        {
-            // try QT now.
-            if (!image.load(filename))
-            {
-                return QImage();
-            }
-        }
-    }
-    else
+    if (!image.load(filename, false, false, false, false))
     {
-        // use default QT image loading
-        if (!image.load(filename))
-        {
-            return QImage();
-        }
+        return QImage();
     }
 
-    return image;
+    return image.copyQImage();
 }
 
 bool HaarIface::retrieveSignatureFromDB(qlonglong imageid, Haar::SignatureData* const sig)
@@ -868,6 +948,8 @@ void HaarIface::getBestAndWorstPossibleScore(Haar::SignatureData* const sig,
                                              double* const lowestAndBestScore,
                                              double* const highestAndWorstScore)
 {
+    d->createWeightBin();
+
     Haar::Weights weights((Haar::Weights::SketchType)type);
     double score = 0;
 
@@ -1105,82 +1187,52 @@ QMap<double, QMap<qlonglong, QList<qlonglong> > > HaarIface::findDuplicates(cons
                                                                               searchResultRestriction,
                                                                             HaarProgressObserver* const observer)
 {
-    QMap<double, QMap<qlonglong, QList<qlonglong> > > resultsMap;
-    QMap<double, QMap<qlonglong, QList<qlonglong> > >::iterator similarity_it;
-    QSet<qlonglong>::const_iterator         it;
-    QPair<double, QMap<qlonglong, double> > bestMatches;
-    QList<qlonglong>                        imageIdList;
-    QSet<qlonglong>                         resultsCandidates;
+    HaarDuplicatesSearch search;
+    search.iface                   = this;
+    search.images                  = images2Scan.toList();
+    search.requiredPercentage      = requiredPercentage;
+    search.maximumPercentage       = maximumPercentage;
+    search.searchResultRestriction = searchResultRestriction;
 
-    int                                     total        = 0;
-    int                                     progress     = 0;
-    int                                     progressStep = 20;
+    int total = search.images.count();
 
     if (observer)
     {
-        total        = images2Scan.count();
-        progressStep = qMax(progressStep, total / 100);
         observer->totalNumberToScan(total);
     }
 
-    // create signature cache map for fast lookup
+    // read the albums once and restrict the search to the images to scan
     d->setSignatureCacheEnabled(true, images2Scan);
+    search.scope = d->searchScope;
 
-    for (it = images2Scan.constBegin() ; it != images2Scan.constEnd() ; ++it)
-    {
-        if (observer && observer->isCanceled())
-        {
-            break;
-        }
+    // Create the shared data before the threads are started. They only read it afterwards.
+    d->createWeightBin();
+    d->signatureIndex();
 
-        if (!resultsCandidates.contains(*it))
-        {
-            QList<int> targetAlbums;
-            // find images with required similarity
-            bestMatches = bestMatchesForImageWithThreshold(*it, requiredPercentage, maximumPercentage,
-                                                           targetAlbums, searchResultRestriction, ScannedSketch);
-            // We need only the image ids from the best matches map.
-            imageIdList = bestMatches.second.keys();
+    // The reference images are distributed in small chunks to all cores.
+    // A thread which is done with its chunk takes the next free one.
+    QThreadPool pool;
+    int threads = qMax(1, qMin(QThread::idealThreadCount(), total / HaarDuplicatesSearch::ChunkSize + 1));
+    pool.setMaxThreadCount(threads);
 
-            if (!imageIdList.isEmpty())
-            {
-                // the list will usually contain one image: the original. Filter out.
-                if (!(imageIdList.count() == 1 && imageIdList.first() == *it))
-                {
-                    // make a lookup for the average similarity
-                    similarity_it = resultsMap.find(bestMatches.first);
-                    // If there is an entry for this similarity, add the result set.
-                    // Else, create a new similarity entry.
-                    if (similarity_it != resultsMap.end())
-                    {
-                        similarity_it->insert(*it, imageIdList);
-                    }
-                    else
-                    {
-                        QMap<qlonglong, QList<qlonglong> > result;
-                        result.insert(*it, imageIdList);
-                        resultsMap.insert(bestMatches.first, result);
-                    }
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Duplicates search over" << total << "images with" << threads << "threads";
 
-                    resultsCandidates << *it;
-                    resultsCandidates.unite(imageIdList.toSet());
-                }
-            }
-        }
+    for (int i = 0 ; i < threads ; ++i)
+    {
+        pool.start(new HaarDuplicatesWorker(&search));
+    }
 
-        // if an imageid is not a results candidate, remove it
-        // from the cached signature map as well,
-        // to greatly improve speed
-        if (!resultsCandidates.contains(*it))
+    // Progress is reported from the calling thread while the workers are running.
+    while (!pool.waitForDone(200))
+    {
+        if (observer)
         {
-            d->signatureCache->remove(*it);
-        }
-
-        ++progress;
+            if (observer->isCanceled())
+            {
+                search.canceled.store(1);
+            }
 
-        if (observer && (progress == total || progress % progressStep == 0))
-        {
-            observer->processedNumber(progress);
+            observer->processedNumber(qMin(search.processed.load(), total));
         }
     }
 
@@ -1193,7 +1245,7 @@ QMap<double, QMap<qlonglong, QList<qlonglong> > > HaarIface::findDuplicates(cons
     // disable cache
     d->setSignatureCacheEnabled(false);
 
-    return resultsMap;
+    return search.resultsMap;
 }
 
 double HaarIface::calculateScore(Haar::SignatureData& querySig,
@@ -28,6 +28,10 @@
 #ifndef DIGIKAM_HAAR_IFACE_H
 #define DIGIKAM_HAAR_IFACE_H
 
+// C++ includes
+
+#include <cfloat>
+
 // Qt includes
 
 #include <QString>
@@ -37,6 +41,7 @@
 // Local includes
 
 #include "haar.h"
+#include "haarsignatureindex.h"
 #include "digikam_export.h"
 
 class QImage;
@@ -176,6 +181,8 @@ public:
      *  For each map item, the result values is list of candidate images which are duplicates of the key image.
      *  All images are referenced by id from database.
      *  The threshold is in the range 0..1, with 1 meaning identical signature.
+     *  The reference images are processed in parallel on all cores; images already
+     *  found in a group of duplicates are not used as reference anymore.
      */
     QMap<double, QMap<qlonglong, QList<qlonglong> > > findDuplicates(const QSet<qlonglong>& images2Scan,
                                                                      double requiredPercentage,
@@ -271,21 +278,23 @@ private:
                                                                        searchResultRestriction,
                                                                      SketchType type);
 
-    /** This function generates the scores for all images in database.
+    /** This function generates the scores for all images in database, using the shared signature index.
      *  @param data The signature of the original image for score calculation.
      *  @param type The type of the sketch, e.g. scanned.
      *  @param searchResultRestriction restrictions to apply to the generated map, i.e. None (default), same album or different album.
      *  @param originalImageId the id of the original image to compare to other images. -1 is only used for sketch search.
      *  @param albumId The album which images must or must not belong to (depending on searchResultRestriction).
-     *  @return The map of image ids and scores which fulfill the restrictions, if any.
+     *  @param maximumScore Only images with a score lower or equal to this value are returned.
+     *  @return The list of image ids and scores which fulfill the restrictions, if any.
      */
-    QMap<qlonglong, double> searchDatabase(Haar::SignatureData* const data,
-                                           SketchType type,
-                                           const QList<int>& targetAlbums,
-                                           DuplicatesSearchRestrictions
-                                             searchResultRestriction = None,
-                                           qlonglong originalImageId = -1,
-                                           int albumId = -1);
+    HaarSignatureIndex::ScoreList searchDatabase(Haar::SignatureData* const data,
+                                                 SketchType type,
+                                                 const QList<int>& targetAlbums,
+                                                 DuplicatesSearchRestrictions
+                                                   searchResultRestriction = None,
+                                                 qlonglong originalImageId = -1,
+                                                 int albumId = -1,
+                                                 double maximumScore = DBL_MAX);
 
     double calculateScore(Haar::SignatureData& querySig,
                           Haar::SignatureData& targetSig,
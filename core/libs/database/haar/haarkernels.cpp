@@ -0,0 +1,629 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-22
+ * Description : Vectorized kernels for the Haar 2d transform
+ *               and signature scoring
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarkernels.h"
+
+// C++ includes
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Runtime dispatch is done with the GCC/Clang target attributes.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define HAAR_KERNELS_X86 1
+#   include <immintrin.h>
+#   define HAAR_TARGET_SSE2 __attribute__((target("sse2")))
+#   define HAAR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+namespace Kernels
+{
+
+/// 1/sqrt(2), as used by the original transform code.
+static const Unit s_invSqrt2 = 0.7071;
+
+// --- Portable versions ------------------------------------------------------------
+
+static void rgbToYiqScalar(Unit* const a, Unit* const b, Unit* const c, int count)
+{
+    for (int i = 0 ; i < count ; ++i)
+    {
+        Unit Y, I, Q;
+
+        Y    = 0.299 * a[i] + 0.587 * b[i] + 0.114 * c[i];
+        I    = 0.596 * a[i] - 0.275 * b[i] - 0.321 * c[i];
+        Q    = 0.212 * a[i] - 0.523 * b[i] + 0.311 * c[i];
+        a[i] = Y;
+        b[i] = I;
+        c[i] = Q;
+    }
+}
+
+/// One decomposition level of one row, for the pairs k in [start, h1[.
+static inline void haarRowLevelScalar(Unit* const row, Unit* const t, int start, int h1, Unit C)
+{
+    for (int k = start ; k < h1 ; ++k)
+    {
+        t[k]   = (row[2*k] - row[2*k + 1]) * C;
+        row[k] = (row[2*k] + row[2*k + 1]);
+    }
+}
+
+static void haarRowsScalar(Unit* const a)
+{
+    Unit t[NumberOfPixels >> 1];
+
+    for (int i = 0 ; i < NumberOfPixelsSquared ; i += NumberOfPixels)
+    {
+        Unit* const row = a + i;
+        Unit C          = 1;
+
+        for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+        {
+            int h1 = h >> 1;        // h = 2*h1
+            C     *= s_invSqrt2;
+
+            haarRowLevelScalar(row, t, 0, h1, C);
+
+            // Write back subtraction results:
+            memcpy(row + h1, t, h1 * sizeof(Unit));
+        }
+
+        // Fix first element of each row:
+        row[0] *= C;  // C = 1/sqrt(NUM_PIXELS)
+    }
+}
+
+/// One decomposition level of all columns for the rows pair (2k, 2k+1), for columns in [start, NumberOfPixels[.
+static inline void haarColumnLevelScalar(Unit* const a, Unit* const t, int k, int start, Unit C)
+{
+    const Unit* const r0  = a + 2 * k * NumberOfPixels;
+    const Unit* const r1  = r0 + NumberOfPixels;
+    Unit* const       dst = a + k * NumberOfPixels;
+    Unit* const       tk  = t + k * NumberOfPixels;
+
+    for (int col = start ; col < NumberOfPixels ; ++col)
+    {
+        Unit v0  = r0[col];
+        Unit v1  = r1[col];
+        tk[col]  = (v0 - v1) * C;
+        dst[col] = (v0 + v1);
+    }
+}
+
+static void haarColumnsScalar(Unit* const a, Unit* const t)
+{
+    Unit C = 1;
+
+    for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+    {
+        int h1 = h >> 1;
+        C     *= s_invSqrt2;
+
+        for (int k = 0 ; k < h1 ; ++k)
+        {
+            haarColumnLevelScalar(a, t, k, 0, C);
+        }
+
+        // Write back subtraction results:
+        memcpy(a + h1 * NumberOfPixels, t, h1 * NumberOfPixels * sizeof(Unit));
+    }
+
+    // Fix first element of each column:
+    for (int col = 0 ; col < NumberOfPixels ; ++col)
+    {
+        a[col] *= C;
+    }
+}
+
+static int nextAboveScalar(const Unit* const data, int start, int end, Unit threshold)
+{
+    for (int i = start ; i < end ; ++i)
+    {
+        if (fabs(data[i]) > threshold)
+        {
+            return i;
+        }
+    }
+
+    return end;
+}
+
+static void averageScoresScalar(const double* const y, const double* const i, const double* const q,
+                                const double* const weights, const double* const query,
+                                double* const inOut, int start, int count)
+{
+    for (int row = start ; row < count ; ++row)
+    {
+        inOut[row] = weights[0] * fabs(query[0] - y[row]) +
+                     weights[1] * fabs(query[1] - i[row]) +
+                     weights[2] * fabs(query[2] - q[row]) -
+                     inOut[row];
+    }
+}
+
+#ifdef HAAR_KERNELS_X86
+
+// --- SSE2 versions ----------------------------------------------------------------
+
+HAAR_TARGET_SSE2 static void rgbToYiqSSE2(Unit* const a, Unit* const b, Unit* const c, int count)
+{
+    const __m128d yr = _mm_set1_pd(0.299), yg = _mm_set1_pd(0.587), yb = _mm_set1_pd(0.114);
+    const __m128d ir = _mm_set1_pd(0.596), ig = _mm_set1_pd(0.275), ib = _mm_set1_pd(0.321);
+    const __m128d qr = _mm_set1_pd(0.212), qg = _mm_set1_pd(0.523), qb = _mm_set1_pd(0.311);
+    int i            = 0;
+
+    for ( ; i + 2 <= count ; i += 2)
+    {
+        __m128d r = _mm_loadu_pd(a + i);
+        __m128d g = _mm_loadu_pd(b + i);
+        __m128d l = _mm_loadu_pd(c + i);
+
+        __m128d Y = _mm_add_pd(_mm_add_pd(_mm_mul_pd(yr, r), _mm_mul_pd(yg, g)), _mm_mul_pd(yb, l));
+        __m128d I = _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(ir, r), _mm_mul_pd(ig, g)), _mm_mul_pd(ib, l));
+        __m128d Q = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(qr, r), _mm_mul_pd(qg, g)), _mm_mul_pd(qb, l));
+
+        _mm_storeu_pd(a + i, Y);
+        _mm_storeu_pd(b + i, I);
+        _mm_storeu_pd(c + i, Q);
+    }
+
+    rgbToYiqScalar(a + i, b + i, c + i, count - i);
+}
+
+HAAR_TARGET_SSE2 static void haarRowsSSE2(Unit* const a)
+{
+    Unit t[NumberOfPixels >> 1];
+
+    for (int i = 0 ; i < NumberOfPixelsSquared ; i += NumberOfPixels)
+    {
+        Unit* const row = a + i;
+        Unit C          = 1;
+
+        for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+        {
+            int h1     = h >> 1;
+            C         *= s_invSqrt2;
+            __m128d vc = _mm_set1_pd(C);
+            int k      = 0;
+
+            // The pairs of 2 consecutive k are read before row[k], row[k+1] are written,
+            // and later iterations only read from 2*k+4 upwards.
+            for ( ; k + 2 <= h1 ; k += 2)
+            {
+                __m128d v0   = _mm_loadu_pd(row + 2*k);         // r0 r1
+                __m128d v1   = _mm_loadu_pd(row + 2*k + 2);     // r2 r3
+                __m128d even = _mm_unpacklo_pd(v0, v1);         // r0 r2
+                __m128d odd  = _mm_unpackhi_pd(v0, v1);         // r1 r3
+
+                _mm_storeu_pd(t + k,   _mm_mul_pd(_mm_sub_pd(even, odd), vc));
+                _mm_storeu_pd(row + k, _mm_add_pd(even, odd));
+            }
+
+            haarRowLevelScalar(row, t, k, h1, C);
+
+            memcpy(row + h1, t, h1 * sizeof(Unit));
+        }
+
+        row[0] *= C;
+    }
+}
+
+HAAR_TARGET_SSE2 static void haarColumnsSSE2(Unit* const a, Unit* const t)
+{
+    Unit C = 1;
+
+    for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+    {
+        int h1     = h >> 1;
+        C         *= s_invSqrt2;
+        __m128d vc = _mm_set1_pd(C);
+
+        for (int k = 0 ; k < h1 ; ++k)
+        {
+            const Unit* const r0  = a + 2 * k * NumberOfPixels;
+            const Unit* const r1  = r0 + NumberOfPixels;
+            Unit* const       dst = a + k * NumberOfPixels;
+            Unit* const       tk  = t + k * NumberOfPixels;
+
+            for (int col = 0 ; col < NumberOfPixels ; col += 2)
+            {
+                __m128d v0 = _mm_loadu_pd(r0 + col);
+                __m128d v1 = _mm_loadu_pd(r1 + col);
+
+                _mm_storeu_pd(tk + col,  _mm_mul_pd(_mm_sub_pd(v0, v1), vc));
+                _mm_storeu_pd(dst + col, _mm_add_pd(v0, v1));
+            }
+        }
+
+        memcpy(a + h1 * NumberOfPixels, t, h1 * NumberOfPixels * sizeof(Unit));
+    }
+
+    for (int col = 0 ; col < NumberOfPixels ; ++col)
+    {
+        a[col] *= C;
+    }
+}
+
+HAAR_TARGET_SSE2 static int nextAboveSSE2(const Unit* const data, int start, int end, Unit threshold)
+{
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d thr  = _mm_set1_pd(threshold);
+    int i              = start;
+
+    for ( ; i + 2 <= end ; i += 2)
+    {
+        __m128d v = _mm_andnot_pd(sign, _mm_loadu_pd(data + i));
+
+        if (_mm_movemask_pd(_mm_cmpgt_pd(v, thr)))
+        {
+            break;
+        }
+    }
+
+    return nextAboveScalar(data, i, end, threshold);
+}
+
+HAAR_TARGET_SSE2 static void averageScoresSSE2(const double* const y, const double* const i, const double* const q,
+                                               const double* const weights, const double* const query,
+                                               double* const inOut, int count)
+{
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d w0   = _mm_set1_pd(weights[0]), w1 = _mm_set1_pd(weights[1]), w2 = _mm_set1_pd(weights[2]);
+    const __m128d q0   = _mm_set1_pd(query[0]),   q1 = _mm_set1_pd(query[1]),   q2 = _mm_set1_pd(query[2]);
+    int row            = 0;
+
+    for ( ; row + 2 <= count ; row += 2)
+    {
+        __m128d d0 = _mm_andnot_pd(sign, _mm_sub_pd(q0, _mm_loadu_pd(y + row)));
+        __m128d d1 = _mm_andnot_pd(sign, _mm_sub_pd(q1, _mm_loadu_pd(i + row)));
+        __m128d d2 = _mm_andnot_pd(sign, _mm_sub_pd(q2, _mm_loadu_pd(q + row)));
+        __m128d s  = _mm_add_pd(_mm_add_pd(_mm_mul_pd(w0, d0), _mm_mul_pd(w1, d1)), _mm_mul_pd(w2, d2));
+
+        _mm_storeu_pd(inOut + row, _mm_sub_pd(s, _mm_loadu_pd(inOut + row)));
+    }
+
+    averageScoresScalar(y, i, q, weights, query, inOut, row, count);
+}
+
+// --- AVX2 versions ----------------------------------------------------------------
+
+HAAR_TARGET_AVX2 static void rgbToYiqAVX2(Unit* const a, Unit* const b, Unit* const c, int count)
+{
+    const __m256d yr = _mm256_set1_pd(0.299), yg = _mm256_set1_pd(0.587), yb = _mm256_set1_pd(0.114);
+    const __m256d ir = _mm256_set1_pd(0.596), ig = _mm256_set1_pd(0.275), ib = _mm256_set1_pd(0.321);
+    const __m256d qr = _mm256_set1_pd(0.212), qg = _mm256_set1_pd(0.523), qb = _mm256_set1_pd(0.311);
+    int i            = 0;
+
+    for ( ; i + 4 <= count ; i += 4)
+    {
+        __m256d r = _mm256_loadu_pd(a + i);
+        __m256d g = _mm256_loadu_pd(b + i);
+        __m256d l = _mm256_loadu_pd(c + i);
+
+        __m256d Y = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(yr, r), _mm256_mul_pd(yg, g)), _mm256_mul_pd(yb, l));
+        __m256d I = _mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(ir, r), _mm256_mul_pd(ig, g)), _mm256_mul_pd(ib, l));
+        __m256d Q = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(qr, r), _mm256_mul_pd(qg, g)), _mm256_mul_pd(qb, l));
+
+        _mm256_storeu_pd(a + i, Y);
+        _mm256_storeu_pd(b + i, I);
+        _mm256_storeu_pd(c + i, Q);
+    }
+
+    rgbToYiqScalar(a + i, b + i, c + i, count - i);
+}
+
+HAAR_TARGET_AVX2 static void haarRowsAVX2(Unit* const a)
+{
+    Unit t[NumberOfPixels >> 1];
+
+    for (int i = 0 ; i < NumberOfPixelsSquared ; i += NumberOfPixels)
+    {
+        Unit* const row = a + i;
+        Unit C          = 1;
+
+        for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+        {
+            int h1     = h >> 1;
+            C         *= s_invSqrt2;
+            __m256d vc = _mm256_set1_pd(C);
+            int k      = 0;
+
+            for ( ; k + 4 <= h1 ; k += 4)
+            {
+                __m256d v0   = _mm256_loadu_pd(row + 2*k);                                      // r0 r1 r2 r3
+                __m256d v1   = _mm256_loadu_pd(row + 2*k + 4);                                  // r4 r5 r6 r7
+                __m256d even = _mm256_permute4x64_pd(_mm256_unpacklo_pd(v0, v1), 0xD8);        // r0 r2 r4 r6
+                __m256d odd  = _mm256_permute4x64_pd(_mm256_unpackhi_pd(v0, v1), 0xD8);        // r1 r3 r5 r7
+
+                _mm256_storeu_pd(t + k,   _mm256_mul_pd(_mm256_sub_pd(even, odd), vc));
+                _mm256_storeu_pd(row + k, _mm256_add_pd(even, odd));
+            }
+
+            haarRowLevelScalar(row, t, k, h1, C);
+
+            memcpy(row + h1, t, h1 * sizeof(Unit));
+        }
+
+        row[0] *= C;
+    }
+}
+
+HAAR_TARGET_AVX2 static void haarColumnsAVX2(Unit* const a, Unit* const t)
+{
+    Unit C = 1;
+
+    for (int h = NumberOfPixels ; h > 1 ; h >>= 1)
+    {
+        int h1     = h >> 1;
+        C         *= s_invSqrt2;
+        __m256d vc = _mm256_set1_pd(C);
+
+        for (int k = 0 ; k < h1 ; ++k)
+        {
+            const Unit* const r0  = a + 2 * k * NumberOfPixels;
+            const Unit* const r1  = r0 + NumberOfPixels;
+            Unit* const       dst = a + k * NumberOfPixels;
+            Unit* const       tk  = t + k * NumberOfPixels;
+
+            for (int col = 0 ; col < NumberOfPixels ; col += 4)
+            {
+                __m256d v0 = _mm256_loadu_pd(r0 + col);
+                __m256d v1 = _mm256_loadu_pd(r1 + col);
+
+                _mm256_storeu_pd(tk + col,  _mm256_mul_pd(_mm256_sub_pd(v0, v1), vc));
+                _mm256_storeu_pd(dst + col, _mm256_add_pd(v0, v1));
+            }
+        }
+
+        memcpy(a + h1 * NumberOfPixels, t, h1 * NumberOfPixels * sizeof(Unit));
+    }
+
+    for (int col = 0 ; col < NumberOfPixels ; ++col)
+    {
+        a[col] *= C;
+    }
+}
+
+HAAR_TARGET_AVX2 static int nextAboveAVX2(const Unit* const data, int start, int end, Unit threshold)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d thr  = _mm256_set1_pd(threshold);
+    int i              = start;
+
+    for ( ; i + 4 <= end ; i += 4)
+    {
+        __m256d v = _mm256_andnot_pd(sign, _mm256_loadu_pd(data + i));
+
+        if (_mm256_movemask_pd(_mm256_cmp_pd(v, thr, _CMP_GT_OQ)))
+        {
+            break;
+        }
+    }
+
+    return nextAboveScalar(data, i, end, threshold);
+}
+
+HAAR_TARGET_AVX2 static void averageScoresAVX2(const double* const y, const double* const i, const double* const q,
+                                               const double* const weights, const double* const query,
+                                               double* const inOut, int count)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d w0   = _mm256_set1_pd(weights[0]), w1 = _mm256_set1_pd(weights[1]), w2 = _mm256_set1_pd(weights[2]);
+    const __m256d q0   = _mm256_set1_pd(query[0]),   q1 = _mm256_set1_pd(query[1]),   q2 = _mm256_set1_pd(query[2]);
+    int row            = 0;
+
+    for ( ; row + 4 <= count ; row += 4)
+    {
+        __m256d d0 = _mm256_andnot_pd(sign, _mm256_sub_pd(q0, _mm256_loadu_pd(y + row)));
+        __m256d d1 = _mm256_andnot_pd(sign, _mm256_sub_pd(q1, _mm256_loadu_pd(i + row)));
+        __m256d d2 = _mm256_andnot_pd(sign, _mm256_sub_pd(q2, _mm256_loadu_pd(q + row)));
+        __m256d s  = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(w0, d0), _mm256_mul_pd(w1, d1)), _mm256_mul_pd(w2, d2));
+
+        _mm256_storeu_pd(inOut + row, _mm256_sub_pd(s, _mm256_loadu_pd(inOut + row)));
+    }
+
+    averageScoresScalar(y, i, q, weights, query, inOut, row, count);
+}
+
+#endif // HAAR_KERNELS_X86
+
+// --- Dispatch ---------------------------------------------------------------------
+
+class Q_DECL_HIDDEN KernelsState
+{
+public:
+
+    KernelsState()
+        : best(Scalar)
+    {
+#ifdef HAAR_KERNELS_X86
+
+        __builtin_cpu_init();
+
+        if      (__builtin_cpu_supports("avx2"))
+        {
+            best = AVX2;
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            best = SSE2;
+        }
+
+#endif
+
+        current = best;
+    }
+
+    InstructionSet best;
+    InstructionSet current;
+};
+
+static KernelsState& state()
+{
+    static KernelsState s;
+
+    return s;
+}
+
+InstructionSet bestInstructionSet()
+{
+    return state().best;
+}
+
+InstructionSet instructionSet()
+{
+    return state().current;
+}
+
+void setInstructionSet(InstructionSet set)
+{
+    state().current = qMin(set, state().best);
+}
+
+const char* instructionSetName(InstructionSet set)
+{
+    switch (set)
+    {
+        case AVX2:
+            return "AVX2";
+
+        case SSE2:
+            return "SSE2";
+
+        default:
+            return "Scalar";
+    }
+}
+
+void rgbToYiq(Unit* const a, Unit* const b, Unit* const c, int count)
+{
+    switch (instructionSet())
+    {
+#ifdef HAAR_KERNELS_X86
+        case AVX2:
+            rgbToYiqAVX2(a, b, c, count);
+            break;
+
+        case SSE2:
+            rgbToYiqSSE2(a, b, c, count);
+            break;
+#endif
+        default:
+            rgbToYiqScalar(a, b, c, count);
+            break;
+    }
+}
+
+void haarRows(Unit* const a)
+{
+    switch (instructionSet())
+    {
+#ifdef HAAR_KERNELS_X86
+        case AVX2:
+            haarRowsAVX2(a);
+            break;
+
+        case SSE2:
+            haarRowsSSE2(a);
+            break;
+#endif
+        default:
+            haarRowsScalar(a);
+            break;
+    }
+}
+
+void haarColumns(Unit* const a)
+{
+    // Difference rows of one decomposition level, at most half of the array.
+    std::vector<Unit> t((NumberOfPixels >> 1) * NumberOfPixels);
+
+    switch (instructionSet())
+    {
+#ifdef HAAR_KERNELS_X86
+        case AVX2:
+            haarColumnsAVX2(a, t.data());
+            break;
+
+        case SSE2:
+            haarColumnsSSE2(a, t.data());
+            break;
+#endif
+        default:
+            haarColumnsScalar(a, t.data());
+            break;
+    }
+}
+
+int nextAbove(const Unit* const data, int start, int end, Unit threshold)
+{
+    switch (instructionSet())
+    {
+#ifdef HAAR_KERNELS_X86
+        case AVX2:
+            return nextAboveAVX2(data, start, end, threshold);
+
+        case SSE2:
+            return nextAboveSSE2(data, start, end, threshold);
+#endif
+        default:
+            return nextAboveScalar(data, start, end, threshold);
+    }
+}
+
+void averageScores(const double* const y, const double* const i, const double* const q,
+                   const double* const weights, const double* const query,
+                   double* const inOut, int count)
+{
+    switch (instructionSet())
+    {
+#ifdef HAAR_KERNELS_X86
+        case AVX2:
+            averageScoresAVX2(y, i, q, weights, query, inOut, count);
+            break;
+
+        case SSE2:
+            averageScoresSSE2(y, i, q, weights, query, inOut, count);
+            break;
+#endif
+        default:
+            averageScoresScalar(y, i, q, weights, query, inOut, 0, count);
+            break;
+    }
+}
+
+} // namespace Kernels
+
+} // namespace Haar
+
+} // namespace Digikam
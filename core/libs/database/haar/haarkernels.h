@@ -0,0 +1,99 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-22
+ * Description : Vectorized kernels for the Haar 2d transform
+ *               and signature scoring
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_KERNELS_H
+#define DIGIKAM_HAAR_KERNELS_H
+
+// Local includes
+
+#include "haar.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+/** The inner loops of Haar::Calculator and of the signature scoring.
+ *  Each kernel exists as portable C++ code and, on x86 with GCC or Clang,
+ *  as SSE2 and AVX2 versions selected at runtime from the CPU features.
+ *  All versions use the same arithmetic operations in the same order,
+ *  so they compute the same signatures.
+ */
+namespace Kernels
+{
+
+enum InstructionSet
+{
+    Scalar = 0,
+    SSE2,
+    AVX2
+};
+
+/** The best instruction set supported by the CPU and this build.
+ */
+DIGIKAM_DATABASE_EXPORT InstructionSet bestInstructionSet();
+
+/** The instruction set used by the kernels. Defaults to bestInstructionSet().
+ */
+DIGIKAM_DATABASE_EXPORT InstructionSet instructionSet();
+
+/** Force the instruction set used by the kernels, for testing and benchmarking.
+ *  The value is clamped to bestInstructionSet(). Not thread-safe.
+ */
+DIGIKAM_DATABASE_EXPORT void setInstructionSet(InstructionSet set);
+
+DIGIKAM_DATABASE_EXPORT const char* instructionSetName(InstructionSet set);
+
+/** RGB -> YIQ colorspace conversion of count pixels, in place.
+ */
+void rgbToYiq(Unit* const a, Unit* const b, Unit* const c, int count);
+
+/** Haar decomposition of all rows of a NumberOfPixels x NumberOfPixels array.
+ */
+void haarRows(Unit* const a);
+
+/** Haar decomposition of all columns of a NumberOfPixels x NumberOfPixels array.
+ *  The columns are processed side by side, one row of the array at a time.
+ */
+void haarColumns(Unit* const a);
+
+/** Returns the first index i in [start, end[ with fabs(data[i]) > threshold, or end.
+ */
+int  nextAbove(const Unit* const data, int start, int end, Unit threshold);
+
+/** For count entries: inOut[i] = w[0]*|q[0]-y[i]| + w[1]*|q[1]-i[i]| + w[2]*|q[2]-q[i]| - inOut[i]
+ */
+void averageScores(const double* const y, const double* const i, const double* const q,
+                   const double* const weights, const double* const query,
+                   double* const inOut, int count);
+
+} // namespace Kernels
+
+} // namespace Haar
+
+} // namespace Digikam
+
+#endif // DIGIKAM_HAAR_KERNELS_H
@@ -0,0 +1,554 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-20
+ * Description : Memory resident index of Haar signatures
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarsignatureindex.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "haarkernels.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN HaarSignatureIndex::Private
+{
+public:
+
+    enum
+    {
+        /// Number of posting lists per channel: one per signed coefficient.
+        PostingListsPerChannel = 2 * Haar::NumberOfPixelsSquared
+    };
+
+public:
+
+    /** A change of the index done while the signatures are read by load(),
+     *  applied again to the signatures read.
+     */
+    class Q_DECL_HIDDEN Change
+    {
+    public:
+
+        enum Type
+        {
+            Insert = 0,
+            Remove,
+            Copy
+        };
+
+    public:
+
+        Type                type;
+        qlonglong           imageId;
+        qlonglong           srcId;
+        Haar::SignatureData sig;
+    };
+
+public:
+
+    explicit Private()
+      : loaded(false),
+        deadRows(0),
+        loaders(0),
+        generation(0)
+    {
+    }
+
+    /// Exchange the signatures with the ones of other. The caller must hold the write lock.
+    void swapContent(Private& other)
+    {
+        ids.swap(other.ids);
+        alive.swap(other.alive);
+        rowForId.swap(other.rowForId);
+        qSwap(deadRows, other.deadRows);
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            avg[channel].swap(other.avg[channel]);
+            sig[channel].swap(other.sig[channel]);
+
+            for (int i = 0 ; i < PostingListsPerChannel ; ++i)
+            {
+                postings[channel][i].swap(other.postings[channel][i]);
+            }
+        }
+    }
+
+    /// Apply a change. The caller must hold the write lock.
+    void apply(const Change& change)
+    {
+        switch (change.type)
+        {
+            case Change::Insert:
+            {
+                kill(change.imageId);
+                append(change.imageId, change.sig);
+                break;
+            }
+
+            case Change::Remove:
+            {
+                kill(change.imageId);
+                break;
+            }
+
+            case Change::Copy:
+            {
+                const int row = rowForId.value(change.srcId, -1);
+
+                if ((row == -1) || (change.srcId == change.imageId))
+                {
+                    return;
+                }
+
+                Haar::SignatureData data;
+                fillSignature(row, &data);
+                kill(change.imageId);
+                append(change.imageId, data);
+                break;
+            }
+        }
+
+        compactIfNeeded();
+    }
+
+    /// Apply a change to the loaded index, or keep it for the signatures being read.
+    /// The caller must hold the write lock.
+    void change(const Change& change)
+    {
+        if (loaders > 0)
+        {
+            changes << change;
+        }
+
+        if (loaded)
+        {
+            apply(change);
+        }
+    }
+
+    void clear()
+    {
+        ids.clear();
+        alive.clear();
+        rowForId.clear();
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            avg[channel].clear();
+            sig[channel].clear();
+
+            for (int i = 0 ; i < PostingListsPerChannel ; ++i)
+            {
+                postings[channel][i].clear();
+            }
+        }
+
+        deadRows = 0;
+    }
+
+    static bool isValidCoefficient(Haar::Idx coef)
+    {
+        return ((coef > -Haar::NumberOfPixelsSquared) && (coef < Haar::NumberOfPixelsSquared));
+    }
+
+    void addPostings(int row)
+    {
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            const Haar::Idx* const coefs = sig[channel].constData() + row * Haar::NumberOfCoefficients;
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+            {
+                if (isValidCoefficient(coefs[coef]))
+                {
+                    postings[channel][coefs[coef] + Haar::NumberOfPixelsSquared] << row;
+                }
+            }
+        }
+    }
+
+    /// Append a new row. The caller must hold the write lock.
+    void append(qlonglong imageId, const Haar::SignatureData& data)
+    {
+        const int row = ids.size();
+
+        ids   << imageId;
+        alive << true;
+        rowForId.insert(imageId, row);
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            avg[channel] << data.avg[channel];
+
+            for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+            {
+                sig[channel] << data.sig[channel][coef];
+            }
+        }
+
+        addPostings(row);
+    }
+
+    /// Mark the row of an image as removed. The caller must hold the write lock.
+    void kill(qlonglong imageId)
+    {
+        QHash<qlonglong, int>::iterator it = rowForId.find(imageId);
+
+        if (it == rowForId.end())
+        {
+            return;
+        }
+
+        alive[it.value()] = false;
+        rowForId.erase(it);
+        ++deadRows;
+    }
+
+    void fillSignature(int row, Haar::SignatureData* const data) const
+    {
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            data->avg[channel] = avg[channel].at(row);
+
+            memcpy(data->sig[channel],
+                   sig[channel].constData() + row * Haar::NumberOfCoefficients,
+                   Haar::NumberOfCoefficients * sizeof(Haar::Idx));
+        }
+    }
+
+    /** Removed rows stay in the posting lists until they make up
+     *  a quarter of the index. Then all arrays are rebuilt without them.
+     *  The caller must hold the write lock.
+     */
+    void compactIfNeeded()
+    {
+        if ((deadRows < 1024) || (deadRows < ids.size() / 4))
+        {
+            return;
+        }
+
+        QVector<qlonglong> oldIds = ids;
+        QVector<bool>      oldAlive = alive;
+        QVector<double>    oldAvg[3];
+        QVector<Haar::Idx> oldSig[3];
+
+        for (int channel = 0 ; channel < 3 ; ++channel)
+        {
+            oldAvg[channel] = avg[channel];
+            oldSig[channel] = sig[channel];
+        }
+
+        clear();
+
+        Haar::SignatureData data;
+
+        for (int row = 0 ; row < oldIds.size() ; ++row)
+        {
+            if (!oldAlive.at(row))
+            {
+                continue;
+            }
+
+            for (int channel = 0 ; channel < 3 ; ++channel)
+            {
+                data.avg[channel] = oldAvg[channel].at(row);
+
+                memcpy(data.sig[channel],
+                       oldSig[channel].constData() + row * Haar::NumberOfCoefficients,
+                       Haar::NumberOfCoefficients * sizeof(Haar::Idx));
+            }
+
+            append(oldIds.at(row), data);
+        }
+    }
+
+public:
+
+    mutable QReadWriteLock lock;
+
+    bool                   loaded;
+    int                    deadRows;
+
+    /// The threads reading the signatures in load(), and the changes done meanwhile.
+    int                    loaders;
+    QList<Change>          changes;
+
+    /// Incremented by invalidate(), to drop the signatures read from the previous database.
+    int                    generation;
+
+    /// Struct of arrays: one entry (or NumberOfCoefficients entries for sig) per row.
+    QVector<qlonglong>     ids;
+    QVector<bool>          alive;
+    QVector<double>        avg[3];
+    QVector<Haar::Idx>     sig[3];
+
+    QHash<qlonglong, int>  rowForId;
+
+    /// Inverted lists: signed coefficient -> rows carrying it, per channel.
+    QVector<int>           postings[3][PostingListsPerChannel];
+
+    Haar::WeightBin        bin;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN HaarSignatureIndexCreator
+{
+public:
+
+    HaarSignatureIndex object;
+};
+
+Q_GLOBAL_STATIC(HaarSignatureIndexCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+HaarSignatureIndex* HaarSignatureIndex::instance()
+{
+    return &creator->object;
+}
+
+HaarSignatureIndex::HaarSignatureIndex()
+    : d(new Private)
+{
+}
+
+HaarSignatureIndex::~HaarSignatureIndex()
+{
+    delete d;
+}
+
+bool HaarSignatureIndex::isLoaded() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->loaded;
+}
+
+void HaarSignatureIndex::load(Loader* const loader)
+{
+    // The loader locks the similarity database, which is already held by the threads calling
+    // remove() or copy() through SimilarityDb: the signatures are read without the index lock,
+    // in an index private to this thread, and the changes done meanwhile are applied to them.
+
+    int firstChange = 0;
+    int generation  = 0;
+
+    {
+        QWriteLocker locker(&d->lock);
+
+        if (d->loaded)
+        {
+            return;
+        }
+
+        firstChange = d->changes.count();
+        generation  = d->generation;
+        ++d->loaders;
+    }
+
+    HaarSignatureIndex staging;
+    loader->load(&staging);
+
+    QWriteLocker locker(&d->lock);
+
+    if (!d->loaded && (d->generation == generation))
+    {
+        for (int i = firstChange ; i < d->changes.count() ; ++i)
+        {
+            staging.d->apply(d->changes.at(i));
+        }
+
+        d->swapContent(*staging.d);
+        d->loaded = true;
+
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Haar signature index loaded with" << d->rowForId.count() << "entries";
+    }
+
+    if (--d->loaders == 0)
+    {
+        d->changes.clear();
+    }
+}
+
+void HaarSignatureIndex::invalidate()
+{
+    QWriteLocker locker(&d->lock);
+
+    d->clear();
+    d->loaded = false;
+    ++d->generation;
+}
+
+void HaarSignatureIndex::addSignature(qlonglong imageId, const Haar::SignatureData& sig)
+{
+    // Called from Loader::load() on the index private to the loading thread.
+
+    d->kill(imageId);
+    d->append(imageId, sig);
+}
+
+void HaarSignatureIndex::insert(qlonglong imageId, const Haar::SignatureData& sig)
+{
+    Private::Change change;
+    change.type    = Private::Change::Insert;
+    change.imageId = imageId;
+    change.srcId   = -1;
+    change.sig     = sig;
+
+    QWriteLocker locker(&d->lock);
+    d->change(change);
+}
+
+void HaarSignatureIndex::remove(qlonglong imageId)
+{
+    Private::Change change;
+    change.type    = Private::Change::Remove;
+    change.imageId = imageId;
+    change.srcId   = -1;
+
+    QWriteLocker locker(&d->lock);
+    d->change(change);
+}
+
+void HaarSignatureIndex::copy(qlonglong srcId, qlonglong dstId)
+{
+    Private::Change change;
+    change.type    = Private::Change::Copy;
+    change.imageId = dstId;
+    change.srcId   = srcId;
+
+    QWriteLocker locker(&d->lock);
+    d->change(change);
+}
+
+bool HaarSignatureIndex::signature(qlonglong imageId, Haar::SignatureData* const sig) const
+{
+    QReadLocker locker(&d->lock);
+
+    int row = d->rowForId.value(imageId, -1);
+
+    if (row == -1)
+    {
+        return false;
+    }
+
+    d->fillSignature(row, sig);
+
+    return true;
+}
+
+int HaarSignatureIndex::count() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->rowForId.count();
+}
+
+HaarSignatureIndex::ScoreList HaarSignatureIndex::scores(const Haar::SignatureData& querySig,
+                                                         Haar::Weights::SketchType type,
+                                                         const HaarSignatureIndexFilter* const filter,
+                                                         double maximumScore) const
+{
+    QReadLocker locker(&d->lock);
+
+    ScoreList        results;
+    Haar::Weights    weights(type);
+    const int        rows = d->ids.size();
+
+    // Step 1: for every significant coefficient of the query, walk the rows sharing it
+    // and accumulate the weight to subtract from their score (lower is better).
+
+    QVector<double>  bonus(rows, 0.0);
+    double* const    bonusData = bonus.data();
+
+    for (int channel = 0 ; channel < 3 ; ++channel)
+    {
+        for (int coef = 0 ; coef < Haar::NumberOfCoefficients ; ++coef)
+        {
+            const Haar::Idx x = querySig.sig[channel][coef];
+
+            if (!Private::isValidCoefficient(x))
+            {
+                continue;
+            }
+
+            const QVector<int>& posting = d->postings[channel][x + Haar::NumberOfPixelsSquared];
+            const int* const    list    = posting.constData();
+            const int           size    = posting.size();
+            const double        weight  = weights.weight(d->bin.binAbs(x), channel);
+
+            for (int i = 0 ; i < size ; ++i)
+            {
+                bonusData[list[i]] += weight;
+            }
+        }
+    }
+
+    // Step 2: one vectorized pass over the contiguous averages to complete the scores.
+
+    const double weightsForAverage[3] = { weights.weightForAverage(0),
+                                          weights.weightForAverage(1),
+                                          weights.weightForAverage(2) };
+
+    Haar::Kernels::averageScores(d->avg[0].constData(), d->avg[1].constData(), d->avg[2].constData(),
+                                 weightsForAverage, querySig.avg, bonusData, rows);
+
+    // Step 3: apply the restrictions to the scores in the requested range.
+
+    const bool*      alive = d->alive.constData();
+    const qlonglong* ids   = d->ids.constData();
+
+    for (int row = 0 ; row < rows ; ++row)
+    {
+        if (!alive[row] || (bonusData[row] > maximumScore))
+        {
+            continue;
+        }
+
+        if (filter && !filter->accept(ids[row]))
+        {
+            continue;
+        }
+
+        results << Score(ids[row], bonusData[row]);
+    }
+
+    return results;
+}
+
+} // namespace Digikam
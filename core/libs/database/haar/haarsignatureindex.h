@@ -0,0 +1,150 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-20
+ * Description : Memory resident index of Haar signatures
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_SIGNATURE_INDEX_H
+#define DIGIKAM_HAAR_SIGNATURE_INDEX_H
+
+// Qt includes
+
+#include <QPair>
+#include <QVector>
+
+// Local includes
+
+#include "haar.h"
+
+namespace Digikam
+{
+
+/** Decides which indexed images take part in a search.
+ */
+class HaarSignatureIndexFilter
+{
+public:
+
+    virtual ~HaarSignatureIndexFilter() = default;
+
+    virtual bool accept(qlonglong imageId) const = 0;
+};
+
+// --------------------------------------------------------------------------
+
+/** A process-wide, memory-resident copy of all Haar signatures of the similarity database.
+ *
+ *  The signatures are stored as contiguous arrays (struct of arrays): one array per channel
+ *  for the averages and one array per channel holding the coefficients of all images.
+ *  Each signed coefficient owns a posting list of the entries carrying it, so a query
+ *  only touches the images which share at least one significant coefficient with it.
+ *
+ *  The index is filled once from the database by HaarIface, then kept up to date
+ *  when images are (re)indexed or when fingerprints are copied or removed.
+ *  All methods are thread-safe.
+ */
+class HaarSignatureIndex
+{
+public:
+
+    typedef QPair<qlonglong, double> Score;
+    typedef QVector<Score>           ScoreList;
+
+    /** Delivers the signatures when the index is filled.
+     *  load() is called without any lock, with an index private to the loading thread,
+     *  and must call HaarSignatureIndex::addSignature() for each entry.
+     */
+    class Loader
+    {
+    public:
+
+        virtual ~Loader() = default;
+
+        virtual void load(HaarSignatureIndex* const index) = 0;
+    };
+
+public:
+
+    static HaarSignatureIndex* instance();
+
+    /** Returns true if the index was filled from the database.
+     */
+    bool isLoaded() const;
+
+    /** Replaces the whole content of the index by the signatures delivered
+     *  by the loader and marks the index as loaded. Does nothing if the index
+     *  is already loaded. The index is not locked while the loader runs, so the loader
+     *  can lock the database: the changes done meanwhile are applied after it.
+     */
+    void load(Loader* const loader);
+
+    /** Drop all entries. The index will be filled again on next use.
+     */
+    void invalidate();
+
+    /** To be used from Loader::load() only.
+     */
+    void addSignature(qlonglong imageId, const Haar::SignatureData& sig);
+
+    /** Add or replace the signature of an image. Ignored if the index is not loaded.
+     */
+    void insert(qlonglong imageId, const Haar::SignatureData& sig);
+
+    /** Remove the signature of an image. Ignored if the index is not loaded.
+     */
+    void remove(qlonglong imageId);
+
+    /** Duplicate the signature of srcId for dstId. Ignored if the index is not loaded.
+     */
+    void copy(qlonglong srcId, qlonglong dstId);
+
+    /** Retrieve the signature of an image. Returns false if the image is not indexed.
+     */
+    bool signature(qlonglong imageId, Haar::SignatureData* const sig) const;
+
+    int  count() const;
+
+    /** Score all indexed images accepted by the filter against the query signature.
+     *  Lowest score is best. Only entries with a score less than or equal to maximumScore
+     *  are returned. The scores match HaarIface::calculateScore() up to rounding.
+     */
+    ScoreList scores(const Haar::SignatureData& querySig,
+                     Haar::Weights::SketchType type,
+                     const HaarSignatureIndexFilter* const filter,
+                     double maximumScore) const;
+
+private:
+
+    explicit HaarSignatureIndex();
+    ~HaarSignatureIndex();
+
+    HaarSignatureIndex(const HaarSignatureIndex&); // Disable
+
+private:
+
+    friend class HaarSignatureIndexCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_HAAR_SIGNATURE_INDEX_H
@@ -195,8 +195,10 @@ ItemInfoData::ItemInfoData()
     colorLabel             = NoColorLabel;
     rating                 = -1;
     category               = DatabaseItem::UndefinedCategory;
+    status                 = DatabaseItem::UndefinedStatus;
     fileSize               = 0;
     manualOrder            = 0;
+    orientation            = 0; // ORIENTATION_UNSPECIFIED
 
     longitude              = 0;
     latitude               = 0;
@@ -214,12 +216,14 @@ ItemInfoData::ItemInfoData()
     colorLabelCached       = false;
     ratingCached           = false;
     categoryCached         = false;
+    statusCached           = false;
     formatCached           = false;
     creationDateCached     = false;
     modificationDateCached = false;
     fileSizeCached         = false;
     manualOrderCached      = false;
     imageSizeCached        = false;
+    orientationCached      = false;
     tagIdsCached           = false;
     positionsCached        = false;
     groupImageCached       = false;
@@ -800,6 +804,254 @@ void ItemInfoList::loadTagIds() const
     }
 }
 
+void ItemInfoList::loadFields(const DatabaseFields::Set& fields) const
+{
+    // Restrict to the fields cached in ItemInfoData
+
+    DatabaseFields::Images imagesFields        = fields.getImages() & (DatabaseFields::Status           |
+                                                                       DatabaseFields::Category         |
+                                                                       DatabaseFields::ModificationDate |
+                                                                       DatabaseFields::FileSize         |
+                                                                       DatabaseFields::UniqueHash       |
+                                                                       DatabaseFields::ManualOrder);
+
+    DatabaseFields::ItemInformation infoFields = fields.getItemInformation() & (DatabaseFields::Rating       |
+                                                                                DatabaseFields::CreationDate |
+                                                                                DatabaseFields::Orientation  |
+                                                                                DatabaseFields::Width        |
+                                                                                DatabaseFields::Height       |
+                                                                                DatabaseFields::Format);
+
+    // The image size is cached as a whole
+
+    if (infoFields & (DatabaseFields::Width | DatabaseFields::Height))
+    {
+        infoFields |= DatabaseFields::Width | DatabaseFields::Height;
+    }
+
+    QHash<qlonglong, ItemInfo> imagesInfos;
+    QHash<qlonglong, ItemInfo> infoInfos;
+
+    {
+        ItemInfoReadLocker lock;
+
+        foreach (const ItemInfo& info, *this)
+        {
+            const ItemInfoData* const data = info.m_data.constData();
+
+            if (!data)
+            {
+                continue;
+            }
+
+            if (((imagesFields & DatabaseFields::Status)           && !data->statusCached)           ||
+                ((imagesFields & DatabaseFields::Category)         && !data->categoryCached)         ||
+                ((imagesFields & DatabaseFields::ModificationDate) && !data->modificationDateCached) ||
+                ((imagesFields & DatabaseFields::FileSize)         && !data->fileSizeCached)         ||
+                ((imagesFields & DatabaseFields::UniqueHash)       && !data->uniqueHashCached)       ||
+                ((imagesFields & DatabaseFields::ManualOrder)      && !data->manualOrderCached))
+            {
+                imagesInfos.insert(data->id, info);
+            }
+
+            if (((infoFields & DatabaseFields::Rating)       && !data->ratingCached)       ||
+                ((infoFields & DatabaseFields::CreationDate) && !data->creationDateCached) ||
+                ((infoFields & DatabaseFields::Orientation)  && !data->orientationCached)  ||
+                ((infoFields & DatabaseFields::Width)        && !data->imageSizeCached)    ||
+                ((infoFields & DatabaseFields::Format)       && !data->formatCached))
+            {
+                infoInfos.insert(data->id, info);
+            }
+        }
+    }
+
+    if (imagesInfos.isEmpty() && infoInfos.isEmpty())
+    {
+        return;
+    }
+
+    QHash<qlonglong, QVariantList> imagesValues;
+    QHash<qlonglong, QVariantList> infoValues;
+
+    {
+        CoreDbAccess access;
+
+        if (!imagesInfos.isEmpty())
+        {
+            imagesValues = access.db()->getImagesFields(imagesInfos.keys(), imagesFields);
+        }
+
+        if (!infoInfos.isEmpty())
+        {
+            infoValues = access.db()->getItemInformation(infoInfos.keys(), infoFields);
+        }
+    }
+
+    ItemInfoWriteLocker lock;
+
+    for (QHash<qlonglong, ItemInfo>::const_iterator it = imagesInfos.constBegin() ; it != imagesInfos.constEnd() ; ++it)
+    {
+        ItemInfoData* const data = it.value().m_data.constCastData();
+        const QVariantList values = imagesValues.value(it.key());
+        int fieldsIndex           = 0;
+
+        // As for the single-item accessors, an item without values is cached with default values
+
+        for (DatabaseFields::ImagesIteratorSetOnly field(imagesFields) ; !field.atEnd() ; ++field)
+        {
+            const bool     hasValue = (fieldsIndex < values.size());
+            const QVariant value    = hasValue ? values.at(fieldsIndex) : QVariant();
+            ++fieldsIndex;
+
+            switch (*field)
+            {
+                case DatabaseFields::Status:
+                    data->statusCached = true;
+
+                    if (hasValue)
+                    {
+                        data->status = (DatabaseItem::Status)value.toInt();
+                    }
+
+                    break;
+
+                case DatabaseFields::Category:
+                    data->categoryCached = true;
+
+                    if (hasValue)
+                    {
+                        data->category = (DatabaseItem::Category)value.toInt();
+                    }
+
+                    break;
+
+                case DatabaseFields::ModificationDate:
+                    data->modificationDateCached = true;
+
+                    if (hasValue)
+                    {
+                        data->modificationDate = value.toDateTime();
+                    }
+
+                    break;
+
+                case DatabaseFields::FileSize:
+                    data->fileSizeCached = true;
+
+                    if (hasValue)
+                    {
+                        data->fileSize = value.toLongLong();
+                    }
+
+                    break;
+
+                case DatabaseFields::UniqueHash:
+                    data->uniqueHashCached = true;
+
+                    if (hasValue)
+                    {
+                        data->uniqueHash = value.toString();
+                    }
+
+                    break;
+
+                case DatabaseFields::ManualOrder:
+                    data->manualOrderCached = true;
+
+                    if (hasValue)
+                    {
+                        data->manualOrder = value.toLongLong();
+                    }
+
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    for (QHash<qlonglong, ItemInfo>::const_iterator it = infoInfos.constBegin() ; it != infoInfos.constEnd() ; ++it)
+    {
+        ItemInfoData* const data = it.value().m_data.constCastData();
+        const QVariantList values = infoValues.value(it.key());
+        int fieldsIndex           = 0;
+        int width                 = 0;
+        int height                = 0;
+
+        for (DatabaseFields::ItemInformationIteratorSetOnly field(infoFields) ; !field.atEnd() ; ++field)
+        {
+            const bool     hasValue = (fieldsIndex < values.size());
+            const QVariant value    = hasValue ? values.at(fieldsIndex) : QVariant();
+            ++fieldsIndex;
+
+            switch (*field)
+            {
+                case DatabaseFields::Rating:
+                    data->ratingCached = true;
+
+                    if (hasValue)
+                    {
+                        data->rating = value.toLongLong();
+                    }
+
+                    break;
+
+                case DatabaseFields::CreationDate:
+                    data->creationDateCached = true;
+
+                    if (hasValue)
+                    {
+                        data->creationDate = value.toDateTime();
+                    }
+
+                    break;
+
+                case DatabaseFields::Orientation:
+                    data->orientationCached = true;
+
+                    if (hasValue)
+                    {
+                        data->orientation = value.toInt();
+                    }
+
+                    break;
+
+                case DatabaseFields::Width:
+                    width = value.toInt();
+                    break;
+
+                case DatabaseFields::Height:
+                    height = value.toInt();
+                    break;
+
+                case DatabaseFields::Format:
+                    data->formatCached = true;
+
+                    if (hasValue)
+                    {
+                        data->format = value.toString();
+                    }
+
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (infoFields & DatabaseFields::Width)
+        {
+            data->imageSizeCached = true;
+
+            if (!values.isEmpty())
+            {
+                data->imageSize = QSize(width, height);
+            }
+        }
+    }
+}
+
 int ItemInfo::orientation() const
 {
     if (!m_data)
@@ -807,14 +1059,11 @@ int ItemInfo::orientation() const
         return 0; // ORIENTATION_UNSPECIFIED
     }
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Orientation);
+    RETURN_IF_CACHED(orientation)
 
-    if (values.isEmpty())
-    {
-        return 0;
-    }
+    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Orientation);
 
-    return values.first().toInt();
+    STORE_IN_CACHE_AND_RETURN(orientation, values.first().toInt())
 }
 
 QUrl ItemInfo::fileUrl() const
@@ -849,6 +1098,15 @@ QString ItemInfo::filePath() const
     }
 }
 
+DatabaseItem::Status ItemInfo::status() const
+{
+    RETURN_IF_CACHED(status)
+
+    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
+
+    STORE_IN_CACHE_AND_RETURN(status, (DatabaseItem::Status)values.first().toInt())
+}
+
 bool ItemInfo::isVisible() const
 {
     if (!m_data)
@@ -856,14 +1114,7 @@ bool ItemInfo::isVisible() const
         return false;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
-
-    if (!value.isEmpty())
-    {
-        return value.first().toInt() == DatabaseItem::Visible;
-    }
-
-    return false;
+    return (status() == DatabaseItem::Visible);
 }
 
 bool ItemInfo::isRemoved() const
@@ -873,14 +1124,9 @@ bool ItemInfo::isRemoved() const
         return true;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
-
-    if (!value.isEmpty())
-    {
-        return (value.first().toInt() == DatabaseItem::Trashed) || (value.first().toInt() == DatabaseItem::Obsolete);
-    }
+    DatabaseItem::Status itemStatus = status();
 
-    return false;
+    return ((itemStatus == DatabaseItem::Trashed) || (itemStatus == DatabaseItem::Obsolete));
 }
 
 void ItemInfo::setVisible(bool isVisible)
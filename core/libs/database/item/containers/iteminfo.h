@@ -523,6 +523,13 @@ public:
      */
     qlonglong currentReferenceImage() const;
 
+private:
+
+    /**
+     * Returns the cached status of the item in the database.
+     */
+    DatabaseItem::Status status() const;
+
 private:
 
     friend class ItemInfoCache;
@@ -58,6 +58,10 @@ ItemInfoCache::ItemInfoCache()
     connect(dbwatch, SIGNAL(albumChange(AlbumChangeset)),
             this, SLOT(slotAlbumChange(AlbumChangeset)),
             Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(collectionImageChange(CollectionImageChangeset)),
+            this, SLOT(slotCollectionImageChanged(CollectionImageChangeset)),
+            Qt::DirectConnection);
 }
 
 ItemInfoCache::~ItemInfoCache()
@@ -297,6 +301,16 @@ void ItemInfoCache::slotImageChanged(const ImageChangeset& changeset)
                 (*it)->categoryCached = false;
             }
 
+            if (changes & DatabaseFields::Status)
+            {
+                (*it)->statusCached = false;
+            }
+
+            if (changes & DatabaseFields::Orientation)
+            {
+                (*it)->orientationCached = false;
+            }
+
             if (changes & DatabaseFields::Format)
             {
                 (*it)->formatCached = false;
@@ -402,6 +416,33 @@ void ItemInfoCache::slotImageTagChanged(const ImageTagChangeset& changeset)
     }
 }
 
+void ItemInfoCache::slotCollectionImageChanged(const CollectionImageChangeset& changeset)
+{
+    // Removing items from an album changes their status without an image changeset
+
+    ItemInfoWriteLocker lock;
+
+    if ((changeset.operation() == CollectionImageChangeset::RemovedAll) || changeset.ids().isEmpty())
+    {
+        foreach (ItemInfoData* const data, m_infos)
+        {
+            data->statusCached = false;
+        }
+
+        return;
+    }
+
+    foreach (const qlonglong& imageId, changeset.ids())
+    {
+        QHash<qlonglong, ItemInfoData*>::iterator it = m_infos.find(imageId);
+
+        if (it != m_infos.end())
+        {
+            (*it)->statusCached = false;
+        }
+    }
+}
+
 void ItemInfoCache::slotAlbumChange(const AlbumChangeset& changeset)
 {
     switch (changeset.operation())
@@ -98,6 +98,7 @@ private Q_SLOTS:
 
     void slotImageChanged(const ImageChangeset& changeset);
     void slotImageTagChanged(const ImageTagChangeset& changeset);
+    void slotCollectionImageChanged(const CollectionImageChangeset& changeset);
     void slotAlbumChange(const AlbumChangeset&);
 
 private:
@@ -109,6 +109,7 @@ public:
     quint8                 colorLabel;
     qint8                  rating;
     DatabaseItem::Category category;
+    DatabaseItem::Status   status;
     QString                format;
     QDateTime              creationDate;
     QDateTime              modificationDate;
@@ -116,6 +117,7 @@ public:
     qlonglong              manualOrder;
     QString                uniqueHash;
     QSize                  imageSize;
+    int                    orientation;
     QList<int>             tagIds;
 
     double                 longitude;
@@ -135,6 +137,7 @@ public:
     bool                   colorLabelCached       : 1;
     bool                   ratingCached           : 1;
     bool                   categoryCached         : 1;
+    bool                   statusCached           : 1;
     bool                   formatCached           : 1;
     bool                   creationDateCached     : 1;
     bool                   modificationDateCached : 1;
@@ -142,6 +145,7 @@ public:
     bool                   manualOrderCached      : 1;
     bool                   uniqueHashCached       : 1;
     bool                   imageSizeCached        : 1;
+    bool                   orientationCached      : 1;
     bool                   tagIdsCached           : 1;
     bool                   positionsCached        : 1;
     bool                   groupImageCached       : 1;
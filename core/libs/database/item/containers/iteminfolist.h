@@ -32,6 +32,7 @@
 // Local includes
 
 #include "iteminfo.h"
+#include "coredbfields.h"
 #include "digikam_export.h"
 #include "digikam_config.h"
 
@@ -57,6 +58,16 @@ public:
     void loadGroupImageIds() const;
     void loadTagIds()        const;
 
+    /**
+     * Load the requested fields for all items of the list which do not have them cached yet,
+     * with a few queries for the whole list instead of one query per item and field.
+     * Call this before a loop accessing the fields of many items, as a model does when
+     * filtering or sorting. Only the fields cached by ItemInfo are loaded, that is:
+     * Status, Category, ModificationDate, FileSize, UniqueHash, ManualOrder,
+     * Rating, CreationDate, Orientation, Width, Height and Format.
+     */
+    void loadFields(const DatabaseFields::Set& fields) const;
+
     bool static namefileLessThan(const ItemInfo& d1, const ItemInfo& d2);
 
     /**
@@ -446,6 +446,9 @@ void ItemFilterModel::setItemFilterSettings(const ItemFilterSettings& settings)
         d->needPrepareGroups   = true;
         d->needPrepare         = d->needPrepareComments || d->needPrepareTags || d->needPrepareGroups;
 
+        d->prepareFields       = settings.watchFlags();
+        d->prepareFields.setFields(d->sorter.watchFlags());
+
         d->hasOneMatch         = false;
         d->hasOneMatchForText  = false;
     }
@@ -664,6 +667,7 @@ void ItemFilterModelPreparer::process(ItemFilterModelTodoPackage package)
 
     // get thread-local copy
     bool needPrepareTags, needPrepareComments, needPrepareGroups;
+    DatabaseFields::Set prepareFields;
     QList<ItemFilterModelPrepareHook*> prepareHooks;
 
     {
@@ -671,6 +675,7 @@ void ItemFilterModelPreparer::process(ItemFilterModelTodoPackage package)
         needPrepareTags     = d->needPrepareTags;
         needPrepareComments = d->needPrepareComments;
         needPrepareGroups   = d->needPrepareGroups;
+        prepareFields       = d->prepareFields;
         prepareHooks        = d->prepareHooks;
     }
 
@@ -692,12 +697,11 @@ void ItemFilterModelPreparer::process(ItemFilterModelTodoPackage package)
     // The downside of QVector: At some point, we may need a QList for an API.
     // Nonetheless, QList and ItemInfo is fast. We could as well
     // reimplement ItemInfoList to ItemInfoVector (internally with templates?)
-    ItemInfoList infoList;
+    ItemInfoList infoList(package.infos.toList());
 
-    if (needPrepareTags || needPrepareGroups)
-    {
-        infoList = ItemInfoList(package.infos.toList());
-    }
+    // Load the fields used by the filter and the sort order with a few queries for the whole package,
+    // instead of one query per item when filtering and sorting.
+    infoList.loadFields(prepareFields);
 
     if (needPrepareTags)
     {
@@ -806,6 +810,19 @@ void ItemFilterModel::setItemSortSettings(const ItemSortSettings& sorter)
 {
     Q_D(ItemFilterModel);
     d->sorter = sorter;
+
+    {
+        QMutexLocker lock(&d->mutex);
+        d->prepareFields = d->filter.watchFlags();
+        d->prepareFields.setFields(d->sorter.watchFlags());
+    }
+
+    // Sorting accesses the sort fields of all items: load them at once.
+    if (d->imageModel)
+    {
+        ItemInfoList(d->imageModel->imageInfos()).loadFields(d->sorter.watchFlags());
+    }
+
     setCategorizedModel(d->sorter.categorizationMode != ItemSortSettings::NoCategories);
     invalidate();
 }
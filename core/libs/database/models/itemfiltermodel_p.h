@@ -118,6 +118,9 @@ public:
     bool                                needPrepareTags;
     bool                                needPrepareGroups;
 
+    /// The fields used by the filter and the sort order, loaded for each package by the preparer.
+    DatabaseFields::Set                 prepareFields;
+
     QMutex                              mutex;
     ItemFilterSettings                 filterCopy;
     VersionItemFilterSettings          versionFilterCopy;
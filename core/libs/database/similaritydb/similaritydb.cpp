@@ -35,6 +35,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "haarsignatureindex.h"
 
 namespace Digikam
 {
@@ -317,6 +318,8 @@ void SimilarityDb::copySimilarityAttributes(qlonglong srcId, qlonglong dstId)
                                      "SELECT ?, modificationDate, uniqueHash, matrix "
                                      " FROM ImageHaarMatrix WHERE imageid=?;"),
                    dstId, srcId);
+
+    HaarSignatureIndex::instance()->copy(srcId, dstId);
 }
 
 
@@ -327,6 +330,8 @@ void SimilarityDb::removeImageFingerprint(qlonglong imageID,
     {
         d->db->execSql(QString::fromUtf8("DELETE FROM ImageHaarMatrix WHERE imageid=?;"),
                        imageID);
+
+        HaarSignatureIndex::instance()->remove(imageID);
     }
     else if (algorithm == FuzzyAlgorithm::TfIdf)
     {
@@ -43,6 +43,7 @@
 #include "similaritydbschemaupdater.h"
 #include "dbengineparameters.h"
 #include "dbengineaccess.h"
+#include "haarsignatureindex.h"
 
 namespace Digikam
 {
@@ -174,33 +175,39 @@ void SimilarityDbAccess::setParameters(const DbEngineParameters& parameters)
         d = new SimilarityDbAccessStaticPriv();
     }
 
-    SimilarityDbAccessMutexLocker lock(d);
-
-    if (d->parameters == parameters)
     {
-        return;
-    }
+        SimilarityDbAccessMutexLocker lock(d);
 
-    if (d->backend && d->backend->isOpen())
-    {
-        d->backend->close();
-    }
+        if (d->parameters == parameters)
+        {
+            return;
+        }
 
-    // Kill the old database error handler
-    if (d->backend)
-    {
-        d->backend->setDbEngineErrorHandler(nullptr);
-    }
+        if (d->backend && d->backend->isOpen())
+        {
+            d->backend->close();
+        }
 
-    d->parameters = parameters;
+        // Kill the old database error handler
+        if (d->backend)
+        {
+            d->backend->setDbEngineErrorHandler(nullptr);
+        }
 
-    if (!d->backend || !d->backend->isCompatible(parameters))
-    {
-        delete d->db;
-        delete d->backend;
-        d->backend = new SimilarityDbBackend(&d->lock);
-        d->db      = new SimilarityDb(d->backend);
+        d->parameters = parameters;
+
+        if (!d->backend || !d->backend->isCompatible(parameters))
+        {
+            delete d->db;
+            delete d->backend;
+            d->backend = new SimilarityDbBackend(&d->lock);
+            d->db      = new SimilarityDb(d->backend);
+        }
     }
+
+    // The signatures in memory are the ones of the previous database.
+    // SimilarityDb locks the index under the database lock, never the reverse.
+    HaarSignatureIndex::instance()->invalidate();
 }
 
 bool SimilarityDbAccess::checkReadyForUse(InitializationObserver* const observer)
@@ -279,6 +286,8 @@ void SimilarityDbAccess::cleanUpDatabase()
 
     delete d;
     d = nullptr;
+
+    HaarSignatureIndex::instance()->invalidate();
 }
 
 } // namespace Digikam
@@ -38,6 +38,7 @@
 #include "digikam_debug.h"
 #include "thumbsdbbackend.h"
 #include "thumbsdb.h"
+#include "thumbsdbwritequeue.h"
 #include "thumbsdbschemaupdater.h"
 #include "dbengineparameters.h"
 #include "dbengineaccess.h"
@@ -172,33 +173,38 @@ void ThumbsDbAccess::setParameters(const DbEngineParameters& parameters)
         d = new ThumbsDbAccessStaticPriv();
     }
 
-    ThumbsDbAccessMutexLocker lock(d);
-
-    if (d->parameters == parameters)
     {
-        return;
-    }
+        ThumbsDbAccessMutexLocker lock(d);
 
-    if (d->backend && d->backend->isOpen())
-    {
-        d->backend->close();
-    }
+        if (d->parameters == parameters)
+        {
+            return;
+        }
 
-    // Kill the old database error handler
-    if (d->backend)
-    {
-        d->backend->setDbEngineErrorHandler(nullptr);
-    }
+        if (d->backend && d->backend->isOpen())
+        {
+            d->backend->close();
+        }
 
-    d->parameters = parameters;
+        // Kill the old database error handler
+        if (d->backend)
+        {
+            d->backend->setDbEngineErrorHandler(nullptr);
+        }
 
-    if (!d->backend || !d->backend->isCompatible(parameters))
-    {
-        delete d->db;
-        delete d->backend;
-        d->backend = new ThumbsDbBackend(&d->lock);
-        d->db      = new ThumbsDb(d->backend);
+        d->parameters = parameters;
+
+        if (!d->backend || !d->backend->isCompatible(parameters))
+        {
+            delete d->db;
+            delete d->backend;
+            d->backend = new ThumbsDbBackend(&d->lock);
+            d->db      = new ThumbsDb(d->backend);
+        }
     }
+
+    // Thumbnails queued while no database was set can be written now.
+    ThumbsDbWriteQueue::instance()->databaseInitialized();
 }
 
 bool ThumbsDbAccess::checkReadyForUse(InitializationObserver* const observer)
@@ -265,6 +271,10 @@ void ThumbsDbAccess::cleanUpDatabase()
 {
     if (d)
     {
+        // Write the thumbnails still waiting in the queue while the database is open.
+
+        ThumbsDbWriteQueue::instance()->shutDown();
+
         ThumbsDbAccessMutexLocker locker(d);
 
         if (d->backend)
@@ -0,0 +1,480 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-24
+ * Description : Batched write-behind queue for the thumbnails database
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "thumbsdbwritequeue.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QVariant>
+#include <QWaitCondition>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "thumbsdbaccess.h"
+#include "thumbsdbbackend.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN ThumbsDbWriteQueueThread : public QThread
+{
+public:
+
+    explicit ThumbsDbWriteQueueThread(ThumbsDbWriteQueue* const q)
+        : q(q)
+    {
+    }
+
+protected:
+
+    void run() override;
+
+private:
+
+    ThumbsDbWriteQueue* const q;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ThumbsDbWriteQueue::Private
+{
+public:
+
+    explicit Private()
+      : batchSize(64),
+        maximumDelay(1000),
+        stop(false),
+        droppedReported(false),
+        thread(nullptr)
+    {
+    }
+
+    static bool sameKeys(const ThumbsDbPendingThumbnail& a, const ThumbsDbPendingThumbnail& b)
+    {
+        return ((a.customIdentifier == b.customIdentifier) &&
+                (a.uniqueHash       == b.uniqueHash)       &&
+                (a.fileSize         == b.fileSize)         &&
+                (a.filePath         == b.filePath));
+    }
+
+    static bool matches(const ThumbsDbPendingThumbnail& thumb,
+                        const QString& customIdentifier,
+                        const QString& uniqueHash,
+                        qlonglong fileSize,
+                        const QString& filePath)
+    {
+        // Same precedence as ThumbnailCreator::loadThumbsDbInfo()
+
+        if (!customIdentifier.isEmpty())
+        {
+            return (thumb.customIdentifier == customIdentifier);
+        }
+
+        if (!thumb.customIdentifier.isNull())
+        {
+            return false;
+        }
+
+        if (!uniqueHash.isEmpty() && (thumb.uniqueHash == uniqueHash) && (thumb.fileSize == fileSize))
+        {
+            return true;
+        }
+
+        return (!filePath.isEmpty() && (thumb.filePath == filePath));
+    }
+
+    /// The caller must hold the mutex.
+    bool batchDue() const
+    {
+        return (!pending.isEmpty() &&
+                ((pending.size() >= batchSize) || (oldestPending.elapsed() >= maximumDelay)));
+    }
+
+    /** Insert one thumbnail and its lookup keys. The caller must have opened a transaction.
+     *  Returns the state of the first failing query.
+     */
+    static BdEngineBackend::QueryState write(ThumbsDbAccess& access, const ThumbsDbPendingThumbnail& thumb)
+    {
+        BdEngineBackend::QueryState lastQueryState;
+        ThumbsDbInfo dbInfo = thumb.dbInfo;
+
+        // Insert thumbnail data
+        if (dbInfo.id == -1)
+        {
+            QVariant id;
+            lastQueryState = access.db()->insertThumbnail(dbInfo, &id);
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                return lastQueryState;
+            }
+
+            dbInfo.id = id.toInt();
+        }
+        else
+        {
+            lastQueryState = access.db()->replaceThumbnail(dbInfo);
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                return lastQueryState;
+            }
+        }
+
+        // Insert lookup data used to locate thumbnail data
+        if (!thumb.customIdentifier.isNull())
+        {
+            return access.db()->insertCustomIdentifier(thumb.customIdentifier, dbInfo.id);
+        }
+
+        if (!thumb.uniqueHash.isNull())
+        {
+            lastQueryState = access.db()->insertUniqueHash(thumb.uniqueHash, thumb.fileSize, dbInfo.id);
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                return lastQueryState;
+            }
+        }
+
+        if (!thumb.filePath.isNull())
+        {
+            lastQueryState = access.db()->insertFilePath(thumb.filePath, dbInfo.id);
+        }
+
+        return lastQueryState;
+    }
+
+public:
+
+    const int                       batchSize;
+    const int                       maximumDelay;
+
+    /// Protects pending, flushing, oldestPending, stop, droppedReported and thread.
+    mutable QMutex                  mutex;
+    QWaitCondition                  condVar;
+
+    /// Serializes the flushes, so that batches are committed in order.
+    QMutex                          flushMutex;
+
+    QList<ThumbsDbPendingThumbnail> pending;
+
+    /// The batch being written. Still visible to readers until committed.
+    QList<ThumbsDbPendingThumbnail> flushing;
+
+    QElapsedTimer                   oldestPending;
+    bool                            stop;
+
+    /// A batch was dropped because no database is set. Reported once until one is set.
+    bool                            droppedReported;
+
+    ThumbsDbWriteQueueThread*       thread;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+void ThumbsDbWriteQueueThread::run()
+{
+    forever
+    {
+        {
+            QMutexLocker locker(&q->d->mutex);
+
+            // Without a database, wait for ThumbsDbAccess::setParameters(). The producers
+            // drop the queued thumbnails meanwhile if too many are waiting.
+
+            while (!q->d->stop && (!q->d->batchDue() || !ThumbsDbAccess::isInitialized()))
+            {
+                if (q->d->pending.isEmpty() || !ThumbsDbAccess::isInitialized())
+                {
+                    q->d->condVar.wait(&q->d->mutex);
+                }
+                else
+                {
+                    qint64 remaining = q->d->maximumDelay - q->d->oldestPending.elapsed();
+                    q->d->condVar.wait(&q->d->mutex, (unsigned long)qMax(remaining, (qint64)1));
+                }
+            }
+
+            if (q->d->stop)
+            {
+                return;
+            }
+        }
+
+        q->flush();
+    }
+}
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ThumbsDbWriteQueueCreator
+{
+public:
+
+    ThumbsDbWriteQueue object;
+};
+
+Q_GLOBAL_STATIC(ThumbsDbWriteQueueCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+ThumbsDbWriteQueue* ThumbsDbWriteQueue::instance()
+{
+    return &creator->object;
+}
+
+ThumbsDbWriteQueue::ThumbsDbWriteQueue()
+    : d(new Private)
+{
+}
+
+ThumbsDbWriteQueue::~ThumbsDbWriteQueue()
+{
+    // The database is closed at this point if the application called
+    // ThumbsDbAccess::cleanUpDatabase(), which already wrote the queue.
+
+    {
+        QMutexLocker locker(&d->mutex);
+        d->stop = true;
+        d->condVar.wakeAll();
+    }
+
+    if (d->thread)
+    {
+        d->thread->wait();
+        delete d->thread;
+    }
+
+    if (!d->pending.isEmpty())
+    {
+        qCWarning(DIGIKAM_DATABASE_LOG) << d->pending.size() << "thumbnails were not written to the database";
+    }
+
+    delete d;
+}
+
+int ThumbsDbWriteQueue::batchSize() const
+{
+    return d->batchSize;
+}
+
+int ThumbsDbWriteQueue::maximumDelay() const
+{
+    return d->maximumDelay;
+}
+
+void ThumbsDbWriteQueue::enqueue(const ThumbsDbPendingThumbnail& thumb)
+{
+    bool mustFlush = false;
+
+    {
+        QMutexLocker locker(&d->mutex);
+
+        if (d->pending.isEmpty())
+        {
+            d->oldestPending.start();
+        }
+
+        bool replaced = false;
+
+        for (int i = 0 ; i < d->pending.size() ; ++i)
+        {
+            if (Private::sameKeys(d->pending.at(i), thumb))
+            {
+                d->pending[i] = thumb;
+                replaced      = true;
+                break;
+            }
+        }
+
+        if (!replaced)
+        {
+            d->pending << thumb;
+        }
+
+        if (!d->thread)
+        {
+            d->thread = new ThumbsDbWriteQueueThread(this);
+        }
+
+        if (!d->thread->isRunning())
+        {
+            d->stop = false;
+            d->thread->start(QThread::LowPriority);
+        }
+
+        if (d->pending.size() >= d->batchSize)
+        {
+            d->condVar.wakeAll();
+        }
+
+        // The writer does not keep pace: let the producers help, so memory use stays bounded.
+
+        mustFlush = (d->pending.size() >= 4 * d->batchSize);
+    }
+
+    if (mustFlush)
+    {
+        flush();
+    }
+}
+
+bool ThumbsDbWriteQueue::findPending(const QString& customIdentifier,
+                                     const QString& uniqueHash,
+                                     qlonglong fileSize,
+                                     const QString& filePath,
+                                     ThumbsDbInfo* const dbInfo) const
+{
+    QMutexLocker locker(&d->mutex);
+
+    // Most recent entries first
+
+    for (int i = d->pending.size() - 1 ; i >= 0 ; --i)
+    {
+        if (Private::matches(d->pending.at(i), customIdentifier, uniqueHash, fileSize, filePath))
+        {
+            *dbInfo = d->pending.at(i).dbInfo;
+            return true;
+        }
+    }
+
+    for (int i = d->flushing.size() - 1 ; i >= 0 ; --i)
+    {
+        if (Private::matches(d->flushing.at(i), customIdentifier, uniqueHash, fileSize, filePath))
+        {
+            *dbInfo = d->flushing.at(i).dbInfo;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThumbsDbWriteQueue::flush()
+{
+    QMutexLocker flushLocker(&d->flushMutex);
+
+    {
+        QMutexLocker locker(&d->mutex);
+
+        if (d->pending.isEmpty())
+        {
+            return;
+        }
+
+        if (!ThumbsDbAccess::isInitialized())
+        {
+            // Keeping the batch would only make the queue grow. The thumbnails are created again on next use.
+
+            if (!d->droppedReported)
+            {
+                qCWarning(DIGIKAM_DATABASE_LOG) << "Thumbnails database is not initialized. Dropping"
+                                                << d->pending.size() << "thumbnails";
+                d->droppedReported = true;
+            }
+
+            d->pending.clear();
+            return;
+        }
+
+        d->flushing = d->pending;
+        d->pending.clear();
+    }
+
+    ThumbsDbAccess access;
+    BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
+
+    while (lastQueryState == BdEngineBackend::ConnectionError)
+    {
+        lastQueryState = access.backend()->beginTransaction();
+
+        if (BdEngineBackend::NoErrors != lastQueryState)
+        {
+            continue;
+        }
+
+        foreach (const ThumbsDbPendingThumbnail& thumb, d->flushing)
+        {
+            lastQueryState = Private::write(access, thumb);
+
+            if (BdEngineBackend::ConnectionError == lastQueryState)
+            {
+                break;
+            }
+
+            if (BdEngineBackend::NoErrors != lastQueryState)
+            {
+                // An SQL error only loses this thumbnail. It will be created again on next use.
+
+                qCWarning(DIGIKAM_DATABASE_LOG) << "Cannot store thumbnail in database"
+                                                << thumb.filePath << thumb.customIdentifier;
+            }
+        }
+
+        if (BdEngineBackend::ConnectionError == lastQueryState)
+        {
+            continue;
+        }
+
+        lastQueryState = access.backend()->commitTransaction();
+    }
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Wrote" << d->flushing.size() << "thumbnails in one transaction";
+
+    QMutexLocker locker(&d->mutex);
+    d->flushing.clear();
+}
+
+void ThumbsDbWriteQueue::databaseInitialized()
+{
+    QMutexLocker locker(&d->mutex);
+    d->droppedReported = false;
+    d->condVar.wakeAll();
+}
+
+void ThumbsDbWriteQueue::shutDown()
+{
+    ThumbsDbWriteQueueThread* thread = nullptr;
+
+    {
+        QMutexLocker locker(&d->mutex);
+        d->stop = true;
+        d->condVar.wakeAll();
+        thread  = d->thread;
+    }
+
+    if (thread)
+    {
+        thread->wait();
+    }
+
+    flush();
+}
+
+} // namespace Digikam
@@ -0,0 +1,127 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-24
+ * Description : Batched write-behind queue for the thumbnails database
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_THUMBS_DB_WRITE_QUEUE_H
+#define DIGIKAM_THUMBS_DB_WRITE_QUEUE_H
+
+// Qt includes
+
+#include <QString>
+
+// Local includes
+
+#include "thumbsdb.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/** A thumbnail waiting to be written, with the lookup keys
+ *  which will locate it in the database.
+ */
+class DIGIKAM_EXPORT ThumbsDbPendingThumbnail
+{
+public:
+
+    explicit ThumbsDbPendingThumbnail()
+        : fileSize(0)
+    {
+    }
+
+    ThumbsDbInfo dbInfo;
+
+    QString      customIdentifier;
+    QString      uniqueHash;
+    qlonglong    fileSize;
+    QString      filePath;
+};
+
+// --------------------------------------------------------------------------
+
+/** Collects the thumbnails created by all ThumbnailCreator instances and writes them
+ *  to the thumbnails database in batches, each batch in a single transaction.
+ *
+ *  A batch is written by a background thread when batchSize() entries are queued
+ *  or when the oldest entry waited longer than maximumDelay() milliseconds.
+ *  Queued entries are visible through findPending() until their transaction is committed,
+ *  so a thumbnail can be read back immediately after it was stored.
+ *
+ *  shutDown() writes all remaining entries. It is called by ThumbsDbAccess::cleanUpDatabase().
+ *  All methods are thread-safe.
+ */
+class DIGIKAM_EXPORT ThumbsDbWriteQueue
+{
+public:
+
+    static ThumbsDbWriteQueue* instance();
+
+    /** Queue a thumbnail. A pending entry with the same lookup keys is replaced.
+     */
+    void enqueue(const ThumbsDbPendingThumbnail& thumb);
+
+    /** Look up a queued thumbnail, with the same precedence as ThumbnailCreator
+     *  uses for the database: custom identifier, else unique hash and file size, else file path.
+     *  Returns false if no entry matches.
+     */
+    bool findPending(const QString& customIdentifier,
+                     const QString& uniqueHash,
+                     qlonglong fileSize,
+                     const QString& filePath,
+                     ThumbsDbInfo* const dbInfo) const;
+
+    /** Write all queued thumbnails now, in one transaction. Returns when they are committed.
+     */
+    void flush();
+
+    /** Wake the background thread when a database was set. Called by ThumbsDbAccess::setParameters().
+     *  Until then, the thread waits and flush() drops the queued thumbnails.
+     */
+    void databaseInitialized();
+
+    /** Write all queued thumbnails and stop the background thread.
+     *  The queue restarts when a new thumbnail is queued.
+     */
+    void shutDown();
+
+    int  batchSize()    const;
+    int  maximumDelay() const;
+
+private:
+
+    explicit ThumbsDbWriteQueue();
+    ~ThumbsDbWriteQueue();
+
+    ThumbsDbWriteQueue(const ThumbsDbWriteQueue&); // Disable
+
+private:
+
+    friend class ThumbsDbWriteQueueCreator;
+    friend class ThumbsDbWriteQueueThread;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_THUMBS_DB_WRITE_QUEUE_H
@@ -43,10 +43,12 @@
 #include "scancontroller.h"
 #include "thumbsdb.h"
 #include "thumbsdbaccess.h"
+#include "thumbsdbwritequeue.h"
 #include "iojobsmanager.h"
 #include "collectionmanager.h"
 #include "dnotificationwrapper.h"
 #include "loadingcacheinterface.h"
+#include "thumbnailpack.h"
 #include "progressmanager.h"
 #include "digikamapp.h"
 #include "iojobdata.h"
@@ -511,14 +513,22 @@ void DIO::slotOneProccessed(const QUrl& url)
             QString newName = data->destUrl(url).fileName();
             QString newPath = data->destUrl(url).toLocalFile();
 
+            // Queued thumbnails must reach the database before the paths are changed
+            ThumbsDbWriteQueue::instance()->flush();
+
             if (data->overwrite())
             {
                 ThumbsDbAccess().db()->removeByFilePath(newPath);
+                ThumbnailPack::instance()->remove(QStringList() << ThumbnailPack::filePathKey(newPath));
                 LoadingCacheInterface::fileChanged(newPath, false);
                 CoreDbAccess().db()->deleteItem(info.albumId(), newName);
             }
 
             ThumbsDbAccess().db()->renameByFilePath(oldPath, newPath);
+
+            // The pack file finds the renamed file by its unique hash. The old path must not match another file.
+            ThumbnailPack::instance()->remove(QStringList() << ThumbnailPack::filePathKey(oldPath));
+
             // Remove old thumbnails and images from the cache
             LoadingCacheInterface::fileChanged(oldPath, false);
             // Rename in ItemInfo and database
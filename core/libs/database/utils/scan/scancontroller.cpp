@@ -165,6 +165,7 @@ void ScanController::run()
         bool doInit             = false;
         bool doScan             = false;
         bool doScanDeferred     = false;
+        bool doScanIncremental  = false;
         bool doFinishScan       = false;
         bool doPartialScan      = false;
         bool doUpdateUniqueHash = false;
@@ -183,6 +184,7 @@ void ScanController::run()
                 d->needsCompleteScan = false;
                 doScan               = true;
                 doScanDeferred       = d->deferFileScanning;
+                doScanIncremental    = d->incrementalScan;
             }
             else if (d->needsUpdateUniqueHash)
             {
@@ -228,6 +230,8 @@ void ScanController::run()
 
             scanner.setNeedFileCount(d->needTotalFiles);
             scanner.setDeferredFileScanning(doScanDeferred);
+            scanner.setIncrementalScan(doScanIncremental);
+            scanner.setPipelinedScanning(true);
             scanner.setHintContainer(d->hints);
 
             SimpleCollectionScannerObserver observer(&d->continueScan);
@@ -256,6 +260,7 @@ void ScanController::run()
             emit collectionScanStarted(i18nc("@info:status", "Scanning collection"));
             //TODO: reconsider performance
             scanner.setNeedFileCount(true);//d->needTotalFiles);
+            scanner.setPipelinedScanning(true);
 
             scanner.setHintContainer(d->hints);
 
@@ -152,12 +152,15 @@ public:
     /**
      * Scan Whole collection without to display a progress dialog
      * or to manage splashscreen, as for NewItemsFinder tool.
+     * With incremental, only the albums changed since the last complete scan
+     * are scanned, see CollectionScanner::setIncrementalScan().
      */
-    void completeCollectionScanInBackground(bool defer);
+    void completeCollectionScanInBackground(bool defer, bool incremental = false);
 
     /**
      * Schedules a scan of the specified part of the collection.
      * Asynchronous, returns immediately.
+     * The scheduling methods record the path in the CollectionScanJournal.
      */
     void scheduleCollectionScan(const QString& path);
 
@@ -216,7 +219,7 @@ private:
      */
     void scanFileDirectly(const QString& filePath);
     void scanFileDirectlyNormal(const ItemInfo& info);
-    void completeCollectionScanCore(bool needTotalFiles, bool defer);
+    void completeCollectionScanCore(bool needTotalFiles, bool defer, bool incremental = false);
 
     //@}
 
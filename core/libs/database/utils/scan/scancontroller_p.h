@@ -31,6 +31,7 @@
 // Qt includes
 
 #include <QStringList>
+#include <QDir>
 #include <QFileInfo>
 #include <QPixmap>
 #include <QIcon>
@@ -51,6 +52,7 @@
 
 #include "digikam_debug.h"
 #include "collectionscanner.h"
+#include "collectionscanjournal.h"
 #include "coredbaccess.h"
 #include "collectionmanager.h"
 #include "collectionlocation.h"
@@ -131,6 +133,7 @@ public:
 
     QStringList                     completeScanDeferredAlbums;
     bool                            deferFileScanning;
+    bool                            incrementalScan;
     bool                            finishScanAllowed;
 
     QMutex                          mutex;
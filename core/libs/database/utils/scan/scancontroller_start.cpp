@@ -48,7 +48,6 @@ ScanController::Advice ScanController::databaseInitialization()
     {
         d->fileWatchInstalled     = true; // once per application lifetime only
         LoadingCache* const cache = LoadingCache::cache();
-        LoadingCache::CacheLock lock(cache);
         cache->setFileWatch(new ScanControllerLoadingCacheFileWatch);
     }
 
@@ -75,12 +74,12 @@ void ScanController::completeCollectionScan(bool defer)
     d->progressDialog = nullptr;
 }
 
-void ScanController::completeCollectionScanInBackground(bool defer)
+void ScanController::completeCollectionScanInBackground(bool defer, bool incremental)
 {
-    completeCollectionScanCore(true, defer);
+    completeCollectionScanCore(true, defer, incremental);
 }
 
-void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer)
+void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer, bool incremental)
 {
     d->needTotalFiles = needTotalFiles;
 
@@ -88,6 +87,7 @@ void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer)
         QMutexLocker lock(&d->mutex);
         d->needsCompleteScan = true;
         d->deferFileScanning = defer;
+        d->incrementalScan   = incremental;
         d->condVar.wakeAll();
     }
 
@@ -99,6 +99,8 @@ void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer)
 
 void ScanController::scheduleCollectionScan(const QString& path)
 {
+    CollectionScanJournal::instance()->recordChange(QDir::cleanPath(path));
+
     QMutexLocker lock(&d->mutex);
 
     if (!d->scanTasks.contains(path))
@@ -111,6 +113,8 @@ void ScanController::scheduleCollectionScan(const QString& path)
 
 void ScanController::scheduleCollectionScanRelaxed(const QString& path)
 {
+    CollectionScanJournal::instance()->recordChange(QDir::cleanPath(path));
+
     if (!d->relaxedTimer->isActive())
     {
         d->relaxedTimer->start();
@@ -126,6 +130,8 @@ void ScanController::scheduleCollectionScanRelaxed(const QString& path)
 
 void ScanController::scheduleCollectionScanExternal(const QString& path)
 {
+    CollectionScanJournal::instance()->recordChange(QDir::cleanPath(path));
+
     d->externalTimer->start();
 
     QMutexLocker lock(&d->mutex);
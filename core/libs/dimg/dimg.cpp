@@ -25,6 +25,7 @@
  * ============================================================ */
 
 #include "dimg_p.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -166,20 +167,8 @@ DImg::DImg(const QImage& image)
 
         if (allocateData())
         {
-            uint*  sptr       = reinterpret_cast<uint*>(target.bits());
-            uchar* dptr       = m_priv->data;
-            const uint pixels = numPixels();
-
-            for (uint i = 0 ; i < pixels ; ++i)
-            {
-                dptr[0] = qBlue(*sptr);
-                dptr[1] = qGreen(*sptr);
-                dptr[2] = qRed(*sptr);
-                dptr[3] = qAlpha(*sptr);
-
-                dptr += 4;
-                ++sptr;
-            }
+            DImgKernels::argb32ToBgra(reinterpret_cast<const uint*>(target.constBits()),
+                                      m_priv->data, numPixels());
         }
 
     }
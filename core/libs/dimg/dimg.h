@@ -30,6 +30,7 @@
 
 #include <QByteArray>
 #include <QFlags>
+#include <QList>
 #include <QSize>
 #include <QRect>
 #include <QVariant>
@@ -338,9 +339,30 @@ public:
     bool       hasAttribute(const QString& key) const;
     void       removeAttribute(const QString& key);
 
+    /** Ask the loaders to deliver a reduced image when the file format allows to decode it
+        directly at a lower resolution: the longest side of the loaded image will be at least
+        size pixels, or the original size if smaller. JPEG images are decoded with DCT scaling,
+        PGF images from the smallest sufficient level, RAW images with half size demosaicing.
+        Other formats are loaded at full size. Set before calling load(). 0 loads the full size.
+     */
+    void       setScaledLoadingSize(int size);
+    int        scaledLoadingSize() const;
+
     void       setEmbeddedText(const QString& key, const QString& text);
     QString    embeddedText(const QString& key) const;
 
+    /** Cache of the histogram computed by ImageHistogram for the current image data,
+        shared by all the DImg referencing the same data. The methods of this class changing
+        the image data drop the cache. Code writing to bits() or with setPixelColor() to an image
+        which may already have a histogram must call removeCachedHistogram(). DImgThreadedFilter
+        does it for the filters returning their original image modified in place.
+        An exact histogram is also returned when an approximate one is asked for.
+        These methods are thread-safe.
+     */
+    void       setCachedHistogram(const QByteArray& histogram, bool exact) const;
+    QByteArray cachedHistogram(bool exact)                                 const;
+    void       removeCachedHistogram()                                     const;
+
     const DImageHistory& getItemHistory() const;
     DImageHistory&       getItemHistory();
     void                 setItemHistory(const DImageHistory& history);
@@ -532,7 +554,9 @@ public:
     void       removeAlphaChannel();
 
     /** Return a version of this image scaled to the specified size with the specified mode.
-        See QSize documentation for information on available modes
+        See QSize documentation for information on available modes.
+        The scaling is done in several threads by DImgResampler, with the kernel
+        given by DImgResampler::smoothScaleKernel(). Use DImgResampler::scale() to choose the kernel.
      */
     DImg       smoothScale(int width, int height, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio) const;
     DImg       smoothScale(const QSize& destSize, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio) const;
@@ -653,6 +677,12 @@ public:
      */
     static bool isAnimatedImage(const QString& filePath);
 
+    /** Split rows processed together on pixels, for the threads of the global QThreadPool.
+     *  The chunks are not smaller than 256K pixels, small images are processed in one chunk.
+     *  Returns the first row of each chunk, followed by rows.
+     */
+    static QList<int> rowChunks(int rows, qint64 pixels);
+
 private:
 
     DImg(const DImg& image, int w, int h);
@@ -686,6 +716,7 @@ private:
     DSharedDataPointer<Private> m_priv;
 
     friend class DImgLoader;
+    friend class DImgResampler;
 };
 
 } // namespace Digikam
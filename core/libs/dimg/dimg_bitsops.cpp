@@ -41,6 +41,8 @@ void DImg::bitBltImage(const DImg* const src, int sx, int sy, int dx, int dy)
 
 void DImg::bitBltImage(const DImg* const src, int sx, int sy, int w, int h, int dx, int dy)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -65,6 +67,8 @@ void DImg::bitBltImage(const DImg* const src, int sx, int sy, int w, int h, int
 void DImg::bitBltImage(const uchar* const src, int sx, int sy, int w, int h, int dx, int dy,
                        uint swidth, uint sheight, int sdepth)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -189,6 +193,8 @@ void DImg::bitBlendImage(DColorComposer* const composer, const DImg* const src,
                          int sx, int sy, int w, int h, int dx, int dy,
                          DColorComposer::MultiplicationFlags multiplicationFlags)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -262,6 +268,8 @@ void DImg::bitBlendImageOnColor(DColorComposer* const composer, const DColor& co
                                 int x, int y, int w, int h,
                                 DColorComposer::MultiplicationFlags multiplicationFlags)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
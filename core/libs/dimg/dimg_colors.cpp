@@ -24,6 +24,7 @@
  * ============================================================ */
 
 #include "dimg_p.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -52,6 +53,8 @@ void DImg::convertToDepthOfImage(const DImg* const otherImage)
 
 void DImg::convertDepth(int depth)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -74,14 +77,10 @@ void DImg::convertDepth(int depth)
         // downgrading from 16 bit to 8 bit
 
         uchar*  data = new uchar[width()*height() * 4];
-        uchar*  dptr = data;
         ushort* sptr = reinterpret_cast<ushort*>(bits());
         uint dim     = width() * height() * 4;
 
-        for (uint i = 0 ; i < dim ; ++i)
-        {
-            *dptr++ = (*sptr++ * 256UL) / 65536UL;
-        }
+        DImgKernels::convert16To8(sptr, data, dim);
 
         delete [] m_priv->data;
         m_priv->data       = data;
@@ -95,24 +94,18 @@ void DImg::convertDepth(int depth)
         ushort* dptr = reinterpret_cast<ushort*>(data);
         uchar*  sptr = bits();
 
-        // use default seed of the generator
-        RandomNumberGenerator generator;
-        ushort noise = 0;
-
         uint dim = width() * height() * 4;
 
-        for (uint i = 0 ; i < dim ; ++i)
+        DImgKernels::convert8To16(sptr, dptr, dim);
+
+        // use default seed of the generator, add noise to the color channels
+        RandomNumberGenerator generator;
+
+        for (uint i = 0 ; i < dim ; i += 4)
         {
-            if (i % 4 < 3)
-            {
-                noise = generator.number(0, 255);
-            }
-            else
-            {
-                noise = 0;
-            }
-
-            *dptr++ = (*sptr++ * 65536ULL) / 256ULL + noise;
+            dptr[i]     += generator.number(0, 255);
+            dptr[i + 1] += generator.number(0, 255);
+            dptr[i + 2] += generator.number(0, 255);
         }
 
         delete [] m_priv->data;
@@ -123,6 +116,8 @@ void DImg::convertDepth(int depth)
 
 void DImg::fill(const DColor& color)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -172,12 +167,32 @@ void DImg::removeAlphaChannel()
 
 void DImg::removeAlphaChannel(const DColor& destColor)
 {
+    removeCachedHistogram();
+
     if (isNull() || !hasAlpha())
     {
         return;
     }
 
-    bitBlendImageOnColor(destColor);
+    // Same result as bitBlendImageOnColor(destColor), with the Porter-Duff None composer.
+
+    DColor color = destColor;
+
+    if (sixteenBit())
+    {
+        color.convertToSixteenBit();
+        const ushort components[4] = { (ushort)color.blue(), (ushort)color.green(),
+                                       (ushort)color.red(),  (ushort)color.alpha() };
+        DImgKernels::blendOnColor16(reinterpret_cast<ushort*>(bits()), width() * height(), components);
+    }
+    else
+    {
+        color.convertToEightBit();
+        const uchar components[4] = { (uchar)color.blue(), (uchar)color.green(),
+                                      (uchar)color.red(),  (uchar)color.alpha() };
+        DImgKernels::blendOnColor8(bits(), width() * height(), components);
+    }
+
     // unsure if alpha value is always 0xFF now
     m_priv->alpha = false;
 }
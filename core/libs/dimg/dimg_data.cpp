@@ -109,6 +109,8 @@ void DImg::putImageData(uint width, uint height, bool sixteenBit, bool alpha, uc
 
 void DImg::putImageData(uchar* const data, bool copyData)
 {
+    removeCachedHistogram();
+
     if (!data)
     {
         delete [] m_priv->data;
@@ -180,6 +182,8 @@ void DImg::setImageDimension(uint width, uint height)
 
 void DImg::setImageData(bool null, uint width, uint height, bool sixteenBit, bool alpha)
 {
+    removeCachedHistogram();
+
     m_priv->null       = null;
     m_priv->width      = width;
     m_priv->height     = height;
@@ -52,6 +52,7 @@ extern "C"
 #include <QByteArray>
 #include <QVariant>
 #include <QMap>
+#include <QMutex>
 #include <QFile>
 #include <QFileInfo>
 #include <QImage>
@@ -130,13 +131,14 @@ public:
 
     explicit Private()
     {
-        null         = true;
-        width        = 0;
-        height       = 0;
-        data         = nullptr;
-        lanczos_func = nullptr;
-        alpha        = false;
-        sixteenBit   = false;
+        null           = true;
+        width          = 0;
+        height         = 0;
+        data           = nullptr;
+        lanczos_func   = nullptr;
+        alpha          = false;
+        sixteenBit     = false;
+        histogramExact = false;
     }
 
     ~Private()
@@ -201,6 +203,11 @@ public:
     QMap<QString, QString>  embeddedText;
     IccProfile              iccProfile;
     DImageHistory           imageHistory;
+
+    /// Histogram cached by ImageHistogram, protected by histogramMutex.
+    QMutex                  histogramMutex;
+    QByteArray              histogram;
+    bool                    histogramExact;
 };
 
 } // namespace Digikam
@@ -25,6 +25,10 @@
 
 #include "dimg_p.h"
 
+// Qt includes
+
+#include <QThreadPool>
+
 namespace Digikam
 {
 
@@ -227,6 +231,56 @@ void DImg::removeAttribute(const QString& key)
     m_priv->attributes.remove(key);
 }
 
+void DImg::setScaledLoadingSize(int size)
+{
+    if (size > 0)
+    {
+        setAttribute(QLatin1String("scaledLoadingSize"), size);
+    }
+    else
+    {
+        removeAttribute(QLatin1String("scaledLoadingSize"));
+    }
+}
+
+int DImg::scaledLoadingSize() const
+{
+    return attribute(QLatin1String("scaledLoadingSize")).toInt();
+}
+
+void DImg::setCachedHistogram(const QByteArray& histogram, bool exact) const
+{
+    QMutexLocker lock(&m_priv->histogramMutex);
+
+    // Do not replace an exact histogram by an approximate one.
+
+    if (exact || !m_priv->histogramExact || m_priv->histogram.isEmpty())
+    {
+        m_priv->histogram      = histogram;
+        m_priv->histogramExact = exact;
+    }
+}
+
+QByteArray DImg::cachedHistogram(bool exact) const
+{
+    QMutexLocker lock(&m_priv->histogramMutex);
+
+    if (exact && !m_priv->histogramExact)
+    {
+        return QByteArray();
+    }
+
+    return m_priv->histogram;
+}
+
+void DImg::removeCachedHistogram() const
+{
+    QMutexLocker lock(&m_priv->histogramMutex);
+
+    m_priv->histogram.clear();
+    m_priv->histogramExact = false;
+}
+
 void DImg::setEmbeddedText(const QString& key, const QString& text)
 {
     m_priv->embeddedText.insert(key, text);
@@ -680,4 +734,22 @@ bool DImg::hasTransparentPixels() const
     return false;
 }
 
+QList<int> DImg::rowChunks(int rows, qint64 pixels)
+{
+    // Below 256K pixels by chunk, the synchronization costs more than it gives.
+
+    const int chunks = qBound(1, (int)qMin(pixels / (256 * 1024), (qint64)rows),
+                              qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    QList<int> vals;
+
+    for (int c = 0 ; c < chunks ; ++c)
+    {
+        vals << (int)((qint64)rows * c / chunks);
+    }
+
+    vals << rows;
+
+    return vals;
+}
+
 } // namespace Digikam
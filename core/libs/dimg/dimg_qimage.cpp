@@ -24,6 +24,7 @@
  * ============================================================ */
 
 #include "dimg_p.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -35,15 +36,6 @@ QImage DImg::copyQImage() const
         return QImage();
     }
 
-    if (sixteenBit())
-    {
-        DImg img(*this);
-        img.detach();
-        img.convertDepth(32);
-
-        return img.copyQImage();
-    }
-
     QImage img(width(), height(), QImage::Format_ARGB32);
 
     if (img.isNull())
@@ -53,13 +45,17 @@ QImage DImg::copyQImage() const
         return QImage();
     }
 
-    uchar* sptr = bits();
-    uint*  dptr = reinterpret_cast<uint*>(img.bits());
+    uint* dptr = reinterpret_cast<uint*>(img.bits());
 
-    for (uint i = 0; i < width()*height(); ++i)
+    if (sixteenBit())
     {
-        *dptr++ = qRgba(sptr[2], sptr[1], sptr[0], sptr[3]);
-        sptr += 4;
+        // convert to 8 bits on the fly, without a temporary copy of the image
+
+        DImgKernels::bgra16ToArgb32(reinterpret_cast<ushort*>(bits()), dptr, numPixels());
+    }
+    else
+    {
+        DImgKernels::bgraToArgb32(bits(), dptr, numPixels());
     }
 
     // NOTE: Qt4 do not provide anymore QImage::setAlphaChannel() because
@@ -94,14 +90,7 @@ QImage DImg::copyQImage(int x, int y, int w, int h) const
         return QImage();
     }
 
-    DImg img = copy(x, y, w, h);
-
-    if (img.sixteenBit())
-    {
-        img.convertDepth(32);
-    }
-
-    return img.copyQImage();
+    return copy(x, y, w, h).copyQImage();
 }
 
 } // namespace Digikam
@@ -24,6 +24,7 @@
  * ============================================================ */
 
 #include "dimg_p.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -75,15 +76,7 @@ QPixmap DImg::convertToPixmap() const
     {
         QImage img(width(), height(), hasAlpha() ? QImage::Format_ARGB32 : QImage::Format_RGB32);
 
-        uchar* sptr = bits();
-        uint*  dptr = reinterpret_cast<uint*>(img.bits());
-        uint dim    = width() * height();
-
-        for (uint i = 0; i < dim; ++i)
-        {
-            *dptr++ = qRgba(sptr[2], sptr[1], sptr[0], sptr[3]);
-            sptr += 4;
-        }
+        DImgKernels::bgraToArgb32(bits(), reinterpret_cast<uint*>(img.bits()), numPixels());
 
         // alpha channel is auto-detected during QImage->QPixmap conversion
         return QPixmap::fromImage(img);
@@ -48,6 +48,7 @@ extern "C"
 #include "digikam_debug.h"
 #include "dimg.h"
 #include "dimg_p.h"
+#include "dimgresampler.h"
 
 typedef uint64_t ullong;    // krazy:exclude=typedefs
 typedef int64_t  llong;     // krazy:exclude=typedefs
@@ -221,42 +222,10 @@ DImg DImg::smoothScaleClipped(int dw, int dh, int clipx, int clipy, int clipw, i
         }
     }
 
-    DImgScaleInfo* scaleinfo = dimgCalcScaleInfo(*this, w, h, dw, dh, sixteenBit(), true);
-
     DImg buffer(*this, clipw, cliph);
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              0, 0, dw, dh, clipw, w,
-                              clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             0, 0, dw, dh, clipw, w,
-                             clipx, clipy, clipw, cliph);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                            0, 0, dw, dh, clipw, w,
-                            clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                           0, 0, dw, dh, clipw, w,
-                           clipx, clipy, clipw, cliph);
-        }
-    }
-
-    delete scaleinfo;
+    DImgResampler::scale(*this, QRect(0, 0, w, h), QSize(dw, dh), QRect(clipx, clipy, clipw, cliph), buffer,
+                         DImgResampler::smoothScaleKernel(QSize(w, h), QSize(dw, dh)));
 
     return buffer;
 }
@@ -327,49 +296,57 @@ DImg DImg::smoothScaleSection(int sx, int sy,
         return copy(sx, sy, sw, sh);
     }
 
-    // calculate scaleinfo
-    DImgScaleInfo* scaleinfo = dimgCalcScaleInfo(*this, sw, sh, dw, dh, sixteenBit(), true);
-
     DImg buffer(*this, dw, dh);
 
-    if (sixteenBit())
+    DImgResampler::scale(*this, QRect(sx, sy, sw, sh), QSize(dw, dh), QRect(0, 0, dw, dh), buffer,
+                         DImgResampler::smoothScaleKernel(QSize(sw, sh), QSize(dw, dh)));
+
+    return buffer;
+}
+
+DImg DImgResampler::legacyScale(const DImg& img, const QSize& destSize)
+{
+    const int w  = img.width();
+    const int h  = img.height();
+    const int dw = destSize.width();
+    const int dh = destSize.height();
+
+    if (img.isNull() || dw <= 0 || dh <= 0)
     {
-        if (hasAlpha())
+        return DImg();
+    }
+
+    DImg buffer(img, dw, dh);
+    DImgScaleInfo* const scaleinfo = dimgCalcScaleInfo(img, w, h, dw, dh, img.sixteenBit(), true);
+
+    if (img.sixteenBit())
+    {
+        if (img.hasAlpha())
         {
             dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              ((sx * dw) / sw),
-                              ((sy * dh) / sh),
-                              dw, dh,
-                              dw, w);
+                              0, 0, dw, dh, dw, w,
+                              0, 0, dw, dh);
         }
         else
         {
             dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             ((sx * dw) / sw),
-                             ((sy * dh) / sh),
-                             dw, dh,
-                             dw, w);
+                             0, 0, dw, dh, dw, w,
+                             0, 0, dw, dh);
         }
     }
     else
     {
-        if (hasAlpha())
+        if (img.hasAlpha())
         {
-            dimgScaleAARGBA(scaleinfo,
-                            reinterpret_cast<uint*>(buffer.bits()),
-                            ((sx * dw) / sw),
-                            ((sy * dh) / sh),
-                            dw, dh,
-                            dw, w);
+            dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
+                            0, 0, dw, dh, dw, w,
+                            0, 0, dw, dh);
         }
         else
         {
-            dimgScaleAARGB(scaleinfo,
-                           reinterpret_cast<uint*>(buffer.bits()),
-                           ((sx * dw) / sw),
-                           ((sy * dh) / sh),
-                           dw, dh,
-                           dw, w);
+            dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
+                           0, 0, dw, dh, dw, w,
+                           0, 0, dw, dh);
         }
     }
 
@@ -35,6 +35,8 @@ void DImg::crop(const QRect& rect)
 
 void DImg::crop(int x, int y, int w, int h)
 {
+    removeCachedHistogram();
+
     if (isNull() || w <= 0 || h <= 0)
     {
         return;
@@ -54,6 +56,8 @@ void DImg::crop(int x, int y, int w, int h)
 
 void DImg::resize(int w, int h)
 {
+    removeCachedHistogram();
+
     if (isNull() || w <= 0 || h <= 0)
     {
         return;
@@ -68,6 +72,8 @@ void DImg::resize(int w, int h)
 
 void DImg::rotate(ANGLE angle)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -281,6 +287,8 @@ void DImg::rotate(ANGLE angle)
 
 void DImg::flip(FLIP direction)
 {
+    removeCachedHistogram();
+
     if (isNull())
     {
         return;
@@ -0,0 +1,967 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : Vectorized kernels for look-up tables and
+ *               pixel format conversions of DImg buffers
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgkernels.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QColor>
+#include <QSysInfo>
+
+// Runtime dispatch is done with the GCC/Clang target attributes.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#   define DIMG_KERNELS_X86 1
+#   include <immintrin.h>
+#   define DIMG_TARGET_SSE41 __attribute__((target("sse4.1")))
+#   define DIMG_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+namespace Digikam
+{
+
+namespace DImgKernels
+{
+
+// --- Portable versions ------------------------------------------------------------
+
+/// The pixels in [start, count[.
+static void applyLut8Scalar(const uchar* const src, uchar* const dst, uint start, uint count,
+                            const int* const luts[4])
+{
+    for (uint i = start ; i < count ; ++i)
+    {
+        const uchar* const sptr = src + 4*i;
+        uchar* const       dptr = dst + 4*i;
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            dptr[c] = luts[c] ? (uchar)qBound(0, luts[c][sptr[c]], 255) : sptr[c];
+        }
+    }
+}
+
+static void applyLut16Scalar(const ushort* const src, ushort* const dst, uint start, uint count,
+                             const int* const luts[4])
+{
+    for (uint i = start ; i < count ; ++i)
+    {
+        const ushort* const sptr = src + 4*i;
+        ushort* const       dptr = dst + 4*i;
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            dptr[c] = luts[c] ? (ushort)qBound(0, luts[c][sptr[c]], 65535) : sptr[c];
+        }
+    }
+}
+
+static void convert16To8Scalar(const ushort* const src, uchar* const dst, uint start, uint count)
+{
+    for (uint i = start ; i < count ; ++i)
+    {
+        dst[i] = src[i] >> 8;
+    }
+}
+
+static void convert8To16Scalar(const uchar* const src, ushort* const dst, uint start, uint count)
+{
+    for (uint i = start ; i < count ; ++i)
+    {
+        dst[i] = src[i] << 8;
+    }
+}
+
+static void bgraToArgb32Scalar(const uchar* const src, uint* const dst, uint count)
+{
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+    {
+        memcpy(dst, src, count * 4);
+        return;
+    }
+
+    const uchar* sptr = src;
+
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        dst[i] = qRgba(sptr[2], sptr[1], sptr[0], sptr[3]);
+        sptr  += 4;
+    }
+}
+
+static void argb32ToBgraScalar(const uint* const src, uchar* const dst, uint count)
+{
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+    {
+        memcpy(dst, src, count * 4);
+        return;
+    }
+
+    uchar* dptr = dst;
+
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        dptr[0] = qBlue(src[i]);
+        dptr[1] = qGreen(src[i]);
+        dptr[2] = qRed(src[i]);
+        dptr[3] = qAlpha(src[i]);
+        dptr   += 4;
+    }
+}
+
+static void bgraToRgbScalar(const uchar* const src, uchar* const dst, uint start, uint count)
+{
+    for (uint i = start ; i < count ; ++i)
+    {
+        dst[3*i    ] = src[4*i + 2];
+        dst[3*i + 1] = src[4*i + 1];
+        dst[3*i + 2] = src[4*i    ];
+    }
+}
+
+static void blendOnColor8Scalar(uchar* const data, uint start, uint count, const uchar color[4])
+{
+    uchar* ptr = data + 4 * start;
+
+    for (uint i = start ; i < count ; ++i, ptr += 4)
+    {
+        const uint sa  = ptr[3] + 1;
+        const uint inv = 256 - ptr[3];
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            ptr[c] = qMin(((sa * ptr[c]) >> 8) + ((inv * color[c]) >> 8), 255U);
+        }
+    }
+}
+
+static void blendOnColor16Scalar(ushort* const data, uint start, uint count, const ushort color[4])
+{
+    ushort* ptr = data + 4 * start;
+
+    for (uint i = start ; i < count ; ++i, ptr += 4)
+    {
+        const uint sa  = ptr[3] + 1;
+        const uint inv = 65536 - ptr[3];
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            ptr[c] = qMin(((sa * ptr[c]) >> 16) + ((inv * color[c]) >> 16), 65535U);
+        }
+    }
+}
+
+static void squaredDistancesScalar(const float* const query, const float* const data,
+                                   size_t rows, size_t stride, float* const out)
+{
+    // Sum in 8 lanes, in the order of the SIMD versions.
+
+    for (size_t r = 0 ; r < rows ; ++r)
+    {
+        const float* const row = data + r * stride;
+        float lanes[8]         = { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+
+        for (size_t i = 0 ; i < stride ; ++i)
+        {
+            const float diff = row[i] - query[i];
+            lanes[i % 8]    += diff * diff;
+        }
+
+        out[r] = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+    }
+}
+
+template <typename T>
+static void resampleRowScalar(const T* const src, float* const dst, uint count,
+                              const int* const starts, const int* const sizes,
+                              const float* const weights, int stride)
+{
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        const T* const     sptr = src + 4 * starts[i];
+        const float* const w    = weights + i * stride;
+        float              acc[4] = { 0.0F, 0.0F, 0.0F, 0.0F };
+
+        for (int k = 0 ; k < sizes[i] ; ++k)
+        {
+            for (int c = 0 ; c < 4 ; ++c)
+            {
+                acc[c] = acc[c] + w[k] * (float)sptr[4*k + c];
+            }
+        }
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            dst[4*i + c] = acc[c];
+        }
+    }
+}
+
+/// The values in [start, count[.
+template <typename T>
+static void resampleColumnScalar(const float* const* const rows, const float* const weights, int size,
+                                 T* const dst, uint start, uint count, float max)
+{
+    for (uint j = start ; j < count ; ++j)
+    {
+        float acc = 0.0F;
+
+        for (int k = 0 ; k < size ; ++k)
+        {
+            acc = acc + rows[k][j] * weights[k];
+        }
+
+        dst[j] = (T)(qBound(0.0F, acc, max) + 0.5F);
+    }
+}
+
+#ifdef DIMG_KERNELS_X86
+
+// --- SSE4.1 versions --------------------------------------------------------------
+
+DIMG_TARGET_SSE41 static void convert16To8SSE41(const ushort* const src, uchar* const dst, uint count)
+{
+    uint i = 0;
+
+    for ( ; i + 16 <= count ; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+
+    convert16To8Scalar(src, dst, i, count);
+}
+
+DIMG_TARGET_SSE41 static void convert8To16SSE41(const uchar* const src, ushort* const dst, uint count)
+{
+    uint i = 0;
+
+    for ( ; i + 8 <= count ; i += 8)
+    {
+        __m128i v = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_slli_epi16(v, 8));
+    }
+
+    convert8To16Scalar(src, dst, i, count);
+}
+
+DIMG_TARGET_SSE41 static void bgraToRgbSSE41(const uchar* const src, uchar* const dst, uint count)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    uint i                = 0;
+
+    for ( ; i + 4 <= count ; i += 4)
+    {
+        __m128i v    = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4*i)), shuffle);
+        int     tail = _mm_extract_epi32(v, 2);
+
+        // 12 bytes of output: do not write over the next pixels.
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 3*i), v);
+        memcpy(dst + 3*i + 8, &tail, 4);
+    }
+
+    bgraToRgbScalar(src, dst, i, count);
+}
+
+DIMG_TARGET_SSE41 static void blendOnColor8SSE41(uchar* const data, uint count, const uchar color[4])
+{
+    // 2 pixels in 8 words: the products fit in 16 bits, the sums are saturated by the packing.
+
+    const __m128i alpha = _mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+    const __m128i one   = _mm_set1_epi16(1);
+    const __m128i range = _mm_set1_epi16(256);
+    const __m128i bg    = _mm_setr_epi16(color[0], color[1], color[2], color[3],
+                                         color[0], color[1], color[2], color[3]);
+    uint i              = 0;
+
+    for ( ; i + 4 <= count ; i += 4)
+    {
+        __m128i v      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4*i));
+        __m128i out[2];
+
+        for (int h = 0 ; h < 2 ; ++h)
+        {
+            __m128i p = _mm_cvtepu8_epi16(h ? _mm_srli_si128(v, 8) : v);
+            __m128i a = _mm_shuffle_epi8(p, alpha);
+            out[h]    = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(p,  _mm_add_epi16(a, one)), 8),
+                                      _mm_srli_epi16(_mm_mullo_epi16(bg, _mm_sub_epi16(range, a)), 8));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4*i), _mm_packus_epi16(out[0], out[1]));
+    }
+
+    blendOnColor8Scalar(data, i, count, color);
+}
+
+DIMG_TARGET_SSE41 static void blendOnColor16SSE41(ushort* const data, uint count, const ushort color[4])
+{
+    // 1 pixel in 4 double words: the sums are saturated by the packing.
+
+    const __m128i one   = _mm_set1_epi32(1);
+    const __m128i range = _mm_set1_epi32(65536);
+    const __m128i bg    = _mm_setr_epi32(color[0], color[1], color[2], color[3]);
+    uint i              = 0;
+
+    for ( ; i + 2 <= count ; i += 2)
+    {
+        __m128i v      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4*i));
+        __m128i out[2];
+
+        for (int h = 0 ; h < 2 ; ++h)
+        {
+            __m128i p = _mm_cvtepu16_epi32(h ? _mm_srli_si128(v, 8) : v);
+            __m128i a = _mm_shuffle_epi32(p, _MM_SHUFFLE(3, 3, 3, 3));
+            out[h]    = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi32(p,  _mm_add_epi32(a, one)), 16),
+                                      _mm_srli_epi32(_mm_mullo_epi32(bg, _mm_sub_epi32(range, a)), 16));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4*i), _mm_packus_epi32(out[0], out[1]));
+    }
+
+    blendOnColor16Scalar(data, i, count, color);
+}
+
+DIMG_TARGET_SSE41 static void squaredDistancesSSE41(const float* const query, const float* const data,
+                                                    size_t rows, size_t stride, float* const out)
+{
+    for (size_t r = 0 ; r < rows ; ++r)
+    {
+        const float* const row = data + r * stride;
+        __m128 acc0            = _mm_setzero_ps();
+        __m128 acc1            = _mm_setzero_ps();
+
+        for (size_t i = 0 ; i < stride ; i += 8)
+        {
+            __m128 d0 = _mm_sub_ps(_mm_loadu_ps(row + i),     _mm_loadu_ps(query + i));
+            __m128 d1 = _mm_sub_ps(_mm_loadu_ps(row + i + 4), _mm_loadu_ps(query + i + 4));
+            acc0      = _mm_add_ps(acc0, _mm_mul_ps(d0, d0));
+            acc1      = _mm_add_ps(acc1, _mm_mul_ps(d1, d1));
+        }
+
+        float sums[4];
+        _mm_storeu_ps(sums, _mm_add_ps(acc0, acc1));
+        out[r] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+}
+
+DIMG_TARGET_SSE41 static inline __m128 resamplePixelSSE41(const uchar* const sptr)
+{
+    int v;
+    memcpy(&v, sptr, 4);
+
+    return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(v)));
+}
+
+DIMG_TARGET_SSE41 static inline __m128 resamplePixelSSE41(const ushort* const sptr)
+{
+    return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sptr))));
+}
+
+template <typename T>
+DIMG_TARGET_SSE41 static void resampleRowSSE41(const T* const src, float* const dst, uint count,
+                                               const int* const starts, const int* const sizes,
+                                               const float* const weights, int stride)
+{
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        const T* const     sptr = src + 4 * starts[i];
+        const float* const w    = weights + i * stride;
+        __m128             acc  = _mm_setzero_ps();
+
+        for (int k = 0 ; k < sizes[i] ; ++k)
+        {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), resamplePixelSSE41(sptr + 4*k)));
+        }
+
+        _mm_storeu_ps(dst + 4*i, acc);
+    }
+}
+
+/// The 4 rounded and clamped values at offset j of the weighted rows.
+DIMG_TARGET_SSE41 static inline __m128i resampleColumnSSE41(const float* const* const rows, const float* const weights,
+                                                            int size, uint j, const __m128 max)
+{
+    __m128 acc = _mm_setzero_ps();
+
+    for (int k = 0 ; k < size ; ++k)
+    {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[k] + j), _mm_set1_ps(weights[k])));
+    }
+
+    acc = _mm_min_ps(_mm_max_ps(acc, _mm_setzero_ps()), max);
+
+    return _mm_cvttps_epi32(_mm_add_ps(acc, _mm_set1_ps(0.5F)));
+}
+
+DIMG_TARGET_SSE41 static void resampleColumn8SSE41(const float* const* const rows, const float* const weights, int size,
+                                                   uchar* const dst, uint count)
+{
+    const __m128 max = _mm_set1_ps(255.0F);
+    uint j           = 0;
+
+    for ( ; j + 4 <= count ; j += 4)
+    {
+        __m128i v = resampleColumnSSE41(rows, weights, size, j, max);
+        v         = _mm_packus_epi16(_mm_packus_epi32(v, v), v);
+        int out   = _mm_cvtsi128_si32(v);
+        memcpy(dst + j, &out, 4);
+    }
+
+    resampleColumnScalar(rows, weights, size, dst, j, count, 255.0F);
+}
+
+DIMG_TARGET_SSE41 static void resampleColumn16SSE41(const float* const* const rows, const float* const weights, int size,
+                                                    ushort* const dst, uint count)
+{
+    const __m128 max = _mm_set1_ps(65535.0F);
+    uint j           = 0;
+
+    for ( ; j + 4 <= count ; j += 4)
+    {
+        __m128i v = resampleColumnSSE41(rows, weights, size, j, max);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + j), _mm_packus_epi32(v, v));
+    }
+
+    resampleColumnScalar(rows, weights, size, dst, j, count, 65535.0F);
+}
+
+// --- AVX2 versions ----------------------------------------------------------------
+
+DIMG_TARGET_AVX2 static void applyLut8AVX2(const uchar* const src, uchar* const dst, uint count,
+                                           const int* const luts[4])
+{
+    const __m256i channelMask = _mm256_set1_epi32(0xFF);
+    const __m256i zero        = _mm256_setzero_si256();
+    const __m256i maxValue    = _mm256_set1_epi32(255);
+    uint i                    = 0;
+
+    // 8 pixels, one per 32 bits lane.
+    for ( ; i + 8 <= count ; i += 8)
+    {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4*i));
+        __m256i result = zero;
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            __m128i shift = _mm_cvtsi32_si128(8 * c);
+
+            if (luts[c])
+            {
+                __m256i index = _mm256_and_si256(_mm256_srl_epi32(pixels, shift), channelMask);
+                __m256i value = _mm256_i32gather_epi32(luts[c], index, 4);
+                value         = _mm256_min_epi32(_mm256_max_epi32(value, zero), maxValue);
+                result        = _mm256_or_si256(result, _mm256_sll_epi32(value, shift));
+            }
+            else
+            {
+                result        = _mm256_or_si256(result, _mm256_and_si256(pixels, _mm256_sll_epi32(channelMask, shift)));
+            }
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), result);
+    }
+
+    applyLut8Scalar(src, dst, i, count, luts);
+}
+
+DIMG_TARGET_AVX2 static void applyLut16AVX2(const ushort* const src, ushort* const dst, uint count,
+                                            const int* const luts[4])
+{
+    const __m256i channelMask = _mm256_set1_epi64x(0xFFFF);
+    const __m256i zero        = _mm256_setzero_si256();
+    const __m128i zero128     = _mm_setzero_si128();
+    const __m128i maxValue    = _mm_set1_epi32(65535);
+    uint i                    = 0;
+
+    // 4 pixels, one per 64 bits lane.
+    for ( ; i + 4 <= count ; i += 4)
+    {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4*i));
+        __m256i result = zero;
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            __m128i shift = _mm_cvtsi32_si128(16 * c);
+
+            if (luts[c])
+            {
+                __m256i index = _mm256_and_si256(_mm256_srl_epi64(pixels, shift), channelMask);
+                __m128i value = _mm256_i64gather_epi32(luts[c], index, 4);
+                value         = _mm_min_epi32(_mm_max_epi32(value, zero128), maxValue);
+                result        = _mm256_or_si256(result, _mm256_sll_epi64(_mm256_cvtepu32_epi64(value), shift));
+            }
+            else
+            {
+                result        = _mm256_or_si256(result, _mm256_and_si256(pixels, _mm256_sll_epi64(channelMask, shift)));
+            }
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), result);
+    }
+
+    applyLut16Scalar(src, dst, i, count, luts);
+}
+
+DIMG_TARGET_AVX2 static void convert16To8AVX2(const ushort* const src, uchar* const dst, uint count)
+{
+    uint i = 0;
+
+    for ( ; i + 32 <= count ; i += 32)
+    {
+        __m256i a = _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)),      8);
+        __m256i b = _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16)), 8);
+
+        // The pack works on each 128 bits lane: put the quarters back in order.
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+    }
+
+    convert16To8Scalar(src, dst, i, count);
+}
+
+DIMG_TARGET_AVX2 static void convert8To16AVX2(const uchar* const src, ushort* const dst, uint count)
+{
+    uint i = 0;
+
+    for ( ; i + 16 <= count ; i += 16)
+    {
+        __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_slli_epi16(v, 8));
+    }
+
+    convert8To16Scalar(src, dst, i, count);
+}
+
+DIMG_TARGET_AVX2 static void bgraToRgbAVX2(const uchar* const src, uchar* const dst, uint count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i pack    = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    uint i                = 0;
+
+    for ( ; i + 8 <= count ; i += 8)
+    {
+        __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4*i)), shuffle);
+        v         = _mm256_permutevar8x32_epi32(v, pack);
+
+        // 24 bytes of output.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3*i),      _mm256_castsi256_si128(v));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 3*i + 16), _mm256_extracti128_si256(v, 1));
+    }
+
+    bgraToRgbScalar(src, dst, i, count);
+}
+
+/// The 8 rounded and clamped values at offset j of the weighted rows.
+DIMG_TARGET_AVX2 static inline __m256i resampleColumnAVX2(const float* const* const rows, const float* const weights,
+                                                          int size, uint j, const __m256 max)
+{
+    __m256 acc = _mm256_setzero_ps();
+
+    for (int k = 0 ; k < size ; ++k)
+    {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + j), _mm256_set1_ps(weights[k])));
+    }
+
+    acc = _mm256_min_ps(_mm256_max_ps(acc, _mm256_setzero_ps()), max);
+
+    return _mm256_cvttps_epi32(_mm256_add_ps(acc, _mm256_set1_ps(0.5F)));
+}
+
+DIMG_TARGET_AVX2 static void resampleColumn8AVX2(const float* const* const rows, const float* const weights, int size,
+                                                 uchar* const dst, uint count)
+{
+    const __m256 max = _mm256_set1_ps(255.0F);
+    uint j           = 0;
+
+    for ( ; j + 8 <= count ; j += 8)
+    {
+        __m256i v  = resampleColumnAVX2(rows, weights, size, j, max);
+        __m128i lo = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + j), _mm_packus_epi16(lo, lo));
+    }
+
+    resampleColumnScalar(rows, weights, size, dst, j, count, 255.0F);
+}
+
+DIMG_TARGET_AVX2 static void resampleColumn16AVX2(const float* const* const rows, const float* const weights, int size,
+                                                  ushort* const dst, uint count)
+{
+    const __m256 max = _mm256_set1_ps(65535.0F);
+    uint j           = 0;
+
+    for ( ; j + 8 <= count ; j += 8)
+    {
+        __m256i v = resampleColumnAVX2(rows, weights, size, j, max);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j),
+                         _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+
+    resampleColumnScalar(rows, weights, size, dst, j, count, 65535.0F);
+}
+
+DIMG_TARGET_AVX2 static void squaredDistancesAVX2(const float* const query, const float* const data,
+                                                  size_t rows, size_t stride, float* const out)
+{
+    for (size_t r = 0 ; r < rows ; ++r)
+    {
+        const float* const row = data + r * stride;
+        __m256 acc             = _mm256_setzero_ps();
+
+        for (size_t i = 0 ; i < stride ; i += 8)
+        {
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(row + i), _mm256_loadu_ps(query + i));
+            acc      = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+        }
+
+        float sums[4];
+        _mm_storeu_ps(sums, _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+        out[r] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+}
+
+#endif // DIMG_KERNELS_X86
+
+// --- Dispatch ---------------------------------------------------------------------
+
+class Q_DECL_HIDDEN KernelsState
+{
+public:
+
+    KernelsState()
+        : best(Scalar)
+    {
+#ifdef DIMG_KERNELS_X86
+
+        __builtin_cpu_init();
+
+        if      (__builtin_cpu_supports("avx2"))
+        {
+            best = AVX2;
+        }
+        else if (__builtin_cpu_supports("sse4.1"))
+        {
+            best = SSE41;
+        }
+
+#endif
+
+        current = best;
+    }
+
+    InstructionSet best;
+    InstructionSet current;
+};
+
+static KernelsState& state()
+{
+    static KernelsState s;
+
+    return s;
+}
+
+InstructionSet bestInstructionSet()
+{
+    return state().best;
+}
+
+InstructionSet instructionSet()
+{
+    return state().current;
+}
+
+void setInstructionSet(InstructionSet set)
+{
+    state().current = qMin(set, state().best);
+}
+
+const char* instructionSetName(InstructionSet set)
+{
+    switch (set)
+    {
+        case AVX2:
+            return "AVX2";
+
+        case SSE41:
+            return "SSE4.1";
+
+        default:
+            return "Scalar";
+    }
+}
+
+void applyLut8(const uchar* const src, uchar* const dst, uint count, const int* const luts[4])
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            applyLut8AVX2(src, dst, count, luts);
+            break;
+#endif
+        default:
+            applyLut8Scalar(src, dst, 0, count, luts);
+            break;
+    }
+}
+
+void applyLut16(const ushort* const src, ushort* const dst, uint count, const int* const luts[4])
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            applyLut16AVX2(src, dst, count, luts);
+            break;
+#endif
+        default:
+            applyLut16Scalar(src, dst, 0, count, luts);
+            break;
+    }
+}
+
+void convert16To8(const ushort* const src, uchar* const dst, uint count)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            convert16To8AVX2(src, dst, count);
+            break;
+
+        case SSE41:
+            convert16To8SSE41(src, dst, count);
+            break;
+#endif
+        default:
+            convert16To8Scalar(src, dst, 0, count);
+            break;
+    }
+}
+
+void convert8To16(const uchar* const src, ushort* const dst, uint count)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            convert8To16AVX2(src, dst, count);
+            break;
+
+        case SSE41:
+            convert8To16SSE41(src, dst, count);
+            break;
+#endif
+        default:
+            convert8To16Scalar(src, dst, 0, count);
+            break;
+    }
+}
+
+void bgraToArgb32(const uchar* const src, uint* const dst, uint count)
+{
+    bgraToArgb32Scalar(src, dst, count);
+}
+
+void argb32ToBgra(const uint* const src, uchar* const dst, uint count)
+{
+    argb32ToBgraScalar(src, dst, count);
+}
+
+void bgra16ToArgb32(const ushort* const src, uint* const dst, uint count)
+{
+    if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+    {
+        convert16To8(src, reinterpret_cast<uchar*>(dst), count * 4);
+        return;
+    }
+
+    const ushort* sptr = src;
+
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        dst[i] = qRgba(sptr[2] >> 8, sptr[1] >> 8, sptr[0] >> 8, sptr[3] >> 8);
+        sptr  += 4;
+    }
+}
+
+void bgraToRgb(const uchar* const src, uchar* const dst, uint count)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            bgraToRgbAVX2(src, dst, count);
+            break;
+
+        case SSE41:
+            bgraToRgbSSE41(src, dst, count);
+            break;
+#endif
+        default:
+            bgraToRgbScalar(src, dst, 0, count);
+            break;
+    }
+}
+
+void blendOnColor8(uchar* const data, uint count, const uchar color[4])
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+        case SSE41:
+            blendOnColor8SSE41(data, count, color);
+            break;
+#endif
+        default:
+            blendOnColor8Scalar(data, 0, count, color);
+            break;
+    }
+}
+
+void blendOnColor16(ushort* const data, uint count, const ushort color[4])
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+        case SSE41:
+            blendOnColor16SSE41(data, count, color);
+            break;
+#endif
+        default:
+            blendOnColor16Scalar(data, 0, count, color);
+            break;
+    }
+}
+
+void resampleRow8(const uchar* const src, float* const dst, uint count,
+                  const int* const starts, const int* const sizes,
+                  const float* const weights, int stride)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+        case SSE41:
+            resampleRowSSE41(src, dst, count, starts, sizes, weights, stride);
+            break;
+#endif
+        default:
+            resampleRowScalar(src, dst, count, starts, sizes, weights, stride);
+            break;
+    }
+}
+
+void resampleRow16(const ushort* const src, float* const dst, uint count,
+                   const int* const starts, const int* const sizes,
+                   const float* const weights, int stride)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+        case SSE41:
+            resampleRowSSE41(src, dst, count, starts, sizes, weights, stride);
+            break;
+#endif
+        default:
+            resampleRowScalar(src, dst, count, starts, sizes, weights, stride);
+            break;
+    }
+}
+
+void resampleColumn8(const float* const* const rows, const float* const weights, int size,
+                     uchar* const dst, uint count)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            resampleColumn8AVX2(rows, weights, size, dst, count);
+            break;
+
+        case SSE41:
+            resampleColumn8SSE41(rows, weights, size, dst, count);
+            break;
+#endif
+        default:
+            resampleColumnScalar(rows, weights, size, dst, 0, count, 255.0F);
+            break;
+    }
+}
+
+void resampleColumn16(const float* const* const rows, const float* const weights, int size,
+                      ushort* const dst, uint count)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            resampleColumn16AVX2(rows, weights, size, dst, count);
+            break;
+
+        case SSE41:
+            resampleColumn16SSE41(rows, weights, size, dst, count);
+            break;
+#endif
+        default:
+            resampleColumnScalar(rows, weights, size, dst, 0, count, 65535.0F);
+            break;
+    }
+}
+
+void squaredDistances(const float* const query, const float* const data,
+                      size_t rows, size_t stride, float* const out)
+{
+    switch (instructionSet())
+    {
+#ifdef DIMG_KERNELS_X86
+        case AVX2:
+            squaredDistancesAVX2(query, data, rows, stride, out);
+            break;
+
+        case SSE41:
+            squaredDistancesSSE41(query, data, rows, stride, out);
+            break;
+#endif
+        default:
+            squaredDistancesScalar(query, data, rows, stride, out);
+            break;
+    }
+}
+
+} // namespace DImgKernels
+
+} // namespace Digikam
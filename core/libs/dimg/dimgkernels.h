@@ -0,0 +1,148 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : Vectorized kernels for look-up tables and
+ *               pixel format conversions of DImg buffers
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_KERNELS_H
+#define DIGIKAM_DIMG_KERNELS_H
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/** The inner loops shared by the DImg conversions and the look-up table filters.
+ *  Each kernel exists as portable C++ code and, on x86 with GCC or Clang,
+ *  as SSE4.1 and AVX2 versions selected at runtime from the CPU features.
+ *  All versions return the same pixels.
+ *
+ *  The pixels are DImg pixels, in B, G, R, A order, of 8 or 16 bits per channel.
+ *  Source and destination can be the same buffer when they have the same depth.
+ */
+namespace DImgKernels
+{
+
+enum InstructionSet
+{
+    Scalar = 0,
+    SSE41,
+    AVX2
+};
+
+/** The best instruction set supported by the CPU and this build.
+ */
+DIGIKAM_EXPORT InstructionSet bestInstructionSet();
+
+/** The instruction set used by the kernels. Defaults to bestInstructionSet().
+ */
+DIGIKAM_EXPORT InstructionSet instructionSet();
+
+/** Force the instruction set used by the kernels, for testing and benchmarking.
+ *  The value is clamped to bestInstructionSet(). Not thread-safe.
+ */
+DIGIKAM_EXPORT void setInstructionSet(InstructionSet set);
+
+DIGIKAM_EXPORT const char* instructionSetName(InstructionSet set);
+
+/** Map each channel of count pixels through a look-up table, in B, G, R, A order.
+ *  A null table leaves the channel unchanged. The tables have 256 entries for 8 bits pixels,
+ *  65536 entries for 16 bits pixels, and their values are clamped to the channel range.
+ *  The table look-ups use the AVX2 gather instructions, SSE4.1 uses the portable code.
+ */
+DIGIKAM_EXPORT void applyLut8(const uchar* const src, uchar* const dst, uint count,
+                              const int* const luts[4]);
+
+DIGIKAM_EXPORT void applyLut16(const ushort* const src, ushort* const dst, uint count,
+                               const int* const luts[4]);
+
+/** Depth conversion of count channel values, as done by DImg::convertDepth():
+ *  16 bits values are truncated to their high byte, 8 bits values are multiplied by 256.
+ */
+DIGIKAM_EXPORT void convert16To8(const ushort* const src, uchar* const dst, uint count);
+
+DIGIKAM_EXPORT void convert8To16(const uchar* const src, ushort* const dst, uint count);
+
+/** Conversion of count pixels between DImg 8 bits pixels and QImage::Format_ARGB32 pixels.
+ *  On little-endian hosts the two formats have the same layout in memory.
+ */
+DIGIKAM_EXPORT void bgraToArgb32(const uchar* const src, uint* const dst, uint count);
+
+DIGIKAM_EXPORT void argb32ToBgra(const uint* const src, uchar* const dst, uint count);
+
+/** Conversion of count 16 bits pixels to QImage::Format_ARGB32 pixels,
+ *  the same as convert16To8() followed by bgraToArgb32().
+ */
+DIGIKAM_EXPORT void bgra16ToArgb32(const ushort* const src, uint* const dst, uint count);
+
+/** Removal of the alpha channel: count 8 bits pixels to packed R, G, B bytes,
+ *  as written to the image files without alpha channel.
+ */
+DIGIKAM_EXPORT void bgraToRgb(const uchar* const src, uchar* const dst, uint count);
+
+/** Blend count pixels in place on a background color, as DImg::bitBlendImageOnColor()
+ *  with the Porter-Duff None composer: each channel becomes
+ *  (c * (a + 1) + color * (range + 1 - a)) >> bits, clamped, where a is the pixel alpha.
+ *  The color is given in B, G, R, A order, in the depth of the pixels. AVX2 uses the SSE4.1 version.
+ */
+DIGIKAM_EXPORT void blendOnColor8(uchar* const data, uint count, const uchar color[4]);
+
+DIGIKAM_EXPORT void blendOnColor16(ushort* const data, uint count, const ushort color[4]);
+
+/** Horizontal pass of DImgResampler, for count destination pixels: the pixel i is the sum
+ *  of sizes[i] source pixels from starts[i], weighted by the values at weights + i * stride.
+ *  The results are stored as 4 floats per pixel. AVX2 uses the SSE4.1 version.
+ */
+DIGIKAM_EXPORT void resampleRow8(const uchar* const src, float* const dst, uint count,
+                                 const int* const starts, const int* const sizes,
+                                 const float* const weights, int stride);
+
+DIGIKAM_EXPORT void resampleRow16(const ushort* const src, float* const dst, uint count,
+                                  const int* const starts, const int* const sizes,
+                                  const float* const weights, int stride);
+
+/** Vertical pass of DImgResampler, for count channel values: the sum of size rows of floats
+ *  weighted by weights, rounded and clamped to the channel range.
+ */
+DIGIKAM_EXPORT void resampleColumn8(const float* const* const rows, const float* const weights, int size,
+                                    uchar* const dst, uint count);
+
+DIGIKAM_EXPORT void resampleColumn16(const float* const* const rows, const float* const weights, int size,
+                                     ushort* const dst, uint count);
+
+/** The squared euclidean distances of query to rows vectors of floats stored every stride values,
+ *  as used by the face recognition index. The stride must be a multiple of 8,
+ *  the values after the vector size must be the same zeros in query and data.
+ */
+DIGIKAM_EXPORT void squaredDistances(const float* const query, const float* const data,
+                                     size_t rows, size_t stride, float* const out);
+
+} // namespace DImgKernels
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_KERNELS_H
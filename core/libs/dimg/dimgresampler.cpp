@@ -0,0 +1,347 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : Multithreaded separable resampler of DImg images
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgresampler.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QFuture>
+#include <QVector>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "dimgkernels.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN DImgResampler::Private
+{
+public:
+
+    /** The filter weights of one direction: the destination pixel i is the sum of sizes[i]
+     *  source pixels from starts[i], weighted by the values at weights + i * stride.
+     */
+    class Q_DECL_HIDDEN Axis
+    {
+    public:
+
+        explicit Axis(Kernel kernel, int imageSize, int sourceStart, int sourceSize,
+                      int destSize, int clipStart, int clipSize);
+
+        QVector<int>   starts;
+        QVector<int>   sizes;
+        QVector<float> weights;
+        int            stride;
+        int            maxSize;
+    };
+
+    /** The destination rows [start, end[ of the clip.
+     */
+    class Q_DECL_HIDDEN Chunk
+    {
+    public:
+
+        const DImg* img;
+        DImg*       dest;
+        const Axis* xaxis;
+        const Axis* yaxis;
+        int         start;
+        int         end;
+    };
+
+public:
+
+    static double radius(Kernel kernel);
+    static double value(Kernel kernel, double x);
+
+    static void resampleRows(const Chunk& chunk);
+};
+
+double DImgResampler::Private::radius(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Lanczos3:
+            return 3.0;
+
+        case Bilinear:
+            return 1.0;
+
+        default:
+            return 0.5;
+    }
+}
+
+double DImgResampler::Private::value(Kernel kernel, double x)
+{
+    switch (kernel)
+    {
+        case Lanczos3:
+        {
+            if (x == 0.0)
+            {
+                return 1.0;
+            }
+
+            if (x <= -3.0 || x >= 3.0)
+            {
+                return 0.0;
+            }
+
+            const double px = M_PI * x;
+
+            return (3.0 * sin(px) * sin(px / 3.0) / (px * px));
+        }
+
+        case Bilinear:
+        {
+            x = fabs(x);
+
+            return (x < 1.0 ? 1.0 - x : 0.0);
+        }
+
+        default:
+        {
+            // Not used by Axis, which integrates the box over the source pixels.
+            return ((x >= -0.5 && x < 0.5) ? 1.0 : 0.0);
+        }
+    }
+}
+
+DImgResampler::Private::Axis::Axis(Kernel kernel, int imageSize, int sourceStart, int sourceSize,
+                                   int destSize, int clipStart, int clipSize)
+    : starts(clipSize),
+      sizes(clipSize),
+      maxSize(1)
+{
+    // When reducing, the kernel is widened to cover all the source pixels of a destination pixel.
+
+    const double scale       = (double)sourceSize / destSize;
+    const double filterScale = qMax(scale, 1.0);
+    const double support     = radius(kernel) * filterScale;
+    stride                   = (int)ceil(2.0 * support) + 2;
+    weights.resize(clipSize * stride);
+
+    QVector<double> w(stride);
+
+    for (int i = 0 ; i < clipSize ; ++i)
+    {
+        // Centers of the pixels at half integer coordinates.
+
+        const double center = sourceStart + (clipStart + i + 0.5) * scale;
+        int left            = qMax(0,         (int)floor(center - support));
+        int right           = qMin(imageSize, (int)ceil(center + support));
+        double total        = 0.0;
+        int count           = 0;
+
+        for (int k = left ; k < right && count < stride ; ++k)
+        {
+            if (kernel == Box)
+            {
+                // The part of the source pixel [k, k + 1[ covered by the destination pixel:
+                // the partly covered pixels at both ends count for their covered fraction.
+                w[count] = qMax(0.0, qMin(k + 1.0, center + support) - qMax((double)k, center - support));
+            }
+            else
+            {
+                w[count] = value(kernel, (k + 0.5 - center) / filterScale);
+            }
+
+            total   += w[count];
+            ++count;
+        }
+
+        // Skip the null weights at both ends.
+
+        int first = 0;
+
+        while (first < count && w[first] == 0.0)
+        {
+            ++first;
+        }
+
+        while (count > first && w[count - 1] == 0.0)
+        {
+            --count;
+        }
+
+        float* const dst = weights.data() + i * stride;
+
+        if (total == 0.0 || first == count)
+        {
+            starts[i] = qBound(0, (int)center, imageSize - 1);
+            sizes[i]  = 1;
+            dst[0]    = 1.0F;
+            continue;
+        }
+
+        starts[i] = left + first;
+        sizes[i]  = count - first;
+        maxSize   = qMax(maxSize, sizes[i]);
+
+        for (int k = first ; k < count ; ++k)
+        {
+            dst[k - first] = (float)(w[k] / total);
+        }
+    }
+}
+
+void DImgResampler::Private::resampleRows(const Chunk& chunk)
+{
+    // The horizontal pass results are kept in a ring of rows indexed by the source row,
+    // large enough for the rows of one destination row. Rows shared by the next destination
+    // rows are computed once.
+
+    const bool sixteenBit = chunk.img->sixteenBit();
+    const uint values     = chunk.dest->width() * 4;
+    const int  ringSize   = chunk.yaxis->maxSize;
+    QVector<float>          ring(ringSize * values);
+    QVector<int>            slots(ringSize, -1);
+    QVector<const float*>   rows(ringSize);
+
+    for (int j = chunk.start ; j < chunk.end ; ++j)
+    {
+        const int start = chunk.yaxis->starts[j];
+        const int size  = chunk.yaxis->sizes[j];
+
+        for (int k = 0 ; k < size ; ++k)
+        {
+            const int y       = start + k;
+            const int slot    = y % ringSize;
+            float* const line = ring.data() + slot * values;
+
+            if (slots[slot] != y)
+            {
+                if (sixteenBit)
+                {
+                    DImgKernels::resampleRow16(reinterpret_cast<const ushort*>(chunk.img->scanLine(y)), line,
+                                               chunk.dest->width(), chunk.xaxis->starts.constData(),
+                                               chunk.xaxis->sizes.constData(), chunk.xaxis->weights.constData(),
+                                               chunk.xaxis->stride);
+                }
+                else
+                {
+                    DImgKernels::resampleRow8(chunk.img->scanLine(y), line,
+                                              chunk.dest->width(), chunk.xaxis->starts.constData(),
+                                              chunk.xaxis->sizes.constData(), chunk.xaxis->weights.constData(),
+                                              chunk.xaxis->stride);
+                }
+
+                slots[slot] = y;
+            }
+
+            rows[k] = line;
+        }
+
+        const float* const weights = chunk.yaxis->weights.constData() + j * chunk.yaxis->stride;
+
+        if (sixteenBit)
+        {
+            DImgKernels::resampleColumn16(rows.constData(), weights, size,
+                                          reinterpret_cast<ushort*>(chunk.dest->scanLine(j)), values);
+        }
+        else
+        {
+            DImgKernels::resampleColumn8(rows.constData(), weights, size,
+                                         chunk.dest->scanLine(j), values);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+
+DImg DImgResampler::scale(const DImg& img, const QSize& destSize, Kernel kernel,
+                          Qt::AspectRatioMode aspectRatioMode)
+{
+    QSize scaleSize = img.size();
+    scaleSize.scale(destSize, aspectRatioMode);
+
+    if (img.isNull() || scaleSize.isEmpty())
+    {
+        return DImg();
+    }
+
+    DImg dest(img, scaleSize.width(), scaleSize.height());
+    scale(img, QRect(QPoint(0, 0), img.size()), scaleSize, QRect(QPoint(0, 0), scaleSize), dest, kernel);
+
+    return dest;
+}
+
+void DImgResampler::scale(const DImg& img, const QRect& sourceRect, const QSize& destSize,
+                          const QRect& clip, DImg& dest, Kernel kernel)
+{
+    const Private::Axis xaxis(kernel, img.width(), sourceRect.x(), sourceRect.width(),
+                              destSize.width(), clip.x(), clip.width());
+    const Private::Axis yaxis(kernel, img.height(), sourceRect.y(), sourceRect.height(),
+                              destSize.height(), clip.y(), clip.height());
+
+    // The chunks of rows are counted on the larger of the source and destination sizes.
+
+    const qint64 pixels     = qMax((qint64)sourceRect.width() * sourceRect.height(),
+                                   (qint64)clip.width() * clip.height());
+    const QList<int> chunks = DImg::rowChunks(clip.height(), pixels);
+    QList<QFuture<void> > tasks;
+
+    for (int c = chunks.size() - 2 ; c >= 0 ; --c)
+    {
+        Private::Chunk chunk;
+        chunk.img   = &img;
+        chunk.dest  = &dest;
+        chunk.xaxis = &xaxis;
+        chunk.yaxis = &yaxis;
+        chunk.start = chunks[c];
+        chunk.end   = chunks[c + 1];
+
+        if (c > 0)
+        {
+            tasks << QtConcurrent::run(&Private::resampleRows, chunk);
+        }
+        else
+        {
+            Private::resampleRows(chunk);
+        }
+    }
+
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+}
+
+DImgResampler::Kernel DImgResampler::smoothScaleKernel(const QSize& sourceSize, const QSize& destSize)
+{
+    if (destSize.width() <= sourceSize.width() && destSize.height() <= sourceSize.height())
+    {
+        return Box;
+    }
+
+    return Bilinear;
+}
+
+} // namespace Digikam
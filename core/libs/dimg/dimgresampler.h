@@ -0,0 +1,94 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : Multithreaded separable resampler of DImg images
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_RESAMPLER_H
+#define DIGIKAM_DIMG_RESAMPLER_H
+
+// Qt includes
+
+#include <QRect>
+#include <QSize>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+namespace Digikam
+{
+
+/** Scaling of 8 and 16 bits images with a separable filter: a horizontal pass followed by
+ *  a vertical pass, computed in floating point with the vectorized DImgKernels.
+ *  The destination rows are split between the threads of the global thread pool.
+ *  The alpha channel is resampled as the color channels.
+ *
+ *  This is the engine of DImg::smoothScale() and its variants.
+ */
+class DIGIKAM_EXPORT DImgResampler
+{
+public:
+
+    enum Kernel
+    {
+        /// Average of the source pixels covered by each destination pixel, weighted by the covered area.
+        Box = 0,
+        /// Linear interpolation, widened to the covered source pixels when reducing.
+        Bilinear,
+        /// Windowed sinc with three lobes: the sharpest result, with slight ringing on hard edges.
+        Lanczos3
+    };
+
+public:
+
+    /** Return the image scaled to destSize with the kernel.
+     */
+    static DImg scale(const DImg& img, const QSize& destSize, Kernel kernel,
+                      Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio);
+
+    /** Scale the section sourceRect of img to destSize and write the region clip of the result
+     *  to dest, which must be an image of the size of clip with the depth of img.
+     *  sourceRect and clip must be valid.
+     */
+    static void scale(const DImg& img, const QRect& sourceRect, const QSize& destSize,
+                      const QRect& clip, DImg& dest, Kernel kernel);
+
+    /** The kernel used by DImg::smoothScale(): Box when reducing in both directions,
+     *  Bilinear otherwise, as the Imlib2 scaler used before.
+     */
+    static Kernel smoothScaleKernel(const QSize& sourceSize, const QSize& destSize);
+
+    /** The former single-threaded Imlib2 scaler of DImg::smoothScale(), only kept
+     *  as reference for the tests and benchmarks.
+     */
+    static DImg legacyScale(const DImg& img, const QSize& destSize);
+
+private:
+
+    DImgResampler(); // Disable
+
+    class Private;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_RESAMPLER_H
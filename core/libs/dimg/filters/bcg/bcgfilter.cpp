@@ -33,6 +33,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -215,6 +216,8 @@ void BCGFilter::applyBCG(DImg& image)
         return;
     }
 
+    image.removeCachedHistogram();
+
     applyBCG(image.bits(), image.width(), image.height(), image.sixteenBit());
 }
 
@@ -225,84 +228,58 @@ void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixtee
         return;
     }
 
-    uint size = width * height;
-    int  progress;
+    Args prm;
+    prm.bits        = bits;
+    prm.sixteenBits = sixteenBits;
+
+    const int* const map = sixteenBits ? d->map16 : d->map;
 
-    if (!sixteenBits)                    // 8 bits image.
+    for (int c = 0 ; c < 4 ; ++c)
     {
-        uchar* data = bits;
-
-        for (uint i = 0; runningFlag() && (i < size); ++i)
-        {
-            switch (d->settings.channel)
-            {
-                case BlueChannel:
-                    data[0] = CLAMP0255(d->map[data[0]]);
-                    break;
-
-                case GreenChannel:
-                    data[1] = CLAMP0255(d->map[data[1]]);
-                    break;
-
-                case RedChannel:
-                    data[2] = CLAMP0255(d->map[data[2]]);
-                    break;
-
-                default:      // all channels
-                    data[0] = CLAMP0255(d->map[data[0]]);
-                    data[1] = CLAMP0255(d->map[data[1]]);
-                    data[2] = CLAMP0255(d->map[data[2]]);
-                    break;
-            }
-
-            data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
-        }
+        prm.luts[c] = nullptr;
     }
-    else                                        // 16 bits image.
+
+    switch (d->settings.channel)
+    {
+        case BlueChannel:
+            prm.luts[0] = map;
+            break;
+
+        case GreenChannel:
+            prm.luts[1] = map;
+            break;
+
+        case RedChannel:
+            prm.luts[2] = map;
+            break;
+
+        default:      // all channels
+            prm.luts[0] = map;
+            prm.luts[1] = map;
+            prm.luts[2] = map;
+            break;
+    }
+
+    runPixelKernel(this, &BCGFilter::applyBCGMultithreaded, prm, width * height);
+}
+
+void BCGFilter::applyBCGMultithreaded(const Args& prm, uint start, uint stop)
+{
+    if (!runningFlag())
     {
-        ushort* data = reinterpret_cast<ushort*>(bits);
-
-        for (uint i = 0; runningFlag() && (i < size); ++i)
-        {
-            switch (d->settings.channel)
-            {
-                case BlueChannel:
-                    data[0] = CLAMP065535(d->map16[data[0]]);
-                    break;
-
-                case GreenChannel:
-                    data[1] = CLAMP065535(d->map16[data[1]]);
-                    break;
-
-                case RedChannel:
-                    data[2] = CLAMP065535(d->map16[data[2]]);
-                    break;
-
-                default:      // all channels
-                    data[0] = CLAMP065535(d->map16[data[0]]);
-                    data[1] = CLAMP065535(d->map16[data[1]]);
-                    data[2] = CLAMP065535(d->map16[data[2]]);
-                    break;
-            }
-
-            data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
-        }
+        return;
     }
 
+    if (!prm.sixteenBits)                    // 8 bits image.
+    {
+        uchar* const data = prm.bits + start * 4;
+        DImgKernels::applyLut8(data, data, stop - start, prm.luts);
+    }
+    else                                        // 16 bits image.
+    {
+        ushort* const data = reinterpret_cast<ushort*>(prm.bits) + start * 4;
+        DImgKernels::applyLut16(data, data, stop - start, prm.luts);
+    }
 }
 
 } // namespace Digikam
@@ -78,6 +78,15 @@ public:
 
     void                    readParameters(const FilterAction& action) override;
 
+private:
+
+    struct Args
+    {
+        uchar*     bits;
+        bool       sixteenBits;
+        const int* luts[4];
+    };
+
 private:
 
     void filterImage() override;
@@ -88,6 +97,7 @@ private:
     void setContrast(double val);
     void applyBCG(DImg& image);
     void applyBCG(uchar* const bits, uint width, uint height, bool sixteenBits);
+    void applyBCGMultithreaded(const Args& prm, uint start, uint stop);
 
 private:
 
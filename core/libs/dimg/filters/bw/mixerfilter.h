@@ -126,9 +126,22 @@ public:
     virtual FilterAction    filterAction() override;
     void                    readParameters(const FilterAction& action) override;
 
+private:
+
+    struct Args
+    {
+        uchar* bits;
+        bool   sixteenBit;
+        double rnorm;
+        double gnorm;
+        double bnorm;
+        double mnorm;
+    };
+
 private:
 
     void filterImage() override;
+    void mixPixelsMultithreaded(const Args& prm, uint start, uint stop);
 
     inline double CalculateNorm(double RedGain, double GreenGain, double BlueGain, bool bPreserveLum);
 
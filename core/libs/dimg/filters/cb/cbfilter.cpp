@@ -32,6 +32,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -250,52 +251,37 @@ void CBFilter::applyCBFilter(DImg& image, double r, double g, double b, double a
         return;
     }
 
-    uint size = image.width() * image.height();
-    int  progress;
+    image.removeCachedHistogram();
 
     adjustRGB(r, g, b, a, image.sixteenBit());
 
-    if (!image.sixteenBit())                    // 8 bits image.
-    {
-        uchar* data = (uchar*) image.bits();
-
-        for (uint i = 0 ; runningFlag() && (i < size) ; ++i)
-        {
-            data[0]  = d->blueMap[data[0]];
-            data[1]  = d->greenMap[data[1]];
-            data[2]  = d->redMap[data[2]];
-            data[3]  = d->alphaMap[data[3]];
+    Args prm;
+    prm.bits       = image.bits();
+    prm.sixteenBit = image.sixteenBit();
+    prm.luts[0]    = prm.sixteenBit ? d->blueMap16  : d->blueMap;
+    prm.luts[1]    = prm.sixteenBit ? d->greenMap16 : d->greenMap;
+    prm.luts[2]    = prm.sixteenBit ? d->redMap16   : d->redMap;
+    prm.luts[3]    = prm.sixteenBit ? d->alphaMap16 : d->alphaMap;
 
-            data    += 4;
+    runPixelKernel(this, &CBFilter::applyCBFilterMultithreaded, prm, image.width() * image.height());
+}
 
-            progress = (int)(((double)i * 100.0) / size);
+void CBFilter::applyCBFilterMultithreaded(const Args& prm, uint start, uint stop)
+{
+    if (!runningFlag())
+    {
+        return;
+    }
 
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
-        }
+    if (!prm.sixteenBit)                    // 8 bits image.
+    {
+        uchar* const data = prm.bits + start * 4;
+        DImgKernels::applyLut8(data, data, stop - start, prm.luts);
     }
     else                                        // 16 bits image.
     {
-        ushort* data = reinterpret_cast<ushort*>(image.bits());
-
-        for (uint i = 0 ; runningFlag() && (i < size) ; ++i)
-        {
-            data[0]  = d->blueMap16[data[0]];
-            data[1]  = d->greenMap16[data[1]];
-            data[2]  = d->redMap16[data[2]];
-            data[3]  = d->alphaMap16[data[3]];
-
-            data    += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
-        }
+        ushort* const data = reinterpret_cast<ushort*>(prm.bits) + start * 4;
+        DImgKernels::applyLut16(data, data, stop - start, prm.luts);
     }
 }
 
@@ -111,6 +111,15 @@ public:
 
     virtual FilterAction    filterAction() override;
 
+private:
+
+    struct Args
+    {
+        uchar*     bits;
+        bool       sixteenBit;
+        const int* luts[4];
+    };
+
 private:
 
     void filterImage() override;
@@ -121,6 +130,7 @@ private:
     void getTables(int* const redMap, int* const greenMap, int* const blueMap, int* const alphaMap, bool sixteenBit);
     void adjustRGB(double r, double g, double b, double a, bool sixteenBit);
     void applyCBFilter(DImg& image, double r, double g, double b, double a);
+    void applyCBFilterMultithreaded(const Args& prm, uint start, uint stop);
 
 private:
 
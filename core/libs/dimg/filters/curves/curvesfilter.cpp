@@ -95,8 +95,22 @@ void CurvesFilter::filterImage()
     curves.curvesLutSetup(AlphaChannel);
     postProgress(75);
 
-    curves.curvesLutProcess(m_orgImage.bits(), m_destImage.bits(), m_orgImage.width(), m_orgImage.height());
-    postProgress(100);
+    Args prm;
+    prm.curves     = &curves;
+    prm.srcBits    = m_orgImage.bits();
+    prm.destBits   = m_destImage.bits();
+    prm.bytesDepth = m_orgImage.bytesDepth();
+
+    runPixelKernel(this, &CurvesFilter::curvesLutProcessMultithreaded, prm,
+                   m_orgImage.width() * m_orgImage.height(), 75, 100);
+}
+
+void CurvesFilter::curvesLutProcessMultithreaded(const Args& prm, uint start, uint stop)
+{
+    // The look-up tables are only read here: the chunks can share them.
+    prm.curves->curvesLutProcess(prm.srcBits  + start * prm.bytesDepth,
+                                 prm.destBits + start * prm.bytesDepth,
+                                 stop - start, 1);
 }
 
 FilterAction CurvesFilter::filterAction()
@@ -86,9 +86,20 @@ public:
     virtual FilterAction    filterAction() override;
     void                    readParameters(const FilterAction& action) override;
 
+private:
+
+    struct Args
+    {
+        ImageCurves* curves;
+        uchar*       srcBits;
+        uchar*       destBits;
+        int          bytesDepth;
+    };
+
 private:
 
     void filterImage() override;
+    void curvesLutProcessMultithreaded(const Args& prm, uint start, uint stop);
 
 private:
 
@@ -445,6 +445,9 @@ void CurvesWidget::updateData(const DImg& img)
     delete d->imageHistogram;
     d->imageHistogram = new ImageHistogram(img);
 
+    // The histogram is only drawn behind the curves.
+    d->imageHistogram->setApproximate(true);
+
     connect(d->imageHistogram, SIGNAL(calculationStarted()),
             this, SLOT(slotCalculationStarted()));
 
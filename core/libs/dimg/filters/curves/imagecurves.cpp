@@ -43,6 +43,7 @@
 #include "curvescontainer.h"
 #include "filteraction.h"
 #include "digikam_globals.h"
+#include "dimgkernels.h"
 
 namespace Digikam
 {
@@ -70,8 +71,8 @@ public:
 
     struct _Lut
     {
-        unsigned short** luts;
-        int              nchannels;
+        int** luts;
+        int   nchannels;
     };
 
 public:
@@ -633,11 +634,11 @@ void ImageCurves::curvesLutSetup(int nchannels)
     d->freeLutData();
 
     d->lut->nchannels = nchannels;
-    d->lut->luts      = new unsigned short*[d->lut->nchannels];
+    d->lut->luts      = new int*[d->lut->nchannels];
 
     for (i = 0 ; i < d->lut->nchannels ; ++i)
     {
-        d->lut->luts[i] = new unsigned short[d->segmentMax + 1];
+        d->lut->luts[i] = new int[d->segmentMax + 1];
 
         for (v = 0 ; v <= (uint)d->segmentMax ; ++v)
         {
@@ -645,119 +646,45 @@ void ImageCurves::curvesLutSetup(int nchannels)
 
             val = (double)(d->segmentMax) * curvesLutFunc(d->lut->nchannels, i, v / (float)(d->segmentMax)) + 0.5;
 
-            d->lut->luts[i][v] = (unsigned short)CLAMP(val, 0.0, (double)d->segmentMax);
+            d->lut->luts[i][v] = (int)CLAMP(val, 0.0, (double)d->segmentMax);
         }
     }
 }
 
 void ImageCurves::curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h)
 {
-    unsigned short* lut0 = nullptr, *lut1 = nullptr, *lut2 = nullptr, *lut3 = nullptr;
-    int i;
+    // The look-up tables are in R, G, B, A order, the pixels in B, G, R, A order.
+
+    const int* luts[4] = { nullptr, nullptr, nullptr, nullptr };
 
     if (d->lut->nchannels > 0)
     {
-        lut0 = d->lut->luts[0];
+        luts[2] = d->lut->luts[0];
     }
 
     if (d->lut->nchannels > 1)
     {
-        lut1 = d->lut->luts[1];
+        luts[1] = d->lut->luts[1];
     }
 
     if (d->lut->nchannels > 2)
     {
-        lut2 = d->lut->luts[2];
+        luts[0] = d->lut->luts[2];
     }
 
     if (d->lut->nchannels > 3)
     {
-        lut3 = d->lut->luts[3];
+        luts[3] = d->lut->luts[3];
     }
 
     if (!isSixteenBits())        // 8 bits image.
     {
-        uchar red, green, blue, alpha;
-        uchar* ptr = srcPR;
-        uchar* dst = destPR;
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if ((d->lut->nchannels > 0) && lut0)
-            {
-                red = lut0[red];
-            }
-
-            if ((d->lut->nchannels > 1) && lut1)
-            {
-                green = lut1[green];
-            }
-
-            if ((d->lut->nchannels > 2) && lut2)
-            {
-                blue = lut2[blue];
-            }
-
-            if ((d->lut->nchannels > 3) && lut3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        DImgKernels::applyLut8(srcPR, destPR, w * h, luts);
     }
     else               // 16 bits image.
     {
-        unsigned short red, green, blue, alpha;
-        unsigned short* ptr = reinterpret_cast<unsigned short*>(srcPR);
-        unsigned short* dst = reinterpret_cast<unsigned short*>(destPR);
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if ((d->lut->nchannels > 0) && lut0)
-            {
-                red = lut0[red];
-            }
-
-            if ((d->lut->nchannels > 1) && lut1)
-            {
-                green = lut1[green];
-            }
-
-            if ((d->lut->nchannels > 2) && lut2)
-            {
-                blue = lut2[blue];
-            }
-
-            if ((d->lut->nchannels > 3) && lut3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        DImgKernels::applyLut16(reinterpret_cast<unsigned short*>(srcPR),
+                                reinterpret_cast<unsigned short*>(destPR), w * h, luts);
     }
 }
 
@@ -53,7 +53,7 @@ DImgThreadedFilter::DImgThreadedFilter(DImg* const orgImage, QObject* const pare
     : DynamicThread(parent)
 {
     // remove meta data
-    setOriginalImage(orgImage->copyImageData());
+    setOriginalImage(orgImage ? orgImage->copyImageData() : DImg());
     setFilterName(name);
     m_version      = 1;
     m_wasCancelled = false;
@@ -195,6 +195,13 @@ void DImgThreadedFilter::startFilterDirectly()
         {
             QDateTime now = QDateTime::currentDateTime();
             filterImage();
+
+            // The filters working in place, as auto-levels or white balance, changed the data
+            // of the original image: a histogram computed before on this data is obsolete.
+            if (!m_destImage.isNull() && (m_destImage.bits() == m_orgImage.bits()))
+            {
+                m_orgImage.removeCachedHistogram();
+            }
             //qCDebug(DIGIKAM_DIMG_LOG) << m_name << ":: excecution time : " << now.msecsTo(QDateTime::currentDateTime()) << " ms";
         }
         catch (std::bad_alloc& ex)
@@ -289,4 +296,22 @@ QList<int> DImgThreadedFilter::multithreadedSteps(int stop, int start) const
     return vals;
 }
 
+QList<uint> DImgThreadedFilter::pixelKernelSteps(uint count) const
+{
+    // Below this number of pixels by chunk, the synchronization costs more than it gives.
+    const uint minChunkSize = 65536;
+    uint nbCore             = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    uint chunks             = qBound(1U, count / minChunkSize, nbCore * 4);
+    QList<uint> vals;
+
+    vals << 0;
+
+    for (uint i = 1 ; i < chunks ; ++i)
+        vals << (uint)(((quint64)count * i) / chunks);
+
+    vals << count;
+
+    return vals;
+}
+
 } // namespace Digikam
@@ -25,6 +25,12 @@
 #ifndef DIGIKAM_DIMG_THREADED_FILTER_H
 #define DIGIKAM_DIMG_THREADED_FILTER_H
 
+// Qt includes
+
+#include <QFuture>
+#include <QList>
+#include <QtConcurrent>    // krazy:exclude=includes
+
 // KDE includes
 
 #include <klocalizedstring.h>
@@ -56,6 +62,7 @@ public:
 
     /** Constructs a filter with all arguments (ready to use).
      *  The given original image will be copied.
+     *  The original image can be null, and be set later with setupFilter().
      *  You need to call startFilter() to start the threaded computation.
      *  To run filter without to use multithreading, call startFilterDirectly().
      */
@@ -98,6 +105,12 @@ public:
      */
     QList<int> multithreadedSteps(int stop, int start=0) const;
 
+    /** This method return the chunks used by runPixelKernel() to process count pixels: a list of
+     *  pixel indexes, each chunk is the range between two successive values. Small images give a single chunk.
+     *  Otherwise, there are a few chunks per CPU core, to balance the load and to aggregate a smooth progress.
+     */
+    QList<uint> pixelKernelSteps(uint count) const;
+
     /** Start the threaded computation.
      */
     virtual void startFilter();
@@ -225,6 +238,49 @@ protected:
     void initMaster();
     virtual void prepareDestImage();
 
+    /**
+     * Parallel execution of a point-wise pixel kernel, for the filters computing each pixel
+     * from the same pixel of the original image only.
+     * The pixels [0, count[ are split by pixelKernelSteps(), and (filter->*kernel)(params, start, stop)
+     * is run for each chunk with QtConcurrent API. The kernel processes the pixels [start, stop[, it must
+     * only write to these pixels, and it must not post progress: the progress of the chunks is aggregated
+     * here, from progressBegin to progressEnd. A chunk is not started when the filter is cancelled.
+     * Params is copied for each chunk, as for the arguments of QtConcurrent::run().
+     * See BCGFilter implementation for example.
+     */
+    template <class Filter, class Params>
+    void runPixelKernel(Filter* const filter, void (Filter::*kernel)(const Params&, uint, uint),
+                        const Params& params, uint count, int progressBegin = 0, int progressEnd = 100)
+    {
+        QList<uint> steps = pixelKernelSteps(count);
+
+        if (steps.count() == 2)
+        {
+            runPixelKernelChunk<Filter, Params>(filter, kernel, params, steps[0], steps[1]);
+            postProgress(progressEnd);
+            return;
+        }
+
+        QList<QFuture<void> > tasks;
+
+        for (int j = 0 ; runningFlag() && (j < steps.count() - 1) ; ++j)
+        {
+            tasks.append(QtConcurrent::run(&DImgThreadedFilter::runPixelKernelChunk<Filter, Params>,
+                                           filter,
+                                           kernel,
+                                           params,
+                                           steps[j],
+                                           steps[j + 1]
+                                          ));
+        }
+
+        for (int j = 0 ; j < tasks.count() ; ++j)
+        {
+            tasks[j].waitForFinished();
+            postProgress(progressBegin + ((progressEnd - progressBegin) * (j + 1)) / tasks.count());
+        }
+    }
+
     /**
      * Convenience class to spare the few repeating lines of code
      */
@@ -262,6 +318,18 @@ protected:
 
     };
 
+private:
+
+    template <class Filter, class Params>
+    static void runPixelKernelChunk(Filter* const filter, void (Filter::*kernel)(const Params&, uint, uint),
+                                    const Params& params, uint start, uint stop)
+    {
+        if (filter->runningFlag())
+        {
+            (filter->*kernel)(params, start, stop);
+        }
+    }
+
 protected:
 
     int                 m_version;
@@ -237,18 +237,27 @@ void HSLFilter::applyHSL(DImg& image)
         return;
     }
 
-    bool   sixteenBit     = image.sixteenBit();
-    uint   numberOfPixels = image.numPixels();
-    int    progress;
+    image.removeCachedHistogram();
+
+    Args prm;
+    prm.bits       = image.bits();
+    prm.sixteenBit = image.sixteenBit();
+
+    runPixelKernel(this, &HSLFilter::applyHSLMultithreaded, prm, image.numPixels());
+}
+
+void HSLFilter::applyHSLMultithreaded(const Args& prm, uint start, uint stop)
+{
+    bool   sixteenBit = prm.sixteenBit;
     int    hue, sat, lig;
-    double vib = d->settings.vibrance;
+    double vib        = d->settings.vibrance;
     DColor color;
 
     if (sixteenBit)                   // 16 bits image.
     {
-        unsigned short* data = reinterpret_cast<unsigned short*>(image.bits());
+        unsigned short* data = reinterpret_cast<unsigned short*>(prm.bits) + start * 4;
 
-        for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
+        for (uint i = start ; runningFlag() && (i < stop) ; ++i)
         {
             color = DColor(data[2], data[1], data[0], 0, sixteenBit);
 
@@ -263,20 +272,13 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else                                      // 8 bits image.
     {
-        uchar* data = image.bits();
+        uchar* data = prm.bits + start * 4;
 
-        for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
+        for (uint i = start ; runningFlag() && (i < stop) ; ++i)
         {
             color = DColor(data[2], data[1], data[0], 0, sixteenBit);
 
@@ -291,13 +293,6 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
@@ -100,6 +100,14 @@ public:
 
     void                    readParameters(const FilterAction& action) override;
 
+private:
+
+    struct Args
+    {
+        uchar* bits;
+        bool   sixteenBit;
+    };
+
 private:
 
     void filterImage() override;
@@ -109,6 +117,7 @@ private:
     void setSaturation(double val);
     void setLightness(double val);
     void applyHSL(DImg& image);
+    void applyHSLMultithreaded(const Args& prm, uint start, uint stop);
     int  vibranceBias(double sat, double hue, double vib, bool sixteenbit);
 
 private:
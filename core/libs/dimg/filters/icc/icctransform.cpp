@@ -28,10 +28,19 @@
 
 // Qt includes
 
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QFile>
+#include <QFuture>
+#include <QHash>
 #include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QSharedData>
 #include <QVarLengthArray>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // KDE includes
 
@@ -57,6 +66,7 @@ public:
         intent         = INTENT_PERCEPTUAL;
         transformFlags = 0;
         proofIntent    = INTENT_ABSOLUTE_COLORIMETRIC;
+        gamutColor     = 0;
     }
 
     bool operator==(const TransformDescription& other) const
@@ -68,7 +78,25 @@ public:
                intent         == other.intent         &&
                transformFlags == other.transformFlags &&
                proofProfile   == other.proofProfile   &&
-               proofIntent    == other.proofIntent;
+               proofIntent    == other.proofIntent    &&
+               gamutColor     == other.gamutColor;
+    }
+
+    /**
+     * The key of the transform in the cache. The profiles are identified by their content,
+     * the same embedded profile read from different images gives the same key.
+     */
+    QByteArray cacheKey() const
+    {
+        QByteArray key;
+        QDataStream stream(&key, QIODevice::WriteOnly);
+
+        stream << profileHash(inputProfile)  << inputFormat
+               << profileHash(outputProfile) << outputFormat
+               << profileHash(proofProfile)  << proofIntent
+               << intent << transformFlags << gamutColor;
+
+        return key;
     }
 
 public:
@@ -81,8 +109,311 @@ public:
     int        transformFlags;
     IccProfile proofProfile;
     int        proofIntent;
+
+    /// The color of the out of gamut pixels, with cmsFLAGS_GAMUTCHECK.
+    QRgb       gamutColor;
+
+private:
+
+    static QByteArray profileHash(IccProfile profile)
+    {
+        if (profile.isNull())
+        {
+            return QByteArray();
+        }
+
+        return QCryptographicHash::hash(profile.data(), QCryptographicHash::Sha1);
+    }
+};
+
+// --------------------------------------------------------------------------------------
+
+/** A LittleCMS transform, deleted when no IccTransform and no cache entry use it anymore.
+ */
+class Q_DECL_HIDDEN CachedTransform : public QSharedData
+{
+public:
+
+    explicit CachedTransform(cmsHTRANSFORM h)
+        : handle(h)
+    {
+    }
+
+    ~CachedTransform()
+    {
+        LcmsLock lock;
+        dkCmsDeleteTransform(handle);
+    }
+
+public:
+
+    const cmsHTRANSFORM handle;
+};
+
+typedef QExplicitlySharedDataPointer<CachedTransform> CachedTransformPtr;
+
+/** The transforms created last, shared by all IccTransform objects of the process.
+ *  A collection uses few camera profiles converted to one working or monitor profile,
+ *  the same transforms are used for most images.
+ */
+class Q_DECL_HIDDEN IccTransformCache
+{
+public:
+
+    IccTransformCache()
+        : maxTransforms(16),
+          lookups(0),
+          hits(0),
+          useCounter(0)
+    {
+        // The cached transforms are deleted under the LcmsLock when the cache is destroyed.
+        // Taking the lock once here constructs its global static before the one of the cache,
+        // the lock is then destroyed after the cache at the exit of the process.
+
+        LcmsLock lock;
+    }
+
+    ~IccTransformCache()
+    {
+        QMutexLocker locker(&mutex);
+        entries.clear();
+    }
+
+    /// Returns the transform for the description, created if not in the cache.
+    CachedTransformPtr transform(const TransformDescription& description)
+    {
+        QByteArray key = description.cacheKey();
+
+        {
+            QMutexLocker locker(&mutex);
+            ++lookups;
+
+            QHash<QByteArray, Entry>::iterator it = entries.find(key);
+
+            if (it != entries.end())
+            {
+                ++hits;
+                it->lastUse = ++useCounter;
+                logStatistics(false);
+
+                return it->transform;
+            }
+        }
+
+        // Creating a transform takes some time: the cache is not locked meanwhile.
+
+        CachedTransformPtr transform = create(description);
+
+        if (!transform)
+        {
+            return transform;
+        }
+
+        QMutexLocker locker(&mutex);
+
+        QHash<QByteArray, Entry>::iterator it = entries.find(key);
+
+        if (it != entries.end())
+        {
+            // Created by another thread at the same time.
+            return it->transform;
+        }
+
+        if (entries.count() >= maxTransforms)
+        {
+            QHash<QByteArray, Entry>::iterator oldest = entries.begin();
+
+            for (QHash<QByteArray, Entry>::iterator e = entries.begin() ; e != entries.end() ; ++e)
+            {
+                if (e->lastUse < oldest->lastUse)
+                {
+                    oldest = e;
+                }
+            }
+
+            entries.erase(oldest);
+        }
+
+        Entry entry;
+        entry.transform = transform;
+        entry.lastUse   = ++useCounter;
+        entries.insert(key, entry);
+        logStatistics(true);
+
+        return transform;
+    }
+
+private:
+
+    CachedTransformPtr create(const TransformDescription& description) const
+    {
+        cmsHTRANSFORM handle = nullptr;
+        LcmsLock lock;
+
+        if (description.proofProfile.isNull())
+        {
+            handle = dkCmsCreateTransform(description.inputProfile,
+                                          description.inputFormat,
+                                          description.outputProfile,
+                                          description.outputFormat,
+                                          description.intent,
+                                          description.transformFlags);
+        }
+        else
+        {
+            handle = dkCmsCreateProofingTransform(description.inputProfile,
+                                                  description.inputFormat,
+                                                  description.outputProfile,
+                                                  description.outputFormat,
+                                                  description.proofProfile,
+                                                  description.intent,
+                                                  description.proofIntent,
+                                                  description.transformFlags);
+        }
+
+        if (!handle)
+        {
+            return CachedTransformPtr();
+        }
+
+        return CachedTransformPtr(new CachedTransform(handle));
+    }
+
+    /// Logged for each new transform and every 100 lookups. The mutex must be held.
+    void logStatistics(bool created) const
+    {
+        if (created || ((lookups % 100) == 0))
+        {
+            qCDebug(DIGIKAM_DIMG_LOG) << "ICC transform cache:" << hits << "hits for" << lookups << "lookups"
+                                      << "(" << (100.0 * hits / lookups) << "% ),"
+                                      << entries.count() << "transforms cached";
+        }
+    }
+
+private:
+
+    class Q_DECL_HIDDEN Entry
+    {
+    public:
+
+        CachedTransformPtr transform;
+        quint64            lastUse;
+    };
+
+    const int                 maxTransforms;
+    QMutex                    mutex;
+    QHash<QByteArray, Entry>  entries;
+    quint64                   lookups;
+    quint64                   hits;
+    quint64                   useCounter;
 };
 
+Q_GLOBAL_STATIC(IccTransformCache, transformCache)
+
+/** A band of scanlines of an image, converted by one thread.
+ */
+class Q_DECL_HIDDEN TransformStrip
+{
+public:
+
+    TransformStrip()
+      : handle(nullptr),
+        data(nullptr),
+        width(0),
+        pixels(0),
+        bytesDepth(0),
+        inPlace(true),
+        image(nullptr),
+        observer(nullptr)
+    {
+    }
+
+public:
+
+    cmsHTRANSFORM       handle;
+    uchar*              data;
+    int                 width;
+    int                 pixels;
+    int                 bytesDepth;
+    bool                inPlace;
+
+    /// Only set for the strip reporting the progress.
+    DImg*               image;
+    DImgLoaderObserver* observer;
+};
+
+/**
+ * Run the transform on the strip, ten scanlines in a batch.
+ * LittleCMS 2 copies the cache of the transform for each cmsDoTransform() call
+ * and does not modify the transform: one handle can be used by several threads at once,
+ * without the LcmsLock.
+ */
+static void transformStrip(const TransformStrip& strip)
+{
+    const int pixelsPerStep = strip.width * 10;
+    uchar* data             = strip.data;
+
+    // see dimgloader.cpp, granularity().
+    int granularity         = 1;
+
+    if (strip.observer)
+    {
+        granularity = (int)((strip.pixels / (20 * 0.9)) / strip.observer->granularity());
+    }
+
+    int checkPoint = strip.pixels;
+
+    // it is safe to use the same input and output buffer if the format is the same
+    QVarLengthArray<uchar> buffer(strip.inPlace ? 0 : pixelsPerStep * strip.bytesDepth);
+
+    for (int p = strip.pixels ; p > 0 ; p -= pixelsPerStep)
+    {
+        int pixelsThisStep = qMin(p, pixelsPerStep);
+        int size           = pixelsThisStep * strip.bytesDepth;
+
+        if (strip.inPlace)
+        {
+            dkCmsDoTransform(strip.handle, data, data, pixelsThisStep);
+        }
+        else
+        {
+            memcpy(buffer.data(), data, size);
+            dkCmsDoTransform(strip.handle, buffer.data(), data, pixelsThisStep);
+        }
+
+        data += size;
+
+        if (strip.observer && p <= checkPoint)
+        {
+            checkPoint -= granularity;
+            strip.observer->progressInfo(strip.image, 0.1 + 0.9 * (1.0 - float(p) / float(strip.pixels)));
+        }
+    }
+}
+
+/**
+ * The out of gamut color is a global LittleCMS setting shared by all the cached proofing transforms.
+ * For a gamut check, it is set to the color of the description and the returned lock must be held
+ * until the transform was applied. Returns null for any other transform.
+ */
+static LcmsLock* gamutCheckLock(const TransformDescription& description)
+{
+    if (!(description.transformFlags & cmsFLAGS_GAMUTCHECK))
+    {
+        return nullptr;
+    }
+
+    LcmsLock* const lock = new LcmsLock;
+
+    dkCmsSetAlarmCodes(qRed(description.gamutColor),
+                       qGreen(description.gamutColor),
+                       qBlue(description.gamutColor));
+
+    return lock;
+}
+
+// --------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN IccTransform::Private : public QSharedData
 {
 public:
@@ -139,8 +470,7 @@ public:
         if (handle)
         {
             currentDescription = TransformDescription();
-            LcmsLock lock;
-            dkCmsDeleteTransform(handle);
+            cachedTransform.reset();
             handle = nullptr;
         }
     }
@@ -203,6 +533,7 @@ public:
     IccProfile                    builtinProfile;
 
     cmsHTRANSFORM                 handle;
+    CachedTransformPtr            cachedTransform;
     TransformDescription          currentDescription;
 };
 
@@ -504,7 +835,7 @@ TransformDescription IccTransform::getProofingDescription(const DImg& image)
 
     if (d->checkGamut)
     {
-        dkCmsSetAlarmCodes(d->checkGamutColor.red(), d->checkGamutColor.green(), d->checkGamutColor.blue());
+        description.gamutColor      = d->checkGamutColor.rgb();
         description.transformFlags |= cmsFLAGS_GAMUTCHECK;
     }
 
@@ -526,57 +857,23 @@ bool IccTransform::open(TransformDescription& description)
     }
 
     d->currentDescription = description;
+    d->cachedTransform    = transformCache->transform(description);
 
-    LcmsLock lock;
-    d->handle = dkCmsCreateTransform(description.inputProfile,
-                                     description.inputFormat,
-                                     description.outputProfile,
-                                     description.outputFormat,
-                                     description.intent,
-                                     description.transformFlags);
-
-    if (!d->handle)
+    if (!d->cachedTransform)
     {
         qCDebug(DIGIKAM_DIMG_LOG) << "LCMS internal error: cannot create a color transform instance";
         return false;
     }
 
+    d->handle = d->cachedTransform->handle;
+
     return true;
 }
 
 bool IccTransform::openProofing(TransformDescription& description)
 {
-    if (d->handle)
-    {
-        if (d->currentDescription == description)
-        {
-            return true;
-        }
-        else
-        {
-            close();
-        }
-    }
-
-    d->currentDescription = description;
-
-    LcmsLock lock;
-    d->handle = dkCmsCreateProofingTransform(description.inputProfile,
-                                             description.inputFormat,
-                                             description.outputProfile,
-                                             description.outputFormat,
-                                             description.proofProfile,
-                                             description.intent,
-                                             description.proofIntent,
-                                             description.transformFlags);
-
-    if (!d->handle)
-    {
-        qCDebug(DIGIKAM_DIMG_LOG) << "LCMS internal error: cannot create a color transform instance";
-        return false;
-    }
-
-    return true;
+    // The cache creates a proofing transform for a description with a proofing profile.
+    return open(description);
 }
 
 bool IccTransform::checkProfiles()
@@ -696,64 +993,54 @@ bool IccTransform::apply(QImage& qimage)
 
 void IccTransform::transform(DImg& image, const TransformDescription& description, DImgLoaderObserver* const observer)
 {
-    const int bytesDepth    = image.bytesDepth();
-    const int pixels        = image.width() * image.height();
-    // convert ten scanlines in a batch
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    image.removeCachedHistogram();
 
-    // see dimgloader.cpp, granularity().
-    int granularity         = 1;
+    // LittleCMS reads the alarm codes when the transform is applied, not when it is created:
+    // they stay set until all strips are converted.
 
-    if (observer)
-    {
-        granularity = (int)((pixels / (20 * 0.9)) / observer->granularity());
-    }
+    QScopedPointer<LcmsLock> alarmLock(gamutCheckLock(description));
 
-    int checkPoint = pixels;
+    // Large images are split in strips of scanlines converted in parallel.
 
-    // it is safe to use the same input and output buffer if the format is the same
-    if (description.inputFormat == description.outputFormat)
+    const int width         = image.width();
+    const int height        = image.height();
+    const QList<int> strips = DImg::rowChunks(height, (qint64)width * height);
+
+    TransformStrip strip;
+    strip.handle     = d->handle;
+    strip.width      = width;
+    strip.bytesDepth = image.bytesDepth();
+    strip.inPlace    = (description.inputFormat == description.outputFormat);
+
+    QList<QFuture<void> > tasks;
+
+    for (int s = 1 ; s < strips.size() - 1 ; ++s)
     {
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
-        {
-            int pixelsThisStep =  qMin(p, pixelsPerStep);
-            int size           =  pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-            data               += size;
+        strip.data   = image.scanLine(strips[s]);
+        strip.pixels = (strips[s + 1] - strips[s]) * width;
 
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
-        }
+        tasks << QtConcurrent::run(&transformStrip, strip);
     }
-    else
-    {
-        QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
 
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
-        {
-            int pixelsThisStep  = qMin(p, pixelsPerStep);
-            int size            = pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            memcpy(buffer.data(), data, size);
-            dkCmsDoTransform(d->handle, buffer.data(), data, pixelsThisStep);
-            data               += size;
+    // The first strip is converted here and reports the progress.
 
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
-        }
+    strip.data     = image.bits();
+    strip.pixels   = strips[1] * width;
+    strip.image    = &image;
+    strip.observer = observer;
+
+    transformStrip(strip);
+
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
     }
 }
 
-void IccTransform::transform(QImage& image, const TransformDescription&)
+void IccTransform::transform(QImage& image, const TransformDescription& description)
 {
+    QScopedPointer<LcmsLock> alarmLock(gamutCheckLock(description));
+
     const int bytesDepth    = 4;
     const int pixels        = image.width() * image.height();
     // convert ten scanlines in a batch
@@ -764,7 +1051,6 @@ void IccTransform::transform(QImage& image, const TransformDescription&)
     {
         int pixelsThisStep =  qMin(p, pixelsPerStep);
         int size           =  pixelsThisStep * bytesDepth;
-        LcmsLock lock;
         dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
         data               += size;
     }
@@ -68,6 +68,8 @@ public:
     /**
      * Apply this transform with the set profiles and options to the image.
      * Optionally pass an observer to get progress information.
+     * Large images are converted on all cores. Different IccTransform objects
+     * can be applied from different threads at the same time.
      */
     bool apply(DImg& image, DImgLoaderObserver* const observer = nullptr);
 
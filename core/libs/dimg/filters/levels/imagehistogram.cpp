@@ -31,7 +31,10 @@
 
 // Qt includes
 
+#include <QFuture>
 #include <QObject>
+#include <QVector>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
@@ -66,12 +69,58 @@ public:
         histogram     = nullptr;
         histoSegments = 0;
         valid         = false;
+        approximate   = false;
+    }
+
+    /** A chunk of rows [start, end[ counted one pixel out of step in each direction,
+        in the bins of the five channels following each other: value, red, green, blue, alpha.
+     */
+    class Q_DECL_HIDDEN Chunk
+    {
+    public:
+
+        uint     start;
+        uint     end;
+        uint     step;
+        quint32* bins;
+    };
+
+    template <typename T>
+    static void countRows(const ImageHistogram* const histogram, const DImg& img, const Chunk& chunk)
+    {
+        const uint segments  = histogram->getHistogramSegments();
+        const uint width     = img.width();
+        const uint step      = chunk.step;
+        quint32* const value = chunk.bins;
+        quint32* const red   = chunk.bins + segments;
+        quint32* const green = chunk.bins + segments * 2;
+        quint32* const blue  = chunk.bins + segments * 3;
+        quint32* const alpha = chunk.bins + segments * 4;
+
+        for (uint y = chunk.start ; histogram->runningFlag() && (y < chunk.end) ; y += step)
+        {
+            const T* data = reinterpret_cast<const T*>(img.scanLine(y));
+
+            for (uint x = 0 ; x < width ; x += step, data += 4 * step)
+            {
+                const T b = data[0];
+                const T g = data[1];
+                const T r = data[2];
+
+                ++blue[b];
+                ++green[g];
+                ++red[r];
+                ++alpha[data[3]];
+                ++value[qMax(r, qMax(g, b))];
+            }
+        }
     }
 
 public:
     /** The histogram data.*/
     struct double_packet* histogram;
     bool                  valid;
+    bool                  approximate;
 
     /** Image information.*/
     DImg                  img;
@@ -144,6 +193,16 @@ bool ImageHistogram::isValid() const
     return d->valid;
 }
 
+void ImageHistogram::setApproximate(bool approximate)
+{
+    d->approximate = approximate;
+}
+
+bool ImageHistogram::isApproximate() const
+{
+    return d->approximate;
+}
+
 bool ImageHistogram::isCalculating() const
 {
     return isRunning();
@@ -172,9 +231,6 @@ void ImageHistogram::calculate()
         return;
     }
 
-    uint i;
-    int  max;
-
     emit calculationStarted();
 
     if (!d->histogram)
@@ -189,78 +245,106 @@ void ImageHistogram::calculate()
         return;
     }
 
-    memset(d->histogram, 0, d->histoSegments * sizeof(struct Private::double_packet));
+    const int bytes        = d->histoSegments * sizeof(struct Private::double_packet);
+    const QByteArray cache = d->img.cachedHistogram(!d->approximate);
 
-    if (isSixteenBit())         // 16 bits image.
+    if (cache.size() == bytes)
     {
-        unsigned short blue, green, red, alpha;
-        unsigned short* const data = reinterpret_cast<unsigned short*>(d->img.bits());
+        memcpy(d->histogram, cache.constData(), bytes);
+        d->valid = true;
+        emit calculationFinished(true);
+        return;
+    }
 
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
+    memset(d->histogram, 0, bytes);
 
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
-        {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
+    // An approximate histogram reads one pixel out of step in each direction.
+
+    const uint width  = d->img.width();
+    const uint height = d->img.height();
+    const uint step   = d->approximate ? qMax(1U, (uint)sqrt(d->img.numPixels() / (2.0 * 1024 * 1024))) : 1;
+    const uint rows   = (height + step - 1) / step;
+    const double read = (double)rows * ((width + step - 1) / step);
+
+    // Each chunk of rows is counted in its own bins, the bins are summed at the end.
 
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
+    const QList<int> rowChunks = DImg::rowChunks(rows, (qint64)read);
+    const int chunks           = rowChunks.size() - 1;
+    const uint size            = d->histoSegments * 5;
+    QVector<quint32>      bins(size * chunks, 0);
+    QList<QFuture<void> > tasks;
 
-            max = (blue > green) ? blue : green;
+    for (int c = chunks - 1 ; c >= 0 ; --c)
+    {
+        Private::Chunk chunk;
+        chunk.start = (uint)rowChunks[c] * step;
+        chunk.end   = qMin((uint)rowChunks[c + 1] * step, height);
+        chunk.step  = step;
+        chunk.bins  = bins.data() + size * c;
 
-            if (red > max)
+        if (c > 0)
+        {
+            if (isSixteenBit())
             {
-                d->histogram[red].value++;
+                tasks << QtConcurrent::run(&Private::countRows<unsigned short>, this, d->img, chunk);
             }
             else
             {
-                d->histogram[max].value++;
+                tasks << QtConcurrent::run(&Private::countRows<uchar>, this, d->img, chunk);
             }
         }
+        else if (isSixteenBit())
+        {
+            Private::countRows<unsigned short>(this, d->img, chunk);
+        }
+        else
+        {
+            Private::countRows<uchar>(this, d->img, chunk);
+        }
     }
-    else                                  // 8 bits images.
-    {
-        uchar blue, green, red, alpha;
-        const uchar* const data = d->img.bits();
 
-        // count here instead of inside the loop, because d is not optimized because it's not defined in the header
-        const uint count = d->img.width() * d->img.height() * 4;
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
 
-        for (i = 0 ; runningFlag() && (i < count) ; i += 4)
-        {
-            blue  = data[i    ];
-            green = data[i + 1];
-            red   = data[i + 2];
-            alpha = data[i + 3];
+    if (!runningFlag())
+    {
+        return;
+    }
 
-            d->histogram[blue].blue++;
-            d->histogram[green].green++;
-            d->histogram[red].red++;
-            d->histogram[alpha].alpha++;
+    const double scale = d->img.numPixels() / read;
 
-            max = (blue > green) ? blue : green;
+    for (int c = 0 ; c < chunks ; ++c)
+    {
+        const quint32* const chunk = bins.constData() + size * c;
 
-            if (red > max)
-            {
-                d->histogram[red].value++;
-            }
-            else
-            {
-                d->histogram[max].value++;
-            }
+        for (int i = 0 ; i < d->histoSegments ; ++i)
+        {
+            d->histogram[i].value += chunk[i];
+            d->histogram[i].red   += chunk[i + d->histoSegments];
+            d->histogram[i].green += chunk[i + d->histoSegments * 2];
+            d->histogram[i].blue  += chunk[i + d->histoSegments * 3];
+            d->histogram[i].alpha += chunk[i + d->histoSegments * 4];
         }
     }
 
-    if (runningFlag())
+    if (step > 1)
     {
-        d->valid = true;
-        emit calculationFinished(true);
+        for (int i = 0 ; i < d->histoSegments ; ++i)
+        {
+            d->histogram[i].value *= scale;
+            d->histogram[i].red   *= scale;
+            d->histogram[i].green *= scale;
+            d->histogram[i].blue  *= scale;
+            d->histogram[i].alpha *= scale;
+        }
     }
+
+    d->img.setCachedHistogram(QByteArray((const char*)d->histogram, bytes), (step == 1));
+
+    d->valid = true;
+    emit calculationFinished(true);
 }
 
 double ImageHistogram::getCount(int channel, int start, int end) const
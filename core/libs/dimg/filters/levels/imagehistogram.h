@@ -51,10 +51,20 @@ public:
 
     /**
      * Started computation: synchronous or threaded.
+     * The histogram of all channels is computed in one pass on all CPU cores,
+     * and cached in the image for the next ImageHistogram of the same image data.
      */
     void calculate();
     void calculateInThread();
 
+    /**
+     * By default, all the pixels are counted. For a display, an approximate histogram computed from
+     * about 2 Mpixels regularly sampled in large images is enough. The counts are scaled
+     * to the number of pixels of the image. Must be called before the computation.
+     */
+    void setApproximate(bool approximate);
+    bool isApproximate() const;
+
     /**
      * Stop threaded computation.
      */
@@ -95,9 +95,22 @@ void LevelsFilter::filterImage()
     levels.levelsLutSetup(AlphaChannel);
     postProgress(80);
 
-    levels.levelsLutProcess(m_orgImage.bits(), m_destImage.bits(),
-                            m_orgImage.width(), m_orgImage.height());
-    postProgress(90);
+    Args prm;
+    prm.levels     = &levels;
+    prm.srcBits    = m_orgImage.bits();
+    prm.destBits   = m_destImage.bits();
+    prm.bytesDepth = m_orgImage.bytesDepth();
+
+    runPixelKernel(this, &LevelsFilter::levelsLutProcessMultithreaded, prm,
+                   m_orgImage.width() * m_orgImage.height(), 80, 90);
+}
+
+void LevelsFilter::levelsLutProcessMultithreaded(const Args& prm, uint start, uint stop)
+{
+    // The look-up tables are only read here: the chunks can share them.
+    prm.levels->levelsLutProcess(prm.srcBits  + start * prm.bytesDepth,
+                                 prm.destBits + start * prm.bytesDepth,
+                                 stop - start, 1);
 }
 
 FilterAction LevelsFilter::filterAction()
@@ -35,6 +35,7 @@ namespace Digikam
 {
 
 class DImg;
+class ImageLevels;
 
 class DIGIKAM_EXPORT LevelsContainer
 {
@@ -114,9 +115,20 @@ public:
     virtual FilterAction    filterAction() override;
     void                    readParameters(const FilterAction& action) override;
 
+private:
+
+    struct Args
+    {
+        ImageLevels* levels;
+        uchar*       srcBits;
+        uchar*       destBits;
+        int          bytesDepth;
+    };
+
 private:
 
     void filterImage() override;
+    void levelsLutProcessMultithreaded(const Args& prm, uint start, uint stop);
 
 private:
 
@@ -422,16 +422,23 @@ void WBFilter::setLUTv()
 
 void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool sixteenBit)
 {
-    uint size = (uint)(width * height);
+    Args prm;
+    prm.data       = data;
+    prm.sixteenBit = sixteenBit;
+
+    runPixelKernel(this, &WBFilter::adjustWhiteBalanceMultithreaded, prm, (uint)(width * height));
+}
+
+void WBFilter::adjustWhiteBalanceMultithreaded(const Args& prm, uint start, uint stop)
+{
     uint i, j;
-    int  progress;
 
-    if (!sixteenBit)        // 8 bits image.
+    if (!prm.sixteenBit)        // 8 bits image.
     {
         uchar  red, green, blue;
-        uchar* ptr = data;
+        uchar* ptr = prm.data + start * 4;
 
-        for (j = 0 ; runningFlag() && (j < size) ; ++j)
+        for (j = start ; runningFlag() && (j < stop) ; ++j)
         {
             int v, rv[3];
 
@@ -456,21 +463,14 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = (uchar)pixelColor(rv[1], i, v);
             ptr[2] = (uchar)pixelColor(rv[2], i, v);
             ptr   += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else               // 16 bits image.
     {
         unsigned short  red, green, blue;
-        unsigned short* ptr = reinterpret_cast<unsigned short*>(data);
+        unsigned short* ptr = reinterpret_cast<unsigned short*>(prm.data) + start * 4;
 
-        for (j = 0 ; runningFlag() && (j < size) ; ++j)
+        for (j = start ; runningFlag() && (j < stop) ; ++j)
         {
             int v, rv[3];
 
@@ -495,13 +495,6 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = pixelColor(rv[1], i, v);
             ptr[2] = pixelColor(rv[2], i, v);
             ptr   += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
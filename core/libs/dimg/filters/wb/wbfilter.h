@@ -94,11 +94,20 @@ protected:
 
     WBContainer m_settings;
 
+private:
+
+    struct Args
+    {
+        uchar* data;
+        bool   sixteenBit;
+    };
+
 private:
 
     void setRGBmult();
     void setLUTv();
     void adjustWhiteBalance(uchar* const data, int width, int height, bool sixteenBit);
+    void adjustWhiteBalanceMultithreaded(const Args& prm, uint start, uint stop);
     inline unsigned short pixelColor(int colorMult, int index, int value);
 
     static void setRGBmult(double& temperature, double& green, float& mr, float& mg, float& mb);
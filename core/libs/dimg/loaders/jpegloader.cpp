@@ -42,6 +42,7 @@ extern "C"
 
 #include "digikam_config.h"
 #include "dimg.h"
+#include "dimgkernels.h"
 #include "digikam_debug.h"
 #include "dimgloaderobserver.h"
 
@@ -891,17 +892,8 @@ bool JPEGLoader::save(const QString& filePath, DImgLoaderObserver* const observe
                 observer->progressInfo(m_image, 0.2 + (0.8 * (((float)j) / ((float)h))));
             }
 
-            dstPtr = line;
-
-            for (uint i = 0; i < w; ++i)
-            {
-                dstPtr[2] = srcPtr[0];  // Blue
-                dstPtr[1] = srcPtr[1];  // Green
-                dstPtr[0] = srcPtr[2];  // Red
-
-                srcPtr   += 4;
-                dstPtr   += 3;
-            }
+            DImgKernels::bgraToRgb(srcPtr, line, w);
+            srcPtr += w * 4;
 
             jpeg_write_scanlines(&cinfo, &line, 1);
         }
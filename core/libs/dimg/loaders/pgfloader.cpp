@@ -282,7 +282,7 @@ bool PGFLoader::load(const QString& filePath, DImgLoaderObserver* const observer
                     w = pgf.Width(i);
                     h = pgf.Height(i);
 
-                    if (qMin(w, h) >= scaledLoadingSize)
+                    if (qMax(w, h) >= scaledLoadingSize)
                     {
                         break;
                     }
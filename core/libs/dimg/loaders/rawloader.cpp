@@ -109,6 +109,18 @@ bool RAWLoader::load(const QString& filePath, DImgLoaderObserver* const observer
             }
         }
 
+        // Fast-track loading with reduced size: half size demosaicing skips the interpolation
+        // and decodes four times fewer pixels.
+
+        int scaledLoadingSize = imageGetAttribute(QLatin1String("scaledLoadingSize")).toInt();
+        QSize rawSize         = dcrawIdentify.imageSize;
+
+        if (scaledLoadingSize > 0 && qMax(rawSize.width(), rawSize.height()) / 2 >= scaledLoadingSize)
+        {
+            qCDebug(DIGIKAM_DIMG_LOG_RAW) << "Loading RAW at half size for size" << scaledLoadingSize;
+            m_decoderSettings.halfSizeColorImage = true;
+        }
+
         if (!DRawDecoder::decodeRAWImage(filePath, m_decoderSettings, data, width, height, rgbmax))
         {
             loadingFailed();
@@ -681,7 +681,7 @@ int OpenCVFaceDetector::recommendedImageSizeForDetection()
     return 800;
 }
 
-cv::Mat OpenCVFaceDetector::prepareForDetection(const QImage& inputImage) const
+cv::Mat OpenCVFaceDetector::prepareForDetection(const QImage& inputImage)
 {
     if (inputImage.isNull() || !inputImage.size().isValid())
     {
@@ -724,7 +724,7 @@ cv::Mat OpenCVFaceDetector::prepareForDetection(const QImage& inputImage) const
     return cvImage;
 }
 
-cv::Mat OpenCVFaceDetector::prepareForDetection(const Digikam::DImg& inputImage) const
+cv::Mat OpenCVFaceDetector::prepareForDetection(const Digikam::DImg& inputImage, int maximumSize)
 {
     if (inputImage.isNull() || !inputImage.size().isValid())
     {
@@ -732,47 +732,45 @@ cv::Mat OpenCVFaceDetector::prepareForDetection(const Digikam::DImg& inputImage)
     }
 
     Digikam::DImg image(inputImage);
-    int inputArea                    = image.width() * image.height();
-    const int maxAcceptableInputArea = 1024*768;
 
-    if (inputArea > maxAcceptableInputArea)
+    if (maximumSize > 0)
     {
-        // Resize to 1024 * 768 (or comparable area for different aspect ratio)
-        // Looking for scale factor z where A = w*z * h*z => z = sqrt(A/(w*h))
-        qreal z          = qSqrt(qreal(maxAcceptableInputArea) / image.width() / image.height());
-        QSize scaledSize = image.size() * z;
-        image            = image.smoothScale(scaledSize, Qt::KeepAspectRatio);
+        if (qMax(image.width(), image.height()) > (uint)maximumSize)
+        {
+            image = image.smoothScale(maximumSize, maximumSize, Qt::KeepAspectRatio);
+        }
     }
-
-    //TODO: move to common utils, opentldrecognition
-    cv::Mat cvImageWrapper, cvImage;
-    int type = image.sixteenBit() ? CV_16UC3 : CV_8UC3;
-    type     = image.hasAlpha()   ? type     : type+8;
-
-    switch (type)
+    else
     {
-        case CV_8UC4:
-        case CV_16UC4:
-            cvImageWrapper = cv::Mat(image.height(), image.width(), type, image.bits());
-            cvtColor(cvImageWrapper, cvImage, CV_RGBA2GRAY);
-            break;
-        case CV_8UC3:
-        case CV_16UC3:
-            cvImageWrapper = cv::Mat(image.height(), image.width(), type, image.bits());
-            cvtColor(cvImageWrapper, cvImage, CV_RGB2GRAY);
-            break;
+        int inputArea                    = image.width() * image.height();
+        const int maxAcceptableInputArea = 1024*768;
+
+        if (inputArea > maxAcceptableInputArea)
+        {
+            // Resize to 1024 * 768 (or comparable area for different aspect ratio)
+            // Looking for scale factor z where A = w*z * h*z => z = sqrt(A/(w*h))
+            qreal z          = qSqrt(qreal(maxAcceptableInputArea) / image.width() / image.height());
+            QSize scaledSize = image.size() * z;
+            image            = image.smoothScale(scaledSize, Qt::KeepAspectRatio);
+        }
     }
 
-    if (type == CV_16UC4 || type == CV_16UC3)
+    // DImg pixels always have 4 channels, in B, G, R, A order, whatever hasAlpha() says.
+
+    cv::Mat cvImage;
+    cv::Mat cvImageWrapper(image.height(), image.width(),
+                           image.sixteenBit() ? CV_16UC4 : CV_8UC4, image.bits());
+    cvtColor(cvImageWrapper, cvImage, CV_BGRA2GRAY);
+
+    if (image.sixteenBit())
     {
-        cvImage.convertTo(cvImage, CV_8UC1, 1/255.0);
+        cvImage.convertTo(cvImage, CV_8UC1, 1/256.0);
     }
 
     equalizeHist(cvImage, cvImage);
     return cvImage;
 }
 
-
 QList<QRect> OpenCVFaceDetector::detectFaces(const cv::Mat& inputImage, const cv::Size& originalSize)
 {
     if (inputImage.empty())
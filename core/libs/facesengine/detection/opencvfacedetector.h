@@ -59,8 +59,14 @@ public:
     explicit OpenCVFaceDetector(const QStringList& cascadeDirs);
     ~OpenCVFaceDetector();
 
-    cv::Mat prepareForDetection(const QImage& inputImage) const;
-    cv::Mat prepareForDetection(const Digikam::DImg& inputImage) const;
+    /**
+     * Returns the equalized grayscale image given to detectFaces(), reduced to about 1024 x 768 pixels.
+     * For a DImg, a maximumSize reduces the longest side to this size instead.
+     * These methods use no detector state and can be called from any thread.
+     */
+    static cv::Mat prepareForDetection(const QImage& inputImage);
+    static cv::Mat prepareForDetection(const Digikam::DImg& inputImage, int maximumSize = 0);
+
     QList<QRect> detectFaces(const cv::Mat& inputImage, const cv::Size& originalSize = cv::Size(0, 0));
 
     /**
@@ -26,28 +26,8 @@
 // OpenCV includes need to show up before Qt includes
 
 #ifdef HAVE_FACESENGINE_DNN
-#   include "tensor.h"
-#   include "input.h"
-#   include "layers.h"
-#   include "loss.h"
-#   include "core.h"
-#   include "solvers.h"
-#   include "cpu_dlib.h"
-#   include "tensor_tools.h"
-#   include "utilities.h"
-#   include "validation.h"
-#   include "serialize.h"
-#   include "matrix.h"
-#   include "matrix_utilities.h"
-#   include "matrix_subexp.h"
-#   include "matrix_math_functions.h"
-#   include "matrix_generic_image.h"
-#   include "assign_image.h"
-#   include "interpolation.h"
-#   include "frontal_face_detector.h"
-#   include "cv_image.h"
 #   include "dnnfacemodel.h"
-#   include "dnn_face.h"
+#   include "dnnfaceembedder.h"
 #endif
 
 // Local includes
@@ -73,10 +53,6 @@ public:
     FaceDbBackend* db;
 };
 
-/*
- * NOTE: This constructor is only used in facerec_dnnborrowed.cpp.
- * Create an object of FaceDb to invoke the method getFaceVector
- */
 FaceDb::FaceDb()
     : d(new Private)
 {
@@ -424,8 +400,7 @@ void FaceDb::clearLBPHTraining(const QList<int>& identities, const QString& cont
 #ifdef HAVE_FACESENGINE_DNN
 void FaceDb::getFaceVector(cv::Mat data, std::vector<float>& vecdata)
 {
-    DNNFaceKernel dnnFaceKernel;
-    dnnFaceKernel.getFaceVector(data, vecdata);
+    vecdata = DNNFaceEmbedder::instance()->faceVector(data);
 }
 #endif
 
@@ -713,12 +688,8 @@ DNNFaceModel FaceDb::dnnFaceModel() const
                 qCDebug(DIGIKAM_FACEDB_LOG) << "Checkout compressed histogram " << metadata.databaseId << " for identity "
                                             << metadata.identity << " with size " << cData.size();
 
-                float* const it = (float *)new_vec.data();
-
-                for (int i = 0; i < 128; ++i)
-                {
-                    vecdata.push_back(*(it+i));
-                }
+                const float* const it = reinterpret_cast<const float*>(new_vec.constData());
+                vecdata.assign(it, it + new_vec.size() / sizeof(float));
 
                 mats        << vecdata;
                 matMetadata << metadata;
@@ -214,6 +214,61 @@ QList<QRectF> FaceDetector::detectFaces(const Digikam::DImg& image, const QSize&
     return result;
 }
 
+QList<QRectF> FaceDetector::detectFaces(const cv::Mat& preparedImage, const QSize& originalSize)
+{
+    QList<QRectF> result;
+
+    if (preparedImage.empty())
+    {
+        return result;
+    }
+
+    try
+    {
+        cv::Size cvOriginalSize;
+
+        if (originalSize.isValid())
+        {
+            cvOriginalSize = cv::Size(originalSize.width(), originalSize.height());
+        }
+        else
+        {
+            cvOriginalSize = cv::Size(preparedImage.cols, preparedImage.rows);
+        }
+
+        QList<QRect> absRects = d->backend()->detectFaces(preparedImage, cvOriginalSize);
+        result                = toRelativeRects(absRects, QSize(preparedImage.cols, preparedImage.rows));
+    }
+    catch (cv::Exception& e)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+    }
+    catch(...)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+    }
+
+    return result;
+}
+
+cv::Mat FaceDetector::prepareForDetection(const Digikam::DImg& image)
+{
+    try
+    {
+        return OpenCVFaceDetector::prepareForDetection(image, OpenCVFaceDetector::recommendedImageSizeForDetection());
+    }
+    catch (cv::Exception& e)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+    }
+    catch(...)
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+    }
+
+    return cv::Mat();
+}
+
 void FaceDetector::setParameter(const QString& parameter, const QVariant& value)
 {
     d->m_parameters.insert(parameter, value);
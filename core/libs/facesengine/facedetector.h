@@ -25,6 +25,9 @@
 #ifndef DIGIKAM_FACESENGINE_FACEDETECTOR_H
 #define DIGIKAM_FACESENGINE_FACEDETECTOR_H
 
+// OpenCV includes need to show up before Qt includes
+#include "digikam_opencv.h"
+
 // Qt includes
 
 #include <QExplicitlySharedDataPointer>
@@ -82,6 +85,19 @@ public:
      */
     QList<QRectF> detectFaces(const Digikam::DImg& image, const QSize& originalSize = QSize());
 
+    /**
+     * Scan an image returned by prepareForDetection() for faces.
+     * Found faces are returned in relative coordinates.
+     */
+    QList<QRectF> detectFaces(const cv::Mat& preparedImage, const QSize& originalSize);
+
+    /**
+     * Returns the equalized grayscale image scanned by the detector, with the longest side
+     * reduced to recommendedImageSize(). This needs no detection backend: it can be done
+     * once per image, in any thread, and the result passed to detectFaces().
+     */
+    static cv::Mat prepareForDetection(const Digikam::DImg& image);
+
     /**
      * Tunes backend parameters.
      * Available parameters:
@@ -95,64 +95,79 @@ using anet_type = loss_metric<fc_no_bias<128,avg_pool_everything<
 using namespace Digikam;
 using namespace Digikam::redeye;
 
+/** The face recognition network, the face detector and the shape predictor aligning
+ *  the faces for the network. The models are loaded once by loadModels().
+ *  Not thread-safe: see DNNFaceEmbedder for the instance shared by the threads.
+ */
 class DNNFaceKernel
 {
 public:
 
     explicit DNNFaceKernel()
+        : detector(get_frontal_face_detector()),
+          loaded(false)
     {
     };
 
-    void getFaceVector(cv::Mat tmp_mat, std::vector<float>& vecdata)
+    /** Read the network and the shape predictor from the data files. Returns false on failure.
+     */
+    bool loadModels()
     {
-        anet_type net;
-        frontal_face_detector detector = get_frontal_face_detector();
+        if (loaded)
+        {
+            return true;
+        }
 
         QString path1 = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                               QLatin1String("digikam/facesengine/dlib_face_recognition_resnet_model_v1.dat")); 
-        deserialize(path1.toStdString()) >> net;
+                                               QLatin1String("digikam/facesengine/dlib_face_recognition_resnet_model_v1.dat"));
+
+        try
+        {
+            deserialize(path1.toStdString()) >> net;
+        }
+        catch (...)
+        {
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Cannot read the face recognition network" << path1;
+            return false;
+        }
 
-        redeye::ShapePredictor sp;
         QString path2 = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
                                                QLatin1String("digikam/facesengine/shapepredictor.dat"));
         QFile model(path2);
-        redeye::ShapePredictor* const temp = new redeye::ShapePredictor();
 
         qCDebug(DIGIKAM_FACEDB_LOG) << "Start reading shape predictor file";
 
-        if (model.open(QIODevice::ReadOnly))
+        if (!model.open(QIODevice::ReadOnly))
         {
-            QDataStream dataStream(&model);
-            dataStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-            dataStream >> *temp;
-            sp = *temp;
-            model.close();
-        }
-        else
-        {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Error open file shapepredictor.dat\n";
-            return;
+            qCWarning(DIGIKAM_FACEDB_LOG) << "Error open file shapepredictor.dat";
+            return false;
         }
 
-        delete temp;
+        QDataStream dataStream(&model);
+        dataStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        dataStream >> sp;
+        model.close();
 
-        matrix<rgb_pixel> img;
-        std::vector<matrix<rgb_pixel> > faces;
+        loaded = true;
 
-        std::cout << "tmp_mat channels: " << tmp_mat.channels() << std::endl;
+        return true;
+    };
 
+    /** Return the 150x150 chip of the face found in tmp_mat, aligned with the shape predictor,
+     *  or the whole image resized to 150x150 if no face is found.
+     */
+    matrix<rgb_pixel> faceChip(cv::Mat tmp_mat)
+    {
+        matrix<rgb_pixel> img;
         assign_image(img, cv_image<rgb_pixel>(tmp_mat));
-        bool face_flag = false;
 
         for (auto face : detector(img))
         {
             qCDebug(DIGIKAM_FACEDB_LOG) << "Detected face";
 
-            face_flag = true;
             cv::Mat gray;
 
             int type = tmp_mat.type();
-            qCDebug(DIGIKAM_FACEDB_LOG) << "type: " << type;
 
             if (type == CV_8UC3 || type == CV_16UC3)
             {
@@ -170,42 +185,84 @@ public:
 
             cv::Rect new_rect(face.left(), face.top(), face.right()-face.left(), face.bottom()-face.top());
             FullObjectDetection object = sp(gray, new_rect);
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Full object detection finished";
             matrix<rgb_pixel> face_chip;
             extract_image_chip(img, get_face_chip_details(object, 150, 0.25), face_chip);
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Extract image chip finished";
-            faces.push_back(move(face_chip));
-            break;
+
+            return face_chip;
+        }
+
+        cv::resize(tmp_mat, tmp_mat, cv::Size(150, 150));
+        assign_image(img, cv_image<rgb_pixel>(tmp_mat));
+
+        return img;
+    };
+
+    /** Compute the face vectors of all the images in one forward pass of the network.
+     *  loadModels() must have succeeded.
+     */
+    void getFaceVectors(const std::vector<cv::Mat>& mats, std::vector<std::vector<float> >& vecdata)
+    {
+        // The empty images get an empty vector.
+
+        std::vector<matrix<rgb_pixel> > faces;
+        std::vector<size_t>             indexes;
+
+        for (size_t i = 0 ; i < mats.size() ; ++i)
+        {
+            if (!mats[i].empty())
+            {
+                faces.push_back(faceChip(mats[i]));
+                indexes.push_back(i);
+            }
         }
 
-        if (!face_flag)
+        vecdata.clear();
+        vecdata.resize(mats.size());
+
+        if (faces.empty())
         {
-            cv::resize(tmp_mat, tmp_mat, cv::Size(150, 150));
-            assign_image(img, cv_image<rgb_pixel>(tmp_mat));
-            faces.push_back(img);
+            return;
         }
 
-        qCDebug(DIGIKAM_FACEDB_LOG) << "Start neural network";
+        qCDebug(DIGIKAM_FACEDB_LOG) << "Start neural network for" << faces.size() << "faces";
         std::vector<matrix<float, 0, 1> > face_descriptors = net(faces);
-        qCDebug(DIGIKAM_FACEDB_LOG) << "Face descriptors size:" << face_descriptors.size();
 
-        if (face_descriptors.size() != 0)
+        for (size_t f = 0 ; f < face_descriptors.size() && f < indexes.size() ; ++f)
         {
-            vecdata.clear();
+            std::vector<float>& vec = vecdata[indexes[f]];
 
-            for(int i = 0 ; i < face_descriptors[0].nr() ; ++i)
+            for (int i = 0 ; i < face_descriptors[f].nr() ; ++i)
             {
-                for(int j = 0 ; j < face_descriptors[0].nc() ; ++j)
+                for (int j = 0 ; j < face_descriptors[f].nc() ; ++j)
                 {
-                    vecdata.push_back(face_descriptors[0](i, j));
+                    vec.push_back(face_descriptors[f](i, j));
                 }
             }
         }
-        /*else
+    };
+
+    void getFaceVector(cv::Mat tmp_mat, std::vector<float>& vecdata)
+    {
+        if (!loadModels())
+        {
+            return;
+        }
+
+        std::vector<std::vector<float> > vectors;
+        getFaceVectors(std::vector<cv::Mat>(1, tmp_mat), vectors);
+
+        if (!vectors.empty() && !vectors[0].empty())
         {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Error calculate face vector";
-        }*/
+            vecdata = vectors[0];
+        }
     };
+
+private:
+
+    anet_type                net;
+    frontal_face_detector    detector;
+    redeye::ShapePredictor   sp;
+    bool                     loaded;
 };
 
 #endif // DIGIKAM_DNN_FACE_H
@@ -0,0 +1,166 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2019-08-31
+ * Description : Resident engine computing the face vectors
+ *               with the deep learning network
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// DNN includes need to show up before Qt includes
+
+#include "dnn_face.h"
+
+#include "dnnfaceembedder.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN DNNFaceEmbedder::Private
+{
+public:
+
+    explicit Private()
+        : kernel(nullptr),
+          failed(false)
+    {
+    }
+
+    ~Private()
+    {
+        delete kernel;
+    }
+
+    /** Load the models if not done yet. The mutex must be locked.
+     */
+    bool load()
+    {
+        if (kernel)
+        {
+            return true;
+        }
+
+        // Do not try to read the data files again after a failure.
+
+        if (failed)
+        {
+            return false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        DNNFaceKernel* const newKernel = new DNNFaceKernel;
+
+        if (!newKernel->loadModels())
+        {
+            delete newKernel;
+            failed = true;
+
+            return false;
+        }
+
+        kernel = newKernel;
+
+        qCDebug(DIGIKAM_FACESENGINE_LOG) << "Face recognition network loaded in" << timer.elapsed() << "ms";
+
+        return true;
+    }
+
+public:
+
+    QMutex         mutex;
+    DNNFaceKernel* kernel;
+    bool           failed;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN DNNFaceEmbedderCreator
+{
+public:
+
+    DNNFaceEmbedder object;
+};
+
+Q_GLOBAL_STATIC(DNNFaceEmbedderCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+DNNFaceEmbedder* DNNFaceEmbedder::instance()
+{
+    return &creator->object;
+}
+
+DNNFaceEmbedder::DNNFaceEmbedder()
+    : d(new Private)
+{
+}
+
+DNNFaceEmbedder::~DNNFaceEmbedder()
+{
+    delete d;
+}
+
+bool DNNFaceEmbedder::isLoaded()
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->load();
+}
+
+std::vector<std::vector<float> > DNNFaceEmbedder::faceVectors(const std::vector<cv::Mat>& faces)
+{
+    std::vector<std::vector<float> > vectors;
+
+    if (faces.empty())
+    {
+        return vectors;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->load())
+    {
+        vectors.resize(faces.size());
+
+        return vectors;
+    }
+
+    d->kernel->getFaceVectors(faces, vectors);
+
+    return vectors;
+}
+
+std::vector<float> DNNFaceEmbedder::faceVector(const cv::Mat& face)
+{
+    std::vector<std::vector<float> > vectors = faceVectors(std::vector<cv::Mat>(1, face));
+
+    return vectors.empty() ? std::vector<float>() : vectors[0];
+}
+
+} // namespace Digikam
@@ -0,0 +1,78 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2019-08-31
+ * Description : Resident engine computing the face vectors
+ *               with the deep learning network
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DNN_FACE_EMBEDDER_H
+#define DIGIKAM_DNN_FACE_EMBEDDER_H
+
+// OpenCV library
+
+#include "digikam_opencv.h"
+
+// C++ includes
+
+#include <vector>
+
+namespace Digikam
+{
+
+/** The face recognition network of the process. The network and the shape predictor
+ *  are read from the data files at the first use only, and stay in memory.
+ *  The methods are thread-safe: the calls from several threads are serialized.
+ */
+class DNNFaceEmbedder
+{
+public:
+
+    static DNNFaceEmbedder* instance();
+
+    /** Return true if the models can be loaded. Loads them on the first call.
+     */
+    bool isLoaded();
+
+    /** Compute the 128 values face vectors of the RGB or RGBA face images, of 8 or 16 bits,
+     *  in one forward pass of the network. Each image is aligned on the face found in it,
+     *  or used whole when no face is found. The vectors are in the order of the images.
+     *  Returns empty vectors if the models cannot be loaded.
+     */
+    std::vector<std::vector<float> > faceVectors(const std::vector<cv::Mat>& faces);
+
+    /** The face vector of one face image, empty on failure.
+     */
+    std::vector<float> faceVector(const cv::Mat& face);
+
+private:
+
+    DNNFaceEmbedder();
+    ~DNNFaceEmbedder();
+
+    DNNFaceEmbedder(const DNNFaceEmbedder&); // Disable
+
+    friend class DNNFaceEmbedderCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DNN_FACE_EMBEDDER_H
@@ -0,0 +1,156 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2019-08-31
+ * Description : In-memory nearest neighbor index of the face vectors
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dnnfaceindex.h"
+
+// C++ includes
+
+#include <cmath>
+#include <algorithm>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgkernels.h"
+
+namespace Digikam
+{
+
+DNNFaceIndex::DNNFaceIndex()
+    : m_dimension(0),
+      m_stride(0)
+{
+}
+
+DNNFaceIndex::~DNNFaceIndex()
+{
+}
+
+void DNNFaceIndex::clear()
+{
+    m_data.clear();
+    m_labels.clear();
+    m_dimension = 0;
+    m_stride    = 0;
+}
+
+void DNNFaceIndex::add(const std::vector<float>& vec, int label)
+{
+    if (vec.empty())
+    {
+        return;
+    }
+
+    if (m_labels.empty())
+    {
+        m_dimension = vec.size();
+        m_stride    = (m_dimension + 7) / 8 * 8;
+    }
+    else if (vec.size() != m_dimension)
+    {
+        qCWarning(DIGIKAM_FACESENGINE_LOG) << "Face vector of size" << vec.size()
+                                           << "ignored, the index uses vectors of size" << m_dimension;
+        return;
+    }
+
+    m_data.insert(m_data.end(), vec.begin(), vec.end());
+    m_data.resize(m_data.size() + m_stride - m_dimension, 0.0F);
+    m_labels.push_back(label);
+}
+
+size_t DNNFaceIndex::size() const
+{
+    return m_labels.size();
+}
+
+std::vector<DNNFaceIndex::Match> DNNFaceIndex::nearest(const std::vector<float>& vec, int k, double threshold) const
+{
+    std::vector<Match> matches;
+
+    if (m_labels.empty() || vec.size() != m_dimension || k < 1)
+    {
+        return matches;
+    }
+
+    std::vector<float> query(vec);
+    query.resize(m_stride, 0.0F);
+
+    std::vector<float> squared(m_labels.size());
+    DImgKernels::squaredDistances(query.data(), m_data.data(), m_labels.size(), m_stride, squared.data());
+
+    // Keep the k best labels sorted by distance, comparing the squared distances.
+
+    const double maxSquared = threshold * threshold;
+
+    for (size_t r = 0 ; r < squared.size() ; ++r)
+    {
+        const double dist = squared[r];
+
+        if ((dist >= maxSquared) || ((int)matches.size() == k && dist >= matches.back().distance))
+        {
+            continue;
+        }
+
+        std::vector<Match>::iterator it = matches.begin();
+
+        while (it != matches.end() && it->label != m_labels[r])
+        {
+            ++it;
+        }
+
+        if (it != matches.end())
+        {
+            if (dist >= it->distance)
+            {
+                continue;
+            }
+
+            matches.erase(it);
+        }
+        else if ((int)matches.size() == k)
+        {
+            matches.pop_back();
+        }
+
+        Match match;
+        match.label    = m_labels[r];
+        match.distance = dist;
+
+        it = matches.begin();
+
+        while (it != matches.end() && it->distance <= dist)
+        {
+            ++it;
+        }
+
+        matches.insert(it, match);
+    }
+
+    for (size_t i = 0 ; i < matches.size() ; ++i)
+    {
+        matches[i].distance = std::sqrt(matches[i].distance);
+    }
+
+    return matches;
+}
+
+} // namespace Digikam
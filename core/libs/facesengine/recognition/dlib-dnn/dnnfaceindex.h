@@ -0,0 +1,82 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2019-08-31
+ * Description : In-memory nearest neighbor index of the face vectors
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DNN_FACE_INDEX_H
+#define DIGIKAM_DNN_FACE_INDEX_H
+
+// C++ includes
+
+#include <cstddef>
+#include <vector>
+
+namespace Digikam
+{
+
+/** The face vectors of the trained faces, stored in one contiguous matrix, with their labels.
+ *  The Euclidean distances of a query vector to all the vectors are computed by
+ *  DImgKernels::squaredDistances(), which dispatches to SSE4.1 or AVX2 code at run time
+ *  when the CPU supports it. The search is exact.
+ *  Not thread-safe.
+ */
+class DNNFaceIndex
+{
+public:
+
+    class Match
+    {
+    public:
+
+        int    label;
+        double distance;
+    };
+
+public:
+
+    explicit DNNFaceIndex();
+    ~DNNFaceIndex();
+
+    void   clear();
+
+    /** Append a vector. All the vectors must have the same size, the others are ignored.
+     */
+    void   add(const std::vector<float>& vec, int label);
+
+    size_t size() const;
+
+    /** Return up to k different labels with the smallest distances to vec, in increasing
+     *  order of distance. The distance of a label is the one of its nearest vector.
+     *  Only the distances smaller than threshold are returned.
+     */
+    std::vector<Match> nearest(const std::vector<float>& vec, int k, double threshold) const;
+
+private:
+
+    /// The vectors, each padded with zeros to stride values.
+    std::vector<float> m_data;
+    std::vector<int>   m_labels;
+    size_t             m_dimension;
+    size_t             m_stride;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DNN_FACE_INDEX_H
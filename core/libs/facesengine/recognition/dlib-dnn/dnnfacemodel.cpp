@@ -32,6 +32,7 @@
 #include "digikam_debug.h"
 #include "facedbaccess.h"
 #include "facedb.h"
+#include "dnnfaceembedder.h"
 
 namespace Digikam
 {
@@ -158,16 +159,8 @@ void DNNFaceModel::setMats(const QList<std::vector<float> >& mats, const QList<D
 
 void DNNFaceModel::update(const std::vector<cv::Mat>& images, const std::vector<int>& labels, const QString& context)
 {
-    std::vector<std::vector<float> > src;
-
-    foreach (const cv::Mat& mat, images)
-    {
-        std::vector<float> vecdata;
-        FaceDbAccess().db()->getFaceVector(mat, vecdata);
-        qCDebug(DIGIKAM_FACEDB_LOG) << "vecdata: " << vecdata[vecdata.size()-2]
-                                                   << vecdata[vecdata.size()-1];
-        src.push_back(vecdata);
-    }
+    // One forward pass of the network for all the faces.
+    std::vector<std::vector<float> > src = DNNFaceEmbedder::instance()->faceVectors(images);
 
     ptr()->update(src, labels);
 
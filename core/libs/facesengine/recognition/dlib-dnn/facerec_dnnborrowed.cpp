@@ -39,6 +39,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "dnnfaceembedder.h"
 
 using namespace cv;
 
@@ -83,6 +84,7 @@ void DNNFaceRecognizer::train(std::vector<std::vector<float> > _in_src, InputArr
     {
         m_labels.release();
         m_src.clear();
+        m_index.clear();
     }
 
     // append labels to m_labels matrix
@@ -90,6 +92,7 @@ void DNNFaceRecognizer::train(std::vector<std::vector<float> > _in_src, InputArr
     {
         m_labels.push_back(labels.at<int>((int)labelIdx));
         m_src.push_back(src[(int)labelIdx]);
+        m_index.add(src[(int)labelIdx], labels.at<int>((int)labelIdx));
     }
 
     return ;
@@ -189,35 +192,52 @@ void DNNFaceRecognizer::getFaceVector(cv::Mat data, std::vector<float>& vecdata)
 */
 void DNNFaceRecognizer::predict(cv::InputArray _src, int& minClass, double& minDist) const
 {
-    qCWarning(DIGIKAM_FACESENGINE_LOG) << "Predicting face image";
+    cv::Mat src = _src.getMat();//254*254
+    nearest(DNNFaceEmbedder::instance()->faceVector(src), minClass, minDist);
+}
+
+void DNNFaceRecognizer::predict(const std::vector<cv::Mat>& srcs, std::vector<int>& labels,
+                                std::vector<double>& dists) const
+{
+    // One forward pass of the network for all the faces.
+    std::vector<std::vector<float> > vectors = DNNFaceEmbedder::instance()->faceVectors(srcs);
 
-    cv::Mat src              = _src.getMat();//254*254
-    std::vector<float> vecdata;
-    FaceDb* const tmp_facedb = new FaceDb();
-    tmp_facedb->getFaceVector(src, vecdata);
-    qCWarning(DIGIKAM_FACESENGINE_LOG) << "vecdata: " << vecdata[vecdata.size()-2] << " " << vecdata[vecdata.size()-1];
+    labels.resize(vectors.size());
+    dists.resize(vectors.size());
 
+    for (size_t i = 0 ; i < vectors.size() ; ++i)
+    {
+        nearest(vectors[i], labels[i], dists[i]);
+    }
+}
+
+void DNNFaceRecognizer::nearest(const std::vector<float>& vecdata, int& minClass, double& minDist) const
+{
     minDist  = DBL_MAX;
     minClass = -1;
 
-    // find nearest neighbor
-
-    for (size_t sampleIdx = 0 ; sampleIdx < m_src.size() ; ++sampleIdx)
+    if (vecdata.empty())
     {
-        double dist = 0;
+        qCWarning(DIGIKAM_FACESENGINE_LOG) << "Cannot compute the face vector";
+        return;
+    }
 
-        for (size_t i = 0 ; i < m_src[sampleIdx].size() ; ++i)
-        {
-            dist += (vecdata[i]-m_src[sampleIdx][i])*(vecdata[i]-m_src[sampleIdx][i]);
-        }
+    std::vector<DNNFaceIndex::Match> matches = m_index.nearest(vecdata, 1, m_threshold);
+
+    if (!matches.empty())
+    {
+        minDist  = matches[0].distance;
+        minClass = matches[0].label;
+    }
+}
 
-        dist = std::sqrt(dist);
+void DNNFaceRecognizer::rebuildIndex()
+{
+    m_index.clear();
 
-        if ((dist < minDist) && (dist < m_threshold))
-        {
-            minDist  = dist;
-            minClass = m_labels.at<int>((int) sampleIdx);
-        }
+    for (size_t i = 0 ; i < m_src.size() && i < m_labels.total() ; ++i)
+    {
+        m_index.add(m_src[i], m_labels.at<int>((int)i));
     }
 }
 
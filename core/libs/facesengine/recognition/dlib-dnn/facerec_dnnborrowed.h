@@ -29,6 +29,7 @@
 #include "digikam_opencv.h"
 #include "facedb.h"
 #include "face.hpp"
+#include "dnnfaceindex.h"
 
 // C++ includes
 
@@ -86,6 +87,12 @@ public:
      */
     void predict(cv::InputArray _src, int& label, double& dist) const;
 
+    /**
+     * Predicts the labels and confidences of several samples,
+     * computing their face vectors in one pass of the network.
+     */
+    void predict(const std::vector<cv::Mat>& srcs, std::vector<int>& labels, std::vector<double>& dists) const;
+
     /**
      * Getter and setter functions.
      */
@@ -93,10 +100,10 @@ public:
     void   setThreshold(double _threshold)                  { m_threshold = _threshold;            }
 
     std::vector<std::vector<float> > getSrc() const         { return m_src;                        }
-    void setSrc(std::vector<std::vector<float> > _src)      { m_src = _src;                        }
+    void setSrc(std::vector<std::vector<float> > _src)      { m_src = _src; rebuildIndex();        }
 
     cv::Mat getLabels() const                               { return m_labels;                     }
-    void setLabels(cv::Mat _labels)                         { m_labels = _labels;                  }
+    void setLabels(cv::Mat _labels)                         { m_labels = _labels; rebuildIndex();  }
 
 private:
 
@@ -107,6 +114,16 @@ private:
      */
     void train(std::vector<std::vector<float> > src, cv::InputArray labels, bool preserveData);
 
+    /**
+     * Finds the label of the nearest trained face vector, closer than the threshold.
+     */
+    void nearest(const std::vector<float>& vecdata, int& label, double& dist) const;
+
+    /**
+     * Fills the index from m_src and m_labels.
+     */
+    void rebuildIndex();
+
 private:
 
     // NOTE: Do not use a d private internal container here, this will crash OpenCV in cv::Algorithm::set()
@@ -114,6 +131,9 @@ private:
 
     std::vector<std::vector<float> > m_src;
     cv::Mat                          m_labels;
+
+    /// The face vectors of m_src with their labels, searched by predict().
+    DNNFaceIndex                     m_index;
 };
 
 } // namespace Digikam
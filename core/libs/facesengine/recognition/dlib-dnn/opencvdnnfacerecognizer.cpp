@@ -113,8 +113,9 @@ cv::Mat OpenCVDNNFaceRecognizer::prepareForRecognition(const QImage& inputImage)
             cvtColor(cvImageWrapper, cvImage, CV_RGBA2RGB);
             break;
         default:
+            // Deep copy: the faces can be kept after the QImage is released.
             image          = image.convertToFormat(QImage::Format_RGB888);
-            cvImage        = cv::Mat(image.height(), image.width(), CV_8UC3, image.scanLine(0), image.bytesPerLine());
+            cvImage        = cv::Mat(image.height(), image.width(), CV_8UC3, image.scanLine(0), image.bytesPerLine()).clone();
             //cvtColor(cvImageWrapper, cvImage, CV_RGB2GRAY);
             break;
     }
@@ -139,6 +140,23 @@ int OpenCVDNNFaceRecognizer::recognize(const cv::Mat& inputImage)
     return predictedLabel;
 }
 
+QList<int> OpenCVDNNFaceRecognizer::recognize(const std::vector<cv::Mat>& inputImages)
+{
+    std::vector<int>    predictedLabels;
+    std::vector<double> confidences;
+    d->dnn()->predict(inputImages, predictedLabels, confidences);
+
+    QList<int> ids;
+
+    for (size_t i = 0 ; i < predictedLabels.size() ; ++i)
+    {
+        qCDebug(DIGIKAM_FACESENGINE_LOG) << predictedLabels[i] << confidences[i];
+        ids << ((confidences[i] > d->threshold) ? -1 : predictedLabels[i]);
+    }
+
+    return ids;
+}
+
 void OpenCVDNNFaceRecognizer::train(const std::vector<cv::Mat>& images,
                                     const std::vector<int>& labels,
                                     const QString& context,
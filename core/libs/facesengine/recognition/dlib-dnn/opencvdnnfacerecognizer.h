@@ -31,6 +31,7 @@
 // Qt include
 
 #include <QImage>
+#include <QList>
 
 namespace Digikam
 {
@@ -60,6 +61,12 @@ public:
      */
     int recognize(const cv::Mat& inputImage);
 
+    /**
+     *  Try to recognize the given images, in one pass of the network.
+     *  Returns the identity ids in the order of the images, -1 for the unrecognized ones.
+     */
+    QList<int> recognize(const std::vector<cv::Mat>& inputImages);
+
     /**
      *  Trains the given images, representing faces of the given matched identities.
      */
@@ -975,6 +975,50 @@ QList<Identity> RecognitionDatabase::recognizeFaces(ImageListProvider* const ima
 
     QList<Identity> result;
 
+#ifdef HAVE_FACESENGINE_DNN
+    if (d->recognizeAlgorithm == RecognizeAlgorithm::DNN)
+    {
+        // The faces are recognized together, with one pass of the network.
+
+        std::vector<cv::Mat> faces;
+        QList<int>           ids;
+        int                  count = 0;
+
+        try
+        {
+            for (; !images->atEnd(); images->proceed(), ++count)
+            {
+                faces.push_back(d->preprocessingChainRGB(images->image()));
+            }
+
+            ids = d->dnn()->recognize(faces);
+        }
+        catch (cv::Exception& e)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+        }
+        catch (...)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+        }
+
+        // The images left after an exception are not recognized.
+
+        for (; !images->atEnd(); images->proceed())
+        {
+            ++count;
+        }
+
+        for (int i = 0 ; i < count ; ++i)
+        {
+            int id = (i < ids.size()) ? ids.at(i) : -1;
+            result << ((id == -1) ? Identity() : d->identityCache.value(id));
+        }
+
+        return result;
+    }
+#endif
+
     for (; !images->atEnd(); images->proceed())
     {
         int id = -1;
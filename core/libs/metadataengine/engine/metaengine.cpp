@@ -77,11 +77,40 @@ MetaEngine& MetaEngine::operator=(const MetaEngine& metadata)
 
 //-- Statics methods ----------------------------------------------
 
+#ifdef _XMP_SUPPORT_
+
+/** Lock function given to the Adobe XMP toolkit, which is not thread-safe.
+ */
+static void s_xmpToolkitLock(void* pLockData, bool lockUnlock)
+{
+    QMutex* const mutex = static_cast<QMutex*>(pLockData);
+
+    if (lockUnlock)
+    {
+        mutex->lock();
+    }
+    else
+    {
+        mutex->unlock();
+    }
+}
+
+#endif // _XMP_SUPPORT_
+
 bool MetaEngine::initializeExiv2()
 {
+    QMutexLocker lock(&s_metaEngineGlobalMutex);
+
+    if (s_metaEngineInitialized.loadAcquire())
+    {
+        return true;
+    }
+
+    Exiv2::LogMsg::setHandler(MetaEngine::Private::printExiv2MessageHandler);
+
 #ifdef _XMP_SUPPORT_
 
-    if (!Exiv2::XmpParser::initialize())
+    if (!Exiv2::XmpParser::initialize(s_xmpToolkitLock, &s_metaEngineGlobalMutex))
         return false;
 
     registerXmpNameSpace(QLatin1String("http://ns.adobe.com/lightroom/1.0/"),  QLatin1String("lr"));
@@ -92,11 +121,17 @@ bool MetaEngine::initializeExiv2()
 
 #endif // _XMP_SUPPORT_
 
+    s_metaEngineInitialized.storeRelease(1);
+
     return true;
 }
 
 bool MetaEngine::cleanupExiv2()
 {
+    QMutexLocker lock(&s_metaEngineGlobalMutex);
+
+    s_metaEngineInitialized.storeRelease(0);
+
     // Fix memory leak if Exiv2 support XMP.
 #ifdef _XMP_SUPPORT_
 
@@ -165,6 +200,8 @@ QString MetaEngine::Exiv2Version()
 
 MetaEngineData MetaEngine::data() const
 {
+    QMutexLocker lock(&d->mutex);
+
     MetaEngineData data;
     data.d = d->data;
 
@@ -173,6 +210,8 @@ MetaEngineData MetaEngine::data() const
 
 void MetaEngine::setData(const MetaEngineData& data)
 {
+    QMutexLocker lock(&d->mutex);
+
     if (data.d)
     {
         d->data = data.d;
@@ -190,7 +229,7 @@ bool MetaEngine::loadFromData(const QByteArray& imgData)
     if (imgData.isEmpty())
         return false;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
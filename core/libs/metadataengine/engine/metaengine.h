@@ -177,6 +177,8 @@ public:
      *  This method must be called before using libMetaEngine with multithreading.
      *  It initialize several non re-entrancy code from Adobe XMP SDK
      *  See Bug #166424 for details. Call cleanupExiv2() to clean things up later.
+     *  It is called by the first instance created if it was not done before.
+     *  Once done, independent instances can be used from different threads at the same time.
      */
     static bool initializeExiv2();
 
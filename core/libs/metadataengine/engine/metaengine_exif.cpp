@@ -45,8 +45,6 @@ namespace Digikam
 
 bool MetaEngine::canWriteExif(const QString& filePath)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
     try
     {
         Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open((const char*)
@@ -77,7 +75,7 @@ bool MetaEngine::hasExif() const
 
 bool MetaEngine::clearExif() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -98,7 +96,7 @@ bool MetaEngine::clearExif() const
 
 QByteArray MetaEngine::getExifEncoded(bool addExifHeader) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -142,7 +140,7 @@ QByteArray MetaEngine::getExifEncoded(bool addExifHeader) const
 
 bool MetaEngine::setExif(const QByteArray& data) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -169,7 +167,7 @@ bool MetaEngine::setExif(const QByteArray& data) const
 
 QString MetaEngine::getExifComment(bool readDescription) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -241,7 +239,7 @@ static bool is7BitAscii(const QByteArray& s)
 
 bool MetaEngine::setExifComment(const QString& comment, bool writeDescription) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -295,7 +293,7 @@ bool MetaEngine::setExifComment(const QString& comment, bool writeDescription) c
 
 QString MetaEngine::getExifTagTitle(const char* exifTagName)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -318,7 +316,7 @@ QString MetaEngine::getExifTagTitle(const char* exifTagName)
 
 QString MetaEngine::getExifTagDescription(const char* exifTagName)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -341,7 +339,7 @@ QString MetaEngine::getExifTagDescription(const char* exifTagName)
 
 bool MetaEngine::removeExifTag(const char* exifTagName) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -368,7 +366,7 @@ bool MetaEngine::removeExifTag(const char* exifTagName) const
 
 bool MetaEngine::getExifTagRational(const char* exifTagName, long int& num, long int& den, int component) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -399,7 +397,7 @@ bool MetaEngine::getExifTagRational(const char* exifTagName, long int& num, long
 
 bool MetaEngine::setExifTagLong(const char* exifTagName, long val) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -420,7 +418,7 @@ bool MetaEngine::setExifTagLong(const char* exifTagName, long val) const
 
 bool MetaEngine::setExifTagRational(const char* exifTagName, long int num, long int den) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -444,7 +442,7 @@ bool MetaEngine::setExifTagData(const char* exifTagName, const QByteArray& data)
     if (data.isEmpty())
         return false;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -544,7 +542,7 @@ bool MetaEngine::setExifTagVariant(const char* exifTagName, const QVariant& val,
 
 QString MetaEngine::createExifUserStringFromValue(const char* exifTagName, const QVariant& val, bool escapeCR)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -644,7 +642,7 @@ bool MetaEngine::getExifTagLong(const char* exifTagName, long& val) const
 
 bool MetaEngine::getExifTagLong(const char* exifTagName, long& val, int component) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -674,7 +672,7 @@ bool MetaEngine::getExifTagLong(const char* exifTagName, long& val, int componen
 
 QByteArray MetaEngine::getExifTagData(const char* exifTagName) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -707,7 +705,7 @@ QByteArray MetaEngine::getExifTagData(const char* exifTagName) const
 
 QVariant MetaEngine::getExifTagVariant(const char* exifTagName, bool rationalAsListOfInts, bool stringEscapeCR, int component) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -802,7 +800,7 @@ QVariant MetaEngine::getExifTagVariant(const char* exifTagName, bool rationalAsL
 
 QString MetaEngine::getExifTagString(const char* exifTagName, bool escapeCR) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -848,7 +846,7 @@ QString MetaEngine::getExifTagString(const char* exifTagName, bool escapeCR) con
 
 bool MetaEngine::setExifTagString(const char* exifTagName, const QString& value) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -875,7 +873,7 @@ QImage MetaEngine::getExifThumbnail(bool fixOrientation) const
     if (d->exifMetadata().empty())
        return thumbnail;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -940,7 +938,7 @@ bool MetaEngine::setExifThumbnail(const QImage& thumbImage) const
         return removeExifThumbnail();
     }
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -970,7 +968,7 @@ bool MetaEngine::setTiffThumbnail(const QImage& thumbImage) const
 {
     removeExifThumbnail();
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1036,7 +1034,7 @@ bool MetaEngine::setTiffThumbnail(const QImage& thumbImage) const
 
 bool MetaEngine::removeExifThumbnail() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1063,7 +1061,7 @@ MetaEngine::MetaDataMap MetaEngine::getExifTagsDataList(const QStringList& exifK
     if (d->exifMetadata().empty())
        return MetaDataMap();
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1141,7 +1139,7 @@ MetaEngine::MetaDataMap MetaEngine::getExifTagsDataList(const QStringList& exifK
 
 MetaEngine::TagsMap MetaEngine::getStdExifTagsList() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1204,7 +1202,7 @@ MetaEngine::TagsMap MetaEngine::getStdExifTagsList() const
 
 MetaEngine::TagsMap MetaEngine::getMakernoteTagsList() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
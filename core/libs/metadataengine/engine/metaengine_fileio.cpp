@@ -94,7 +94,7 @@ bool MetaEngine::load(const QString& filePath)
     d->filePath      = filePath;
     bool hasLoaded   = false;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -156,7 +156,7 @@ bool MetaEngine::loadFromSidecarAndMerge(const QString& filePath)
 
 #ifdef _XMP_SUPPORT_
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
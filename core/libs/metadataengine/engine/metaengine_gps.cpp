@@ -60,7 +60,7 @@ bool MetaEngine::getGPSInfo(double& altitude, double& latitude, double& longitud
 
 bool MetaEngine::getGPSLatitudeNumber(double* const latitude) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -142,7 +142,7 @@ bool MetaEngine::getGPSLatitudeNumber(double* const latitude) const
 
 bool MetaEngine::getGPSLongitudeNumber(double* const longitude) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -228,7 +228,7 @@ bool MetaEngine::getGPSLongitudeNumber(double* const longitude) const
 
 bool MetaEngine::getGPSAltitude(double* const altitude) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -325,7 +325,7 @@ QString MetaEngine::getGPSLongitudeString() const
 
 bool MetaEngine::initializeGPSInfo()
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -367,7 +367,7 @@ bool MetaEngine::setGPSInfo(const double altitude, const double latitude, const
 
 bool MetaEngine::setGPSInfo(const double* const altitude, const double latitude, const double longitude)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -506,7 +506,7 @@ bool MetaEngine::setGPSInfo(const double altitude, const QString& latitude, cons
 
 bool MetaEngine::removeGPSInfo()
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -34,8 +34,6 @@ namespace Digikam
 
 bool MetaEngine::canWriteIptc(const QString& filePath)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
     try
     {
         Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open((const char*)
@@ -65,7 +63,7 @@ bool MetaEngine::hasIptc() const
 
 bool MetaEngine::clearIptc() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -86,7 +84,7 @@ bool MetaEngine::clearIptc() const
 
 QByteArray MetaEngine::getIptc(bool addIrbHeader) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -128,7 +126,7 @@ QByteArray MetaEngine::getIptc(bool addIrbHeader) const
 
 bool MetaEngine::setIptc(const QByteArray& data) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -160,7 +158,7 @@ MetaEngine::MetaDataMap MetaEngine::getIptcTagsDataList(const QStringList& iptcK
     if (d->iptcMetadata().empty())
        return MetaDataMap();
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -267,7 +265,7 @@ MetaEngine::MetaDataMap MetaEngine::getIptcTagsDataList(const QStringList& iptcK
 
 QString MetaEngine::getIptcTagTitle(const char* iptcTagName)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -289,7 +287,7 @@ QString MetaEngine::getIptcTagTitle(const char* iptcTagName)
 
 QString MetaEngine::getIptcTagDescription(const char* iptcTagName)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -311,7 +309,7 @@ QString MetaEngine::getIptcTagDescription(const char* iptcTagName)
 
 bool MetaEngine::removeIptcTag(const char* iptcTagName) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -353,7 +351,7 @@ bool MetaEngine::setIptcTagData(const char* iptcTagName, const QByteArray& data)
     if (data.isEmpty())
         return false;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -375,7 +373,7 @@ bool MetaEngine::setIptcTagData(const char* iptcTagName, const QByteArray& data)
 
 QByteArray MetaEngine::getIptcTagData(const char* iptcTagName) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -407,7 +405,7 @@ QByteArray MetaEngine::getIptcTagData(const char* iptcTagName) const
 
 QString MetaEngine::getIptcTagString(const char* iptcTagName, bool escapeCR) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -442,7 +440,7 @@ QString MetaEngine::getIptcTagString(const char* iptcTagName, bool escapeCR) con
 
 bool MetaEngine::setIptcTagString(const char* iptcTagName, const QString& value) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -466,7 +464,7 @@ bool MetaEngine::setIptcTagString(const char* iptcTagName, const QString& value)
 
 QStringList MetaEngine::getIptcTagsStringList(const char* iptcTagName, bool escapeCR) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -510,7 +508,7 @@ bool MetaEngine::setIptcTagsStringList(const char* iptcTagName, int maxSize,
                                        const QStringList& oldValues,
                                        const QStringList& newValues) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -574,7 +572,7 @@ bool MetaEngine::setIptcTagsStringList(const char* iptcTagName, int maxSize,
 
 QStringList MetaEngine::getIptcKeywords() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -613,7 +611,7 @@ QStringList MetaEngine::getIptcKeywords() const
 
 bool MetaEngine::setIptcKeywords(const QStringList& oldKeywords, const QStringList& newKeywords) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -675,7 +673,7 @@ bool MetaEngine::setIptcKeywords(const QStringList& oldKeywords, const QStringLi
 
 QStringList MetaEngine::getIptcSubjects() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -712,7 +710,7 @@ QStringList MetaEngine::getIptcSubjects() const
 
 bool MetaEngine::setIptcSubjects(const QStringList& oldSubjects, const QStringList& newSubjects) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -769,7 +767,7 @@ bool MetaEngine::setIptcSubjects(const QStringList& oldSubjects, const QStringLi
 
 QStringList MetaEngine::getIptcSubCategories() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -806,7 +804,7 @@ QStringList MetaEngine::getIptcSubCategories() const
 
 bool MetaEngine::setIptcSubCategories(const QStringList& oldSubCategories, const QStringList& newSubCategories) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -864,7 +862,7 @@ bool MetaEngine::setIptcSubCategories(const QStringList& oldSubCategories, const
 
 MetaEngine::TagsMap MetaEngine::getIptcTagsList() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
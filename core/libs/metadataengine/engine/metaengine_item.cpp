@@ -40,7 +40,7 @@ namespace Digikam
 
 bool MetaEngine::setItemProgramId(const QString& program, const QString& version) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -103,7 +103,7 @@ bool MetaEngine::setItemProgramId(const QString& program, const QString& version
 
 QSize MetaEngine::getItemDimensions() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -207,7 +207,7 @@ QSize MetaEngine::getItemDimensions() const
 
 bool MetaEngine::setItemDimensions(const QSize& size) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -246,7 +246,7 @@ bool MetaEngine::setItemDimensions(const QSize& size) const
 
 MetaEngine::ImageOrientation MetaEngine::getItemOrientation() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -349,7 +349,7 @@ MetaEngine::ImageOrientation MetaEngine::getItemOrientation() const
 
 bool MetaEngine::setItemOrientation(ImageOrientation orientation) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -503,7 +503,7 @@ MetaEngine::ImageColorWorkSpace MetaEngine::getItemColorWorkSpace() const
 
 bool MetaEngine::setItemColorWorkSpace(ImageColorWorkSpace workspace) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -535,7 +535,7 @@ bool MetaEngine::setItemColorWorkSpace(ImageColorWorkSpace workspace) const
 
 QDateTime MetaEngine::getItemDateTime() const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -892,7 +892,7 @@ bool MetaEngine::setImageDateTime(const QDateTime& dateTime, bool setDateTimeDig
     if (!dateTime.isValid())
         return false;
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -969,7 +969,7 @@ bool MetaEngine::setImageDateTime(const QDateTime& dateTime, bool setDateTimeDig
 
 QDateTime MetaEngine::getDigitizationDateTime(bool fallbackToCreationTime) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1122,7 +1122,7 @@ QDateTime MetaEngine::getDigitizationDateTime(bool fallbackToCreationTime) const
 
 bool MetaEngine::getItemPreview(QImage& preview) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1154,7 +1154,7 @@ bool MetaEngine::setItemPreview(const QImage& preview) const
         return true;
     }
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
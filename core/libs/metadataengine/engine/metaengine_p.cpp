@@ -62,21 +62,29 @@ extern "C"
 namespace Digikam
 {
 
-/** This mutex is used to protect all Exiv2 API calls when MetaEngine is used with multi-threads.
+/** This mutex serializes the calls to the process-wide state of Exiv2: the initialization,
+ *  the XMP namespace registry and the Adobe XMP toolkit, which uses it as its own lock.
+ *  All other Exiv2 calls only work on the data of one instance and are protected by the mutex of the instance.
  */
-QMutex s_metaEngineMutex(QMutex::Recursive);
+QMutex     s_metaEngineGlobalMutex(QMutex::Recursive);
+QAtomicInt s_metaEngineInitialized(0);
 
 MetaEngine::Private::Private()
-    : data(new MetaEngineData::Private)
+    : data(new MetaEngineData::Private),
+      mutex(QMutex::Recursive)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
     writeRawFiles         = false;
     updateFileTimeStamp   = false;
     useXMPSidecar4Reading = false;
     metadataWritingMode   = WRITE_TO_FILE_ONLY;
     loadedFromSidecar     = false;
-    Exiv2::LogMsg::setHandler(MetaEngine::Private::printExiv2MessageHandler);
+
+    // Exiv2 must be initialized before instances are used from several threads.
+
+    if (!s_metaEngineInitialized.loadAcquire())
+    {
+        MetaEngine::initializeExiv2();
+    }
 }
 
 MetaEngine::Private::~Private()
@@ -127,14 +135,34 @@ Exiv2::XmpData& MetaEngine::Private::xmpMetadata()
 
 void MetaEngine::Private::copyPrivateData(const Private* const other)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
-    data                  = other->data;
-    filePath              = other->filePath;
-    writeRawFiles         = other->writeRawFiles;
-    updateFileTimeStamp   = other->updateFileTimeStamp;
-    useXMPSidecar4Reading = other->useXMPSidecar4Reading;
-    metadataWritingMode   = other->metadataWritingMode;
+    // Never hold the locks of two instances at once: copy the other one first.
+
+    QSharedDataPointer<MetaEngineData::Private> otherData;
+    QString                                     otherFilePath;
+    bool                                        otherWriteRawFiles;
+    bool                                        otherUpdateFileTimeStamp;
+    bool                                        otherUseXMPSidecar4Reading;
+    int                                         otherMetadataWritingMode;
+
+    {
+        QMutexLocker lock(&other->mutex);
+
+        otherData                  = other->data;
+        otherFilePath              = other->filePath;
+        otherWriteRawFiles         = other->writeRawFiles;
+        otherUpdateFileTimeStamp   = other->updateFileTimeStamp;
+        otherUseXMPSidecar4Reading = other->useXMPSidecar4Reading;
+        otherMetadataWritingMode   = other->metadataWritingMode;
+    }
+
+    QMutexLocker lock(&mutex);
+
+    data                  = otherData;
+    filePath              = otherFilePath;
+    writeRawFiles         = otherWriteRawFiles;
+    updateFileTimeStamp   = otherUpdateFileTimeStamp;
+    useXMPSidecar4Reading = otherUseXMPSidecar4Reading;
+    metadataWritingMode   = otherMetadataWritingMode;
 }
 
 bool MetaEngine::Private::saveToXMPSidecar(const QFileInfo& finfo) const
@@ -146,7 +174,7 @@ bool MetaEngine::Private::saveToXMPSidecar(const QFileInfo& finfo) const
         return false;
     }
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&mutex);
 
     try
     {
@@ -237,7 +265,7 @@ bool MetaEngine::Private::saveToFile(const QFileInfo& finfo) const
     bool ret = false;
 */
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&mutex);
 
     try
     {
@@ -264,7 +292,7 @@ bool MetaEngine::Private::saveToFile(const QFileInfo& finfo) const
 
 bool MetaEngine::Private::saveOperations(const QFileInfo& finfo, Exiv2::Image::AutoPtr image) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&mutex);
 
     try
     {
@@ -441,7 +469,7 @@ void MetaEngine::Private::printExiv2MessageHandler(int lvl, const char* msg)
 
 QString MetaEngine::Private::convertCommentValue(const Exiv2::Exifdatum& exifDatum) const
 {
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&mutex);
 
     try
     {
@@ -680,7 +708,7 @@ int MetaEngine::Private::getXMPTagsListFromPrefix(const QString& pf, MetaEngine:
 
 #ifdef _XMP_SUPPORT_
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&s_metaEngineGlobalMutex);
 
     try
     {
@@ -46,6 +46,8 @@
 #include <QLatin1String>
 #include <QFileInfo>
 #include <QSharedData>
+#include <QAtomicInt>
+#include <QMutex>
 #include <QMutexLocker>
 
 // Exiv2 includes -------------------------------------------------------
@@ -110,7 +112,8 @@
 namespace Digikam
 {
 
-extern QMutex s_metaEngineMutex;
+extern QMutex     s_metaEngineGlobalMutex;
+extern QAtomicInt s_metaEngineInitialized;
 
 // --------------------------------------------------------------------------
 
@@ -187,6 +190,9 @@ public:
     QString                                     mimeType;
 
     QSharedDataPointer<MetaEngineData::Private> data;
+
+    /// Protects the data of this instance. Recursive: the methods call each other.
+    mutable QMutex                              mutex;
 };
 
 } // namespace Digikam
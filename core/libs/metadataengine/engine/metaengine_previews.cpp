@@ -49,8 +49,6 @@ public:
 
     void load(Exiv2::Image::AutoPtr image_)
     {
-        QMutexLocker lock(&s_metaEngineMutex);
-
         try
         {
 #if EXIV2_TEST_VERSION(0,27,99)
@@ -86,13 +84,14 @@ public:
     Exiv2::Image::AutoPtr           image;
     Exiv2::PreviewManager*          manager;
     QList<Exiv2::PreviewProperties> properties;
+
+    /// Protects the image while a preview is extracted.
+    QMutex                          mutex;
 };
 
 MetaEnginePreviews::MetaEnginePreviews(const QString& filePath)
     : d(new Private)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
     try
     {
         Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open((const char*)(QFile::encodeName(filePath).constData()));
@@ -115,8 +114,6 @@ MetaEnginePreviews::MetaEnginePreviews(const QString& filePath)
 MetaEnginePreviews::MetaEnginePreviews(const QByteArray& imgData)
     : d(new Private)
 {
-    QMutexLocker lock(&s_metaEngineMutex);
-
     try
     {
         Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open((Exiv2::byte*)imgData.data(), imgData.size());
@@ -209,7 +206,7 @@ QByteArray MetaEnginePreviews::data(int index)
     qCDebug(DIGIKAM_METAENGINE_LOG) << "index: "         << index;
     qCDebug(DIGIKAM_METAENGINE_LOG) << "d->properties: " << count();
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
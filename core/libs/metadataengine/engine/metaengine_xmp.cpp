@@ -35,8 +35,6 @@ namespace Digikam
 bool MetaEngine::canWriteXmp(const QString& filePath)
 {
 #ifdef _XMP_SUPPORT_
-    QMutexLocker lock(&s_metaEngineMutex);
-
     try
     {
         Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open((const char*)
@@ -82,7 +80,7 @@ bool MetaEngine::hasXmp() const
 bool MetaEngine::clearXmp() const
 {
 #ifdef _XMP_SUPPORT_
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -106,7 +104,7 @@ bool MetaEngine::clearXmp() const
 QByteArray MetaEngine::getXmp() const
 {
 #ifdef _XMP_SUPPORT_
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -138,7 +136,7 @@ QByteArray MetaEngine::getXmp() const
 bool MetaEngine::setXmp(const QByteArray& data) const
 {
 #ifdef _XMP_SUPPORT_
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -181,7 +179,7 @@ MetaEngine::MetaDataMap MetaEngine::getXmpTagsDataList(const QStringList& xmpKey
     if (d->xmpMetadata().empty())
        return MetaDataMap();
 
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -296,7 +294,7 @@ MetaEngine::MetaDataMap MetaEngine::getXmpTagsDataList(const QStringList& xmpKey
 QString MetaEngine::getXmpTagTitle(const char* xmpTagName)
 {
 #ifdef _XMP_SUPPORT_
-    QMutexLocker lock(&s_metaEngineMutex);
+    QMutexLocker lock(&d->mutex);
 
     try
     {
@@ -1041,6 +1039,8 @@ bool MetaEngine::registerXmpNameSpace(const QString& uri, const QString& prefix)
 {
 #ifdef _XMP_SUPPORT_
 
+    QMutexLocker lock(&s_metaEngineGlobalMutex);
+
     try
     {
         QString ns = uri;
@@ -1074,6 +1074,8 @@ bool MetaEngine::unregisterXmpNameSpace(const QString& uri)
 {
 #ifdef _XMP_SUPPORT_
 
+    QMutexLocker lock(&s_metaEngineGlobalMutex);
+
     try
     {
         QString ns = uri;
@@ -227,6 +227,7 @@ void ApplicationSettings::readSettings()
     d->showThumbbar                      = group.readEntry(d->configShowThumbbarEntry,                 true);
 
     d->showFolderTreeViewItemsCount      = group.readEntry(d->configShowFolderTreeViewItemsCountEntry, false);
+    d->useThumbnailsPackFile             = group.readEntry(d->configUseThumbnailsPackFileEntry,        false);
 
     // ---------------------------------------------------------------------
 
@@ -267,6 +268,7 @@ void ApplicationSettings::readSettings()
     setApplicationFont(group.readEntry(d->configApplicationFontEntry, QFontDatabase::systemFont(QFontDatabase::GeneralFont)));
 
     d->scanAtStart                       = group.readEntry(d->configScanAtStartEntry,                                 true);
+    d->incrementalScanAtStart            = group.readEntry(d->configIncrementalScanAtStartEntry,                      false);
     d->cleanAtStart                      = group.readEntry(d->configCleanAtStartEntry,                                false);
 
     // ---------------------------------------------------------------------
@@ -429,6 +431,7 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configPreviewShowIconsEntry,                   d->previewShowIcons);
     group.writeEntry(d->configShowThumbbarEntry,                       d->showThumbbar);
     group.writeEntry(d->configShowFolderTreeViewItemsCountEntry,       d->showFolderTreeViewItemsCount);
+    group.writeEntry(d->configUseThumbnailsPackFileEntry,              d->useThumbnailsPackFile);
 
     // ---------------------------------------------------------------------
 
@@ -451,6 +454,7 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configApplicationFontEntry,                    d->applicationFont);
 
     group.writeEntry(d->configScanAtStartEntry,                        d->scanAtStart);
+    group.writeEntry(d->configIncrementalScanAtStartEntry,             d->incrementalScanAtStart);
     group.writeEntry(d->configCleanAtStartEntry,                       d->cleanAtStart);
 
     // ---------------------------------------------------------------------
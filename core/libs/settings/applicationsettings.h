@@ -161,6 +161,13 @@ public:
     void setSyncDigikamToBaloo(bool val);
     bool getSyncDigikamToBaloo() const;
 
+    /**
+     * Store the thumbnails in a memory-mapped pack file instead of the thumbnails database.
+     * Used at application start.
+     */
+    void setUseThumbnailsPackFile(bool val);
+    bool getUseThumbnailsPackFile() const;
+
     // -- Albums Settings -------------------------------------------------------
 
     void setTreeViewIconSize(int val);
@@ -397,6 +404,9 @@ public:
     void setScanAtStart(bool val);
     bool getScanAtStart() const;
 
+    void setIncrementalScanAtStart(bool val);
+    bool getIncrementalScanAtStart() const;
+
     void setCleanAtStart(bool val);
     bool getCleanAtStart() const;
 
@@ -55,6 +55,16 @@ bool ApplicationSettings::getSyncDigikamToBaloo() const
     return d->syncToBaloo;
 }
 
+void ApplicationSettings::setUseThumbnailsPackFile(bool val)
+{
+    d->useThumbnailsPackFile = val;
+}
+
+bool ApplicationSettings::getUseThumbnailsPackFile() const
+{
+    return d->useThumbnailsPackFile;
+}
+
 DbEngineParameters ApplicationSettings::getDbEngineParameters() const
 {
     return d->databaseParams;
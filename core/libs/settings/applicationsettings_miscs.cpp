@@ -249,6 +249,16 @@ bool ApplicationSettings::getScanAtStart() const
     return d->scanAtStart;
 }
 
+void ApplicationSettings::setIncrementalScanAtStart(bool val)
+{
+    d->incrementalScanAtStart = val;
+}
+
+bool ApplicationSettings::getIncrementalScanAtStart() const
+{
+    return d->incrementalScanAtStart;
+}
+
 void ApplicationSettings::setCleanAtStart(bool val)
 {
     d->cleanAtStart = val;
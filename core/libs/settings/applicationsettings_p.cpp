@@ -142,7 +142,9 @@ const QString ApplicationSettings::Private::configApplicationStyleEntry(QLatin1S
 const QString ApplicationSettings::Private::configIconThemeEntry(QLatin1String("Icon Theme"));
 const QString ApplicationSettings::Private::configApplicationFontEntry(QLatin1String("Application Font"));
 const QString ApplicationSettings::Private::configScanAtStartEntry(QLatin1String("Scan At Start"));
+const QString ApplicationSettings::Private::configIncrementalScanAtStartEntry(QLatin1String("Incremental Scan At Start"));
 const QString ApplicationSettings::Private::configCleanAtStartEntry(QLatin1String("Clean core DB At Start"));
+const QString ApplicationSettings::Private::configUseThumbnailsPackFileEntry(QLatin1String("Use Thumbnails Pack File"));
 const QString ApplicationSettings::Private::configMinimumSimilarityBound(QLatin1String("Lower bound for minimum similarity"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastMinSimilarity(QLatin1String("Last minimum similarity"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastMaxSimilarity(QLatin1String("Last maximum similarity"));
@@ -231,8 +233,10 @@ ApplicationSettings::Private::Private(ApplicationSettings* const qq)
       recursiveAlbums(false),
       recursiveTags(false),
       scanAtStart(true),
+      incrementalScanAtStart(false),
       cleanAtStart(true),
       databaseDirSetAtCmd(false),
+      useThumbnailsPackFile(false),
       albumMonitoring(false),
       sidebarTitleStyle(DMultiTabBar::AllIconsText),
       albumSortRole(ApplicationSettings::ByFolder),
@@ -377,8 +381,10 @@ void ApplicationSettings::Private::init()
     duplicatesSearchLastRestrictions     = 0;
 
     scanAtStart                          = true;
+    incrementalScanAtStart               = false;
     cleanAtStart                         = true;
     databaseDirSetAtCmd                  = false;
+    useThumbnailsPackFile                = false;
     albumMonitoring                      = false;
     stringComparisonType                 = ApplicationSettings::Natural;
 
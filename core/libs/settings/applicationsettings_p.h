@@ -145,7 +145,9 @@ public:
     static const QString configShowPermanentDeleteDialogEntry;
     static const QString configApplySidebarChangesDirectlyEntry;
     static const QString configScanAtStartEntry;
+    static const QString configIncrementalScanAtStartEntry;
     static const QString configCleanAtStartEntry;
+    static const QString configUseThumbnailsPackFileEntry;
     static const QString configSyncBalootoDigikamEntry;
     static const QString configSyncDigikamtoBalooEntry;
     static const QString configStringComparisonTypeEntry;
@@ -257,8 +259,10 @@ public:
     // database settings
     DbEngineParameters                           databaseParams;
     bool                                         scanAtStart;
+    bool                                         incrementalScanAtStart;
     bool                                         cleanAtStart;
     bool                                         databaseDirSetAtCmd;
+    bool                                         useThumbnailsPackFile;
 
     // album settings
     bool                                         albumMonitoring;
@@ -45,33 +45,18 @@ void SharedLoadSaveThread::load(const LoadingDescription& description, AccessMod
 DImg SharedLoadSaveThread::cacheLookup(const QString& filePath, AccessMode /*accessMode*/)
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
-    DImg* cachedImg     = cache->retrieveImage(filePath);
+    DImg cachedImg      = cache->retrieveImage(filePath);
 
     // Qt4: uncomment this code.
     // See comments in SharedLoadingTask::execute for explanation.
 
 /*
-    if (cachedImg)
-    {
-        if (accessMode == AccessModeReadWrite)
-            return cachedImg->copy();
-        else
-            return *cachedImg;
-    }
+    if (accessMode == AccessModeReadWrite)
+        return cachedImg.copy();
     else
-    {
-        return DImg();
-    }
+        return cachedImg;
 */
-    if (cachedImg)
-    {
-        return cachedImg->copy();
-    }
-    else
-    {
-        return DImg();
-    }
+    return cachedImg.copy();
 }
 
 } // namespace Digikam
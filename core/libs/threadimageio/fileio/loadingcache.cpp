@@ -22,13 +22,12 @@
  * ============================================================ */
 
 #include "loadingcache.h"
+#include "loadingcache_p.h"
 
 // Qt includes
 
 #include <QCoreApplication>
 #include <QEvent>
-#include <QCache>
-#include <QMap>
 
 // Local includes
 
@@ -41,105 +40,31 @@
 namespace Digikam
 {
 
-class Q_DECL_HIDDEN LoadingCache::Private
+void LoadingCache::Private::fileWatchAddedImage(const QString& filePath)
 {
-public:
+    QMutexLocker locker(&watchMutex);
 
-    explicit Private(LoadingCache* const q)
-        : q(q)
-    {
-        // Note: Don't make the mutex recursive, we need to use a wait condition on it
-        watch = nullptr;
-    }
-
-    void mapImageFilePath(const QString& filePath, const QString& cacheKey);
-    void mapThumbnailFilePath(const QString& filePath, const QString& cacheKey);
-    void cleanUpImageFilePathHash();
-    void cleanUpThumbnailFilePathHash();
-    LoadingCacheFileWatch* fileWatch() const;
-
-public:
-
-    QCache<QString, DImg>           imageCache;
-    QCache<QString, QImage>         thumbnailImageCache;
-    QCache<QString, QPixmap>        thumbnailPixmapCache;
-    QMultiMap<QString, QString>     imageFilePathHash;
-    QMultiMap<QString, QString>     thumbnailFilePathHash;
-    QMap<QString, LoadingProcess*>  loadingDict;
-    QMutex                          mutex;
-    QWaitCondition                  condVar;
-    LoadingCacheFileWatch*          watch;
-    LoadingCache*                   q;
-};
-
-LoadingCacheFileWatch* LoadingCache::Private::fileWatch() const
-{
     // install default watch if no watch is set yet
     if (!watch)
     {
-        q->setFileWatch(new ClassicLoadingCacheFileWatch);
+        watch          = new ClassicLoadingCacheFileWatch;
+        watch->m_cache = q;
     }
 
-    return watch;
+    watch->addedImage(filePath);
 }
 
-void LoadingCache::Private::mapImageFilePath(const QString& filePath, const QString& cacheKey)
+void LoadingCache::Private::fileWatchAddedThumbnail(const QString& filePath)
 {
-    if (imageFilePathHash.size() > 5*imageCache.size())
-    {
-        cleanUpImageFilePathHash();
-    }
-
-    imageFilePathHash.insert(filePath, cacheKey);
-}
+    QMutexLocker locker(&watchMutex);
 
-void LoadingCache::Private::mapThumbnailFilePath(const QString& filePath, const QString& cacheKey)
-{
-    if (thumbnailFilePathHash.size() > 5*(thumbnailImageCache.size() + thumbnailPixmapCache.size()))
+    if (!watch)
     {
-        cleanUpThumbnailFilePathHash();
+        watch          = new ClassicLoadingCacheFileWatch;
+        watch->m_cache = q;
     }
 
-    thumbnailFilePathHash.insert(filePath, cacheKey);
-}
-
-void LoadingCache::Private::cleanUpImageFilePathHash()
-{
-    // Remove all entries from hash whose value is no longer a key in the cache
-    QSet<QString> keys = imageCache.keys().toSet();
-    QMultiMap<QString, QString>::iterator it;
-
-    for (it = imageFilePathHash.begin() ; it != imageFilePathHash.end() ; )
-    {
-        if (!keys.contains(it.value()))
-        {
-            it = imageFilePathHash.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
-}
-
-void LoadingCache::Private::cleanUpThumbnailFilePathHash()
-{
-    QSet<QString> keys;
-    keys += thumbnailImageCache.keys().toSet();
-    keys += thumbnailPixmapCache.keys().toSet();
-    QMultiMap<QString, QString>::iterator it;
-
-    for (it = thumbnailFilePathHash.begin() ; it != thumbnailFilePathHash.end() ; )
-    {
-        if (!keys.contains(it.value()))
-        {
-            it = thumbnailFilePathHash.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    watch->addedThumbnail(filePath);
 }
 
 LoadingCache* LoadingCache::m_instance = nullptr;
@@ -177,25 +102,38 @@ LoadingCache::LoadingCache()
 
 LoadingCache::~LoadingCache()
 {
+    const char* const names[] = { "Images", "Thumbnail images", "Thumbnail pixmaps" };
+
+    for (int type = ImageCache ; type <= ThumbnailPixmapCache ; ++type)
+    {
+        LoadingCacheStatistics stats = statistics((CacheType)type);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "LoadingCache:" << names[type] << ":"
+                                     << stats.hits      << "hits,"
+                                     << stats.misses    << "misses,"
+                                     << stats.evictions << "evictions";
+    }
+
     delete d->watch;
     delete d;
     m_instance = nullptr;
 }
 
-DImg* LoadingCache::retrieveImage(const QString& cacheKey) const
+DImg LoadingCache::retrieveImage(const QString& cacheKey) const
 {
-    return d->imageCache[cacheKey];
+    DImg img;
+    d->imageCache.find(cacheKey, &img);
+
+    return img;
 }
 
 bool LoadingCache::putImage(const QString& cacheKey, const DImg& img, const QString& filePath) const
 {
-    int cost                 = img.numBytes();
-    bool successfulyInserted = d->imageCache.insert(cacheKey, new DImg(img), cost);
+    bool successfulyInserted = d->imageCache.insert(cacheKey, img, img.numBytes(), filePath);
 
     if (successfulyInserted && !filePath.isEmpty())
     {
-        d->mapImageFilePath(filePath, cacheKey);
-        d->fileWatch()->addedImage(filePath);
+        d->fileWatchAddedImage(filePath);
     }
 
     return successfulyInserted;
@@ -214,7 +152,7 @@ void LoadingCache::removeImages()
 bool LoadingCache::isCacheable(const DImg& img) const
 {
     // return whether image fits in cache
-    return (uint)d->imageCache.maxCost() >= img.numBytes();
+    return (d->imageCache.maximumCost() >= (qint64)img.numBytes());
 }
 
 void LoadingCache::addLoadingProcess(LoadingProcess* const process)
@@ -244,19 +182,25 @@ void LoadingCache::notifyNewLoadingProcess(LoadingProcess* const process, const
 void LoadingCache::setCacheSize(int megabytes)
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "Allowing a cache size of" << megabytes << "MB";
-    d->imageCache.setMaxCost(megabytes * 1024 * 1024);
+    d->imageCache.setMaxCost((qint64)megabytes * 1024 * 1024);
 }
 
 // --- Thumbnails ----
 
-const QImage* LoadingCache::retrieveThumbnail(const QString& cacheKey) const
+QImage LoadingCache::retrieveThumbnail(const QString& cacheKey) const
 {
-    return d->thumbnailImageCache[cacheKey];
+    QImage thumb;
+    d->thumbnailImageCache.find(cacheKey, &thumb);
+
+    return thumb;
 }
 
-const QPixmap* LoadingCache::retrieveThumbnailPixmap(const QString& cacheKey) const
+QPixmap LoadingCache::retrieveThumbnailPixmap(const QString& cacheKey) const
 {
-    return d->thumbnailPixmapCache[cacheKey];
+    QPixmap thumb;
+    d->thumbnailPixmapCache.find(cacheKey, &thumb);
+
+    return thumb;
 }
 
 bool LoadingCache::hasThumbnailPixmap(const QString& cacheKey) const
@@ -267,26 +211,24 @@ bool LoadingCache::hasThumbnailPixmap(const QString& cacheKey) const
 void LoadingCache::putThumbnail(const QString& cacheKey, const QImage& thumb, const QString& filePath)
 {
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
-    int cost = thumb.sizeInBytes();
+    qint64 cost = thumb.sizeInBytes();
 #else
-    int cost = thumb.byteCount();
+    qint64 cost = thumb.byteCount();
 #endif
 
-    if (d->thumbnailImageCache.insert(cacheKey, new QImage(thumb), cost))
+    if (d->thumbnailImageCache.insert(cacheKey, thumb, cost, filePath))
     {
-        d->mapThumbnailFilePath(filePath, cacheKey);
-        d->fileWatch()->addedThumbnail(filePath);
+        d->fileWatchAddedThumbnail(filePath);
     }
 }
 
 void LoadingCache::putThumbnail(const QString& cacheKey, const QPixmap& thumb, const QString& filePath)
 {
-    int cost = thumb.width() * thumb.height() * thumb.depth() / 8;
+    qint64 cost = (qint64)thumb.width() * thumb.height() * thumb.depth() / 8;
 
-    if (d->thumbnailPixmapCache.insert(cacheKey, new QPixmap(thumb), cost))
+    if (d->thumbnailPixmapCache.insert(cacheKey, thumb, cost, filePath))
     {
-        d->mapThumbnailFilePath(filePath, cacheKey);
-        d->fileWatch()->addedThumbnail(filePath);
+        d->fileWatchAddedThumbnail(filePath);
     }
 }
 
@@ -304,37 +246,51 @@ void LoadingCache::removeThumbnails()
 
 void LoadingCache::setThumbnailCacheSize(int numberOfQImages, int numberOfQPixmaps)
 {
-    d->thumbnailImageCache.setMaxCost(numberOfQImages *
+    d->thumbnailImageCache.setMaxCost((qint64)numberOfQImages *
                                       ThumbnailSize::maxThumbsSize() *
                                       ThumbnailSize::maxThumbsSize() * 4);
 
-    d->thumbnailPixmapCache.setMaxCost(numberOfQPixmaps *
+    d->thumbnailPixmapCache.setMaxCost((qint64)numberOfQPixmaps *
                                        ThumbnailSize::maxThumbsSize() *
                                        ThumbnailSize::maxThumbsSize() * QPixmap::defaultDepth() / 8);
 }
 
 void LoadingCache::setFileWatch(LoadingCacheFileWatch* const watch)
 {
-    delete d->watch;
-    d->watch          = watch;
-    d->watch->m_cache = this;
+    LoadingCacheFileWatch* old = nullptr;
+
+    {
+        QMutexLocker locker(&d->watchMutex);
+        old               = d->watch;
+        d->watch          = watch;
+        d->watch->m_cache = this;
+    }
+
+    if (old)
+    {
+        // Detach first: the destructor must not look for itself in the cache.
+        old->m_cache = nullptr;
+        delete old;
+    }
 }
 
 QStringList LoadingCache::imageFilePathsInCache() const
 {
-    d->cleanUpImageFilePathHash();
-    return d->imageFilePathHash.uniqueKeys();
+    return d->imageCache.filePaths();
 }
 
 QStringList LoadingCache::thumbnailFilePathsInCache() const
 {
-    d->cleanUpThumbnailFilePathHash();
-    return d->thumbnailFilePathHash.uniqueKeys();
+    QStringList paths = d->thumbnailImageCache.filePaths();
+    paths            << d->thumbnailPixmapCache.filePaths();
+    paths.removeDuplicates();
+
+    return paths;
 }
 
 void LoadingCache::notifyFileChanged(const QString& filePath, bool notify)
 {
-    QList<QString> keys = d->imageFilePathHash.values(filePath);
+    QStringList keys = d->imageCache.keysForFilePath(filePath);
 
     foreach (const QString& cacheKey, keys)
     {
@@ -344,7 +300,9 @@ void LoadingCache::notifyFileChanged(const QString& filePath, bool notify)
         }
     }
 
-    keys = d->thumbnailFilePathHash.values(filePath);
+    keys  = d->thumbnailImageCache.keysForFilePath(filePath);
+    keys << d->thumbnailPixmapCache.keysForFilePath(filePath);
+    keys.removeDuplicates();
 
     foreach (const QString& cacheKey, keys)
     {
@@ -363,6 +321,21 @@ void LoadingCache::notifyFileChanged(const QString& filePath, bool notify)
     }
 }
 
+LoadingCacheStatistics LoadingCache::statistics(CacheType type) const
+{
+    switch (type)
+    {
+        case ImageCache:
+            return d->imageCache.statistics();
+        case ThumbnailImageCache:
+            return d->thumbnailImageCache.statistics();
+        case ThumbnailPixmapCache:
+            return d->thumbnailPixmapCache.statistics();
+    }
+
+    return LoadingCacheStatistics();
+}
+
 void LoadingCache::iccSettingsChanged(const ICCSettingsContainer& current, const ICCSettingsContainer& previous)
 {
     if (current.enableCM           != previous.enableCM           ||
@@ -381,7 +354,7 @@ LoadingCacheFileWatch::~LoadingCacheFileWatch()
 {
     if (m_cache)
     {
-        LoadingCache::CacheLock lock(m_cache);
+        QMutexLocker locker(&m_cache->d->watchMutex);
 
         if (m_cache->d->watch == this)
         {
@@ -394,7 +367,6 @@ void LoadingCacheFileWatch::notifyFileChanged(const QString& filePath)
 {
     if (m_cache)
     {
-        LoadingCache::CacheLock lock(m_cache);
         m_cache->notifyFileChanged(filePath);
     }
 }
@@ -464,8 +436,11 @@ void ClassicLoadingCacheFileWatch::slotFileDirty(const QString& path)
 
 void ClassicLoadingCacheFileWatch::slotUpdateDirWatch()
 {
-    // Event comes from main thread, we need to lock ourselves.
-    LoadingCache::CacheLock lock(m_cache);
+    // Event comes from main thread. The cache is thread-safe, no need to lock.
+    if (!m_cache)
+    {
+        return;
+    }
 
     // get a list of files in cache that need watch
     QSet<QString> toBeAdded;
@@ -127,6 +127,32 @@ protected:
 
 // --------------------------------------------------------------------------------------------------------------
 
+class DIGIKAM_EXPORT LoadingCacheStatistics
+{
+public:
+
+    explicit LoadingCacheStatistics()
+        : hits(0),
+          misses(0),
+          insertions(0),
+          evictions(0),
+          count(0),
+          cost(0),
+          maximumCost(0)
+    {
+    }
+
+    qint64 hits;
+    qint64 misses;
+    qint64 insertions;
+    qint64 evictions;       ///< Entries dropped to make room, not removed ones.
+    qint64 count;
+    qint64 cost;            ///< In bytes
+    qint64 maximumCost;     ///< In bytes
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
 class DIGIKAM_EXPORT LoadingCache : public QObject
 {
     Q_OBJECT
@@ -137,7 +163,21 @@ public:
     static void cleanUp();
     virtual ~LoadingCache();
 
-    /// !! All methods of LoadingCache shall only be called when a CacheLock is held !!
+    enum CacheType
+    {
+        ImageCache,
+        ThumbnailImageCache,
+        ThumbnailPixmapCache
+    };
+
+    /**
+     * The image and thumbnail caches are thread-safe, their methods can be called without lock.
+     * They are split in shards with their own lock, so concurrent loading threads rarely wait
+     * for each other.
+     *
+     * !! The loading process methods of LoadingCache shall only be called when a CacheLock is held !!
+     * Hold it as well around a cache lookup whose result decides if a loading process is registered.
+     */
 
     class DIGIKAM_EXPORT CacheLock
     {
@@ -155,9 +195,9 @@ public:
 
     /**
      * Retrieves an image for the given string from the cache,
-     * or 0 if no image is found.
+     * or a null image if no image is found.
      */
-    DImg* retrieveImage(const QString& cacheKey) const;
+    DImg retrieveImage(const QString& cacheKey) const;
 
     /// Returns whether the given DImg fits in the cache.
     bool isCacheable(const DImg& img) const;
@@ -216,11 +256,11 @@ public:
     /// QPixmaps can only be accessed from the main thread, so the tasks cannot access this cache.
     /**
      * Retrieves a thumbnail for the given filePath from the thumbnail cache,
-     * or a 0 if the thumbnail is not found.
+     * or a null image if the thumbnail is not found.
      */
-    const QImage* retrieveThumbnail(const QString& cacheKey) const;
-    const QPixmap* retrieveThumbnailPixmap(const QString& cacheKey) const;
-    bool  hasThumbnailPixmap(const QString& cacheKey) const;
+    QImage  retrieveThumbnail(const QString& cacheKey) const;
+    QPixmap retrieveThumbnailPixmap(const QString& cacheKey) const;
+    bool    hasThumbnailPixmap(const QString& cacheKey) const;
 
     /**
      * Puts a thumbnail into the thumbnail cache.
@@ -273,6 +313,11 @@ public:
      */
     void notifyFileChanged(const QString& filePath, bool notify = true);
 
+    /**
+     * Returns the hit, miss and eviction counters and the current use of a cache.
+     */
+    LoadingCacheStatistics statistics(CacheType type) const;
+
 Q_SIGNALS:
 
     /**
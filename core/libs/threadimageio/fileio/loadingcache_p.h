@@ -0,0 +1,484 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-27
+ * Description : shared image loading and caching - private containers
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_LOADING_CACHE_P_H
+#define DIGIKAM_LOADING_CACHE_P_H
+
+// Qt includes
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+
+// Local includes
+
+#include "loadingcache.h"
+
+namespace Digikam
+{
+
+/** A thread-safe cache of objects with a cost in bytes, evicted in least recently used order
+ *  when the total cost exceeds the maximum cost.
+ *
+ *  The entries are distributed over shards by hash of their key, each shard with its own lock,
+ *  its own hash table and its own LRU list. The total cost and the use clock are global,
+ *  so eviction always takes the least recently used entry of all shards.
+ *
+ *  The file path of each entry is recorded in a reverse map, also sharded,
+ *  which is updated when the entry is inserted or dropped.
+ *  A shard lock can be held while taking a file path shard lock, never the contrary.
+ */
+template <class T>
+class Q_DECL_HIDDEN LoadingCacheStore
+{
+public:
+
+    enum
+    {
+        NumberOfShards = 16
+    };
+
+public:
+
+    explicit LoadingCacheStore()
+      : maxCost(0)
+    {
+    }
+
+    ~LoadingCacheStore()
+    {
+        clear();
+    }
+
+    /** Copy the object stored for key to object and mark it as most recently used.
+     */
+    bool find(const QString& key, T* const object)
+    {
+        Shard& shard = shardForKey(key);
+        QMutexLocker locker(&shard.mutex);
+
+        Entry* const entry = shard.entries.value(key);
+
+        if (!entry)
+        {
+            misses.ref();
+            return false;
+        }
+
+        shard.unlink(entry);
+        shard.pushFront(entry);
+        entry->lastUse = clock.fetchAndAddRelaxed(1);
+        *object        = entry->object;
+        hits.ref();
+
+        return true;
+    }
+
+    bool contains(const QString& key) const
+    {
+        const Shard& shard = shardForKey(key);
+        QMutexLocker locker(&shard.mutex);
+
+        return shard.entries.contains(key);
+    }
+
+    /** Insert or replace the object stored for key. Returns false if the cost is larger
+     *  than the maximum cost of the cache. Less recently used entries are evicted if needed.
+     */
+    bool insert(const QString& key, const T& object, qint64 cost, const QString& filePath)
+    {
+        if (cost > maxCost.load())
+        {
+            return false;
+        }
+
+        {
+            Shard& shard = shardForKey(key);
+            QMutexLocker locker(&shard.mutex);
+
+            Entry* const old = shard.entries.take(key);
+
+            if (old)
+            {
+                shard.unlink(old);
+                drop(old);
+            }
+
+            Entry* const entry = new Entry;
+            entry->key         = key;
+            entry->filePath    = filePath;
+            entry->object      = object;
+            entry->cost        = cost;
+            entry->lastUse     = clock.fetchAndAddRelaxed(1);
+
+            shard.entries.insert(key, entry);
+            shard.pushFront(entry);
+            totalCost.fetchAndAddRelaxed(cost);
+            mapFilePath(entry);
+            insertions.ref();
+        }
+
+        evictIfNeeded();
+
+        return true;
+    }
+
+    bool remove(const QString& key)
+    {
+        Shard& shard = shardForKey(key);
+        QMutexLocker locker(&shard.mutex);
+
+        Entry* const entry = shard.entries.take(key);
+
+        if (!entry)
+        {
+            return false;
+        }
+
+        shard.unlink(entry);
+        drop(entry);
+
+        return true;
+    }
+
+    void clear()
+    {
+        for (int i = 0 ; i < NumberOfShards ; ++i)
+        {
+            Shard& shard = shards[i];
+            QMutexLocker locker(&shard.mutex);
+
+            foreach (Entry* const entry, shard.entries)
+            {
+                drop(entry);
+            }
+
+            shard.entries.clear();
+            shard.head = nullptr;
+            shard.tail = nullptr;
+        }
+    }
+
+    void setMaxCost(qint64 cost)
+    {
+        maxCost.store(cost);
+        evictIfNeeded();
+    }
+
+    qint64 maximumCost() const
+    {
+        return maxCost.load();
+    }
+
+    /** All file paths of the entries in the cache.
+     */
+    QStringList filePaths() const
+    {
+        QStringList paths;
+
+        for (int i = 0 ; i < NumberOfShards ; ++i)
+        {
+            QMutexLocker locker(&pathShards[i].mutex);
+            paths << pathShards[i].keys.keys();
+        }
+
+        return paths;
+    }
+
+    /** The keys of the entries loaded from filePath.
+     */
+    QStringList keysForFilePath(const QString& filePath) const
+    {
+        const PathShard& pathShard = pathShardForFilePath(filePath);
+        QMutexLocker locker(&pathShard.mutex);
+
+        return pathShard.keys.value(filePath).toList();
+    }
+
+    LoadingCacheStatistics statistics() const
+    {
+        LoadingCacheStatistics stats;
+        stats.hits        = hits.load();
+        stats.misses      = misses.load();
+        stats.insertions  = insertions.load();
+        stats.evictions   = evictions.load();
+        stats.cost        = totalCost.load();
+        stats.maximumCost = maxCost.load();
+
+        for (int i = 0 ; i < NumberOfShards ; ++i)
+        {
+            QMutexLocker locker(&shards[i].mutex);
+            stats.count += shards[i].entries.count();
+        }
+
+        return stats;
+    }
+
+private:
+
+    class Entry
+    {
+    public:
+
+        QString key;
+        QString filePath;
+        T       object;
+        qint64  cost;
+        quint64 lastUse;
+        Entry*  previous;
+        Entry*  next;
+    };
+
+    class Shard
+    {
+    public:
+
+        explicit Shard()
+          : head(nullptr),
+            tail(nullptr)
+        {
+        }
+
+        void pushFront(Entry* const entry)
+        {
+            entry->previous = nullptr;
+            entry->next     = head;
+
+            if (head)
+            {
+                head->previous = entry;
+            }
+
+            head = entry;
+
+            if (!tail)
+            {
+                tail = entry;
+            }
+        }
+
+        void unlink(Entry* const entry)
+        {
+            if (entry->previous)
+            {
+                entry->previous->next = entry->next;
+            }
+            else
+            {
+                head = entry->next;
+            }
+
+            if (entry->next)
+            {
+                entry->next->previous = entry->previous;
+            }
+            else
+            {
+                tail = entry->previous;
+            }
+
+            entry->previous = nullptr;
+            entry->next     = nullptr;
+        }
+
+    public:
+
+        mutable QMutex          mutex;
+        QHash<QString, Entry*>  entries;
+
+        /// Most recently used first.
+        Entry*                  head;
+        Entry*                  tail;
+    };
+
+    class PathShard
+    {
+    public:
+
+        mutable QMutex                  mutex;
+        QHash<QString, QSet<QString> >  keys;
+    };
+
+private:
+
+    Shard& shardForKey(const QString& key)
+    {
+        return shards[qHash(key) % NumberOfShards];
+    }
+
+    const Shard& shardForKey(const QString& key) const
+    {
+        return shards[qHash(key) % NumberOfShards];
+    }
+
+    PathShard& pathShardForFilePath(const QString& filePath)
+    {
+        return pathShards[qHash(filePath) % NumberOfShards];
+    }
+
+    const PathShard& pathShardForFilePath(const QString& filePath) const
+    {
+        return pathShards[qHash(filePath) % NumberOfShards];
+    }
+
+    /// The shard lock of the entry must be held.
+    void mapFilePath(Entry* const entry)
+    {
+        if (entry->filePath.isEmpty())
+        {
+            return;
+        }
+
+        PathShard& pathShard = pathShardForFilePath(entry->filePath);
+        QMutexLocker locker(&pathShard.mutex);
+        pathShard.keys[entry->filePath].insert(entry->key);
+    }
+
+    /// The shard lock of the entry must be held.
+    void unmapFilePath(Entry* const entry)
+    {
+        if (entry->filePath.isEmpty())
+        {
+            return;
+        }
+
+        PathShard& pathShard = pathShardForFilePath(entry->filePath);
+        QMutexLocker locker(&pathShard.mutex);
+
+        typename QHash<QString, QSet<QString> >::iterator it = pathShard.keys.find(entry->filePath);
+
+        if (it != pathShard.keys.end())
+        {
+            it.value().remove(entry->key);
+
+            if (it.value().isEmpty())
+            {
+                pathShard.keys.erase(it);
+            }
+        }
+    }
+
+    /// Free an entry already removed from its shard. The shard lock must be held.
+    void drop(Entry* const entry)
+    {
+        unmapFilePath(entry);
+        totalCost.fetchAndAddRelaxed(-entry->cost);
+        delete entry;
+    }
+
+    void evictIfNeeded()
+    {
+        while (totalCost.load() > maxCost.load())
+        {
+            // Find the least recently used entry: it is the tail of one of the shards.
+
+            int     oldestShard = -1;
+            quint64 oldestUse   = 0;
+
+            for (int i = 0 ; i < NumberOfShards ; ++i)
+            {
+                QMutexLocker locker(&shards[i].mutex);
+
+                if (shards[i].tail && ((oldestShard == -1) || (shards[i].tail->lastUse < oldestUse)))
+                {
+                    oldestShard = i;
+                    oldestUse   = shards[i].tail->lastUse;
+                }
+            }
+
+            if (oldestShard == -1)
+            {
+                return;
+            }
+
+            Shard& shard = shards[oldestShard];
+            QMutexLocker locker(&shard.mutex);
+            Entry* const entry = shard.tail;
+
+            if (entry)
+            {
+                shard.entries.remove(entry->key);
+                shard.unlink(entry);
+                drop(entry);
+                evictions.ref();
+            }
+        }
+    }
+
+private:
+
+    Shard                    shards[NumberOfShards];
+    PathShard                pathShards[NumberOfShards];
+
+    QAtomicInteger<qint64>   maxCost;
+    QAtomicInteger<qint64>   totalCost;
+    QAtomicInteger<quint64>  clock;
+
+    QAtomicInteger<qint64>   hits;
+    QAtomicInteger<qint64>   misses;
+    QAtomicInteger<qint64>   insertions;
+    QAtomicInteger<qint64>   evictions;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN LoadingCache::Private
+{
+public:
+
+    explicit Private(LoadingCache* const q)
+      : watch(nullptr),
+        q(q)
+    {
+        // Note: Don't make the mutex recursive, we need to use a wait condition on it
+    }
+
+    /// Inform the file watch, installing the default one if no watch is set yet.
+    void fileWatchAddedImage(const QString& filePath);
+    void fileWatchAddedThumbnail(const QString& filePath);
+
+public:
+
+    LoadingCacheStore<DImg>         imageCache;
+    LoadingCacheStore<QImage>       thumbnailImageCache;
+    LoadingCacheStore<QPixmap>      thumbnailPixmapCache;
+
+    /// Protected by mutex, the CacheLock.
+    QMap<QString, LoadingProcess*>  loadingDict;
+    QMutex                          mutex;
+    QWaitCondition                  condVar;
+
+    QMutex                          watchMutex;
+    LoadingCacheFileWatch*          watch;
+    LoadingCache*                   q;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_LOADING_CACHE_P_H
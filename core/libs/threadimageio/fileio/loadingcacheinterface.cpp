@@ -43,8 +43,6 @@ void LoadingCacheInterface::cleanUp()
 void LoadingCacheInterface::fileChanged(const QString& filePath, bool notify)
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
-
     cache->notifyFileChanged(filePath, notify);
 }
 
@@ -54,27 +52,24 @@ void LoadingCacheInterface::connectToSignalFileChanged(QObject* object, const ch
     QObject::connect(cache, SIGNAL(fileChanged(QString)),
                      object, slot,
                      Qt::QueuedConnection);
-    // make it a queued connection because the signal is emitted when the CacheLock is held!
+    // make it a queued connection because the signal is emitted from any thread
 }
 
 void LoadingCacheInterface::cleanCache()
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
     cache->removeImages();
 }
 
 void LoadingCacheInterface::cleanThumbnailCache()
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
     cache->removeThumbnails();
 }
 
 void LoadingCacheInterface::putImage(const QString& filePath, const DImg& img)
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
 
     if (cache->isCacheable(img))
     {
@@ -85,7 +80,6 @@ void LoadingCacheInterface::putImage(const QString& filePath, const DImg& img)
 void LoadingCacheInterface::setCacheOptions(int cacheSize)
 {
     LoadingCache* cache = LoadingCache::cache();
-    LoadingCache::CacheLock lock(cache);
     cache->setCacheSize(cacheSize);
 }
 
@@ -112,22 +112,24 @@ void SharedLoadingTask::execute()
         LoadingCache::CacheLock lock(cache);
 
         // find possible cached images
-        DImg* cachedImg        = nullptr;
+        DImg cachedImg;
         QStringList lookupKeys = m_loadingDescription.lookupCacheKeys();
 
         foreach (const QString& key, lookupKeys)
         {
-            if ((cachedImg = cache->retrieveImage(key)))
+            cachedImg = cache->retrieveImage(key);
+
+            if (!cachedImg.isNull())
             {
                 if (m_loadingDescription.needCheckRawDecoding())
                 {
-                    if (cachedImg->rawDecodingSettings() == m_loadingDescription.rawDecodingSettings)
+                    if (cachedImg.rawDecodingSettings() == m_loadingDescription.rawDecodingSettings)
                     {
                         break;
                     }
                     else
                     {
-                        cachedImg = nullptr;
+                        cachedImg = DImg();
                     }
                 }
                 else
@@ -137,10 +139,10 @@ void SharedLoadingTask::execute()
             }
         }
 
-        if (cachedImg)
+        if (!cachedImg.isNull())
         {
             // image is found in image cache, loading is successful
-            m_img = *cachedImg;
+            m_img = cachedImg;
         }
         else
         {
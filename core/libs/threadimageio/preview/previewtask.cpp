@@ -60,7 +60,7 @@ void PreviewLoadingTask::execute()
         LoadingCache::CacheLock lock(cache);
 
         // find possible cached images
-        DImg* cachedImg        = nullptr;
+        DImg cachedImg;
         QStringList lookupKeys = m_loadingDescription.lookupCacheKeys();
 
         // lookupCacheKeys returns "best first". Prepend the cache key to make the list "fastest first":
@@ -69,17 +69,19 @@ void PreviewLoadingTask::execute()
 
         foreach (const QString& key, lookupKeys)
         {
-            if ((cachedImg = cache->retrieveImage(key)))
+            cachedImg = cache->retrieveImage(key);
+
+            if (!cachedImg.isNull())
             {
                 if (m_loadingDescription.needCheckRawDecoding())
                 {
-                    if (cachedImg->rawDecodingSettings() == m_loadingDescription.rawDecodingSettings)
+                    if (cachedImg.rawDecodingSettings() == m_loadingDescription.rawDecodingSettings)
                     {
                         break;
                     }
                     else
                     {
-                        cachedImg = nullptr;
+                        cachedImg = DImg();
                     }
                 }
                 else
@@ -89,10 +91,10 @@ void PreviewLoadingTask::execute()
             }
         }
 
-        if (cachedImg)
+        if (!cachedImg.isNull())
         {
             // image is found in image cache, loading is successful
-            m_img = *cachedImg;
+            m_img = cachedImg;
         }
         else
         {
@@ -273,11 +275,9 @@ void PreviewLoadingTask::execute()
 
                     if (continueQuery(&m_img))
                     {
-                        // Set a hint to try to load a JPEG or PGF with the fast scale-before-decoding method
-                        if (isFast)
-                        {
-                            m_img.setAttribute(QLatin1String("scaledLoadingSize"), m_loadingDescription.previewParameters.size);
-                        }
+                        // Set a hint to try to load a JPEG or PGF with the fast scale-before-decoding method.
+                        // Both qualities only need the longest side to be at least the preview size.
+                        m_img.setScaledLoadingSize(m_loadingDescription.previewParameters.size);
 
                         m_img.load(m_loadingDescription.filePath, this, m_loadingDescription.rawDecodingSettings);
                     }
@@ -63,6 +63,8 @@
 #include "thumbsdbaccess.h"
 #include "thumbsdb.h"
 #include "thumbsdbbackend.h"
+#include "thumbsdbwritequeue.h"
+#include "thumbnailpack.h"
 #include "thumbnailsize.h"
 
 #ifdef HAVE_MEDIAPLAYER
@@ -127,7 +129,7 @@ int ThumbnailCreator::Private::storageSize() const
 
     if (onlyLargeThumbnails)
     {
-        if (ratio > 1.0 && thumbnailStorage == ThumbnailDatabase)
+        if (ratio > 1.0 && thumbnailStorage != FreeDesktopStandard)
         {
             return ThumbnailSize::getUseLargeThumbs() ? ThumbnailSize::MAX
                                                       : ThumbnailSize::HD;
@@ -139,7 +141,7 @@ int ThumbnailCreator::Private::storageSize() const
     }
     else
     {
-        if (ratio > 1.0 && thumbnailStorage == ThumbnailDatabase)
+        if (ratio > 1.0 && thumbnailStorage != FreeDesktopStandard)
         {
             return (thumbnailSize <= ThumbnailSize::Small) ? ThumbnailSize::Huge
                                                            : ThumbnailSize::HD;
@@ -268,6 +270,21 @@ QImage ThumbnailCreator::load(const ThumbnailIdentifier& identifier, const QRect
                 image = loadFromDatabase(info);
             }
 
+            break;
+        case ThumbnailPackFile:
+
+            if (pregenerate)
+            {
+                if (isInPack(info))
+                {
+                    return QImage();
+                }
+            }
+            else
+            {
+                image = loadFromPack(info);
+            }
+
             break;
         case FreeDesktopStandard:
             image = loadFreedesktop(info);
@@ -292,6 +309,9 @@ QImage ThumbnailCreator::load(const ThumbnailIdentifier& identifier, const QRect
                 case ThumbnailDatabase:
                     storeInDatabase(info, image);
                     break;
+                case ThumbnailPackFile:
+                    storeInPack(info, image);
+                    break;
                 case FreeDesktopStandard:
 
                     // image is stored rotated
@@ -324,7 +344,7 @@ QImage ThumbnailCreator::load(const ThumbnailIdentifier& identifier, const QRect
                                        Qt::KeepAspectRatio, Qt::SmoothTransformation);
     image.qimage = handleAlphaChannel(image.qimage);
 
-    if (d->thumbnailStorage == ThumbnailDatabase)
+    if (d->thumbnailStorage != FreeDesktopStandard)
     {
         // image is stored, or created, unrotated, and is now rotated for display
         // detail thumbnails are stored readily rotated
@@ -443,6 +463,9 @@ void ThumbnailCreator::store(const QString& path, const QImage& i, const QRect&
                 storeInDatabase(info, image);
             }
 
+            break;
+        case ThumbnailPackFile:
+            storeInPack(info, image);
             break;
         case FreeDesktopStandard:
             storeFreedesktop(info, image);
@@ -458,6 +481,7 @@ void ThumbnailCreator::deleteThumbnailsFromDisk(const QString& filePath) const
             deleteFromDiskFreedesktop(filePath);
             break;
         case ThumbnailDatabase:
+        case ThumbnailPackFile:
         {
             ThumbnailInfo info;
 
@@ -470,7 +494,15 @@ void ThumbnailCreator::deleteThumbnailsFromDisk(const QString& filePath) const
                 info = fileThumbnailInfo(filePath);
             }
 
-            deleteFromDatabase(info);
+            if (d->thumbnailStorage == ThumbnailPackFile)
+            {
+                deleteFromPack(info);
+            }
+            else
+            {
+                deleteFromDatabase(info);
+            }
+
             break;
         }
     }
@@ -614,6 +646,10 @@ ThumbnailImage ThumbnailCreator::createThumbnail(const ThumbnailInfo& info, cons
 
             thumbnailer.addFilter(&videoStrip);
             thumbnailer.setThumbnailSize(d->storageSize());
+
+            // VideoDecoder::seek() stops on a key frame anyway: the codec can skip
+            // the other frames instead of decoding them.
+            thumbnailer.setKeyFramesOnly(true);
             thumbnailer.generateThumbnail(path, qimage);
 #else
             qDebug(DIGIKAM_GENERAL_LOG) << "Cannot load video preview for" << path;
@@ -646,7 +682,7 @@ ThumbnailImage ThumbnailCreator::createThumbnail(const ThumbnailInfo& info, cons
 QImage ThumbnailCreator::loadWithDImg(const QString& path, IccProfile* const profile) const
 {
     DImg img;
-    img.setAttribute(QLatin1String("scaledLoadingSize"), d->storageSize());
+    img.setScaledLoadingSize(d->storageSize());
     img.load(path, false, profile ? true : false, false, false, d->observer, d->rawSettings);
 
     if (profile)
@@ -840,90 +876,37 @@ void ThumbnailCreator::storeInDatabase(const ThumbnailInfo& info, const Thumbnai
         }
     }
 
-    ThumbsDbAccess access;
-    BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
+    // The encoding is done here, in the loading thread. The database writes of all
+    // threads are grouped in batched transactions by the queue.
 
-    while (lastQueryState == BdEngineBackend::ConnectionError)
-    {
-        lastQueryState = access.backend()->beginTransaction();
+    ThumbsDbPendingThumbnail thumb;
+    thumb.dbInfo           = dbInfo;
+    thumb.customIdentifier = info.customIdentifier;
 
-        if (BdEngineBackend::NoErrors != lastQueryState)
-        {
-            continue;
-        }
-
-        // Insert thumbnail data
-        if (dbInfo.id == -1)
-        {
-            QVariant id;
-            lastQueryState = access.db()->insertThumbnail(dbInfo, &id);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-            else
-            {
-                dbInfo.id = id.toInt();
-            }
-        }
-        else
-        {
-            lastQueryState = access.db()->replaceThumbnail(dbInfo);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-        }
-
-        // Insert lookup data used to locate thumbnail data
-        if (!info.customIdentifier.isNull())
-        {
-            lastQueryState = access.db()->insertCustomIdentifier(info.customIdentifier, dbInfo.id);
-
-            if (BdEngineBackend::NoErrors != lastQueryState)
-            {
-                continue;
-            }
-        }
-        else
-        {
-            if (!info.uniqueHash.isNull())
-            {
-                lastQueryState = access.db()->insertUniqueHash(info.uniqueHash, info.fileSize, dbInfo.id);
-
-                if (BdEngineBackend::NoErrors != lastQueryState)
-                {
-                    continue;
-                }
-            }
-
-            if (!info.filePath.isNull())
-            {
-                lastQueryState = access.db()->insertFilePath(info.filePath, dbInfo.id);
+    if (info.customIdentifier.isNull())
+    {
+        thumb.uniqueHash   = info.uniqueHash;
+        thumb.fileSize     = info.fileSize;
+        thumb.filePath     = info.filePath;
+    }
 
-                if (BdEngineBackend::NoErrors != lastQueryState)
-                {
-                    continue;
-                }
-            }
-        }
+    ThumbsDbWriteQueue::instance()->enqueue(thumb);
+}
 
-        lastQueryState = access.backend()->commitTransaction();
+ThumbsDbInfo ThumbnailCreator::loadThumbsDbInfo(const ThumbnailInfo& info) const
+{
+    ThumbsDbInfo dbInfo;
 
-        if (BdEngineBackend::NoErrors != lastQueryState)
-        {
-            continue;
-        }
+    // A thumbnail stored recently can still wait in the write queue
+    if (ThumbsDbWriteQueue::instance()->findPending(info.customIdentifier, info.uniqueHash,
+                                                    info.fileSize, info.filePath, &dbInfo))
+    {
+        d->dbIdForReplacement = dbInfo.id;
 
+        return dbInfo;
     }
-}
 
-ThumbsDbInfo ThumbnailCreator::loadThumbsDbInfo(const ThumbnailInfo& info) const
-{
     ThumbsDbAccess access;
-    ThumbsDbInfo   dbInfo;
 
     // Custom identifier takes precedence
     if (!info.customIdentifier.isEmpty())
@@ -1052,6 +1035,9 @@ ThumbnailImage ThumbnailCreator::loadFromDatabase(const ThumbnailInfo& info) con
 
 void ThumbnailCreator::deleteFromDatabase(const ThumbnailInfo& info) const
 {
+    // Do not let a queued thumbnail be written after its removal
+    ThumbsDbWriteQueue::instance()->flush();
+
     ThumbsDbAccess access;
     BdEngineBackend::QueryState lastQueryState = BdEngineBackend::QueryState(BdEngineBackend::ConnectionError);
 
@@ -1093,6 +1079,98 @@ void ThumbnailCreator::deleteFromDatabase(const ThumbnailInfo& info) const
     }
 }
 
+// --------------- Memory-mapped thumbnail pack storage -----------------------
+
+
+QStringList ThumbnailCreator::packKeys(const ThumbnailInfo& info)
+{
+    // Same lookup precedence as for the database: custom identifier, else hash, else path.
+
+    QStringList keys;
+
+    if (!info.customIdentifier.isEmpty())
+    {
+        keys << ThumbnailPack::customIdentifierKey(info.customIdentifier);
+
+        return keys;
+    }
+
+    if (!info.uniqueHash.isEmpty())
+    {
+        keys << ThumbnailPack::uniqueHashKey(info.uniqueHash, info.fileSize);
+    }
+
+    if (!info.filePath.isEmpty())
+    {
+        keys << ThumbnailPack::filePathKey(info.filePath);
+    }
+
+    return keys;
+}
+
+void ThumbnailCreator::storeInPack(const ThumbnailInfo& info, const ThumbnailImage& image) const
+{
+    if (!ThumbnailPack::instance()->insert(packKeys(info), image.qimage,
+                                           info.modificationDate, image.exifOrientation))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot save thumb in pack file for" << info.filePath;
+    }
+}
+
+bool ThumbnailCreator::isInPack(const ThumbnailInfo& info) const
+{
+    ThumbnailPackEntry entry;
+
+    if (!ThumbnailPack::instance()->find(packKeys(info), &entry))
+    {
+        return false;
+    }
+
+    // check modification date
+    return (entry.modificationDate >= info.modificationDate);
+}
+
+ThumbnailImage ThumbnailCreator::loadFromPack(const ThumbnailInfo& info) const
+{
+    ThumbnailPackEntry entry;
+
+    if (!ThumbnailPack::instance()->find(packKeys(info), &entry))
+    {
+        return ThumbnailImage();
+    }
+
+    // check modification date
+    if (entry.modificationDate < info.modificationDate)
+    {
+        return ThumbnailImage();
+    }
+
+    // The pixels are used in place, there is nothing to decode.
+    ThumbnailImage image;
+    image.qimage          = entry.image;
+
+    // Same rotation flag priority as loadFromDatabase()
+    image.exifOrientation = info.orientationHint;
+
+    if (image.exifOrientation == DMetadata::ORIENTATION_UNSPECIFIED &&
+        !info.filePath.isEmpty() && LoadSaveThread::infoProvider())
+    {
+        image.exifOrientation = LoadSaveThread::infoProvider()->orientationHint(info.filePath);
+    }
+
+    if (image.exifOrientation == DMetadata::ORIENTATION_UNSPECIFIED)
+    {
+        image.exifOrientation = entry.orientationHint;
+    }
+
+    return image;
+}
+
+void ThumbnailCreator::deleteFromPack(const ThumbnailInfo& info) const
+{
+    ThumbnailPack::instance()->remove(packKeys(info));
+}
+
 // --------------- Freedesktop.org standard implementation -----------------------
 
 
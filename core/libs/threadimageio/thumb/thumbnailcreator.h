@@ -29,6 +29,7 @@
 // Qt includes
 
 #include <QString>
+#include <QStringList>
 #include <QPixmap>
 #include <QImage>
 
@@ -54,7 +55,8 @@ public:
     enum StorageMethod
     {
         FreeDesktopStandard,
-        ThumbnailDatabase
+        ThumbnailDatabase,
+        ThumbnailPackFile    ///< Decoded thumbnails in a memory-mapped file, see ThumbnailPack
     };
 
 public:
@@ -199,6 +201,12 @@ private:
     bool isInDatabase(const ThumbnailInfo& info) const;
     void deleteFromDatabase(const ThumbnailInfo& info) const;
 
+    void storeInPack(const ThumbnailInfo& info, const ThumbnailImage& image) const;
+    ThumbnailImage loadFromPack(const ThumbnailInfo& info) const;
+    bool isInPack(const ThumbnailInfo& info) const;
+    void deleteFromPack(const ThumbnailInfo& info) const;
+    static QStringList packKeys(const ThumbnailInfo& info);
+
     void storeFreedesktop(const ThumbnailInfo& info, const ThumbnailImage& image) const;
     ThumbnailImage loadFreedesktop(const ThumbnailInfo& info) const;
     void deleteFromDiskFreedesktop(const QString& filePath) const;
@@ -49,6 +49,8 @@
 #include "iccsettings.h"
 #include "metaenginesettings.h"
 #include "thumbsdbaccess.h"
+#include "thumbsdbwritequeue.h"
+#include "thumbnailpack.h"
 #include "thumbnailsize.h"
 #include "thumbnailtask.h"
 #include "thumbnailcreator.h"
@@ -198,6 +200,12 @@ void ThumbnailLoadThread::cleanUp()
     defaultIconViewThread()->stopAllTasks();
     defaultThumbBarThread()->stopAllTasks();
     defaultThread()->stopAllTasks();
+
+    // Write the thumbnails queued so far. ThumbsDbAccess::cleanUpDatabase() writes the remaining ones.
+    if (static_d->storageMethod == ThumbnailCreator::ThumbnailDatabase)
+    {
+        ThumbsDbWriteQueue::instance()->flush();
+    }
 }
 
 void ThumbnailLoadThread::initializeThumbnailDatabase(const DbEngineParameters& params, ThumbnailInfoProvider* const provider)
@@ -224,6 +232,34 @@ void ThumbnailLoadThread::initializeThumbnailDatabase(const DbEngineParameters&
     }
 }
 
+bool ThumbnailLoadThread::initializeThumbnailPack(const QString& filePath, ThumbnailInfoProvider* const provider)
+{
+    if (static_d->firstThreadCreated)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Call initializeThumbnailPack at application start. "
+                                        "There are already thumbnail loading threads created, "
+                                        "and these will not be switched to use the pack file. ";
+    }
+
+    if (!ThumbnailPack::instance()->open(filePath))
+    {
+        delete provider;
+
+        return false;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Thumbnails pack file ready for use";
+    static_d->storageMethod = ThumbnailCreator::ThumbnailPackFile;
+
+    if (provider && (provider != static_d->provider))
+    {
+        delete static_d->provider;
+        static_d->provider = provider;
+    }
+
+    return true;
+}
+
 void ThumbnailLoadThread::setDisplayingWidget(QWidget* const widget)
 {
     static_d->profile = IccManager::displayProfile(widget);
@@ -380,14 +416,9 @@ bool ThumbnailLoadThread::Private::checkDescription(const LoadingDescription& de
 {
     QString cacheKey = description.cacheKey();
 
+    if (LoadingCache::cache()->hasThumbnailPixmap(cacheKey))
     {
-        LoadingCache* const cache = LoadingCache::cache();
-        LoadingCache::CacheLock lock(cache);
-
-        if (cache->hasThumbnailPixmap(cacheKey))
-        {
-            return false;
-        }
+        return false;
     }
 
     {
@@ -456,7 +487,6 @@ QList<LoadingDescription> ThumbnailLoadThread::Private::makeDescriptions(const Q
 
 bool ThumbnailLoadThread::find(const ThumbnailIdentifier& identifier, int size, QPixmap* retPixmap, bool emitSignal, const QRect& detailRect)
 {
-    const QPixmap* pix = nullptr;
     LoadingDescription description;
 
     if (detailRect.isNull())
@@ -469,24 +499,19 @@ bool ThumbnailLoadThread::find(const ThumbnailIdentifier& identifier, int size,
     }
 
     QString cacheKey = description.cacheKey();
+    QPixmap pix      = LoadingCache::cache()->retrieveThumbnailPixmap(cacheKey);
 
-    {
-        LoadingCache* const cache = LoadingCache::cache();
-        LoadingCache::CacheLock lock(cache);
-        pix                       = cache->retrieveThumbnailPixmap(cacheKey);
-    }
-
-    if (pix)
+    if (!pix.isNull())
     {
         if (retPixmap)
         {
-            *retPixmap = *pix;
+            *retPixmap = pix;
         }
 
         if (emitSignal)
         {
             load(description);
-            emit signalThumbnailLoaded(description, QPixmap(*pix));
+            emit signalThumbnailLoaded(description, pix);
         }
 
         return true;
@@ -767,9 +792,7 @@ void ThumbnailLoadThread::slotThumbnailLoaded(const LoadingDescription& descript
     // put into cache
     if (!pix.isNull())
     {
-        LoadingCache* const cache = LoadingCache::cache();
-        LoadingCache::CacheLock lock(cache);
-        cache->putThumbnail(description.cacheKey(), pix, description.filePath);
+        LoadingCache::cache()->putThumbnail(description.cacheKey(), pix, description.filePath);
     }
 
     emit signalThumbnailLoaded(description, pix);
@@ -834,7 +857,6 @@ void ThumbnailLoadThread::deleteThumbnail(const QString& filePath)
 {
     {
         LoadingCache* const cache = LoadingCache::cache();
-        LoadingCache::CacheLock lock(cache);
         QStringList possibleKeys  = LoadingDescription::possibleThumbnailCacheKeys(filePath);
 
         foreach (const QString& cacheKey, possibleKeys)
@@ -70,6 +70,16 @@ public:
      */
     static void initializeThumbnailDatabase(const DbEngineParameters& params, ThumbnailInfoProvider* const provider = nullptr);
 
+    /**
+     * Store thumbnails decoded in a memory-mapped pack file instead of the database.
+     * This shall be called once at application startup, after initializeThumbnailDatabase()
+     * if a database is used for the thumbnail infos. Returns false if the file cannot be used,
+     * the storage method is then unchanged.
+     * You can optionally provide a thumbnail info provider, replacing the current one.
+     * The provider is taken over, also on failure.
+     */
+    static bool initializeThumbnailPack(const QString& filePath, ThumbnailInfoProvider* const provider = nullptr);
+
     /**
      * For color management, this sets the widget the thumbnails will be color managed for.
      * (currently it is only possible to set one global widget)
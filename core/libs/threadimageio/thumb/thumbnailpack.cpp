@@ -0,0 +1,777 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-26
+ * Description : Memory-mapped single file storage of decoded thumbnails
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "thumbnailpack.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QFile>
+#include <QHash>
+#include <QLockFile>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/// The file grows and is mapped by chunks of this size. A record never crosses a chunk boundary.
+const qint64  ChunkSize       = 64 * 1024 * 1024;
+const qint64  FileHeaderSize  = 64;
+const quint32 FileVersion     = 1;
+const quint32 ByteOrderMark   = 0x01020304;
+const quint32 RecordMagic     = 0x4b505452;
+const char    FileMagic[8]    = { 'D', 'K', 'T', 'H', 'U', 'M', 'B', 'P' };
+
+/// Reclaim the unused space when opening a file with more than this amount wasted.
+const qint64  CompactionLimit = 256 * 1024 * 1024;
+
+enum RecordFlags
+{
+    NoFlags = 0x0,
+    Removed = 0x1
+};
+
+struct FileHeader
+{
+    char    magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    qint64  chunkSize;
+
+    /// Position after the last complete record.
+    qint64  end;
+};
+
+/** A record is this header, the keys (each one as 16 bits length and UTF-8 data),
+ *  then the pixels, each part aligned on 16 bytes.
+ */
+struct RecordHeader
+{
+    quint32 magic;
+    quint32 flags;
+    qint64  size;
+    qint64  modificationDate;        ///< msecs since epoch, -1 if invalid
+    qint32  orientationHint;
+    qint32  format;
+    qint32  width;
+    qint32  height;
+    qint32  bytesPerLine;
+    quint32 keysSize;
+};
+
+inline qint64 align16(qint64 value)
+{
+    return ((value + 15) & ~qint64(15));
+}
+
+inline qint64 pixelsOffset(const RecordHeader* const header)
+{
+    return align16(sizeof(RecordHeader) + header->keysSize);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ThumbnailPack::Private
+{
+public:
+
+    explicit Private()
+      : liveSize(0),
+        isOpen(false),
+        lockFile(nullptr)
+    {
+    }
+
+    ~Private()
+    {
+        close();
+    }
+
+    FileHeader* header() const
+    {
+        return reinterpret_cast<FileHeader*>(chunks.first());
+    }
+
+    uchar* pointer(qint64 pos) const
+    {
+        return (chunks.at(pos / ChunkSize) + pos % ChunkSize);
+    }
+
+    const RecordHeader* record(qint64 pos) const
+    {
+        return reinterpret_cast<const RecordHeader*>(pointer(pos));
+    }
+
+    bool mapChunk(int chunk)
+    {
+        const qint64 end = (chunk + 1) * ChunkSize;
+
+        if ((file.size() < end) && !file.resize(end))
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot grow thumbnail pack" << file.fileName() << file.errorString();
+            return false;
+        }
+
+        uchar* const data = file.map(chunk * ChunkSize, ChunkSize);
+
+        if (!data)
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot map thumbnail pack" << file.fileName() << file.errorString();
+            return false;
+        }
+
+        chunks << data;
+
+        return true;
+    }
+
+    /// Unmap and close the file, and release the lock file so another attempt can be made.
+    void close()
+    {
+        unmapAll();
+        file.close();
+
+        if (lockFile)
+        {
+            lockFile->unlock();
+            delete lockFile;
+            lockFile = nullptr;
+        }
+    }
+
+    void unmapAll()
+    {
+        foreach (uchar* const data, chunks)
+        {
+            file.unmap(data);
+        }
+
+        chunks.clear();
+        index.clear();
+        references.clear();
+        liveSize = 0;
+    }
+
+    bool create()
+    {
+        unmapAll();
+
+        if (!file.resize(0) || !mapChunk(0))
+        {
+            return false;
+        }
+
+        FileHeader* const h = header();
+        memcpy(h->magic, FileMagic, sizeof(FileMagic));
+        h->version          = FileVersion;
+        h->byteOrderMark    = ByteOrderMark;
+        h->chunkSize        = ChunkSize;
+        h->end              = FileHeaderSize;
+
+        return true;
+    }
+
+    bool hasValidHeader() const
+    {
+        const FileHeader* const h = header();
+
+        return ((memcmp(h->magic, FileMagic, sizeof(FileMagic)) == 0) &&
+                (h->version       == FileVersion)                   &&
+                (h->byteOrderMark == ByteOrderMark)                 &&
+                (h->chunkSize     == ChunkSize)                     &&
+                (h->end           >= FileHeaderSize)                &&
+                (h->end           <= file.size()));
+    }
+
+    bool openFile(const QString& filePath)
+    {
+        file.setFileName(filePath);
+
+        if (!file.open(QIODevice::ReadWrite))
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot open thumbnail pack" << filePath << file.errorString();
+            return false;
+        }
+
+        const qint64 size = file.size();
+
+        if ((size == 0) || (size % ChunkSize != 0))
+        {
+            return create();
+        }
+
+        for (int chunk = 0 ; chunk < size / ChunkSize ; ++chunk)
+        {
+            if (!mapChunk(chunk))
+            {
+                return false;
+            }
+        }
+
+        if (!hasValidHeader())
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Thumbnail pack" << filePath << "is not compatible. It is recreated.";
+            return create();
+        }
+
+        scan();
+
+        return true;
+    }
+
+    /// Rebuild the index by walking all records.
+    void scan()
+    {
+        const qint64 end = header()->end;
+        qint64 pos       = FileHeaderSize;
+
+        while (pos < end)
+        {
+            const qint64 remaining = ChunkSize - pos % ChunkSize;
+
+            if ((remaining < (qint64)sizeof(RecordHeader)) || (record(pos)->magic == 0))
+            {
+                // The rest of the chunk was too small for the next record.
+
+                pos += remaining;
+                continue;
+            }
+
+            const RecordHeader* const h = record(pos);
+
+            if ((h->magic != RecordMagic) || (h->size > remaining) || (h->size < (qint64)sizeof(RecordHeader)))
+            {
+                qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnail pack" << file.fileName()
+                                               << "is damaged at" << pos << ". Following records are dropped.";
+                memset(pointer(pos), 0, sizeof(quint32));
+                header()->end = pos;
+                break;
+            }
+
+            QStringList keys = readKeys(pos);
+
+            foreach (const QString& key, keys)
+            {
+                if (h->flags & Removed)
+                {
+                    unbind(key);
+                }
+                else
+                {
+                    bind(key, pos);
+                }
+            }
+
+            pos += h->size;
+        }
+    }
+
+    QStringList readKeys(qint64 pos) const
+    {
+        QStringList keys;
+        const RecordHeader* const h = record(pos);
+        const uchar* data           = pointer(pos) + sizeof(RecordHeader);
+        const uchar* const end      = data + h->keysSize;
+
+        while (data + sizeof(quint16) <= end)
+        {
+            quint16 length;
+            memcpy(&length, data, sizeof(quint16));
+            data += sizeof(quint16);
+
+            if (data + length > end)
+            {
+                break;
+            }
+
+            keys << QString::fromUtf8(reinterpret_cast<const char*>(data), length);
+            data += length;
+        }
+
+        return keys;
+    }
+
+    void bind(const QString& key, qint64 pos)
+    {
+        const qint64 old = index.value(key, -1);
+
+        if (old == pos)
+        {
+            return;
+        }
+
+        if (old != -1)
+        {
+            dereference(old);
+        }
+
+        index.insert(key, pos);
+
+        if (references[pos]++ == 0)
+        {
+            liveSize += record(pos)->size;
+        }
+    }
+
+    void unbind(const QString& key)
+    {
+        const qint64 old = index.value(key, -1);
+
+        if (old != -1)
+        {
+            index.remove(key);
+            dereference(old);
+        }
+    }
+
+    void dereference(qint64 pos)
+    {
+        if (--references[pos] == 0)
+        {
+            references.remove(pos);
+            liveSize -= record(pos)->size;
+        }
+    }
+
+    /** Append a record with the given properties and pixels. Returns false if there is no space.
+     */
+    bool append(const QStringList& keys, const RecordHeader& properties, const uchar* const pixels)
+    {
+        QList<QByteArray> encodedKeys;
+        qint64 keysSize = 0;
+
+        foreach (const QString& key, keys)
+        {
+            encodedKeys << key.toUtf8().left(0xFFFF);
+            keysSize    += sizeof(quint16) + encodedKeys.last().size();
+        }
+
+        RecordHeader h      = properties;
+        h.magic             = RecordMagic;
+        h.keysSize          = keysSize;
+
+        const qint64 offset = pixelsOffset(&h);
+        const qint64 bytes  = (h.flags & Removed) ? 0 : (qint64)h.bytesPerLine * h.height;
+        h.size              = offset + align16(bytes);
+
+        if (h.size > ChunkSize - FileHeaderSize)
+        {
+            return false;
+        }
+
+        qint64 pos = header()->end;
+
+        if (pos % ChunkSize + h.size > ChunkSize)
+        {
+            // Leave the end of the chunk empty. A null magic tells scan() to skip it.
+
+            const qint64 remaining = ChunkSize - pos % ChunkSize;
+            memset(pointer(pos), 0, qMin(remaining, (qint64)sizeof(RecordHeader)));
+            pos += remaining;
+        }
+
+        while (chunks.size() <= pos / ChunkSize)
+        {
+            if (!mapChunk(chunks.size()))
+            {
+                return false;
+            }
+        }
+
+        uchar* const data = pointer(pos);
+        uchar* keyData    = data + sizeof(RecordHeader);
+
+        foreach (const QByteArray& key, encodedKeys)
+        {
+            const quint16 length = key.size();
+            memcpy(keyData, &length, sizeof(quint16));
+            memcpy(keyData + sizeof(quint16), key.constData(), length);
+            keyData += sizeof(quint16) + length;
+        }
+
+        if (bytes)
+        {
+            memcpy(data + offset, pixels, bytes);
+        }
+
+        memcpy(data, &h, sizeof(RecordHeader));
+
+        // The record is complete: make it part of the file.
+
+        header()->end = pos + h.size;
+
+        foreach (const QString& key, keys)
+        {
+            if (h.flags & Removed)
+            {
+                unbind(key);
+            }
+            else
+            {
+                bind(key, pos);
+            }
+        }
+
+        return true;
+    }
+
+    /** Copy the used records to a new file and replace the current one with it.
+     */
+    bool compact()
+    {
+        const QString filePath = file.fileName();
+        const QString newPath  = filePath + QLatin1String(".new");
+
+        QFile::remove(newPath);
+
+        // Keys grouped by record, in file order.
+
+        QMap<qint64, QStringList> keysForRecord;
+
+        for (QHash<QString, qint64>::const_iterator it = index.constBegin() ; it != index.constEnd() ; ++it)
+        {
+            keysForRecord[it.value()] << it.key();
+        }
+
+        bool success = false;
+
+        {
+            Private fresh;
+
+            if (fresh.openFile(newPath))
+            {
+                success = true;
+
+                for (QMap<qint64, QStringList>::const_iterator it = keysForRecord.constBegin() ;
+                     success && (it != keysForRecord.constEnd()) ; ++it)
+                {
+                    const RecordHeader* const h = record(it.key());
+                    success                     = fresh.append(it.value(), *h, pointer(it.key()) + pixelsOffset(h));
+                }
+            }
+        }
+
+        if (!success)
+        {
+            QFile::remove(newPath);
+
+            return false;
+        }
+
+        unmapAll();
+        file.close();
+
+        if (!QFile::remove(filePath) || !QFile::rename(newPath, filePath))
+        {
+            qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot replace thumbnail pack" << filePath;
+        }
+
+        return openFile(filePath);
+    }
+
+public:
+
+    QFile                  file;
+    QVector<uchar*>        chunks;
+
+    QHash<QString, qint64> index;
+
+    /// Number of keys referring to a record, for the records in use.
+    QHash<qint64, int>     references;
+    qint64                 liveSize;
+
+    bool                   isOpen;
+    QLockFile*             lockFile;
+
+    mutable QReadWriteLock lock;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ThumbnailPackCreator
+{
+public:
+
+    ThumbnailPack object;
+};
+
+Q_GLOBAL_STATIC(ThumbnailPackCreator, creator)
+
+// -----------------------------------------------------------------------------------------------------
+
+ThumbnailPack* ThumbnailPack::instance()
+{
+    return &creator->object;
+}
+
+ThumbnailPack::ThumbnailPack()
+    : d(new Private)
+{
+}
+
+ThumbnailPack::~ThumbnailPack()
+{
+    delete d;
+}
+
+bool ThumbnailPack::open(const QString& filePath)
+{
+    QWriteLocker locker(&d->lock);
+
+    if (d->isOpen || d->lockFile)
+    {
+        return (d->isOpen && (d->file.fileName() == filePath));
+    }
+
+#ifdef Q_OS_WIN
+
+    qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnail pack files are not supported on this platform";
+
+    return false;
+
+#else
+
+    d->lockFile = new QLockFile(filePath + QLatin1String(".lock"));
+
+    if (!d->lockFile->tryLock(0))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnail pack" << filePath << "is used by another process";
+        delete d->lockFile;
+        d->lockFile = nullptr;
+
+        return false;
+    }
+
+    if (!d->openFile(filePath))
+    {
+        d->close();
+
+        return false;
+    }
+
+    const qint64 unused = d->header()->end - FileHeaderSize - d->liveSize;
+
+    if ((unused > CompactionLimit) && (unused > d->liveSize))
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Compacting thumbnail pack" << filePath << ":" << unused << "bytes unused";
+
+        if (!d->compact())
+        {
+            d->close();
+
+            return false;
+        }
+    }
+
+    d->isOpen = true;
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Thumbnail pack" << filePath << "opened with"
+                                 << d->references.count() << "thumbnails";
+
+    return true;
+
+#endif
+}
+
+bool ThumbnailPack::isOpen() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->isOpen;
+}
+
+QString ThumbnailPack::filePath() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->file.fileName();
+}
+
+bool ThumbnailPack::find(const QStringList& keys, ThumbnailPackEntry* const entry) const
+{
+    QReadLocker locker(&d->lock);
+
+    if (!d->isOpen)
+    {
+        return false;
+    }
+
+    foreach (const QString& key, keys)
+    {
+        const qint64 pos = d->index.value(key, -1);
+
+        if (pos == -1)
+        {
+            continue;
+        }
+
+        const RecordHeader* const h = d->record(pos);
+
+        // Read-only constructor: the pixels stay in the mapped file.
+
+        entry->image            = QImage(d->pointer(pos) + pixelsOffset(h), h->width, h->height,
+                                         h->bytesPerLine, (QImage::Format)h->format);
+        entry->modificationDate = (h->modificationDate == -1) ? QDateTime()
+                                                              : QDateTime::fromMSecsSinceEpoch(h->modificationDate);
+        entry->orientationHint  = h->orientationHint;
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ThumbnailPack::insert(const QStringList& keys, const QImage& image,
+                           const QDateTime& modificationDate, int orientationHint)
+{
+    if (keys.isEmpty() || image.isNull())
+    {
+        return false;
+    }
+
+    QImage qimage = image;
+
+    if ((qimage.format() != QImage::Format_RGB32) &&
+        (qimage.format() != QImage::Format_ARGB32) &&
+        (qimage.format() != QImage::Format_ARGB32_Premultiplied))
+    {
+        qimage = qimage.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    RecordHeader properties;
+    memset(&properties, 0, sizeof(RecordHeader));
+    properties.flags            = NoFlags;
+    properties.modificationDate = modificationDate.isValid() ? modificationDate.toMSecsSinceEpoch() : -1;
+    properties.orientationHint  = orientationHint;
+    properties.format           = qimage.format();
+    properties.width            = qimage.width();
+    properties.height           = qimage.height();
+    properties.bytesPerLine     = qimage.bytesPerLine();
+
+    QWriteLocker locker(&d->lock);
+
+    if (!d->isOpen)
+    {
+        return false;
+    }
+
+    return d->append(keys, properties, qimage.constBits());
+}
+
+void ThumbnailPack::remove(const QStringList& keys)
+{
+    QWriteLocker locker(&d->lock);
+
+    if (!d->isOpen)
+    {
+        return;
+    }
+
+    QStringList known;
+
+    foreach (const QString& key, keys)
+    {
+        if (d->index.contains(key))
+        {
+            known << key;
+        }
+    }
+
+    RecordHeader properties;
+    memset(&properties, 0, sizeof(RecordHeader));
+    properties.flags            = Removed;
+    properties.modificationDate = -1;
+
+    // One removal record per batch of keys, so that a record always fits in a chunk.
+
+    const int batchSize = 1000;
+
+    for (int i = 0 ; i < known.size() ; i += batchSize)
+    {
+        if (!d->append(known.mid(i, batchSize), properties, nullptr))
+        {
+            break;
+        }
+    }
+}
+
+QStringList ThumbnailPack::keys() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->index.keys();
+}
+
+QString ThumbnailPack::customIdentifierKey(const QString& customIdentifier)
+{
+    return (QLatin1String("c:") + customIdentifier);
+}
+
+QString ThumbnailPack::uniqueHashKey(const QString& uniqueHash, qlonglong fileSize)
+{
+    return QString::fromLatin1("h:%1:%2").arg(uniqueHash).arg(fileSize);
+}
+
+QString ThumbnailPack::filePathKey(const QString& filePath)
+{
+    return (QLatin1String("p:") + filePath);
+}
+
+int ThumbnailPack::count() const
+{
+    QReadLocker locker(&d->lock);
+
+    return d->references.count();
+}
+
+qint64 ThumbnailPack::fileSize() const
+{
+    QReadLocker locker(&d->lock);
+
+    return (d->chunks.isEmpty() ? 0 : d->header()->end);
+}
+
+qint64 ThumbnailPack::unusedSize() const
+{
+    QReadLocker locker(&d->lock);
+
+    return (d->chunks.isEmpty() ? 0 : d->header()->end - FileHeaderSize - d->liveSize);
+}
+
+} // namespace Digikam
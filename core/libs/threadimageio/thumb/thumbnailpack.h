@@ -0,0 +1,132 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-26
+ * Description : Memory-mapped single file storage of decoded thumbnails
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_THUMBNAIL_PACK_H
+#define DIGIKAM_THUMBNAIL_PACK_H
+
+// Qt includes
+
+#include <QDateTime>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+class DIGIKAM_EXPORT ThumbnailPackEntry
+{
+public:
+
+    explicit ThumbnailPackEntry()
+        : orientationHint(0)
+    {
+    }
+
+    /// Refers directly to the mapped file. Read-only: a modification detaches a copy.
+    QImage    image;
+    QDateTime modificationDate;
+    int       orientationHint;
+};
+
+// --------------------------------------------------------------------------
+
+/** A thumbnail store holding decoded, pre-sized images in one append-only file.
+ *
+ *  The file is mapped in memory by chunks of fixed size. A record contains the lookup keys,
+ *  the modification date and orientation of the original, and the pixels of the thumbnail
+ *  in a QImage compatible layout, so a stored thumbnail is returned without copy nor decoding,
+ *  served from the page cache of the operating system.
+ *
+ *  The key to record map is held in memory and rebuilt when the file is opened.
+ *  A replaced or removed thumbnail leaves its old record in the file: the space is
+ *  reclaimed by a compaction when the file is opened and more than half of it is unused.
+ *
+ *  The mapping stays valid until the process ends, which keeps all returned images valid.
+ *  Only one process can open a given file. All methods are thread-safe.
+ *  Not available on Windows, where a mapped file cannot grow.
+ */
+class DIGIKAM_EXPORT ThumbnailPack
+{
+public:
+
+    static ThumbnailPack* instance();
+
+    /** Open or create the pack file. A damaged or incompatible file is recreated.
+     *  Returns false if the file cannot be used, after releasing it.
+     *  Once a file is open, the pack cannot be opened again.
+     */
+    bool open(const QString& filePath);
+
+    bool    isOpen()   const;
+    QString filePath() const;
+
+    /** Look up the thumbnail stored under the first known key of the list.
+     */
+    bool find(const QStringList& keys, ThumbnailPackEntry* const entry) const;
+
+    /** Store a thumbnail under all the keys of the list, replacing previous ones.
+     */
+    bool insert(const QStringList& keys, const QImage& image,
+                const QDateTime& modificationDate, int orientationHint);
+
+    /** Forget the thumbnails stored under the keys of the list.
+     */
+    void remove(const QStringList& keys);
+
+    /** All keys with a thumbnail stored. Used by the database maintenance to find stale entries.
+     */
+    QStringList keys() const;
+
+    /** The keys of a thumbnail, the same as the lookup keys of the thumbnails database.
+     */
+    static QString customIdentifierKey(const QString& customIdentifier);
+    static QString uniqueHashKey(const QString& uniqueHash, qlonglong fileSize);
+    static QString filePathKey(const QString& filePath);
+
+    int    count()       const;
+    qint64 fileSize()    const;
+    qint64 unusedSize()  const;
+
+private:
+
+    explicit ThumbnailPack();
+    ~ThumbnailPack();
+
+    ThumbnailPack(const ThumbnailPack&); // Disable
+
+private:
+
+    friend class ThumbnailPackCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_THUMBNAIL_PACK_H
@@ -93,12 +93,7 @@ void ThumbnailLoadingTask::execute()
         LoadingCache::CacheLock lock(cache);
 
         // find possible cached images
-        const QImage* const cachedImage = cache->retrieveThumbnail(m_loadingDescription.cacheKey());
-
-        if (cachedImage)
-        {
-            m_qimage = QImage(*cachedImage);
-        }
+        m_qimage = cache->retrieveThumbnail(m_loadingDescription.cacheKey());
 
         if (m_qimage.isNull())
         {
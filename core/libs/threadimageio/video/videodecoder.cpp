@@ -32,9 +32,10 @@
 namespace Digikam
 {
 
-VideoDecoder::VideoDecoder(const QString& filename)
+VideoDecoder::VideoDecoder(const QString& filename, int scaledDecodingSize)
     : d(new Private)
 {
+    d->scaledDecodingSize = scaledDecodingSize;
     initialize(filename);
 }
 
@@ -124,6 +125,12 @@ void VideoDecoder::destroy()
         av_free(d->pFrameBuffer);
         d->pFrameBuffer = nullptr;
     }
+
+    if (d->scaleContext)
+    {
+        sws_freeContext(d->scaleContext);
+        d->scaleContext = nullptr;
+    }
 }
 
 QString VideoDecoder::getCodec() const 
@@ -168,11 +175,19 @@ int VideoDecoder::getDuration() const
     return 0;
 }
 
-void VideoDecoder::seek(int timeInSeconds)
+void VideoDecoder::setKeyFramesOnly(bool keyFramesOnly)
+{
+    if (d->pVideoCodecContext)
+    {
+        d->pVideoCodecContext->skip_frame = keyFramesOnly ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    }
+}
+
+bool VideoDecoder::seek(int timeInSeconds)
 {
     if (!d->allowSeek)
     {
-        return;
+        return false;
     }
 
     qint64 timestamp = AV_TIME_BASE * static_cast<qint64>(timeInSeconds);
@@ -191,7 +206,7 @@ void VideoDecoder::seek(int timeInSeconds)
     else
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "Seeking in video failed";
-        return;
+        return false;
     }
 
     int keyFrameAttempts = 0;
@@ -218,6 +233,8 @@ void VideoDecoder::seek(int timeInSeconds)
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "Seeking in video failed";
     }
+
+    return gotFrame;
 }
 
 bool VideoDecoder::decodeVideoFrame() const
@@ -246,8 +263,8 @@ void VideoDecoder::getScaledVideoFrame(int scaledSize,
         d->processFilterGraph(d->pFrame,
                               d->pFrame,
                               d->pVideoCodecContext->pix_fmt,
-                              d->pVideoCodecContext->width,
-                              d->pVideoCodecContext->height);
+                              d->pFrame->width,
+                              d->pFrame->height);
     }
 
     int scaledWidth, scaledHeight;
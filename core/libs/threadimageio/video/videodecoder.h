@@ -40,7 +40,11 @@ class VideoDecoder
 {
 public:
 
-    explicit VideoDecoder(const QString& filename);
+    /**
+     * With a scaledDecodingSize, the codecs able to decode at a reduced resolution (as MJPEG)
+     * do it, as long as both sides remain larger than this size.
+     */
+    explicit VideoDecoder(const QString& filename, int scaledDecodingSize = 0);
     ~VideoDecoder();
 
 public:
@@ -51,7 +55,16 @@ public:
     int     getDuration()    const;
     bool    getInitialized() const;
 
-    void seek(int timeInSeconds);
+    /**
+     * Let the codec skip all frames except the key frames. Seeking and decoding only
+     * return key frames then, which needs no decoding of the frames in between.
+     */
+    void setKeyFramesOnly(bool keyFramesOnly);
+
+    /**
+     * Return true if a frame was decoded at the new position.
+     */
+    bool seek(int timeInSeconds);
     bool decodeVideoFrame()  const;
     void getScaledVideoFrame(int scaledSize,
                              bool maintainAspectRatio,
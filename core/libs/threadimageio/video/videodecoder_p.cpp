@@ -51,6 +51,8 @@ VideoDecoder::Private::Private()
     lastWidth             = 0;
     lastHeight            = 0;
     lastPixfmt            = AV_PIX_FMT_NONE;
+    scaleContext          = nullptr;
+    scaledDecodingSize    = 0;
 }
 
 VideoDecoder::Private::~Private()
@@ -102,6 +104,20 @@ bool VideoDecoder::Private::initializeVideo()
     pVideoCodecContext = avcodec_alloc_context3(pVideoCodec);
     avcodec_parameters_to_context(pVideoCodecContext, pVideoCodecParameters);
 
+    if (scaledDecodingSize > 0)
+    {
+        // Each lowres step halves the decoded width and height
+        int shortestSide = qMin(pVideoCodecContext->width, pVideoCodecContext->height);
+        int lowres       = 0;
+
+        while ((lowres < pVideoCodec->max_lowres) && ((shortestSide >> (lowres + 1)) >= scaledDecodingSize))
+        {
+            ++lowres;
+        }
+
+        pVideoCodecContext->lowres = lowres;
+    }
+
     if (avcodec_open2(pVideoCodecContext, pVideoCodec, nullptr) < 0)
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "Could not open video codec";
@@ -351,16 +367,23 @@ void VideoDecoder::Private::convertAndScaleFrame(AVPixelFormat format,
 
     calculateDimensions(scaledSize, maintainAspectRatio, scaledWidth, scaledHeight);
 
-    SwsContext* const scaleContext = sws_getContext(pVideoCodecContext->width,
-                                                    pVideoCodecContext->height,
-                                                    pVideoCodecContextPixFormat,
-                                                    scaledWidth,
-                                                    scaledHeight,
-                                                    format,
-                                                    SWS_BICUBIC,
-                                                    nullptr,
-                                                    nullptr,
-                                                    nullptr);
+    // The frame has the decoded size, which is reduced with lowres decoding.
+    // The scaler is kept from one frame to the next one while the sizes do not change.
+
+    int frameWidth  = pFrame->width  ? pFrame->width  : pVideoCodecContext->width;
+    int frameHeight = pFrame->height ? pFrame->height : pVideoCodecContext->height;
+
+    scaleContext    = sws_getCachedContext(scaleContext,
+                                           frameWidth,
+                                           frameHeight,
+                                           pVideoCodecContextPixFormat,
+                                           scaledWidth,
+                                           scaledHeight,
+                                           format,
+                                           SWS_BICUBIC,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr);
 
     if (!scaleContext)
     {
@@ -381,12 +404,10 @@ void VideoDecoder::Private::convertAndScaleFrame(AVPixelFormat format,
               pFrame->data,
               pFrame->linesize,
               0,
-              pVideoCodecContext->height,
+              frameHeight,
               convertedFrame->data,
               convertedFrame->linesize);
 
-    sws_freeContext(scaleContext);
-
     av_frame_free(&pFrame);
     av_free(pFrameBuffer);
 
@@ -70,6 +70,8 @@ public:
     int                lastWidth;
     int                lastHeight;
     enum AVPixelFormat lastPixfmt;
+    SwsContext*        scaleContext;
+    int                scaledDecodingSize;
 
 public:
 
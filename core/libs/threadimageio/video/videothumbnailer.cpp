@@ -27,12 +27,15 @@
 // C++ includes
 
 #include <cfloat>
+#include <cmath>
+#include <cstring>
 
 // Qt includes
 
 #include <QtGlobal>
-#include <QtMath>
 #include <QTime>
+#include <QThread>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
@@ -58,9 +61,9 @@ public:
 
         explicit Histogram()
         {
-            memset(r, 0, 255 * sizeof(T));
-            memset(g, 0, 255 * sizeof(T));
-            memset(b, 0, 255 * sizeof(T));
+            memset(r, 0, 256 * sizeof(T));
+            memset(g, 0, 256 * sizeof(T));
+            memset(b, 0, 256 * sizeof(T));
         }
 
         ~Histogram()
@@ -74,10 +77,29 @@ public:
         T b[256];
     };
 
+    /**
+     * The candidate frames of the smart frame selection decoded by one thread,
+     * with its own decoder.
+     */
+    class Q_DECL_HIDDEN SmartFrameTask
+    {
+
+    public:
+
+        QString                    videoFile;
+        int                        thumbnailSize;
+        bool                       maintainAspectRatio;
+        QList<int>                 indexes;
+        const QVector<int>*        seconds;
+        vector<VideoFrame>*        videoFrames;
+        vector<Histogram<int> >*   histograms;
+    };
+
 public:
 
     explicit Private()
-      : SMART_FRAME_ATTEMPTS(25)
+      : SMART_FRAME_ATTEMPTS(25),
+        MAX_DECODING_THREADS(4)
     {
         thumbnailSize       = 256;
         seekPercentage      = 10;
@@ -85,11 +107,12 @@ public:
         workAroundIssues    = true;
         maintainAspectRatio = true;
         smartFrameSelection = false;
+        keyFramesOnly       = false;
     }
 
-    void generateHistogram(const VideoFrame& videoFrame, Histogram<int>& histogram);
-    int  getBestThumbnailIndex(std::vector<VideoFrame>& videoFrames,
-                               const std::vector<Histogram<int> >& histograms);
+    static void decodeSmartFrames(const SmartFrameTask& task);
+    static void generateHistogram(const VideoFrame& videoFrame, Histogram<int>& histogram);
+    static int  getBestThumbnailIndex(const std::vector<Histogram<int> >& histograms);
 
 public:
 
@@ -99,10 +122,12 @@ public:
     bool                      workAroundIssues;
     bool                      maintainAspectRatio;
     bool                      smartFrameSelection;
+    bool                      keyFramesOnly;
     QString                   seekTime;
     QVector<VideoStripFilter*> filters;
 
     const int                 SMART_FRAME_ATTEMPTS;
+    const int                 MAX_DECODING_THREADS;
 };
 
 VideoThumbnailer::VideoThumbnailer()
@@ -158,6 +183,11 @@ void VideoThumbnailer::setSmartFrameSelection(bool enabled)
     d->smartFrameSelection = enabled;
 }
 
+void VideoThumbnailer::setKeyFramesOnly(bool enabled)
+{
+    d->keyFramesOnly = enabled;
+}
+
 int VideoThumbnailer::timeToSeconds(const QString& time) const
 {
     return QTime::fromString(time, QLatin1String("hh:mm:ss")).secsTo(QTime(0, 0, 0));
@@ -167,21 +197,25 @@ void VideoThumbnailer::generateThumbnail(const QString& videoFile,
                                          VideoThumbWriter& imageWriter,
                                          QImage &image)
 {
-    VideoDecoder movieDecoder(videoFile);
+    VideoDecoder movieDecoder(videoFile, d->thumbnailSize);
 
     if (movieDecoder.getInitialized())
     {
+        movieDecoder.setKeyFramesOnly(d->keyFramesOnly);
+
         // before seeking, a frame has to be decoded
         if (!movieDecoder.decodeVideoFrame())
         {
             return;
         }
 
+        int secondToSeekTo = -1;
+
         if ((!d->workAroundIssues) || (movieDecoder.getCodec() != QLatin1String("h264")))
         {
             // workaround for bug in older ffmpeg (100% cpu usage when seeking in h264 files)
-            int secondToSeekTo = d->seekTime.isEmpty() ? movieDecoder.getDuration() * d->seekPercentage / 100
-                                                       : timeToSeconds(d->seekTime);
+            secondToSeekTo = d->seekTime.isEmpty() ? movieDecoder.getDuration() * d->seekPercentage / 100
+                                                   : timeToSeconds(d->seekTime);
             movieDecoder.seek(secondToSeekTo);
         }
 
@@ -189,7 +223,7 @@ void VideoThumbnailer::generateThumbnail(const QString& videoFile,
 
         if (d->smartFrameSelection)
         {
-            generateSmartThumbnail(movieDecoder, videoFrame);
+            generateSmartThumbnail(videoFile, movieDecoder, secondToSeekTo, videoFrame);
         }
         else
         {
@@ -201,20 +235,91 @@ void VideoThumbnailer::generateThumbnail(const QString& videoFile,
     }
 }
 
-void VideoThumbnailer::generateSmartThumbnail(VideoDecoder& movieDecoder,
+void VideoThumbnailer::generateSmartThumbnail(const QString& videoFile,
+                                              VideoDecoder& movieDecoder,
+                                              int secondToSeekTo,
                                               VideoFrame& videoFrame)
 {
     vector<VideoFrame> videoFrames(d->SMART_FRAME_ATTEMPTS);
     vector<Private::Histogram<int> > histograms(d->SMART_FRAME_ATTEMPTS);
 
-    for (int i = 0 ; i < d->SMART_FRAME_ATTEMPTS ; ++i)
+    // The current frame, at the seek position, is the first candidate.
+
+    movieDecoder.getScaledVideoFrame(d->thumbnailSize, d->maintainAspectRatio, videoFrames[0]);
+    Private::generateHistogram(videoFrames[0], histograms[0]);
+
+    int duration = movieDecoder.getDuration();
+
+    if (d->keyFramesOnly && (secondToSeekTo >= 0) && (duration > secondToSeekTo))
+    {
+        // Consecutive key frames are seconds apart, the candidates are spread from the
+        // seek position to the end of the video instead, and each thread seeks to its ones.
+
+        int lastSecond = qMax(secondToSeekTo, duration * 95 / 100);
+        QVector<int> seconds(d->SMART_FRAME_ATTEMPTS);
+
+        for (int i = 0 ; i < d->SMART_FRAME_ATTEMPTS ; ++i)
+        {
+            seconds[i] = secondToSeekTo + (lastSecond - secondToSeekTo) * i / (d->SMART_FRAME_ATTEMPTS - 1);
+        }
+
+        int threads = qBound(1, QThread::idealThreadCount(), d->MAX_DECODING_THREADS);
+        QList<QFuture<void> > tasks;
+
+        for (int t = 0 ; t < threads ; ++t)
+        {
+            Private::SmartFrameTask task;
+            task.videoFile           = videoFile;
+            task.thumbnailSize       = d->thumbnailSize;
+            task.maintainAspectRatio = d->maintainAspectRatio;
+            task.seconds             = &seconds;
+            task.videoFrames         = &videoFrames;
+            task.histograms          = &histograms;
+
+            for (int i = 1 + t ; i < d->SMART_FRAME_ATTEMPTS ; i += threads)
+            {
+                task.indexes << i;
+            }
+
+            tasks << QtConcurrent::run(&Private::decodeSmartFrames, task);
+        }
+
+        foreach (QFuture<void> t, tasks)
+        {
+            t.waitForFinished();
+        }
+    }
+    else
     {
-        movieDecoder.decodeVideoFrame();
-        movieDecoder.getScaledVideoFrame(d->thumbnailSize, d->maintainAspectRatio, videoFrames[i]);
-        d->generateHistogram(videoFrames[i], histograms[i]);
+        for (int i = 1 ; i < d->SMART_FRAME_ATTEMPTS ; ++i)
+        {
+            if (!movieDecoder.decodeVideoFrame())
+            {
+                break;
+            }
+
+            movieDecoder.getScaledVideoFrame(d->thumbnailSize, d->maintainAspectRatio, videoFrames[i]);
+            Private::generateHistogram(videoFrames[i], histograms[i]);
+        }
     }
 
-    int bestFrame = d->getBestThumbnailIndex(videoFrames, histograms);
+    // Drop the candidates which failed to decode, the first one is always there.
+
+    size_t count = 0;
+
+    for (size_t i = 0 ; i < videoFrames.size() ; ++i)
+    {
+        if (videoFrames[i].width && videoFrames[i].height)
+        {
+            videoFrames[count] = videoFrames[i];
+            histograms[count]  = histograms[i];
+            ++count;
+        }
+    }
+
+    histograms.resize(count);
+
+    int bestFrame = Private::getBestThumbnailIndex(histograms);
 
     Q_ASSERT(bestFrame != -1);
 
@@ -263,35 +368,89 @@ void VideoThumbnailer::applyFilters(VideoFrame& videoFrame)
     }
 }
 
+void VideoThumbnailer::Private::decodeSmartFrames(const SmartFrameTask& task)
+{
+    VideoDecoder movieDecoder(task.videoFile, task.thumbnailSize);
+
+    if (!movieDecoder.getInitialized())
+    {
+        return;
+    }
+
+    movieDecoder.setKeyFramesOnly(true);
+
+    // before seeking, a frame has to be decoded
+    if (!movieDecoder.decodeVideoFrame())
+    {
+        return;
+    }
+
+    foreach (int index, task.indexes)
+    {
+        if (!movieDecoder.seek(task.seconds->at(index)))
+        {
+            continue;
+        }
+
+        movieDecoder.getScaledVideoFrame(task.thumbnailSize, task.maintainAspectRatio, (*task.videoFrames)[index]);
+        generateHistogram((*task.videoFrames)[index], (*task.histograms)[index]);
+    }
+}
+
 void VideoThumbnailer::Private::generateHistogram(const VideoFrame& videoFrame,
                                                   Private::Histogram<int>& histogram)
 {
+    // Four pixels are counted at once in four partial histograms: the increments
+    // of neighbour pixels with the same value do not wait for each other.
+
+    int partial[4][3][256];
+    memset(partial, 0, sizeof(partial));
+
     for (quint32 i = 0 ; i < videoFrame.height ; ++i)
     {
-        int pixelIndex = i * videoFrame.lineSize;
+        const quint8* const line = videoFrame.frameData.constData() + i * videoFrame.lineSize;
+        quint32 j                = 0;
+
+        for ( ; j + 4 <= videoFrame.width ; j += 4)
+        {
+            const quint8* const pixels = line + j * 3;
+
+            for (int k = 0 ; k < 4 ; ++k)
+            {
+                ++partial[k][0][pixels[k * 3]];
+                ++partial[k][1][pixels[k * 3 + 1]];
+                ++partial[k][2][pixels[k * 3 + 2]];
+            }
+        }
 
-        for (quint32 j = 0 ; j < videoFrame.width * 3 ; j += 3)
+        for ( ; j < videoFrame.width ; ++j)
         {
-            ++histogram.r[videoFrame.frameData[pixelIndex + j]];
-            ++histogram.g[videoFrame.frameData[pixelIndex + j + 1]];
-            ++histogram.b[videoFrame.frameData[pixelIndex + j + 2]];
+            ++partial[0][0][line[j * 3]];
+            ++partial[0][1][line[j * 3 + 1]];
+            ++partial[0][2][line[j * 3 + 2]];
         }
     }
+
+    for (int j = 0 ; j < 256 ; ++j)
+    {
+        histogram.r[j] += partial[0][0][j] + partial[1][0][j] + partial[2][0][j] + partial[3][0][j];
+        histogram.g[j] += partial[0][1][j] + partial[1][1][j] + partial[2][1][j] + partial[3][1][j];
+        histogram.b[j] += partial[0][2][j] + partial[1][2][j] + partial[2][2][j] + partial[3][2][j];
+    }
 }
 
-int VideoThumbnailer::Private::getBestThumbnailIndex(vector<VideoFrame>& videoFrames,
-                                                     const vector<Private::Histogram<int> >& histograms)
+int VideoThumbnailer::Private::getBestThumbnailIndex(const vector<Private::Histogram<int> >& histograms)
 {
-    Q_UNUSED(videoFrames);
     Private::Histogram<float> avgHistogram;
+    const float scale = 1.0F / histograms.size();
 
     for (size_t i = 0 ; i < histograms.size() ; ++i)
     {
-        for (int j = 0 ; j < 255 ; ++j)
+        for (int j = 0 ; j < 256 ; ++j)
         {
-            avgHistogram.r[j] += static_cast<float>(histograms[i].r[j]) / histograms.size();
-            avgHistogram.g[j] += static_cast<float>(histograms[i].g[j]) / histograms.size();
-            avgHistogram.b[j] += static_cast<float>(histograms[i].b[j]) / histograms.size();
+            avgHistogram.r[j] += static_cast<float>(histograms[i].r[j]) * scale;
+            avgHistogram.g[j] += static_cast<float>(histograms[i].g[j]) * scale;
+            avgHistogram.b[j] += static_cast<float>(histograms[i].b[j]) * scale;
         }
     }
 
@@ -300,18 +459,30 @@ int VideoThumbnailer::Private::getBestThumbnailIndex(vector<VideoFrame>& videoFr
 
     for (size_t i = 0 ; i < histograms.size() ; ++i)
     {
-        // calculate root mean squared error
-        float rmse = 0.0;
+        // calculate root mean squared error.
+        // The errors are summed in eight lanes, which the compiler maps to the vector registers.
+
+        float sums[8] = { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+
+        for (int j = 0 ; j < 256 ; j += 8)
+        {
+            for (int k = 0 ; k < 8 ; ++k)
+            {
+                float error = std::fabs(avgHistogram.r[j + k] - histograms[i].r[j + k]) +
+                              std::fabs(avgHistogram.g[j + k] - histograms[i].g[j + k]) +
+                              std::fabs(avgHistogram.b[j + k] - histograms[i].b[j + k]);
+                sums[k]    += error * error;
+            }
+        }
+
+        float rmse = 0.0F;
 
-        for (int j = 0 ; j < 255 ; ++j)
+        for (int k = 0 ; k < 8 ; ++k)
         {
-            float error = qFabs(avgHistogram.r[j] - histograms[i].r[j]) +
-                          qFabs(avgHistogram.g[j] - histograms[i].g[j]) +
-                          qFabs(avgHistogram.b[j] - histograms[i].b[j]);
-            rmse += (error * error) / 255;
+            rmse += sums[k];
         }
 
-        rmse = qSqrt(rmse);
+        rmse = std::sqrt(rmse / 256);
 
         if (rmse < minRMSE)
         {
@@ -63,6 +63,13 @@ public:
     void setWorkAroundIssues(bool workAround);
     void setMaintainAspectRatio(bool enabled);
     void setSmartFrameSelection(bool enabled);
+
+    /**
+     * Only decode the key frames. With the smart frame selection, the candidate frames
+     * are then taken from the seek position to the end of the video, and decoded in parallel.
+     */
+    void setKeyFramesOnly(bool enabled);
+
     void addFilter(VideoStripFilter* const filter);
     void removeFilter(VideoStripFilter* const filter);
     void clearFilters();
@@ -70,7 +77,8 @@ public:
 private:
 
     void generateThumbnail(const QString& videoFile, VideoThumbWriter& imageWriter, QImage& image);
-    void generateSmartThumbnail(VideoDecoder& movieDecoder, VideoFrame& videoFrame);
+    void generateSmartThumbnail(const QString& videoFile, VideoDecoder& movieDecoder,
+                                int secondToSeekTo, VideoFrame& videoFrame);
 
     void applyFilters(VideoFrame& frameData);
     int  timeToSeconds(const QString& time) const;
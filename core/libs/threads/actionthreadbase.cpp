@@ -27,6 +27,7 @@
 
 // Qt includes
 
+#include <QMultiMap>
 #include <QMutexLocker>
 #include <QWaitCondition>
 #include <QMutex>
@@ -35,6 +36,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "kmemoryinfo.h"
 
 namespace Digikam
 {
@@ -42,7 +44,8 @@ namespace Digikam
 ActionJob::ActionJob()
     : QObject(),
       QRunnable(),
-      m_cancel(false)
+      m_cancel(false),
+      m_memoryEstimate(0)
 {
     setAutoDelete(false);
 }
@@ -57,6 +60,16 @@ void ActionJob::cancel()
     m_cancel = true;
 }
 
+void ActionJob::setMemoryEstimate(qint64 bytes)
+{
+    m_memoryEstimate = qMax(bytes, (qint64)0);
+}
+
+qint64 ActionJob::memoryEstimate() const
+{
+    return m_memoryEstimate;
+}
+
 // -----------------------------------------------------------------
 
 class Q_DECL_HIDDEN ActionThreadBase::Private
@@ -65,12 +78,17 @@ public:
 
     explicit Private()
     {
-        running = false;
-        pool    = nullptr;
+        running      = false;
+        pool         = nullptr;
+        memoryBudget = 0;
+        memoryUsed   = 0;
     }
 
     volatile bool       running;
 
+    qint64              memoryBudget;
+    qint64              memoryUsed;     // Sum of the estimates of the pending jobs.
+
     QWaitCondition      condVarJobs;
     QMutex              mutex;
 
@@ -136,6 +154,29 @@ void ActionThreadBase::defaultMaximumNumberOfThreads()
     setMaximumNumberOfThreads(maximumNumberOfThreads);
 }
 
+void ActionThreadBase::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->memoryBudget = qMax(bytes, (qint64)0);
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Using a memory budget of" << d->memoryBudget / (1024 * 1024) << "MB to run threads";
+
+    d->condVarJobs.wakeAll();
+}
+
+qint64 ActionThreadBase::memoryBudget() const
+{
+    return d->memoryBudget;
+}
+
+void ActionThreadBase::defaultMemoryBudget(int percent)
+{
+    KMemoryInfo memory = KMemoryInfo::currentInfo();
+    qint64 available   = (memory.isValid() == 1) ? memory.bytes(KMemoryInfo::AvailableRam) : -1;
+
+    setMemoryBudget((available > 0) ? available / 100 * qBound(1, percent, 100) : 0);
+}
+
 void ActionThreadBase::slotJobFinished()
 {
     ActionJob* const job = dynamic_cast<ActionJob*>(sender());
@@ -150,7 +191,11 @@ void ActionThreadBase::slotJobFinished()
     QMutexLocker lock(&d->mutex);
 
     d->processed.insert(job, 0);
-    d->pending.remove(job);
+
+    if (d->pending.remove(job))
+    {
+        d->memoryUsed -= job->memoryEstimate();
+    }
 
     if (isEmpty())
     {
@@ -165,6 +210,13 @@ void ActionThreadBase::cancel()
     qCDebug(DIGIKAM_GENERAL_LOG) << "Cancel Main Thread";
     QMutexLocker lock(&d->mutex);
 
+    // The jobs not started are deleted with the processed ones.
+
+    foreach (ActionJob* const job, d->todo.keys())
+    {
+        d->processed.insert(job, 0);
+    }
+
     d->todo.clear();
 
     foreach (ActionJob* const job, d->pending.keys())
@@ -174,19 +226,20 @@ void ActionThreadBase::cancel()
     }
 
     d->pending.clear();
-    d->running = false;
+    d->memoryUsed = 0;
+    d->running    = false;
 
     d->condVarJobs.wakeAll();
 }
 
 bool ActionThreadBase::isEmpty() const
 {
-    return d->pending.isEmpty();
+    return (d->pending.isEmpty() && d->todo.isEmpty());
 }
 
 int ActionThreadBase::pendingCount() const
 {
-    return d->pending.count();
+    return (d->pending.count() + d->todo.count());
 }
 
 void ActionThreadBase::appendJobs(const ActionJobCollection& jobs)
@@ -209,29 +262,76 @@ void ActionThreadBase::run()
     {
         QMutexLocker lock(&d->mutex);
 
-        if (!d->todo.isEmpty())
+        // Wait for a job to finish or for new jobs if none can be started.
+
+        if (startJobs() == 0)
         {
-            qCDebug(DIGIKAM_GENERAL_LOG) << "Action Thread run " << d->todo.count() << " new jobs";
+            d->condVarJobs.wait(&d->mutex);
+        }
+    }
+}
 
-            for (ActionJobCollection::iterator it = d->todo.begin() ; it != d->todo.end() ; ++it)
-            {
-                ActionJob* const job = it.key();
-                int priority         = it.value();
+int ActionThreadBase::startJobs()
+{
+    if (d->todo.isEmpty())
+    {
+        return 0;
+    }
 
-                connect(job, SIGNAL(signalDone()),
-                        this, SLOT(slotJobFinished()));
+    // Jobs with the higher priority value first, as in QThreadPool.
 
-                d->pool->start(job, priority);
-                d->pending.insert(job, priority);
-            }
+    QMultiMap<int, ActionJob*> queue;
+
+    for (ActionJobCollection::const_iterator it = d->todo.constBegin() ; it != d->todo.constEnd() ; ++it)
+    {
+        queue.insert(-it.value(), it.key());
+    }
+
+    // When a job does not fit in the memory left, the memory it needs is reserved:
+    // the smaller jobs started meanwhile on the free cores must leave room for it.
+
+    qint64 reserved = 0;
+    int    started  = 0;
 
-            d->todo.clear();
+    for (QMultiMap<int, ActionJob*>::const_iterator it = queue.constBegin() ; it != queue.constEnd() ; ++it)
+    {
+        if (d->pending.count() >= d->pool->maxThreadCount())
+        {
+            break;
         }
-        else
+
+        ActionJob* const job = it.value();
+        int priority         = -it.key();
+        qint64 memory        = job->memoryEstimate();
+
+        if ((d->memoryBudget > 0) && (memory > 0) && !d->pending.isEmpty() &&
+            (d->memoryUsed + reserved + memory > d->memoryBudget))
         {
-            d->condVarJobs.wait(&d->mutex);
+            if (reserved == 0)
+            {
+                reserved = qMin(memory, d->memoryBudget);
+            }
+
+            continue;
         }
+
+        connect(job, SIGNAL(signalDone()),
+                this, SLOT(slotJobFinished()));
+
+        d->pool->start(job, priority);
+        d->pending.insert(job, priority);
+        d->todo.remove(job);
+        d->memoryUsed += memory;
+        ++started;
     }
+
+    if (started)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Action Thread run" << started << "new jobs," << d->todo.count()
+                                     << "waiting, memory used" << d->memoryUsed / (1024 * 1024) << "MB";
+    }
+
+    return started;
 }
 
 } // namespace Digikam
@@ -54,6 +54,12 @@ public:
      */
     virtual ~ActionJob();
 
+    /** Set the memory in bytes expected to be used by this job. ActionThreadBase only runs
+     *  the jobs fitting in its memory budget. Zero, the default, means a small job always run.
+     */
+    void   setMemoryEstimate(qint64 bytes);
+    qint64 memoryEstimate() const;
+
 Q_SIGNALS:
 
     /** Use this signal in your implementation to inform ActionThreadBase manager that job is started
@@ -78,7 +84,11 @@ protected:
 
     /** You can use this boolean in your implementation to know if job must be canceled.
      */
-    bool m_cancel;
+    bool   m_cancel;
+
+private:
+
+    qint64 m_memoryEstimate;
 };
 
 /** Define a map of job/priority to process by ActionThreadBase manager.
@@ -111,6 +121,19 @@ public:
      */
     void defaultMaximumNumberOfThreads();
 
+    /** Adjust the memory in bytes available to the jobs running at the same time.
+     *  A job is started only if its memoryEstimate() fits in the budget with the running jobs,
+     *  or if no other job is running. Zero means no limit, which is the default.
+     */
+    void   setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+    /** Reset the memory budget to percent of the RAM currently available on the computer,
+     *  three quarters by default, or no limit if this one cannot be read.
+     *  Reads the memory information of the system: call it when the jobs need a budget.
+     */
+    void   defaultMemoryBudget(int percent = 75);
+
     /** Cancel processing of current jobs under progress.
      */
     void cancel();
@@ -126,14 +149,21 @@ protected:
      */
     void appendJobs(const ActionJobCollection& jobs);
 
-    /** Return true if list of pending jobs to process is empty.
+    /** Return true if list of pending jobs to process is empty, including the jobs not started yet.
      */
     bool isEmpty() const;
 
-    /** Return the number of pending jobs to process.
+    /** Return the number of pending jobs to process, including the jobs not started yet.
      */
     int pendingCount() const;
 
+private:
+
+    /** Start the jobs to do, in order of priority, while they fit in the number of threads
+     *  and the memory budget. Must be called with the mutex locked. Returns the number of jobs started.
+     */
+    int startJobs();
+
 protected Q_SLOTS:
 
     void slotJobFinished();
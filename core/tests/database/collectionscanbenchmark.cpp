@@ -0,0 +1,173 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-29
+ * Description : CLI benchmark for the complete and incremental collection scans
+ *
+ * Copyright (C) 2019 by Gilles Caulier, <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUrl>
+#include <QDebug>
+
+// Local includes
+
+#include "collectionlocation.h"
+#include "collectionmanager.h"
+#include "collectionscanner.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "dbengineparameters.h"
+
+using namespace Digikam;
+
+/** Create albums with empty files. Scanning them takes the same database work as real files,
+ *  only the metadata reading is short.
+ */
+static void createCollection(const QString& path, int albums, int files)
+{
+    QDir root(path);
+
+    for (int a = 0 ; a < albums ; ++a)
+    {
+        QString album = QString::fromLatin1("album%1").arg(a, 5, 10, QLatin1Char('0'));
+        root.mkdir(album);
+
+        for (int f = 0 ; f < files ; ++f)
+        {
+            QFile file(path + QLatin1Char('/') + album +
+                       QString::fromLatin1("/img%1.jpg").arg(f, 5, 10, QLatin1Char('0')));
+            file.open(QIODevice::WriteOnly);
+        }
+    }
+}
+
+static qint64 timeCompleteScan(bool incremental)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    CollectionScanner scanner;
+    scanner.setPipelinedScanning(true);
+    scanner.setIncrementalScan(incremental);
+    scanner.completeScan();
+
+    return timer.elapsed();
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // Do not touch the album fingerprints of the user
+    QStandardPaths::setTestModeEnabled(true);
+
+    int     albums = 2000;
+    int     files  = 250;
+    QString collectionPath;
+    QTemporaryDir tempDir;
+
+    if (argc == 2)
+    {
+        collectionPath = QString::fromLocal8Bit(argv[1]);
+    }
+    else
+    {
+        if (argc == 3)
+        {
+            albums = qMax(1, QString::fromLatin1(argv[1]).toInt());
+            files  = qMax(1, QString::fromLatin1(argv[2]).toInt());
+        }
+        else
+        {
+            qDebug() << "collectionscanbenchmark - measure complete and incremental scans of an unchanged collection";
+            qDebug() << "Usage: <number of albums> <files per album> (default 2000 x 250)";
+            qDebug() << "       <path to an existing collection>";
+        }
+
+        collectionPath = tempDir.path() + QLatin1String("/collection");
+        QDir().mkpath(collectionPath);
+
+        QElapsedTimer timer;
+        timer.start();
+        createCollection(collectionPath, albums, files);
+
+        qDebug() << "Created" << albums * files << "files in" << timer.elapsed() << "ms";
+
+        // Directories modified in the last seconds are always scanned
+        QThread::sleep(2);
+    }
+
+    DbEngineParameters params;
+    params.databaseType = DbEngineParameters::SQLiteDatabaseType();
+    params.setCoreDatabasePath(tempDir.path() + QLatin1String("/digikam-core-benchmark.db"));
+    params.setThumbsDatabasePath(tempDir.path() + QLatin1String("/digikam-thumbs-benchmark.db"));
+    params.setFaceDatabasePath(tempDir.path() + QLatin1String("/digikam-faces-benchmark.db"));
+    params.legacyAndDefaultChecks();
+
+    CoreDbAccess::setParameters(params, CoreDbAccess::MainApplication);
+
+    if (!CoreDbAccess::checkReadyForUse(nullptr))
+    {
+        qWarning() << "Cannot initialize the database";
+        return 1;
+    }
+
+    CollectionLocation location = CollectionManager::instance()->addLocation(QUrl::fromLocalFile(collectionPath));
+
+    if (location.isNull())
+    {
+        qWarning() << "Cannot add the collection" << collectionPath;
+        return 1;
+    }
+
+    qDebug() << "Initial scan:     " << timeCompleteScan(false) << "ms";
+    qDebug() << "Complete scan:    " << timeCompleteScan(false) << "ms";
+    qDebug() << "Incremental scan: " << timeCompleteScan(true)  << "ms";
+
+    if (argc != 2)
+    {
+        // A new file in one album must be found by the next incremental scan
+
+        QFile file(collectionPath + QLatin1String("/album00000/new.jpg"));
+        file.open(QIODevice::WriteOnly);
+        file.close();
+        QThread::sleep(2);
+
+        qDebug() << "Incremental scan, one album changed:" << timeCompleteScan(true) << "ms";
+
+        CoreDbAccess access;
+        int albumId = access.db()->getAlbumForPath(location.id(), QLatin1String("/album00000"), false);
+
+        if (!access.db()->getItemNamesInAlbum(albumId).contains(QLatin1String("new.jpg")))
+        {
+            qWarning() << "The incremental scan did not find the new file";
+            return 1;
+        }
+    }
+
+    return 0;
+}
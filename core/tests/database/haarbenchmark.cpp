@@ -0,0 +1,144 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-22
+ * Description : CLI micro-benchmark for the Haar signature calculation
+ *
+ * Copyright (C) 2019 by Gilles Caulier, <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QList>
+#include <QDebug>
+
+// Local includes
+
+#include "haar.h"
+#include "haarkernels.h"
+
+using namespace Digikam;
+
+/** Build synthetic test images: smooth gradients plus some noise,
+ *  so the coefficients selection does not degenerate.
+ */
+static QList<QImage> createImages(int count)
+{
+    QList<QImage> images;
+    qsrand(12345);
+
+    for (int n = 0 ; n < count ; ++n)
+    {
+        QImage image(640, 480, QImage::Format_RGB32);
+
+        for (int y = 0 ; y < image.height() ; ++y)
+        {
+            QRgb* const line = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+            for (int x = 0 ; x < image.width() ; ++x)
+            {
+                line[x] = qRgb((x + n * 7)  % 256,
+                               (y + n * 13) % 256,
+                               ((x ^ y) + (qrand() % 32)) % 256);
+            }
+        }
+
+        images << image;
+    }
+
+    return images;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    int count = 200;
+
+    if (argc == 2)
+    {
+        count = qMax(1, QString::fromLatin1(argv[1]).toInt());
+    }
+    else
+    {
+        qDebug() << "haarbenchmark - measure Haar signatures per second";
+        qDebug() << "Usage: <number of images> (default 200)";
+    }
+
+    QList<QImage> images = createImages(count);
+    Haar::ImageData* const data = new Haar::ImageData;
+    Haar::Calculator haar;
+
+    // Reference signatures computed with the portable kernels.
+    QList<Haar::SignatureData> references;
+
+    qDebug() << "Best instruction set:"
+             << Haar::Kernels::instructionSetName(Haar::Kernels::bestInstructionSet());
+
+    for (int set = Haar::Kernels::Scalar ; set <= Haar::Kernels::bestInstructionSet() ; ++set)
+    {
+        Haar::Kernels::setInstructionSet((Haar::Kernels::InstructionSet)set);
+
+        QElapsedTimer timer;
+        qint64        transformTime = 0;
+        int           mismatches    = 0;
+
+        timer.start();
+
+        for (int n = 0 ; n < images.count() ; ++n)
+        {
+            data->fillPixelData(images.at(n));
+
+            QElapsedTimer transformTimer;
+            transformTimer.start();
+
+            Haar::SignatureData sig;
+            haar.transform(data);
+            haar.calcHaar(data, &sig);
+
+            transformTime += transformTimer.nsecsElapsed();
+
+            if (set == Haar::Kernels::Scalar)
+            {
+                references << sig;
+            }
+            else if (memcmp(&sig, &references.at(n), sizeof(Haar::SignatureData)) != 0)
+            {
+                ++mismatches;
+            }
+        }
+
+        double total     = timer.nsecsElapsed() / 1.0E9;
+        double transform = transformTime / 1.0E9;
+
+        qDebug().nospace() << Haar::Kernels::instructionSetName(Haar::Kernels::instructionSet()) << ": "
+                           << count / total     << " signatures/s (with scaling), "
+                           << count / transform << " signatures/s (transform only), "
+                           << mismatches        << " signatures differ from scalar";
+    }
+
+    delete data;
+
+    return 0;
+}
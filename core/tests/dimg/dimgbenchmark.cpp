@@ -0,0 +1,90 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : helpers shared by the DImg CLI benchmarks
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgbenchmark.h"
+
+// C++ includes
+
+#include <cstdlib>
+
+// Qt includes
+
+#include <QFileInfo>
+#include <QDebug>
+
+namespace Digikam
+{
+
+namespace DImgBenchmark
+{
+
+DImg createImage(uint width, uint height, bool sixteenBit)
+{
+    DImg img(width, height, sixteenBit);
+    qsrand(1234);
+
+    if (sixteenBit)
+    {
+        unsigned short* data = reinterpret_cast<unsigned short*>(img.bits());
+
+        for (uint i = 0 ; i < width * height * 4 ; ++i)
+        {
+            data[i] = qrand() % 65536;
+        }
+    }
+    else
+    {
+        uchar* data = img.bits();
+
+        for (uint i = 0 ; i < width * height * 4 ; ++i)
+        {
+            data[i] = qrand() % 256;
+        }
+    }
+
+    return img;
+}
+
+bool imageSize(int argc, char** argv, const char* const description, uint* const width, uint* const height)
+{
+    *width  = 6000;
+    *height = 4000;
+
+    if (argc == 3)
+    {
+        *width  = qMax(1, atoi(argv[1]));
+        *height = qMax(1, atoi(argv[2]));
+
+        return true;
+    }
+
+    qDebug().noquote() << QFileInfo(QString::fromLocal8Bit(argv[0])).fileName()
+                       << "-" << QLatin1String(description);
+    qDebug() << "Usage: <width> <height> (default 6000 x 4000)";
+
+    return false;
+}
+
+} // namespace DImgBenchmark
+
+} // namespace Digikam
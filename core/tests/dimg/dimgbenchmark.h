@@ -0,0 +1,51 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : helpers shared by the DImg CLI benchmarks
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_BENCHMARK_H
+#define DIGIKAM_DIMG_BENCHMARK_H
+
+// Local includes
+
+#include "dimg.h"
+
+namespace Digikam
+{
+
+namespace DImgBenchmark
+{
+
+/** An image of random pixels, the same at each run.
+ */
+DImg createImage(uint width, uint height, bool sixteenBit);
+
+/** Read the image size from the command line "<width> <height>", 6000 x 4000 by default.
+ *  Without arguments, prints the name and the description of the benchmark, and its usage.
+ *  Returns true if the size was given on the command line.
+ */
+bool imageSize(int argc, char** argv, const char* const description, uint* const width, uint* const height);
+
+} // namespace DImgBenchmark
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_BENCHMARK_H
@@ -0,0 +1,124 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : an unit-test to check the histogram cached on DImg
+ *               after the filters working in place
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimghistogramcachetest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "digikam_globals.h"
+#include "imagehistogram.h"
+#include "autolevelsfilter.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgHistogramCacheTest)
+
+/** A low contrast gradient, which auto-levels stretches to the full range.
+ */
+static DImg createImage(bool sixteenBit)
+{
+    const uint width  = 256;
+    const uint height = 64;
+    DImg img(width, height, sixteenBit);
+
+    for (uint y = 0 ; y < height ; ++y)
+    {
+        for (uint x = 0 ; x < width ; ++x)
+        {
+            int value = 64 + x / 2;
+
+            if (sixteenBit)
+            {
+                unsigned short* const p = reinterpret_cast<unsigned short*>(img.scanLine(y)) + x * 4;
+                p[0] = p[1] = p[2] = value * 257;
+                p[3] = 65535;
+            }
+            else
+            {
+                uchar* const p = img.scanLine(y) + x * 4;
+                p[0] = p[1] = p[2] = value;
+                p[3] = 255;
+            }
+        }
+    }
+
+    return img;
+}
+
+void DImgHistogramCacheTest::testAutoLevels_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgHistogramCacheTest::testAutoLevels()
+{
+    QFETCH(bool, sixteenBit);
+
+    DImg img = createImage(sixteenBit);
+
+    // Cache the histogram of the original data.
+
+    ImageHistogram before(img);
+    before.calculate();
+    QVERIFY(!img.cachedHistogram(true).isEmpty());
+
+    AutoLevelsFilter filter(&img, &img);
+    filter.startFilterDirectly();
+    DImg result = filter.getTargetImage();
+
+    // The histogram of the result must be the one of its pixels,
+    // as computed on a copy which has no cached histogram.
+
+    ImageHistogram after(result);
+    after.calculate();
+
+    DImg copy = result.copy();
+    QVERIFY(copy.cachedHistogram(false).isEmpty());
+
+    ImageHistogram reference(copy);
+    reference.calculate();
+
+    const int segments = reference.getHistogramSegments();
+
+    for (int channel = LuminosityChannel ; channel <= BlueChannel ; ++channel)
+    {
+        for (int bin = 0 ; bin < segments ; ++bin)
+        {
+            QCOMPARE(after.getValue(channel, bin), reference.getValue(channel, bin));
+        }
+    }
+
+    // Auto-levels stretched the values: the histogram changed.
+
+    QVERIFY(after.getValue(LuminosityChannel, 0) != before.getValue(LuminosityChannel, 0) ||
+            after.getValue(LuminosityChannel, segments - 1) != before.getValue(LuminosityChannel, segments - 1));
+}
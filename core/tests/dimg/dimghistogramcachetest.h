@@ -0,0 +1,42 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : an unit-test to check the histogram cached on DImg
+ *               after the filters working in place
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_HISTOGRAM_CACHE_TEST_H
+#define DIGIKAM_DIMG_HISTOGRAM_CACHE_TEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgHistogramCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testAutoLevels();
+    void testAutoLevels_data();
+};
+
+#endif // DIGIKAM_DIMG_HISTOGRAM_CACHE_TEST_H
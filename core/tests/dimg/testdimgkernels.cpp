@@ -0,0 +1,174 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : CLI benchmark of the DImg look-up table and
+ *               pixel format kernels
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <vector>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Local includes
+
+#include "dimgbenchmark.h"
+#include "dimgkernels.h"
+
+using namespace Digikam;
+
+/** The results of all kernels for one instruction set.
+ */
+struct Results
+{
+    std::vector<uchar>  lut8;
+    std::vector<ushort> lut16;
+    std::vector<uchar>  depth8;
+    std::vector<ushort> depth16;
+    std::vector<uchar>  rgb;
+    std::vector<uchar>  blend8;
+    std::vector<ushort> blend16;
+};
+
+static void report(const char* const name, qint64 nsecs, uint pixels, bool identical)
+{
+    qDebug().noquote() << QString::fromLatin1("    %1 %2 Mpixels/s %3")
+                          .arg(QLatin1String(name), -14)
+                          .arg(pixels / (nsecs / 1000.0), 8, 'f', 1)
+                          .arg(identical ? QLatin1String("") : QLatin1String("RESULTS DIFFER"));
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    uint width, height;
+    DImgBenchmark::imageSize(argc, argv, "benchmark the DImg kernels for each instruction set", &width, &height);
+
+    const uint pixels = width * height;
+    const DImg img8   = DImgBenchmark::createImage(width, height, false);
+    const DImg img16  = DImgBenchmark::createImage(width, height, true);
+    std::vector<uchar>  src8(img8.bits(), img8.bits() + pixels * 4);
+    std::vector<ushort> src16(reinterpret_cast<const ushort*>(img16.bits()),
+                              reinterpret_cast<const ushort*>(img16.bits()) + pixels * 4);
+    std::vector<int>    lut8(256);
+    std::vector<int>    lut16(65536);
+
+    // Values out of range, to check the clamping.
+
+    for (int i = 0 ; i < 256 ; ++i)
+    {
+        lut8[i] = (i * 5) / 4 - 20;
+    }
+
+    for (int i = 0 ; i < 65536 ; ++i)
+    {
+        lut16[i] = (i * 5) / 4 - 5000;
+    }
+
+    const int* const luts8[4]  = { lut8.data(),  lut8.data(),  lut8.data(),  nullptr };
+    const int* const luts16[4] = { lut16.data(), lut16.data(), lut16.data(), nullptr };
+    const uchar      color8[4]  = { 255, 0, 128, 255 };
+    const ushort     color16[4] = { 65535, 0, 32768, 65535 };
+
+    Results reference;
+    bool    success = true;
+
+    qDebug() << "Best instruction set:"
+             << DImgKernels::instructionSetName(DImgKernels::bestInstructionSet());
+
+    for (int set = DImgKernels::Scalar ; set <= DImgKernels::bestInstructionSet() ; ++set)
+    {
+        DImgKernels::setInstructionSet((DImgKernels::InstructionSet)set);
+
+        Results       results;
+        QElapsedTimer timer;
+
+        results.lut8.resize(pixels * 4);
+        results.lut16.resize(pixels * 4);
+        results.depth8.resize(pixels * 4);
+        results.depth16.resize(pixels * 4);
+        results.rgb.resize(pixels * 3);
+        results.blend8  = src8;
+        results.blend16 = src16;
+
+        qDebug() << DImgKernels::instructionSetName(DImgKernels::instructionSet());
+
+        timer.start();
+        DImgKernels::applyLut8(src8.data(), results.lut8.data(), pixels, luts8);
+        qint64 lut8Time    = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::applyLut16(src16.data(), results.lut16.data(), pixels, luts16);
+        qint64 lut16Time   = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::convert16To8(src16.data(), results.depth8.data(), pixels * 4);
+        qint64 depth8Time  = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::convert8To16(src8.data(), results.depth16.data(), pixels * 4);
+        qint64 depth16Time = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::bgraToRgb(src8.data(), results.rgb.data(), pixels);
+        qint64 rgbTime     = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::blendOnColor8(results.blend8.data(), pixels, color8);
+        qint64 blend8Time  = timer.nsecsElapsed();
+
+        timer.restart();
+        DImgKernels::blendOnColor16(results.blend16.data(), pixels, color16);
+        qint64 blend16Time = timer.nsecsElapsed();
+
+        if (set == DImgKernels::Scalar)
+        {
+            reference = results;
+        }
+
+        bool lut8Ok    = (results.lut8    == reference.lut8);
+        bool lut16Ok   = (results.lut16   == reference.lut16);
+        bool depth8Ok  = (results.depth8  == reference.depth8);
+        bool depth16Ok = (results.depth16 == reference.depth16);
+        bool rgbOk     = (results.rgb     == reference.rgb);
+        bool blend8Ok  = (results.blend8  == reference.blend8);
+        bool blend16Ok = (results.blend16 == reference.blend16);
+
+        report("LUT 8 bits",  lut8Time,    pixels, lut8Ok);
+        report("LUT 16 bits", lut16Time,   pixels, lut16Ok);
+        report("16 to 8 bits", depth8Time,  pixels, depth8Ok);
+        report("8 to 16 bits", depth16Time, pixels, depth16Ok);
+        report("BGRA to RGB", rgbTime,     pixels, rgbOk);
+        report("Blend 8 bits", blend8Time,  pixels, blend8Ok);
+        report("Blend 16 bits", blend16Time, pixels, blend16Ok);
+
+        success &= lut8Ok && lut16Ok && depth8Ok && depth16Ok && rgbOk && blend8Ok && blend16Ok;
+    }
+
+    DImgKernels::setInstructionSet(DImgKernels::bestInstructionSet());
+
+    return (success ? 0 : 1);
+}
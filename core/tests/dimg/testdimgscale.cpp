@@ -0,0 +1,197 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : CLI benchmark of the DImg resampler against
+ *               the former Imlib2 scaler
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QDebug>
+
+// Local includes
+
+#include "dimg.h"
+#include "dimgbenchmark.h"
+#include "dimgresampler.h"
+
+using namespace Digikam;
+
+/** Smooth waves, where the images scaled by the resampler and by the Imlib2 scaler
+ *  only differ by their rounding and their alignment of the pixels.
+ */
+static DImg createSmoothImage(uint width, uint height, bool sixteenBit)
+{
+    DImg img(width, height, sixteenBit);
+
+    for (uint y = 0 ; y < height ; ++y)
+    {
+        for (uint x = 0 ; x < width ; ++x)
+        {
+            for (int c = 0 ; c < 4 ; ++c)
+            {
+                double value = 128.0 + 100.0 * sin((x + 50 * c) / 97.0) * cos((y + 30 * c) / 131.0);
+
+                if (sixteenBit)
+                {
+                    reinterpret_cast<unsigned short*>(img.scanLine(y))[x * 4 + c] = lround(value * 257.0);
+                }
+                else
+                {
+                    img.scanLine(y)[x * 4 + c] = lround(value);
+                }
+            }
+        }
+    }
+
+    return img;
+}
+
+/** The mean and maximum differences of the channel values of two images of the same size, in 8 bits levels.
+ */
+static void difference(const DImg& a, const DImg& b, double* const mean, double* const maximum)
+{
+    const uint   count = a.width() * a.height() * 4;
+    const double scale = a.sixteenBit() ? 1.0 / 257.0 : 1.0;
+    double total       = 0.0;
+    *maximum           = 0.0;
+
+    for (uint i = 0 ; i < count ; ++i)
+    {
+        int va = a.sixteenBit() ? reinterpret_cast<const unsigned short*>(a.bits())[i] : a.bits()[i];
+        int vb = b.sixteenBit() ? reinterpret_cast<const unsigned short*>(b.bits())[i] : b.bits()[i];
+        double diff = abs(va - vb) * scale;
+        total      += diff;
+        *maximum    = qMax(*maximum, diff);
+    }
+
+    *mean = total / count;
+}
+
+/** Time smoothScale() to size with the Imlib2 scaler, and with the resampler in one and all threads.
+ *  Check that the results in one and all threads are identical, and that the result on smooth
+ *  is close to the one of the Imlib2 scaler. Returns false if a check fails.
+ */
+static bool benchmarkSmoothScale(const DImg& img, const DImg& smooth, const QSize& size, int threads)
+{
+    QSize scaleSize = img.size();
+    scaleSize.scale(size, Qt::KeepAspectRatio);
+
+    QElapsedTimer timer;
+    timer.start();
+    DImgResampler::legacyScale(img, scaleSize);
+    qint64 legacyTime   = timer.elapsed();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    timer.restart();
+    DImg serial         = img.smoothScale(scaleSize);
+    qint64 serialTime   = timer.elapsed();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+    timer.restart();
+    DImg parallel       = img.smoothScale(scaleSize);
+    qint64 parallelTime = timer.elapsed();
+
+    bool identical      = (serial.numBytes() == parallel.numBytes()) &&
+                          (memcmp(serial.bits(), parallel.bits(), serial.numBytes()) == 0);
+
+    double mean, maximum;
+    difference(smooth.smoothScale(scaleSize), DImgResampler::legacyScale(smooth, scaleSize), &mean, &maximum);
+
+    // The rounding of the Imlib2 fixed point code and its half pixel shift
+    // when enlarging stay under one level on average.
+
+    bool close          = (mean <= 1.0);
+
+    qDebug().noquote() << QString::fromLatin1("    %1 legacy %2 ms, 1 thread %3 ms, all threads %4 ms, speed-up x%5, "
+                                              "difference to legacy: mean %6 max %7 %8 %9")
+                          .arg(QString::fromLatin1("smoothScale %1x%2").arg(scaleSize.width()).arg(scaleSize.height()), -22)
+                          .arg(legacyTime, 6)
+                          .arg(serialTime, 6)
+                          .arg(parallelTime, 6)
+                          .arg((double)legacyTime / qMax(parallelTime, (qint64)1), 0, 'f', 2)
+                          .arg(mean, 0, 'f', 2)
+                          .arg(maximum, 0, 'f', 1)
+                          .arg(identical ? QLatin1String("") : QLatin1String("THREADED RESULTS DIFFER"))
+                          .arg(close     ? QLatin1String("") : QLatin1String("TOO FAR FROM LEGACY"));
+
+    return (identical && close);
+}
+
+static void benchmarkKernel(const DImg& img, const QSize& size, DImgResampler::Kernel kernel,
+                            const char* const name)
+{
+    QElapsedTimer timer;
+    timer.start();
+    DImgResampler::scale(img, size, kernel, Qt::KeepAspectRatio);
+
+    qDebug().noquote() << QString::fromLatin1("    %1 %2x%3 %4 ms")
+                          .arg(QLatin1String(name), -8)
+                          .arg(size.width())
+                          .arg(size.height())
+                          .arg(timer.elapsed(), 6);
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    uint width, height;
+
+    if (!DImgBenchmark::imageSize(argc, argv, "benchmark and check the DImg resampler against the former Imlib2 scaler",
+                                  &width, &height))
+    {
+        qDebug() << "Try sizes up to 12000 x 8000";
+    }
+
+    const int   threads  = QThreadPool::globalInstance()->maxThreadCount();
+    bool        success  = true;
+    const QSize sizes[3] = { QSize(256, 256), QSize(1920, 1080), QSize(width * 2, height * 2) };
+
+    for (int depth = 0 ; depth < 2 ; ++depth)
+    {
+        DImg img    = DImgBenchmark::createImage(width, height, (depth == 1));
+        DImg smooth = createSmoothImage(width, height, (depth == 1));
+
+        qDebug() << width << "x" << height << (img.sixteenBit() ? 16 : 8) << "bits," << threads << "threads";
+
+        // The enlargement is limited to the images up to 24 Mpixels.
+
+        for (int i = 0 ; i < ((width * height <= 24000000) ? 3 : 2) ; ++i)
+        {
+            success &= benchmarkSmoothScale(img, smooth, sizes[i], threads);
+        }
+
+        benchmarkKernel(img, sizes[1], DImgResampler::Box,      "Box");
+        benchmarkKernel(img, sizes[1], DImgResampler::Bilinear, "Bilinear");
+        benchmarkKernel(img, sizes[1], DImgResampler::Lanczos3, "Lanczos3");
+    }
+
+    return (success ? 0 : 1);
+}
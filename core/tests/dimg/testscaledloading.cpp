@@ -0,0 +1,110 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : CLI benchmark of the decoding of images
+ *               at full and reduced size
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDebug>
+
+// Local includes
+
+#include "dimg.h"
+
+using namespace Digikam;
+
+/** Load the file with the given scaled loading size, 0 for the full size.
+ *  Returns the time in ms, or -1 if the file cannot be loaded.
+ */
+static qint64 timeLoading(const QString& filePath, int size, QSize* const loadedSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    DImg img;
+    img.setScaledLoadingSize(size);
+
+    if (!img.load(filePath, false, false, false, false))
+    {
+        return -1;
+    }
+
+    qint64 elapsed = timer.elapsed();
+    *loadedSize    = img.size();
+
+    return elapsed;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc < 3)
+    {
+        qDebug() << "testscaledloading - compare the decoding of images at full and reduced size";
+        qDebug() << "Usage: <size> <image files>";
+        return -1;
+    }
+
+    int    size      = qMax(1, QString::fromLatin1(argv[1]).toInt());
+    qint64 fullTotal = 0;
+    qint64 fastTotal = 0;
+
+    for (int i = 2 ; i < argc ; ++i)
+    {
+        QString filePath = QString::fromLocal8Bit(argv[i]);
+        QSize   fullSize, fastSize;
+
+        qint64 fullTime  = timeLoading(filePath, 0,    &fullSize);
+        qint64 fastTime  = timeLoading(filePath, size, &fastSize);
+
+        if (fullTime < 0 || fastTime < 0)
+        {
+            qWarning() << "Cannot load" << filePath;
+            continue;
+        }
+
+        fullTotal       += fullTime;
+        fastTotal       += fastTime;
+
+        qDebug().noquote() << QString::fromLatin1("%1: full %2x%3 in %4 ms, scaled %5x%6 in %7 ms")
+                              .arg(QFileInfo(filePath).fileName())
+                              .arg(fullSize.width()).arg(fullSize.height()).arg(fullTime)
+                              .arg(fastSize.width()).arg(fastSize.height()).arg(fastTime);
+
+        if (qMax(fastSize.width(), fastSize.height()) < qMin(size, qMax(fullSize.width(), fullSize.height())))
+        {
+            qWarning() << "The scaled image of" << filePath << "is smaller than" << size;
+        }
+    }
+
+    qDebug().noquote() << QString::fromLatin1("Total: full %1 ms, scaled %2 ms, %3 ms saved (%4 %)")
+                          .arg(fullTotal)
+                          .arg(fastTotal)
+                          .arg(fullTotal - fastTotal)
+                          .arg(fullTotal ? 100.0 * (fullTotal - fastTotal) / fullTotal : 0.0, 0, 'f', 1);
+
+    return 0;
+}
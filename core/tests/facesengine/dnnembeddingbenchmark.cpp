@@ -0,0 +1,140 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : CLI benchmark of the face vectors computed by
+ *               the resident deep learning network
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// OpenCV includes need to show up before Qt includes
+
+#include "dnn_face.h"
+#include "dnnfaceembedder.h"
+#include "opencvdnnfacerecognizer.h"
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QDebug>
+
+using namespace Digikam;
+
+static void report(const QString& name, int faces, qint64 msecs)
+{
+    qDebug().noquote() << QString::fromLatin1("%1 %2 faces in %3 ms, %4 faces/s")
+                          .arg(name, -26)
+                          .arg(faces)
+                          .arg(msecs, 7)
+                          .arg(faces * 1000.0 / qMax(msecs, (qint64)1), 0, 'f', 1);
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc < 2)
+    {
+        qDebug() << "dnnembeddingbenchmark - measure the face vectors computed per second";
+        qDebug() << "Usage: <face images>";
+        return -1;
+    }
+
+    // The face images are repeated to have enough faces for the batches.
+
+    OpenCVDNNFaceRecognizer recognizer;
+    std::vector<cv::Mat>    faces;
+
+    while (faces.size() < 64)
+    {
+        for (int i = 1 ; i < argc ; ++i)
+        {
+            QImage image(QString::fromLocal8Bit(argv[i]));
+
+            if (image.isNull())
+            {
+                qWarning() << "Cannot load" << argv[i];
+                return -1;
+            }
+
+            faces.push_back(recognizer.prepareForRecognition(image));
+        }
+    }
+
+    QElapsedTimer timer;
+
+    // Before the resident network, the models were read again for each face.
+
+    timer.start();
+
+    for (size_t i = 0 ; i < faces.size() ; ++i)
+    {
+        DNNFaceKernel kernel;
+        std::vector<float> vecdata;
+
+        if (!kernel.loadModels())
+        {
+            qWarning() << "Cannot load the face recognition network";
+            return -1;
+        }
+
+        kernel.getFaceVector(faces[i], vecdata);
+    }
+
+    report(QLatin1String("Loading for each face:"), (int)faces.size(), timer.elapsed());
+
+    timer.restart();
+
+    if (!DNNFaceEmbedder::instance()->isLoaded())
+    {
+        qWarning() << "Cannot load the face recognition network";
+        return -1;
+    }
+
+    const qint64 loadTime = timer.elapsed();
+    qDebug() << "Network loaded in" << loadTime << "ms";
+
+    timer.restart();
+
+    for (size_t i = 0 ; i < faces.size() ; ++i)
+    {
+        DNNFaceEmbedder::instance()->faceVector(faces[i]);
+    }
+
+    report(QLatin1String("One face at a time:"), (int)faces.size(), timer.elapsed());
+
+    const size_t batchSizes[3] = { 8, 32, faces.size() };
+
+    for (int b = 0 ; b < 3 ; ++b)
+    {
+        timer.restart();
+
+        for (size_t start = 0 ; start < faces.size() ; start += batchSizes[b])
+        {
+            std::vector<cv::Mat> batch(faces.begin() + start,
+                                       faces.begin() + qMin(start + batchSizes[b], faces.size()));
+            DNNFaceEmbedder::instance()->faceVectors(batch);
+        }
+
+        report(QString::fromLatin1("Batches of %1 faces:").arg(batchSizes[b]), (int)faces.size(), timer.elapsed());
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : CLI benchmark of the parallel point-wise color filters
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QDebug>
+
+// Local includes
+
+#include "dimg.h"
+#include "../dimg/dimgbenchmark.h"
+#include "bcgfilter.h"
+#include "cbfilter.h"
+#include "curvesfilter.h"
+#include "hslfilter.h"
+#include "levelsfilter.h"
+#include "mixerfilter.h"
+#include "wbfilter.h"
+
+using namespace Digikam;
+
+/** Run the filter with the given number of threads, return the time in ms.
+ */
+template <class Filter, class Container>
+static qint64 timeFilter(const DImg& img, const Container& settings, int threads, DImg* const result)
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    DImg   copy = img.copy();
+    Filter filter(&copy, nullptr, settings);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    filter.startFilterDirectly();
+
+    qint64 elapsed = timer.elapsed();
+    *result        = filter.getTargetImage();
+
+    return elapsed;
+}
+
+/** Compare the filter run in one thread and in all threads. Returns false if the results differ.
+ */
+template <class Filter, class Container>
+static bool benchmarkFilter(const QString& name, const DImg& img, const Container& settings, int threads)
+{
+    DImg serial, parallel;
+
+    qint64 serialTime   = timeFilter<Filter>(img, settings, 1,       &serial);
+    qint64 parallelTime = timeFilter<Filter>(img, settings, threads, &parallel);
+
+    bool identical      = (serial.numBytes() == parallel.numBytes()) &&
+                          (memcmp(serial.bits(), parallel.bits(), serial.numBytes()) == 0);
+
+    qDebug().noquote() << QString::fromLatin1("%1 %2 bits: 1 thread %3 ms, %4 threads %5 ms, speed-up x%6 %7")
+                          .arg(name, -8)
+                          .arg(img.sixteenBit() ? 16 : 8)
+                          .arg(serialTime, 6)
+                          .arg(threads)
+                          .arg(parallelTime, 6)
+                          .arg((double)serialTime / qMax(parallelTime, (qint64)1), 0, 'f', 2)
+                          .arg(identical ? QLatin1String("") : QLatin1String("RESULTS DIFFER"));
+
+    return identical;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    uint width, height;
+    DImgBenchmark::imageSize(argc, argv, "benchmark the point-wise color filters in one and all threads",
+                             &width, &height);
+
+    int  threads = QThreadPool::globalInstance()->maxThreadCount();
+    bool success = true;
+
+    for (int depth = 0 ; depth < 2 ; ++depth)
+    {
+        bool sixteenBit = (depth == 1);
+        DImg img        = DImgBenchmark::createImage(width, height, sixteenBit);
+
+        BCGContainer bcg;
+        bcg.brightness  = 0.1;
+        bcg.contrast    = 1.2;
+        bcg.gamma       = 1.1;
+        success        &= benchmarkFilter<BCGFilter>(QLatin1String("BCG"), img, bcg, threads);
+
+        WBContainer wb;
+        wb.temperature  = 5000.0;
+        wb.saturation   = 1.2;
+        success        &= benchmarkFilter<WBFilter>(QLatin1String("WB"), img, wb, threads);
+
+        HSLContainer hsl;
+        hsl.hue         = 20.0;
+        hsl.saturation  = 10.0;
+        hsl.lightness   = 5.0;
+        success        &= benchmarkFilter<HSLFilter>(QLatin1String("HSL"), img, hsl, threads);
+
+        CurvesContainer curves(ImageCurves::CURVE_SMOOTH, sixteenBit);
+        curves.initialize();
+        success        &= benchmarkFilter<CurvesFilter>(QLatin1String("Curves"), img, curves, threads);
+
+        LevelsContainer levels;
+
+        for (int i = 0 ; i < 5 ; ++i)
+        {
+            levels.hInput[i]  = sixteenBit ? 60000 : 235;
+            levels.hOutput[i] = sixteenBit ? 65535 : 255;
+            levels.gamma[i]   = 1.2;
+        }
+
+        success        &= benchmarkFilter<LevelsFilter>(QLatin1String("Levels"), img, levels, threads);
+
+        CBContainer cb;
+        cb.red          = 1.1;
+        cb.blue         = 0.9;
+        success        &= benchmarkFilter<CBFilter>(QLatin1String("CB"), img, cb, threads);
+
+        MixerContainer mixer;
+        mixer.redGreenGain = 0.2;
+        mixer.bPreserveLum = true;
+        success        &= benchmarkFilter<MixerFilter>(QLatin1String("Mixer"), img, mixer, threads);
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    return (success ? 0 : 1);
+}
@@ -0,0 +1,224 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : An unit test to measure the metadata read throughput
+ *               of concurrent threads.
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "metareaderthroughputtest.h"
+
+// Qt includes
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+// Local includes
+
+#include "dmetadata.h"
+
+/** A summary of the values used to populate the core database, to compare the results of the threads.
+ */
+static QString s_readSummary(const DMetadata& meta)
+{
+    QStringList tags;
+    meta.getItemTagsPath(tags);
+
+    QString summary;
+    QDebug  debug(&summary);
+    debug << meta.getItemDimensions()
+          << meta.getItemComments().keys()
+          << meta.getItemTitles().keys()
+          << meta.getPhotographInformation().make
+          << meta.getPhotographInformation().model
+          << meta.getPhotographInformation().dateTime
+          << tags
+          << meta.getXmpKeywords()
+          << meta.getXmpSubjects();
+
+    return summary;
+}
+
+class Q_DECL_HIDDEN MetaReaderThroughputTask : public QRunnable
+{
+public:
+
+    MetaReaderThroughputTask(const QString& filePath, int index, QStringList* const results, QMutex* const mutex)
+        : filePath(filePath),
+          index(index),
+          results(results),
+          mutex(mutex)
+    {
+    }
+
+    void run() override
+    {
+        DMetadata meta;
+        QString   summary;
+
+        if (meta.load(filePath))
+        {
+            summary = s_readSummary(meta);
+        }
+
+        QMutexLocker lock(mutex);
+        (*results)[index] = summary;
+    }
+
+private:
+
+    QString      filePath;
+    int          index;
+    QStringList* results;
+    QMutex*      mutex;
+};
+
+class Q_DECL_HIDDEN MetaReaderSharedDataTask : public QRunnable
+{
+public:
+
+    MetaReaderSharedDataTask(const MetaEngineData& data, int index, QStringList* const results, QMutex* const mutex)
+        : data(data),
+          index(index),
+          results(results),
+          mutex(mutex)
+    {
+    }
+
+    void run() override
+    {
+        // All tasks read the same implicitly shared data, each one through its own instance.
+
+        DMetadata meta(data);
+        QString   summary = s_readSummary(meta);
+
+        QMutexLocker lock(mutex);
+        (*results)[index] = summary;
+    }
+
+private:
+
+    MetaEngineData data;
+    int            index;
+    QStringList*   results;
+    QMutex*        mutex;
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+QTEST_MAIN(MetaReaderThroughputTest)
+
+QStringList MetaReaderThroughputTest::readFiles(const QStringList& files, int rounds, int threads,
+                                                double* const filesPerSecond)
+{
+    QStringList results;
+    QMutex      mutex;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    for (int i = 0 ; i < files.count() * rounds ; ++i)
+    {
+        results << QString();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0 ; i < results.count() ; ++i)
+    {
+        pool.start(new MetaReaderThroughputTask(files.at(i % files.count()), i, &results, &mutex));
+    }
+
+    pool.waitForDone();
+
+    *filesPerSecond = results.count() * 1000.0 / qMax((qint64)1, timer.elapsed());
+
+    return results;
+}
+
+void MetaReaderThroughputTest::testReadThroughput()
+{
+    QStringList files;
+    QDirIterator it(m_originalImageFolder, QStringList() << QLatin1String("*.jpg") << QLatin1String("*.JPG"),
+                    QDir::Files);
+
+    while (it.hasNext())
+    {
+        files << it.next();
+    }
+
+    QVERIFY(!files.isEmpty());
+
+    const int rounds  = 200;
+    const int threads = qMax(2, QThread::idealThreadCount());
+    double    sequentialRate;
+    double    concurrentRate;
+
+    QStringList sequential = readFiles(files, rounds, 1,       &sequentialRate);
+    QStringList concurrent = readFiles(files, rounds, threads, &concurrentRate);
+
+    qDebug() << "Metadata reads with 1 thread:" << sequentialRate << "files/s";
+    qDebug() << "Metadata reads with" << threads << "threads:" << concurrentRate << "files/s"
+             << "speedup:" << concurrentRate / sequentialRate;
+
+    // The concurrent reads must give the same values as the sequential ones
+
+    QCOMPARE(concurrent.count(), sequential.count());
+
+    for (int i = 0 ; i < sequential.count() ; ++i)
+    {
+        QVERIFY(!sequential.at(i).isEmpty());
+        QCOMPARE(concurrent.at(i), sequential.at(i));
+    }
+}
+
+void MetaReaderThroughputTest::testSharedDataReads()
+{
+    DMetadata meta;
+    QVERIFY(meta.load(m_originalImageFolder + QLatin1String("2008-05_DSC_0294.JPG")));
+
+    const QString reference = s_readSummary(meta);
+    const int     tasks     = 500;
+    QStringList   results;
+    QMutex        mutex;
+    QThreadPool   pool;
+    pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+
+    for (int i = 0 ; i < tasks ; ++i)
+    {
+        results << QString();
+    }
+
+    for (int i = 0 ; i < tasks ; ++i)
+    {
+        pool.start(new MetaReaderSharedDataTask(meta.data(), i, &results, &mutex));
+    }
+
+    pool.waitForDone();
+
+    foreach (const QString& result, results)
+    {
+        QCOMPARE(result, reference);
+    }
+}
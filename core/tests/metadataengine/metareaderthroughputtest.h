@@ -0,0 +1,55 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-30
+ * Description : An unit test to measure the metadata read throughput
+ *               of concurrent threads.
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_META_READER_THROUGHPUT_TEST_H
+#define DIGIKAM_META_READER_THROUGHPUT_TEST_H
+
+// Qt includes
+
+#include <QStringList>
+
+// Local includes
+
+#include "abstractunittest.h"
+
+using namespace Digikam;
+
+class MetaReaderThroughputTest : public AbstractUnitTest
+{
+    Q_OBJECT
+
+private:
+
+    /** Read the metadata of all files, each one the given number of times, with the given number of threads.
+     *  Returns the summary of the values read for each file, and the files read per second.
+     */
+    QStringList readFiles(const QStringList& files, int rounds, int threads, double* const filesPerSecond);
+
+private Q_SLOTS:
+
+    void testReadThroughput();
+    void testSharedDataReads();
+};
+
+#endif // DIGIKAM_META_READER_THROUGHPUT_TEST_H
@@ -0,0 +1,220 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2019-08-31
+ * Description : CLI test of the Exif orientation of a RAW file
+ *               processed by a chain of batch tools
+ *
+ * Copyright (C) 2019 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QDebug>
+
+// Local includes
+
+#include "batchtool.h"
+#include "dimg.h"
+#include "dmetadata.h"
+#include "metaengine.h"
+
+using namespace Digikam;
+
+/** Convert to PNG, as done by the Convert tools.
+ */
+class ConvertTestTool : public BatchTool
+{
+public:
+
+    explicit ConvertTestTool()
+        : BatchTool(QLatin1String("ConvertTestTool"), ConvertTool)
+    {
+    }
+
+    BatchToolSettings defaultSettings()
+    {
+        return BatchToolSettings();
+    }
+
+    BatchTool* clone(QObject* const parent=nullptr) const
+    {
+        Q_UNUSED(parent);
+        return new ConvertTestTool;
+    }
+
+    QString outputSuffix() const
+    {
+        return QLatin1String("png");
+    }
+
+private:
+
+    bool toolOperations()
+    {
+        if (!loadToDImg())
+        {
+            return false;
+        }
+
+        return savefromDImg();
+    }
+
+    void slotSettingsChanged()
+    {
+    }
+};
+
+/** Reduce the size by 2, as done by the Resize tool.
+ */
+class ResizeTestTool : public BatchTool
+{
+public:
+
+    explicit ResizeTestTool()
+        : BatchTool(QLatin1String("ResizeTestTool"), TransformTool)
+    {
+    }
+
+    BatchToolSettings defaultSettings()
+    {
+        return BatchToolSettings();
+    }
+
+    BatchTool* clone(QObject* const parent=nullptr) const
+    {
+        Q_UNUSED(parent);
+        return new ResizeTestTool;
+    }
+
+private:
+
+    bool toolOperations()
+    {
+        if (!loadToDImg())
+        {
+            return false;
+        }
+
+        image().resize(image().width() / 2, image().height() / 2);
+
+        return savefromDImg();
+    }
+
+    void slotSettingsChanged()
+    {
+    }
+};
+
+/** Run the RAW file through Convert and Resize, as done by the queue manager Task,
+ *  and return the output file.
+ */
+static QString runChain(const QString& rawFile, const QString& workingPath, bool inMemory)
+{
+    ConvertTestTool   convert;
+    ResizeTestTool    resize;
+    QList<BatchTool*> tools;
+    tools << &convert << &resize;
+
+    QUrl inUrl = QUrl::fromLocalFile(rawFile);
+    DImg image;
+
+    for (int i = 0 ; i < tools.count() ; ++i)
+    {
+        BatchTool* const tool = tools[i];
+
+        tool->setImageData(image);
+        tool->setInputUrl(inUrl);
+        tool->setWorkingUrl(QUrl::fromLocalFile(workingPath));
+        tool->setResetExifOrientationAllowed(true);
+        tool->setInMemoryChain(inMemory);
+        tool->setLastChainedTool(i == tools.count() - 1);
+        tool->setOutputUrlFromInputUrl();
+
+        if (!tool->apply())
+        {
+            return QString();
+        }
+
+        inUrl = tool->outputUrl();
+        image = tool->imageData();
+    }
+
+    return inUrl.toLocalFile();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        qDebug() << "bqmorientationtest - check the Exif orientation of a RAW file converted and resized";
+        qDebug() << "Usage: <rawfile> (with an orientation other than normal)";
+        return -1;
+    }
+
+    QApplication app(argc, argv);
+    MetaEngine::initializeExiv2();
+
+    QString       rawFile = QString::fromLocal8Bit(argv[1]);
+    QTemporaryDir tempDir;
+    bool          success = true;
+    QSize         size;
+
+    qDebug() << "RAW orientation:" << DMetadata(rawFile).getItemOrientation();
+
+    for (int inMemory = 0 ; inMemory < 2 ; ++inMemory)
+    {
+        QString output = runChain(rawFile, tempDir.path(), inMemory == 1);
+
+        if (output.isEmpty())
+        {
+            qWarning() << "Cannot process" << rawFile;
+            return 1;
+        }
+
+        MetaEngine::ImageOrientation orientation = DMetadata(output).getItemOrientation();
+        DImg result(output);
+
+        qDebug() << (inMemory ? "In memory chain:" : "Chain with files:")
+                 << "orientation" << orientation << "size" << result.size();
+
+        // The pixels are already rotated by the RAW decoder: the tag must be reset.
+
+        if (orientation != MetaEngine::ORIENTATION_NORMAL)
+        {
+            qWarning() << "The Exif orientation is not reset";
+            success = false;
+        }
+
+        if (inMemory && (result.size() != size))
+        {
+            qWarning() << "The in memory chain gives another image size than the chain with files";
+            success = false;
+        }
+
+        size = result.size();
+        QFile::remove(output);
+    }
+
+    MetaEngine::cleanupExiv2();
+
+    return (success ? 0 : 1);
+}
@@ -23,6 +23,7 @@
 // Qt includes
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QDebug>
 
 // Local includes
@@ -63,6 +64,23 @@ int main(int argc, char** argv)
         {
            qDebug() << "Cannot extract thumbnail from" << path;
         }
+
+        // Compare the smart frame selection on consecutive frames and on key frames only
+
+        QElapsedTimer timer;
+
+        for (int keyFrames = 0 ; keyFrames < 2 ; ++keyFrames)
+        {
+            QImage smartImage;
+            thumbnailer.setSmartFrameSelection(true);
+            thumbnailer.setKeyFramesOnly(keyFrames == 1);
+
+            timer.start();
+            thumbnailer.generateThumbnail(path, smartImage);
+
+            qDebug() << "Smart frame selection" << (keyFrames ? "on key frames:" : "on all frames:")
+                     << timer.elapsed() << "ms" << smartImage.size();
+        }
     }
 
     return 0;
@@ -62,6 +62,11 @@ protected:
     int                          falseNegativeFaces;
     int                          falsePositiveFaces;
 
+    qint64                       decodingTime;
+    qint64                       preparationTime;
+    qint64                       detectionTime;
+    qint64                       recognitionTime;
+
     FacePipeline::Private* const d;
 };
 
@@ -101,6 +106,8 @@ protected:
 protected:
 
     QMap<int, Statistics>        results;
+    int                          processedImages;
+    qint64                       recognitionTime;
 
     FacePipeline::Private* const d;
     RecognitionDatabase          database;
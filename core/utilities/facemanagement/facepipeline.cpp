@@ -24,6 +24,10 @@
 #include "facepipeline.h"
 #include "facepipeline_p.h"
 
+// KDE includes
+
+#include <klocalizedstring.h>
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -37,6 +41,61 @@
 namespace Digikam
 {
 
+/** The worker creators of the parallel stages. The workers created while the pipeline runs
+ *  get the settings given to the pipeline before.
+ */
+static WorkerObject* createDetectionWorker(FacePipeline::Private* const d)
+{
+    DetectionWorker* const worker = new DetectionWorker(d);
+
+    QObject::connect(d, SIGNAL(accuracyChanged(double)),
+                     worker, SLOT(setAccuracy(double)));
+
+    if (d->accuracy >= 0.0)
+    {
+        worker->setAccuracy(d->accuracy);
+    }
+
+    return worker;
+}
+
+/** Each recognizer loads its own copy of the recognition model. The DNN recognizers share
+ *  the network of DNNFaceEmbedder, which computes the face vectors of one thread at a time:
+ *  more DNN recognizers only wait on it, one recognizes the faces of a package in one pass.
+ */
+static int maximumRecognizers(RecognitionDatabase::RecognizeAlgorithm algorithmType)
+{
+    if (algorithmType == RecognitionDatabase::RecognizeAlgorithm::DNN)
+    {
+        return 1;
+    }
+
+    return qMin(4, QThread::idealThreadCount());
+}
+
+static WorkerObject* createRecognitionWorker(FacePipeline::Private* const d)
+{
+    RecognitionWorker* const worker = new RecognitionWorker(d);
+    worker->activeFaceRecognizer(d->recognizeAlgorithm);
+
+    QObject::connect(d, SIGNAL(accuracyChanged(double)),
+                     worker, SLOT(setThreshold(double)));
+
+    if (d->accuracy >= 0.0)
+    {
+        worker->setThreshold(d->accuracy);
+    }
+
+    return worker;
+}
+
+static WorkerObject* createDatabaseWriter(FacePipeline::Private* const d)
+{
+    return new DatabaseWriter(d->writeMode, d);
+}
+
+// ----------------------------------------------------------------------------------------
+
 FacePipelineFaceTagsIface::FacePipelineFaceTagsIface()
     : roles(NoRole),
       assignedTagId(0)
@@ -155,7 +214,9 @@ FacePipeline::~FacePipeline()
     delete d->detectionWorker;
     delete d->parallelDetectors;
     delete d->recognitionWorker;
+    delete d->parallelRecognizers;
     delete d->databaseWriter;
+    delete d->parallelWriters;
     delete d->trainer;
     qDeleteAll(d->thumbnailLoadThreads);
     delete d->detectionBenchmarker;
@@ -174,6 +235,36 @@ bool FacePipeline::hasFinished() const
     return d->hasFinished();
 }
 
+QString FacePipeline::queueStatus() const
+{
+    QStringList status;
+
+    if (d->parallelDetectors)
+    {
+        status << i18np("Detection: %2 queued, 1 worker", "Detection: %2 queued, %1 workers",
+                        d->parallelDetectors->activeWorkers(), d->parallelDetectors->queueDepth());
+    }
+
+    if (d->parallelRecognizers)
+    {
+        status << i18np("Recognition: %2 queued, 1 worker", "Recognition: %2 queued, %1 workers",
+                        d->parallelRecognizers->activeWorkers(), d->parallelRecognizers->queueDepth());
+    }
+
+    if (d->parallelWriters)
+    {
+        status << i18np("Database: %2 queued, 1 worker", "Database: %2 queued, %1 workers",
+                        d->parallelWriters->activeWorkers(), d->parallelWriters->queueDepth());
+    }
+
+    if (!d->delayedPackages.isEmpty())
+    {
+        status << i18n("Waiting: %1", d->delayedPackages.size());
+    }
+
+    return status.join(QLatin1String(" - "));
+}
+
 QString FacePipeline::benchmarkResult() const
 {
     if (d->detectionBenchmarker)
@@ -226,19 +317,10 @@ void FacePipeline::plugParallelFaceDetectors()
         return plugFaceDetector();
     }
 
-    // limit number of parallel detectors to 3, because of memory cost (cascades)
-    const int n          = qMin(3, QThread::idealThreadCount());
+    // Each detector loads its own cascades, which limits the number of parallel detectors.
     d->parallelDetectors = new ParallelPipes;
-
-    for (int i = 0 ; i < n ; ++i)
-    {
-        DetectionWorker* const worker = new DetectionWorker(d);
-
-        connect(d, SIGNAL(accuracyChanged(double)),
-                worker, SLOT(setAccuracy(double)));
-
-        d->parallelDetectors->add(worker);
-    }
+    d->parallelDetectors->add(createDetectionWorker(d));
+    d->parallelDetectors->setWorkerCreator(createDetectionWorker, d, qMin(8, QThread::idealThreadCount()));
 }
 
 void FacePipeline::plugFaceRecognizer()
@@ -250,12 +332,38 @@ void FacePipeline::plugFaceRecognizer()
             d->recognitionWorker, SLOT(setThreshold(double)));
 }
 
+void FacePipeline::plugParallelFaceRecognizers()
+{
+    if (QThread::idealThreadCount() <= 1)
+    {
+        return plugFaceRecognizer();
+    }
+
+    d->parallelRecognizers = new ParallelPipes;
+    d->parallelRecognizers->add(createRecognitionWorker(d));
+    d->parallelRecognizers->setWorkerCreator(createRecognitionWorker, d, maximumRecognizers(d->recognizeAlgorithm));
+}
+
 void FacePipeline::plugDatabaseWriter(WriteMode mode)
 {
     d->databaseWriter = new DatabaseWriter(mode, d);
     d->createThumbnailLoadThread();
 }
 
+void FacePipeline::plugParallelDatabaseWriters(WriteMode mode)
+{
+    if (QThread::idealThreadCount() <= 1)
+    {
+        return plugDatabaseWriter(mode);
+    }
+
+    // The database serializes the writes: a second writer overlaps them with the thumbnail storage.
+    d->writeMode       = mode;
+    d->parallelWriters = new ParallelPipes;
+    d->parallelWriters->add(createDatabaseWriter(d));
+    d->parallelWriters->setWorkerCreator(createDatabaseWriter, d, 2);
+}
+
 void FacePipeline::plugTrainer()
 {
     d->trainer = new Trainer(d);
@@ -298,7 +406,12 @@ void FacePipeline::construct()
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add single thread detector";
     }
 
-    if (d->recognitionWorker)
+    if (d->parallelRecognizers)
+    {
+        d->pipeline << d->parallelRecognizers;
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add parallel recognition workers";
+    }
+    else if (d->recognitionWorker)
     {
         d->pipeline << d->recognitionWorker;
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add recognition worker";
@@ -316,7 +429,12 @@ void FacePipeline::construct()
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add recognition benchmaker";
     }
 
-    if (d->databaseWriter)
+    if (d->parallelWriters)
+    {
+        d->pipeline << d->parallelWriters;
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add parallel database writers";
+    }
+    else if (d->databaseWriter)
     {
         d->pipeline << d->databaseWriter;
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add database writer";
@@ -367,10 +485,22 @@ QThread::Priority FacePipeline::priority() const
 
 void FacePipeline::activeFaceRecognizer(RecognitionDatabase::RecognizeAlgorithm algorithmType)
 {
+    d->recognizeAlgorithm = algorithmType;
+
     if (d->recognitionWorker != nullptr)
     {
         d->recognitionWorker->activeFaceRecognizer(algorithmType);
     }
+
+    if (d->parallelRecognizers != nullptr)
+    {
+        d->parallelRecognizers->setWorkerCreator(createRecognitionWorker, d, maximumRecognizers(algorithmType));
+
+        foreach (WorkerObject* const worker, d->parallelRecognizers->m_workers)
+        {
+            static_cast<RecognitionWorker*>(worker)->activeFaceRecognizer(algorithmType);
+        }
+    }
 }
 
 void FacePipeline::cancel()
@@ -523,6 +653,7 @@ void FacePipeline::process(const QList<ItemInfo>& infos)
 
 void FacePipeline::setDetectionAccuracy(double value)
 {
+    d->accuracy = value;
     emit d->accuracyChanged(value);
 }
 
@@ -191,6 +191,7 @@ public:
      * PlugParallel: You can call this instead of the simple plugging method.
      * Depending on the number of processor cores of the machine and the memory cost,
      * more than one element may be plugged and process parallelly for this part of the pipeline.
+     * The pools start with one worker and grow while the packages queue up before their workers.
      *
      * Supported combinations:
      *  (Database Filter ->) (Preview Loader ->) Detector -> Recognizer (-> DatabaseWriter)
@@ -207,7 +208,9 @@ public:
     void plugFaceDetector();
     void plugParallelFaceDetectors();
     void plugFaceRecognizer();
+    void plugParallelFaceRecognizers();
     void plugDatabaseWriter(WriteMode mode);
+    void plugParallelDatabaseWriters(WriteMode mode);
     void plugDatabaseEditor();
     void plugTrainer();
     void plugDetectionBenchmarker();
@@ -232,6 +235,12 @@ public:
     bool hasFinished() const;
     QString benchmarkResult() const;
 
+    /**
+     * Returns the packages queued in each parallel stage and its number of active workers,
+     * as a translated text for progress displays.
+     */
+    QString queueStatus() const;
+
     /**
      * Set the priority of the threads used by this pipeline.
      * The default setting is QThread::LowPriority.
@@ -65,7 +65,9 @@ FacePipeline::Private::Private(FacePipeline* const q)
     detectionWorker        = nullptr;
     parallelDetectors      = nullptr;
     recognitionWorker      = nullptr;
+    parallelRecognizers    = nullptr;
     databaseWriter         = nullptr;
+    parallelWriters        = nullptr;
     trainer                = nullptr;
     detectionBenchmarker   = nullptr;
     recognitionBenchmarker = nullptr;
@@ -75,6 +77,9 @@ FacePipeline::Private::Private(FacePipeline* const q)
     packagesOnTheRoad      = 0;
     maxPackagesOnTheRoad   = 50;
     totalPackagesAdded     = 0;
+    accuracy               = -1.0;
+    recognizeAlgorithm     = RecognitionDatabase::RecognizeAlgorithm::LBP;
+    writeMode              = FacePipeline::NormalWrite;
 }
 
 void FacePipeline::Private::processBatch(const QList<ItemInfo>& infos)
@@ -212,6 +217,37 @@ bool FacePipeline::Private::hasFinished()
     return !packagesOnTheRoad && !infosForFiltering;
 }
 
+bool FacePipeline::Private::hasSaturatedPool() const
+{
+    ParallelPipes* pipes = nullptr;
+
+    foreach (QObject* const element, pipeline)
+    {
+        if ((pipes = qobject_cast<ParallelPipes*>(element)) && pipes->isSaturated())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int FacePipeline::Private::poolCapacity() const
+{
+    int capacity         = 0;
+    ParallelPipes* pipes = nullptr;
+
+    foreach (QObject* const element, pipeline)
+    {
+        if ((pipes = qobject_cast<ParallelPipes*>(element)))
+        {
+            capacity += pipes->maximumWorkers() * ParallelPipes::QueueLimit;
+        }
+    }
+
+    return capacity;
+}
+
 void FacePipeline::Private::checkFinished()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "Check for finish: " << packagesOnTheRoad << "packages,"
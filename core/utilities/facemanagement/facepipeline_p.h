@@ -24,10 +24,14 @@
 #ifndef DIGIKAM_FACE_PIPELINE_PRIVATE_H
 #define DIGIKAM_FACE_PIPELINE_PRIVATE_H
 
+// OpenCV includes need to show up before Qt includes
+#include "digikam_opencv.h"
+
 #include "facepipeline.h"
 
 // Qt includes
 
+#include <QElapsedTimer>
 #include <QExplicitlySharedDataPointer>
 #include <QMetaMethod>
 #include <QMutex>
@@ -59,12 +63,30 @@ class ScanStateFilter;
 class Q_DECL_HIDDEN FacePipelineExtendedPackage : public FacePipelinePackage,
                                                   public QSharedData
 {
+public:
+
+    FacePipelineExtendedPackage()
+      : decodingTime(0),
+        preparationTime(0),
+        detectionTime(0),
+        recognitionTime(0)
+    {
+    }
+
 public:
 
     QString                                                           filePath;
-    DImg                                                              detectionImage; // image scaled to about 0.5 Mpx
+    cv::Mat                                                           detectionImage; // grayscale image from FaceDetector::prepareForDetection()
     typedef QExplicitlySharedDataPointer<FacePipelineExtendedPackage> Ptr;
 
+    /// The time spent in each stage in ms, reported by the benchmarkers.
+    /// The decoding time includes the waiting in the loading queue.
+    qint64                                                            decodingTime;
+    qint64                                                            preparationTime;
+    qint64                                                            detectionTime;
+    qint64                                                            recognitionTime;
+    QElapsedTimer                                                     decodingTimer;
+
 public:
 
     bool operator==(const LoadingDescription& description) const
@@ -111,6 +133,8 @@ public:
 
     bool hasFinished();
     void checkFinished();
+    bool hasSaturatedPool() const;
+    int  poolCapacity()     const;
     void start();
     void stop();
     void wait();
@@ -125,7 +149,9 @@ public:
     DetectionWorker*                        detectionWorker;
     ParallelPipes*                          parallelDetectors;
     RecognitionWorker*                      recognitionWorker;
+    ParallelPipes*                          parallelRecognizers;
     DatabaseWriter*                         databaseWriter;
+    ParallelPipes*                          parallelWriters;
     Trainer*                                trainer;
     DetectionBenchmarker*                   detectionBenchmarker;
     RecognitionBenchmarker*                 recognitionBenchmarker;
@@ -142,6 +168,11 @@ public:
 
     QList<FacePipelineExtendedPackage::Ptr> delayedPackages;
 
+    /// The settings given to the workers created later in the pools
+    double                                  accuracy;
+    RecognitionDatabase::RecognizeAlgorithm recognizeAlgorithm;
+    FacePipeline::WriteMode                 writeMode;
+
 public Q_SLOTS:
 
     void finishProcess(FacePipelineExtendedPackage::Ptr package);
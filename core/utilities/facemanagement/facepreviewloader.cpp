@@ -57,7 +57,10 @@ void FacePreviewLoader::process(FacePipelineExtendedPackage::Ptr package)
         return;
     }
 
+    package->decodingTimer.start();
     scheduledPackages << package;
+
+    // The preview is decoded at reduced size where the format allows it (JPEG, PGF, RAW).
     loadFastButLarge(package->filePath, 1600);
     //load(package->filePath, 800, MetaEngineSettings::instance()->settings().exifRotate);
     //loadHighQuality(package->filePath, MetaEngineSettings::instance()->settings().exifRotate);
@@ -92,16 +95,24 @@ void FacePreviewLoader::slotImageLoaded(const LoadingDescription& loadingDescrip
         return;
     }
 
+    // The detection image is prepared by the detection workers, in parallel.
     package->image         = img;
+    package->decodingTime  = package->decodingTimer.elapsed();
     package->processFlags |= FacePipelinePackage::PreviewImageLoaded;
     emit processed(package);
 }
 
 bool FacePreviewLoader::sentOutLimitReached()
 {
+    // Back-pressure: stop loading when a worker pool is full, else feed the pools as they grow.
+    if (d->hasSaturatedPool())
+    {
+        return true;
+    }
+
     int packagesInTheFollowingPipeline = d->packagesOnTheRoad - scheduledPackages.size();
 
-    return (packagesInTheFollowingPipeline > maximumSentOutPackages);
+    return (packagesInTheFollowingPipeline > qMax(maximumSentOutPackages, d->poolCapacity()));
 }
 
 void FacePreviewLoader::checkRestart()
@@ -26,6 +26,10 @@
 #include <ksharedconfig.h>
 #include <kconfiggroup.h>
 
+// Qt includes
+
+#include <QElapsedTimer>
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -40,30 +44,34 @@ DetectionWorker::DetectionWorker(FacePipeline::Private* const d)
 
 void DetectionWorker::process(FacePipelineExtendedPackage::Ptr package)
 {
-    QImage detectionImage  = scaleForDetection(package->image);
-    package->detectedFaces = detector.detectFaces(detectionImage, package->image.originalSize());
+    QElapsedTimer timer;
+    timer.start();
+
+    // The grayscale image is prepared here, out of the preview loading thread, which notifies
+    // the loaded images under the lock of the loading cache. The images given to the pipeline
+    // with their detection image are not prepared again.
+
+    if (package->detectionImage.empty())
+    {
+        package->detectionImage  = FaceDetector::prepareForDetection(package->image);
+        package->preparationTime = timer.restart();
+    }
+
+    package->detectedFaces = detector.detectFaces(package->detectionImage, package->image.originalSize());
+    package->detectionTime = timer.elapsed();
 
     qCDebug(DIGIKAM_GENERAL_LOG) << "Found" << package->detectedFaces.size() << "faces in"
                                  << package->info.name() << package->image.size()
                                  << package->image.originalSize();
 
+    // The grayscale image is not needed by the next stages.
+    package->detectionImage.release();
+
     package->processFlags |= FacePipelinePackage::ProcessedByDetector;
 
     emit processed(package);
 }
 
-QImage DetectionWorker::scaleForDetection(const DImg& image) const
-{
-    int recommendedSize = detector.recommendedImageSize(image.size());
-
-    if (qMax(image.width(), image.height()) > (uint)recommendedSize)
-    {
-        return image.smoothScale(recommendedSize, recommendedSize, Qt::KeepAspectRatio).copyQImage();
-    }
-
-    return image.copyQImage();
-}
-
 void DetectionWorker::setAccuracy(double accuracy)
 {
     QVariantMap params;
@@ -89,6 +97,8 @@ void RecognitionWorker::process(FacePipelineExtendedPackage::Ptr package)
 {
     FaceUtils     utils;
     QList<QImage> images;
+    QElapsedTimer timer;
+    timer.start();
 
     if (package->processFlags & FacePipelinePackage::ProcessedByDetector)
     {
@@ -101,6 +111,7 @@ void RecognitionWorker::process(FacePipelineExtendedPackage::Ptr package)
     }
 
     package->recognitionResults  = database.recognizeFaces(images);
+    package->recognitionTime     = timer.elapsed();
     package->processFlags       |= FacePipelinePackage::ProcessedByRecognizer;
 
     emit processed(package);
@@ -44,8 +44,6 @@ public:
         wait();    // protect detector
     }
 
-    QImage scaleForDetection(const DImg& image) const;
-
 public Q_SLOTS:
 
     void process(FacePipelineExtendedPackage::Ptr package);
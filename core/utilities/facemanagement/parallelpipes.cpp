@@ -31,7 +31,11 @@ namespace Digikam
 {
 
 ParallelPipes::ParallelPipes()
-    : m_currentIndex(0)
+    : m_scheduled(false),
+      m_priority(QThread::InheritPriority),
+      m_creator(nullptr),
+      m_d(nullptr),
+      m_maximumWorkers(0)
 {
 }
 
@@ -45,17 +49,33 @@ ParallelPipes::~ParallelPipes()
 
 void ParallelPipes::schedule()
 {
-    foreach (WorkerObject* const object, m_workers)
+    m_scheduled = true;
+
+    for (int i = 0 ; i < m_workers.size() ; ++i)
     {
-        object->schedule();
+        if (i == 0 || m_active.at(i) || m_pending.at(i) > 0)
+        {
+            activate(i);
+        }
     }
 }
 
 void ParallelPipes::deactivate(WorkerObject::DeactivatingMode mode)
 {
-    foreach (WorkerObject* const object, m_workers)
+    m_scheduled = false;
+
+    for (int i = 0 ; i < m_workers.size() ; ++i)
     {
-        object->deactivate(mode);
+        m_workers.at(i)->deactivate(mode);
+
+        // With FlushSignals, the queued packages are dropped and will never come back.
+
+        if (mode == WorkerObject::FlushSignals)
+        {
+            m_pending[i] = 0;
+        }
+
+        m_active[i] = false;
     }
 }
 
@@ -69,12 +89,21 @@ void ParallelPipes::wait()
 
 void ParallelPipes::setPriority(QThread::Priority priority)
 {
+    m_priority = priority;
+
     foreach (WorkerObject* const object, m_workers)
     {
         object->setPriority(priority);
     }
 }
 
+void ParallelPipes::setWorkerCreator(WorkerCreator creator, FacePipeline::Private* const d, int maximumWorkers)
+{
+    m_creator        = creator;
+    m_d              = d;
+    m_maximumWorkers = maximumWorkers;
+}
+
 void ParallelPipes::add(WorkerObject* const worker)
 {
     QByteArray normalizedSignature = QMetaObject::normalizedSignature("process(FacePipelineExtendedPackage::Ptr)");
@@ -89,22 +118,145 @@ void ParallelPipes::add(WorkerObject* const worker)
 
     m_workers << worker;
     m_methods << worker->metaObject()->method(methodIndex);
+    m_pending << 0;
+    m_active  << false;
 
-    // collect the worker's signals and bundle them to our single signal, which is further connected
+    // collect the worker's signals, count them, and bundle them to our single signal, which is further connected
     connect(worker, SIGNAL(processed(FacePipelineExtendedPackage::Ptr)),
-            this, SIGNAL(processed(FacePipelineExtendedPackage::Ptr)));
+            this, SLOT(slotWorkerProcessed(FacePipelineExtendedPackage::Ptr)));
+}
+
+int ParallelPipes::queueDepth() const
+{
+    int depth = 0;
+
+    foreach (int pending, m_pending)
+    {
+        depth += pending;
+    }
+
+    return depth;
+}
+
+int ParallelPipes::activeWorkers() const
+{
+    return m_active.count(true);
+}
+
+int ParallelPipes::maximumWorkers() const
+{
+    return qMax(m_maximumWorkers, m_workers.size());
+}
+
+bool ParallelPipes::isSaturated() const
+{
+    if (m_workers.size() < m_maximumWorkers || activeWorkers() < m_workers.size())
+    {
+        return false;
+    }
+
+    foreach (int pending, m_pending)
+    {
+        if (pending < QueueLimit)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int ParallelPipes::leastLoadedWorker() const
+{
+    int index = -1;
+
+    for (int i = 0 ; i < m_workers.size() ; ++i)
+    {
+        if (m_active.at(i) && (index == -1 || m_pending.at(i) < m_pending.at(index)))
+        {
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+int ParallelPipes::inactiveWorker()
+{
+    int index = m_active.indexOf(false);
+
+    if (index == -1 && m_creator && m_workers.size() < m_maximumWorkers)
+    {
+        WorkerObject* const worker = m_creator(m_d);
+        worker->setPriority(m_priority);
+        add(worker);
+        index = m_workers.indexOf(worker);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Face pipeline: growing the pool of" << worker->metaObject()->className()
+                                     << "to" << m_workers.size() << "workers";
+    }
+
+    return index;
+}
+
+void ParallelPipes::activate(int index)
+{
+    m_active[index] = true;
+
+    if (m_scheduled)
+    {
+        m_workers.at(index)->schedule();
+    }
 }
 
 void ParallelPipes::process(FacePipelineExtendedPackage::Ptr package)
 {
-    // Here, we send the package to one of the workers, in turn
-    m_methods.at(m_currentIndex).invoke(m_workers.at(m_currentIndex), Qt::QueuedConnection,
-                                        Q_ARG(FacePipelineExtendedPackage::Ptr, package));
+    // Here, we send the package to the least loaded worker, adding one if they all have a queue
+
+    int index = leastLoadedWorker();
 
-    if (++m_currentIndex == m_workers.size())
+    if (index == -1 || m_pending.at(index) >= QueueLimit)
     {
-        m_currentIndex = 0;
+        int inactive = inactiveWorker();
+
+        if (inactive != -1)
+        {
+            activate(inactive);
+            index = inactive;
+        }
     }
+
+    if (index == -1)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "No worker to process the package, passing it on.";
+        emit processed(package);
+        return;
+    }
+
+    m_pending[index]++;
+    m_methods.at(index).invoke(m_workers.at(index), Qt::QueuedConnection,
+                               Q_ARG(FacePipelineExtendedPackage::Ptr, package));
+}
+
+void ParallelPipes::slotWorkerProcessed(FacePipelineExtendedPackage::Ptr package)
+{
+    int index = m_workers.indexOf(qobject_cast<WorkerObject*>(sender()));
+
+    if (index != -1 && m_pending.at(index) > 0)
+    {
+        m_pending[index]--;
+
+        // Release the thread of an idle worker when the others can take the remaining packages.
+
+        if (index > 0 && m_active.at(index) && m_pending.at(index) == 0 &&
+            queueDepth() < activeWorkers() - 1)
+        {
+            m_active[index] = false;
+            m_workers.at(index)->deactivate(WorkerObject::PhaseOut);
+        }
+    }
+
+    emit processed(package);
 }
 
 } // namespace Digikam
@@ -31,10 +31,26 @@
 namespace Digikam
 {
 
+/** A pool of workers for one stage of the face pipeline.
+ *  Each package is sent to the active worker with the fewest packages waiting.
+ *  When all active workers have QueueLimit packages or more, another worker is activated,
+ *  or created if a creator is set, up to the maximum number of workers.
+ *  Idle workers beyond the first are deactivated again, which releases their thread.
+ */
 class Q_DECL_HIDDEN ParallelPipes : public QObject
 {
     Q_OBJECT
 
+public:
+
+    /// Creates one more worker for the pool, connected like the first ones.
+    typedef WorkerObject* (*WorkerCreator)(FacePipeline::Private* const d);
+
+    enum
+    {
+        QueueLimit = 2
+    };
+
 public:
 
     explicit ParallelPipes();
@@ -47,6 +63,19 @@ public:
     void add(WorkerObject* const worker);
     void setPriority(QThread::Priority priority);
 
+    /**
+     * Lets the pool grow up to maximumWorkers, creating the missing workers with creator.
+     */
+    void setWorkerCreator(WorkerCreator creator, FacePipeline::Private* const d, int maximumWorkers);
+
+    /// The packages sent to the workers and not processed yet.
+    int  queueDepth()     const;
+    int  activeWorkers()  const;
+    int  maximumWorkers() const;
+
+    /// True if all workers are active and have QueueLimit packages or more.
+    bool isSaturated()   const;
+
 public:
 
     QList<WorkerObject*> m_workers;
@@ -59,10 +88,28 @@ Q_SIGNALS:
 
     void processed(FacePipelineExtendedPackage::Ptr package);
 
+protected Q_SLOTS:
+
+    void slotWorkerProcessed(FacePipelineExtendedPackage::Ptr package);
+
 protected:
 
-    QList<QMetaMethod> m_methods;
-    int                m_currentIndex;
+    int  leastLoadedWorker() const;
+    int  inactiveWorker();
+    void activate(int index);
+
+protected:
+
+    QList<QMetaMethod>     m_methods;
+    QList<int>             m_pending;
+    QList<bool>            m_active;
+
+    bool                   m_scheduled;
+    QThread::Priority      m_priority;
+
+    WorkerCreator          m_creator;
+    FacePipeline::Private* m_d;
+    int                    m_maximumWorkers;
 };
 
 } // namespace Digikam
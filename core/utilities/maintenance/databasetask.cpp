@@ -33,6 +33,7 @@
 #include "iteminfo.h"
 #include "thumbsdb.h"
 #include "thumbsdbaccess.h"
+#include "thumbsdbwritequeue.h"
 #include "coredb.h"
 #include "coredbaccess.h"
 #include "recognitiondatabase.h"
@@ -40,6 +41,7 @@
 #include "maintenancedata.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
+#include "thumbnailpack.h"
 
 namespace Digikam
 {
@@ -288,8 +290,15 @@ void DatabaseTask::run()
             // OR
             // The thumbnail is stale, i.e. no thumbs db table references it.
 
+            ThumbsDbWriteQueue::instance()->flush();
+
             QSet<int> thumbIds = ThumbsDbAccess().db()->findAll().toSet();
 
+            // The thumbnails pack file uses the same lookup keys. The keys still in use are collected.
+
+            const bool scanPack = ThumbnailPack::instance()->isOpen();
+            QSet<QString> packKeys;
+
             FaceTagsEditor editor;
 
             foreach (const qlonglong& item, coredbItems)
@@ -315,6 +324,12 @@ void DatabaseTask::run()
                         thumbIds.remove(ThumbsDbAccess().db()->findByHash(hash, fileSize).id);
                     }
 
+                    if (scanPack)
+                    {
+                        packKeys << ThumbnailPack::filePathKey(info.filePath());
+                        packKeys << ThumbnailPack::uniqueHashKey(hash, fileSize);
+                    }
+
                     // Add the custom identifier.
                     // get all faces for the image and generate the custom identifiers
                     QUrl url;
@@ -337,6 +352,11 @@ void DatabaseTask::run()
 
                         // Remove the id that is found by the custom identifier. Finding the id -1 does no harm
                         thumbIds.remove(ThumbsDbAccess().db()->findByCustomIdentifier(url.toString()).id);
+
+                        if (scanPack)
+                        {
+                            packKeys << ThumbnailPack::customIdentifierKey(url.toString());
+                        }
                     }
                 }
 
@@ -347,6 +367,25 @@ void DatabaseTask::run()
             // The remaining thumbnail ids should be used to remove them since they are stale.
             staleThumbIds = thumbIds.toList();
 
+            // The pack file entries are not counted as database items: they are removed now.
+
+            if (scanPack)
+            {
+                QStringList stalePackKeys;
+
+                foreach (const QString& key, ThumbnailPack::instance()->keys())
+                {
+                    if (!packKeys.contains(key))
+                    {
+                        stalePackKeys << key;
+                    }
+                }
+
+                qCDebug(DIGIKAM_THUMBSDB_LOG) << "Removing" << stalePackKeys.size() << "stale keys from the thumbnails pack file";
+
+                ThumbnailPack::instance()->remove(stalePackKeys);
+            }
+
             // Signal that the database was processed.
             emit signalFinished();
         }
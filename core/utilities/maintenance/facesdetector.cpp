@@ -185,20 +185,48 @@ FacesDetector::FacesDetector(const FaceScanSettings& settings, ProgressItem* con
         {
             //d->pipeline.plugRerecognizingDatabaseFilter();
             qCDebug(DIGIKAM_GENERAL_LOG) << "recognize algorithm: " << (int)settings.recognizeAlgorithm;
-            d->pipeline.plugFaceRecognizer();
+
+            if (settings.useFullCpu)
+            {
+                d->pipeline.plugParallelFaceRecognizers();
+            }
+            else
+            {
+                d->pipeline.plugFaceRecognizer();
+            }
+
             d->pipeline.activeFaceRecognizer(settings.recognizeAlgorithm);
         }
 
-        d->pipeline.plugDatabaseWriter(writeMode);
+        if (settings.useFullCpu)
+        {
+            d->pipeline.plugParallelDatabaseWriters(writeMode);
+        }
+        else
+        {
+            d->pipeline.plugDatabaseWriter(writeMode);
+        }
+
         d->pipeline.setDetectionAccuracy(settings.accuracy);
         d->pipeline.construct();
     }
     else // FaceScanSettings::RecognizeMarkedFaces
     {
         d->pipeline.plugRerecognizingDatabaseFilter();
-        d->pipeline.plugFaceRecognizer();
-        d->pipeline.activeFaceRecognizer(settings.recognizeAlgorithm);
-        d->pipeline.plugDatabaseWriter(FacePipeline::NormalWrite);
+
+        if (settings.useFullCpu)
+        {
+            d->pipeline.plugParallelFaceRecognizers();
+            d->pipeline.activeFaceRecognizer(settings.recognizeAlgorithm);
+            d->pipeline.plugParallelDatabaseWriters(FacePipeline::NormalWrite);
+        }
+        else
+        {
+            d->pipeline.plugFaceRecognizer();
+            d->pipeline.activeFaceRecognizer(settings.recognizeAlgorithm);
+            d->pipeline.plugDatabaseWriter(FacePipeline::NormalWrite);
+        }
+
         d->pipeline.setDetectionAccuracy(settings.accuracy);
         d->pipeline.construct();
     }
@@ -395,6 +423,7 @@ void FacesDetector::slotImagesSkipped(const QList<ItemInfo>& infos)
 void FacesDetector::slotShowOneDetected(const FacePipelinePackage& /*package*/)
 {
     advance(1);
+    setStatus(d->pipeline.queueStatus());
 }
 
 } // namespace Digikam
@@ -37,6 +37,8 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "applicationsettings.h"
+#include "collectionscanner.h"
 #include "scancontroller.h"
 
 namespace Digikam
@@ -115,7 +117,13 @@ void NewItemsFinder::slotStart()
             connect(ScanController::instance(), SIGNAL(completeScanDone()),
                     this, SLOT(slotDone()));
 
-            ScanController::instance()->completeCollectionScanInBackground(false);
+            // At startup, only the albums changed since the last scan are scanned if the user wants it.
+            // The very first scan is always a complete one.
+
+            bool incremental = ApplicationSettings::instance()->getIncrementalScanAtStart() &&
+                               CollectionScanner::databaseInitialScanDone();
+
+            ScanController::instance()->completeCollectionScanInBackground(false, incremental);
             ScanController::instance()->allowToScanDeferredFiles();
             break;
         }
@@ -29,6 +29,8 @@
 #include "digikam_debug.h"
 #include "digikam_config.h"
 #include "collectionscanner.h"
+#include "dimg.h"
+#include "iteminfo.h"
 #include "task.h"
 
 namespace Digikam
@@ -42,6 +44,33 @@ public:
     {
     }
 
+    /** Estimation of the memory used to process an item, from the image dimensions stored in the database:
+     *  the image, the original and the target images of a filter in 16 bits depth,
+     *  and the buffers of the RAW demosaicing. Returns 0 if the dimensions are not known.
+     */
+    qint64 memoryEstimate(const QUrl& url) const
+    {
+        QSize size = ItemInfo::fromUrl(url).dimensions();
+
+        if (!size.isValid())
+        {
+            return 0;
+        }
+
+        qint64 pixels = (qint64)size.width() * size.height();
+        qint64 bytes  = pixels * 8 * 3;
+
+        if ((settings.rawLoadingRule == QueueSettings::DEMOSAICING) &&
+            (DImg::fileFormat(url.toLocalFile()) == DImg::RAW))
+        {
+            bytes += pixels * 8;
+        }
+
+        return bytes;
+    }
+
+public:
+
     QueueSettings settings;
 };
 
@@ -79,6 +108,10 @@ void ActionThread::setSettings(const QueueSettings& settings)
     {
         defaultMaximumNumberOfThreads();
     }
+
+    // The large images are processed in parallel only if they fit in the memory available now.
+
+    defaultMemoryBudget(d->settings.memoryBudget);
 }
 
 void ActionThread::processQueueItems(const QList<AssignedBatchTools>& items)
@@ -90,6 +123,7 @@ void ActionThread::processQueueItems(const QList<AssignedBatchTools>& items)
         Task* const t = new Task();
         t->setSettings(d->settings);
         t->setItem(items.at(i));
+        t->setMemoryEstimate(d->memoryEstimate(items.at(i).m_itemUrl));
 
         connect(t, SIGNAL(signalStarting(Digikam::ActionData)),
                 this, SIGNAL(signalStarting(Digikam::ActionData)));
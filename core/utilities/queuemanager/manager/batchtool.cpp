@@ -68,6 +68,8 @@ public:
         branchHistory(true),
         cancel(false),
         last(false),
+        inMemoryChain(false),
+        tileStreaming(false),
         observer(nullptr),
         toolGroup(BaseTool),
         rawLoadingRule(QueueSettings::DEMOSAICING),
@@ -80,6 +82,8 @@ public:
     bool                          branchHistory;
     bool                          cancel;
     bool                          last;
+    bool                          inMemoryChain;
+    bool                          tileStreaming;
 
     QString                       errorMessage;
     QString                       toolTitle;          // User friendly tool title.
@@ -402,6 +406,26 @@ bool BatchTool::isLastChainedTool() const
     return d->last;
 }
 
+void BatchTool::setInMemoryChain(bool inMemory)
+{
+    d->inMemoryChain = inMemory;
+}
+
+bool BatchTool::isInMemoryChain() const
+{
+    return d->inMemoryChain;
+}
+
+void BatchTool::setTileStreaming(bool streaming)
+{
+    d->tileStreaming = streaming;
+}
+
+bool BatchTool::isTileStreaming() const
+{
+    return d->tileStreaming;
+}
+
 void BatchTool::setOutputUrlFromInputUrl()
 {
     QString randomString(QUuid::createUuid().toString());
@@ -464,6 +488,35 @@ bool BatchTool::savefromDImg() const
     bool resetOrientation       = getResetExifOrientationAllowed() &&
                                   (getNeedResetExifOrientation() || detectedFormat == DImg::RAW);
 
+    if (!isLastChainedTool() && isInMemoryChain())
+    {
+        // Do not encode an intermediate file: the next tools get the image in memory
+        // and the last one saves it in the target format, with the settings of this tool.
+        // The orientation reset of this tool, for ex. for a RAW file already rotated
+        // by the decoder, is done by the last tool.
+
+        DImg::FORMAT format = DImg::fileFormat(outputUrl().toLocalFile());
+
+        if (!DImg::formatToMimeType(format).isEmpty())
+        {
+            d->image.setAttribute(QLatin1String("detectedFileFormat"),    format);
+            d->image.setAttribute(QLatin1String("batchToolPendingFormat"), true);
+
+            if (resetOrientation)
+            {
+                d->image.setAttribute(QLatin1String("batchToolResetOrientation"), true);
+            }
+
+            return true;
+        }
+    }
+
+    if (d->image.hasAttribute(QLatin1String("batchToolResetOrientation")))
+    {
+        d->image.removeAttribute(QLatin1String("batchToolResetOrientation"));
+        resetOrientation = getResetExifOrientationAllowed();
+    }
+
     if (d->branchHistory)
     {
         // image has its original history
@@ -473,7 +526,12 @@ bool BatchTool::savefromDImg() const
     if (frm.isEmpty())
     {
         // In case of output support is not set for ex. with all tool which do not convert to new format.
-        if (detectedFormat == DImg::JPEG)
+        // A format converted in memory by a previous tool keeps the settings of this tool.
+        if (d->image.hasAttribute(QLatin1String("batchToolPendingFormat")))
+        {
+            d->image.removeAttribute(QLatin1String("batchToolPendingFormat"));
+        }
+        else if (detectedFormat == DImg::JPEG)
         {
             d->image.setAttribute(QLatin1String("quality"),     JPEGSettings::convertCompressionForLibJpeg(ioFileSettings().JPEGCompression));
             d->image.setAttribute(QLatin1String("subsampling"), ioFileSettings().JPEGSubSampling);
@@ -586,6 +644,76 @@ void BatchTool::applyFilter(DImgBuiltinFilter* const filter)
     d->image.addFilterAction(filter->filterAction());
 }
 
+void BatchTool::applyFilterInStrips(DImgThreadedFilter* const filter, int margin)
+{
+    // Size of the source strips, i.e. 16 Mpixels in 8 bits depth.
+
+    const uint stripBytes = 64 * 1024 * 1024;
+    const uint width      = d->image.width();
+    const uint height     = d->image.height();
+    const uint lineBytes  = qMax(width * d->image.bytesDepth(), 1U);
+    const uint rows       = qMax(stripBytes / lineBytes, 4U * margin + 16U);
+
+    if (!d->tileStreaming || rows >= height)
+    {
+        filter->setupFilter(d->image);
+        filter->startFilterDirectly();
+
+        if (isCancelled())
+        {
+            return;
+        }
+
+        DImg trg = filter->getTargetImage();
+
+        if (trg.bits() != d->image.bits())
+        {
+            d->image.putImageData(trg.bits());
+        }
+
+        d->image.addFilterAction(filter->filterAction());
+        return;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Apply" << filter->filterName() << "in strips of" << rows << "rows";
+
+    // The result of a strip is written back once the source of the next strip is read,
+    // as the margin of the next strip overlaps the rows of the previous one.
+
+    DImg result;
+    uint resultOffset = 0;
+    uint resultY      = 0;
+    uint resultRows   = 0;
+
+    for (uint y = 0 ; y < height ; y += rows)
+    {
+        uint top    = (y > (uint)margin) ? y - margin : 0;
+        uint bottom = qMin(y + rows + margin, height);
+        DImg strip  = d->image.copy(0, top, width, bottom - top);
+
+        if (!result.isNull())
+        {
+            d->image.bitBltImage(&result, 0, resultOffset, width, resultRows, 0, resultY);
+        }
+
+        filter->setupFilter(strip);
+        filter->startFilterDirectly();
+
+        if (isCancelled())
+        {
+            return;
+        }
+
+        result       = filter->getTargetImage();
+        resultOffset = y - top;
+        resultY      = y;
+        resultRows   = qMin(rows, height - y);
+    }
+
+    d->image.bitBltImage(&result, 0, resultOffset, width, resultRows, 0, resultY);
+    d->image.addFilterAction(filter->filterAction());
+}
+
 // -- Settings Widgets methods ---------------------------------------------------------------------------
 
 QWidget* BatchTool::settingsWidget() const
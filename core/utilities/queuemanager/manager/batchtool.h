@@ -144,6 +144,18 @@ public:
     void setLastChainedTool(bool last);
     bool isLastChainedTool() const;
 
+    /** Manage flag properties to indicate if the image can be passed in memory to the next tool
+        when this one converts to a new format. The conversion is then done by the last tool.
+     */
+    void setInMemoryChain(bool inMemory);
+    bool isInMemoryChain() const;
+
+    /** Manage flag properties to indicate if the filters of this tool can be applied to large images
+        strip by strip. See applyFilterInStrips() for details.
+     */
+    void setTileStreaming(bool streaming);
+    bool isTileStreaming() const;
+
     /** Set output url using input url content + annotation based on time stamp + file
         extension defined by outputSuffix().
         if outputSuffix() return null, file extension is the same than original.
@@ -271,6 +283,16 @@ protected:
     void applyFilterChangedProperties(DImgThreadedFilter* const filter);
     void applyFilter(DImgBuiltinFilter* const filter);
 
+    /**
+     * Use this with a filter created without image, for filters computing each pixel
+     * from its neighbours in a distance of margin rows at most. When tile streaming is enabled,
+     * the filter is applied to horizontal strips of a large image() and the result is written back
+     * strip by strip, so the memory used in addition to image() is bounded by the strip size.
+     * Otherwise, the whole image is filtered at once, without copy of the original data.
+     * The filter must not depend on statistics computed from the whole image.
+     */
+    void applyFilterInStrips(DImgThreadedFilter* const filter, int margin = 0);
+
     /** Re-implement this method to customize all batch operations done by this tool.
         This method is called by apply().
      */
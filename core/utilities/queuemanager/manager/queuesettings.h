@@ -60,6 +60,9 @@ public:
     QueueSettings()
     {
         useMultiCoreCPU    = false;
+        useInMemoryChain   = true;
+        useTileStreaming   = true;
+        memoryBudget       = 75;
         exifSetOrientation = true;
         useOrgAlbum        = true;
         conflictRule       = FileSaveConflictBox::DIFFNAME;
@@ -71,6 +74,17 @@ public:
 
     bool                              useMultiCoreCPU;
 
+    /// If true, the images are passed in memory between chained tools and
+    /// only the last tool output is encoded to file.
+    bool                              useInMemoryChain;
+
+    /// If true, the filters working on a local neighbourhood process large images by strips.
+    bool                              useTileStreaming;
+
+    /// The percentage of the RAM available when the queue starts that the items
+    /// processed at the same time can use.
+    int                               memoryBudget;
+
     /// Setting managed through Metadata control panel.
     bool                              exifSetOrientation;
 
@@ -166,6 +166,8 @@ void Task::run()
         d->tool->setRawLoadingRules(d->settings.rawLoadingRule);
         d->tool->setDRawDecoderSettings(d->settings.rawDecodingSettings);
         d->tool->setResetExifOrientationAllowed(d->settings.exifSetOrientation);
+        d->tool->setInMemoryChain(d->settings.useInMemoryChain);
+        d->tool->setTileStreaming(d->settings.useTileStreaming);
 
         if (index == d->tools.m_toolsList.count())
         {
@@ -188,6 +190,13 @@ void Task::run()
         outUrl   = d->tool->outputUrl();
         success  = d->tool->apply();
         tmpImage = d->tool->imageData();
+
+        // A user script works on files: the next tool must load its output.
+        if (set.group == BatchTool::CustomTool)
+        {
+            tmpImage = DImg();
+        }
+
         errMsg   = d->tool->errorDescription();
         tmp2del.append(outUrl);
 
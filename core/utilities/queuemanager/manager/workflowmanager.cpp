@@ -229,6 +229,18 @@ bool WorkflowManager::save()
             data.setAttribute(QLatin1String("value"), q.qSettings.useMultiCoreCPU);
             elm.appendChild(data);
 
+            data = doc.createElement(QLatin1String("useinmemorychain"));
+            data.setAttribute(QLatin1String("value"), q.qSettings.useInMemoryChain);
+            elm.appendChild(data);
+
+            data = doc.createElement(QLatin1String("usetilestreaming"));
+            data.setAttribute(QLatin1String("value"), q.qSettings.useTileStreaming);
+            elm.appendChild(data);
+
+            data = doc.createElement(QLatin1String("memorybudget"));
+            data.setAttribute(QLatin1String("value"), q.qSettings.memoryBudget);
+            elm.appendChild(data);
+
             data = doc.createElement(QLatin1String("workingurl"));
             data.setAttribute(QLatin1String("value"), q.qSettings.workingUrl.toLocalFile());
             elm.appendChild(data);
@@ -419,6 +431,18 @@ bool WorkflowManager::load(QStringList& failed)
                 {
                     q.qSettings.useMultiCoreCPU = (bool)val2.toUInt(&ok);
                 }
+                else if (name2 == QLatin1String("useinmemorychain"))
+                {
+                    q.qSettings.useInMemoryChain = (bool)val2.toUInt(&ok);
+                }
+                else if (name2 == QLatin1String("usetilestreaming"))
+                {
+                    q.qSettings.useTileStreaming = (bool)val2.toUInt(&ok);
+                }
+                else if (name2 == QLatin1String("memorybudget"))
+                {
+                    q.qSettings.memoryBudget = val2.toUInt(&ok);
+                }
                 else if (name2 == QLatin1String("workingurl"))
                 {
                     q.qSettings.workingUrl = QUrl::fromLocalFile(val2);
@@ -31,6 +31,7 @@
 #include <QRadioButton>
 #include <QScrollArea>
 #include <QCheckBox>
+#include <QSpinBox>
 #include <QTimer>
 #include <QTreeWidget>
 #include <QVBoxLayout>
@@ -90,6 +91,9 @@ public:
         demosaicingButton(nullptr),
         useOrgAlbum(nullptr),
         useMutiCoreCPU(nullptr),
+        useInMemoryChain(nullptr),
+        useTileStreaming(nullptr),
+        memoryBudget(nullptr),
         conflictBox(nullptr),
         albumSel(nullptr),
         advancedRenameManager(nullptr),
@@ -117,6 +121,10 @@ public:
 
     QCheckBox*             useOrgAlbum;
     QCheckBox*             useMutiCoreCPU;
+    QCheckBox*             useInMemoryChain;
+    QCheckBox*             useTileStreaming;
+
+    QSpinBox*              memoryBudget;
 
     FileSaveConflictBox*   conflictBox;
     AlbumSelectWidget*     albumSel;
@@ -219,12 +227,38 @@ QueueSettingsView::QueueSettingsView(QWidget* const parent)
     d->useMutiCoreCPU = new QCheckBox(i18nc("@option:check", "Work on all processor cores"), panel);
     d->useMutiCoreCPU->setWhatsThis(i18n("Turn on this option to use all CPU core from your computer "
                                          "to process more than one item from a queue at the same time."));
+
+    d->useInMemoryChain = new QCheckBox(i18nc("@option:check", "Pass images in memory between tools"), panel);
+    d->useInMemoryChain->setWhatsThis(i18n("Turn on this option to pass the images in memory from one tool "
+                                           "to the next one. Only the result of the last tool is written to "
+                                           "file. Tools converting the format are applied when saving. "
+                                           "User scripts always work on files."));
+
+    d->useTileStreaming = new QCheckBox(i18nc("@option:check", "Process large images by strips"), panel);
+    d->useTileStreaming->setWhatsThis(i18n("Turn on this option to limit the memory used by the color, "
+                                           "ICC and sharpen tools on very large images, as panoramas. "
+                                           "The images are processed strip by strip with the same result."));
+
+    DHBox* const memoryBox = new DHBox(panel);
+    new QLabel(i18n("Memory for the items processed at the same time:"), memoryBox);
+    d->memoryBudget        = new QSpinBox(memoryBox);
+    d->memoryBudget->setRange(10, 100);
+    d->memoryBudget->setSuffix(QLatin1String("%"));
+    d->memoryBudget->setValue(75);
+    d->memoryBudget->setWhatsThis(i18n("The percentage of the memory available when the queue starts "
+                                       "that the items processed on all processor cores can use. "
+                                       "A large image waits for the other items to finish when it "
+                                       "does not fit."));
+    memoryBox->setStretchFactor(new QWidget(memoryBox), 10);
     // -------------
 
     layout->addWidget(d->rawLoadingLabel);
     layout->addWidget(rawLoadingBox);
     layout->addWidget(d->conflictBox);
     layout->addWidget(d->useMutiCoreCPU);
+    layout->addWidget(d->useInMemoryChain);
+    layout->addWidget(d->useTileStreaming);
+    layout->addWidget(memoryBox);
     layout->setContentsMargins(spacing, spacing, spacing, spacing);
     layout->setSpacing(spacing);
     layout->addStretch();
@@ -299,6 +333,15 @@ QueueSettingsView::QueueSettingsView(QWidget* const parent)
     connect(d->useMutiCoreCPU, SIGNAL(toggled(bool)),
             this, SLOT(slotSettingsChanged()));
 
+    connect(d->useInMemoryChain, SIGNAL(toggled(bool)),
+            this, SLOT(slotSettingsChanged()));
+
+    connect(d->useTileStreaming, SIGNAL(toggled(bool)),
+            this, SLOT(slotSettingsChanged()));
+
+    connect(d->memoryBudget, SIGNAL(valueChanged(int)),
+            this, SLOT(slotSettingsChanged()));
+
     connect(d->albumSel, SIGNAL(itemSelectionChanged()),
             this, SLOT(slotSettingsChanged()));
 
@@ -377,6 +420,9 @@ void QueueSettingsView::slotResetSettings()
     blockSignals(true);
     d->useOrgAlbum->setChecked(true);
     d->useMutiCoreCPU->setChecked(false);
+    d->useInMemoryChain->setChecked(true);
+    d->useTileStreaming->setChecked(true);
+    d->memoryBudget->setValue(75);
     // TODO: reset d->albumSel
     d->renamingButtonGroup->button(QueueSettings::USEORIGINAL)->setChecked(true);
     d->conflictBox->setConflictRule(FileSaveConflictBox::DIFFNAME);
@@ -401,6 +447,9 @@ void QueueSettingsView::slotQueueSelected(int, const QueueSettings& settings, co
 {
     d->useOrgAlbum->setChecked(settings.useOrgAlbum);
     d->useMutiCoreCPU->setChecked(settings.useMultiCoreCPU);
+    d->useInMemoryChain->setChecked(settings.useInMemoryChain);
+    d->useTileStreaming->setChecked(settings.useTileStreaming);
+    d->memoryBudget->setValue(settings.memoryBudget);
     d->albumSel->setEnabled(!settings.useOrgAlbum);
     d->albumSel->setCurrentAlbumUrl(settings.workingUrl);
 
@@ -435,6 +484,9 @@ void QueueSettingsView::slotSettingsChanged()
     d->albumSel->setEnabled(!d->useOrgAlbum->isChecked());
     settings.useOrgAlbum         = d->useOrgAlbum->isChecked();
     settings.useMultiCoreCPU     = d->useMutiCoreCPU->isChecked();
+    settings.useInMemoryChain    = d->useInMemoryChain->isChecked();
+    settings.useTileStreaming    = d->useTileStreaming->isChecked();
+    settings.memoryBudget        = d->memoryBudget->value();
     settings.workingUrl          = d->albumSel->currentAlbumUrl();
 
     settings.renamingRule        = (QueueSettings::RenamingRule)d->renamingButtonGroup->checkedId();
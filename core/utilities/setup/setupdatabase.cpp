@@ -26,6 +26,7 @@
 
 // Qt includes
 
+#include <QCheckBox>
 #include <QCursor>
 #include <QGroupBox>
 #include <QLabel>
@@ -75,6 +76,7 @@ public:
     explicit Private()
       : databaseWidget(nullptr),
         updateBox(nullptr),
+        thumbsPackBox(nullptr),
         hashesButton(nullptr),
         ignoreEdit(nullptr),
         ignoreLabel(nullptr)
@@ -83,6 +85,7 @@ public:
 
     DatabaseSettingsWidget* databaseWidget;
     QGroupBox*              updateBox;
+    QCheckBox*              thumbsPackBox;
     QPushButton*            hashesButton;
     QLineEdit*              ignoreEdit;
     QLabel*                 ignoreLabel;
@@ -104,6 +107,19 @@ SetupDatabase::SetupDatabase(QWidget* const parent)
     d->databaseWidget = new DatabaseSettingsWidget;
     settingsLayout->addWidget(d->databaseWidget);
 
+    d->thumbsPackBox  = new QCheckBox(i18n("Store thumbnails in a memory-mapped pack file"), settingsPanel);
+    d->thumbsPackBox->setWhatsThis(i18n("<p>Set this option to store the thumbnails decoded in one file mapped "
+                                        "in memory, instead of the thumbnails database. Thumbnails are shown faster, "
+                                        "but take more disk space. The file is stored next to a SQLite thumbnails "
+                                        "database, else in the cache location.</p>"
+                                        "<p>This option takes effect when digiKam is restarted.</p>"));
+    settingsLayout->addWidget(d->thumbsPackBox);
+
+#ifdef Q_OS_WIN
+    // A mapped file cannot grow on Windows, see ThumbnailPack.
+    d->thumbsPackBox->hide();
+#endif
+
     if (!CoreDbSchemaUpdater::isUniqueHashUpToDate())
     {
         createUpdateBox();
@@ -185,6 +201,12 @@ void SetupDatabase::applySettings()
         return;
     }
 
+    if (d->thumbsPackBox->isChecked() != settings->getUseThumbnailsPackFile())
+    {
+        settings->setUseThumbnailsPackFile(d->thumbsPackBox->isChecked());
+        settings->saveSettings();
+    }
+
     QString ignoreDirectory;
     CoreDbAccess().db()->getUserIgnoreDirectoryFilterSettings(&ignoreDirectory);
 
@@ -253,6 +275,7 @@ void SetupDatabase::readSettings()
     CoreDbAccess().db()->getUserIgnoreDirectoryFilterSettings(&ignoreDirectory);
     d->ignoreEdit->setText(ignoreDirectory);
 
+    d->thumbsPackBox->setChecked(settings->getUseThumbnailsPackFile());
     d->databaseWidget->setParametersFromSettings(settings);
 }
 
@@ -77,6 +77,7 @@ public:
         scrollItemToCenterCheck(nullptr),
         showOnlyPersonTagsInPeopleSidebarCheck(nullptr),
         scanAtStart(nullptr),
+        incrementalScanAtStart(nullptr),
         cleanAtStart(nullptr),
         sidebarType(nullptr),
         stringComparisonType(nullptr),
@@ -105,6 +106,7 @@ public:
     QCheckBox*                scrollItemToCenterCheck;
     QCheckBox*                showOnlyPersonTagsInPeopleSidebarCheck;
     QCheckBox*                scanAtStart;
+    QCheckBox*                incrementalScanAtStart;
     QCheckBox*                cleanAtStart;
 
     QComboBox*                sidebarType;
@@ -160,6 +162,14 @@ SetupMisc::SetupMisc(QWidget* const parent)
                                     "this can introduce low latency, and it is recommended to disable this option and to plan\n"
                                     "a manual scan through the maintenance tool at the right moment."));
 
+    d->incrementalScanAtStart         = new QCheckBox(i18n("Only scan the folders changed since the last scan at startup"), behaviourPanel);
+    d->incrementalScanAtStart->setToolTip(i18n("Set this option to skip at startup the folders which were not changed since\n"
+                                               "the last complete scan, as seen by the file system. This makes the startup scan\n"
+                                               "of huge collections much faster. Files modified in place while digiKam was not\n"
+                                               "running are not found: use the maintenance tool to scan for them."));
+
+    connect(d->scanAtStart, SIGNAL(toggled(bool)),
+            d->incrementalScanAtStart, SLOT(setEnabled(bool)));
 
     d->cleanAtStart                   = new QCheckBox(i18n("Remove obsolete core database objects (makes startup slower)"), behaviourPanel);
     d->cleanAtStart->setToolTip(i18n("Set this option to force digiKam to clean up the core database from obsolete item entries.\n"
@@ -193,6 +203,7 @@ SetupMisc::SetupMisc(QWidget* const parent)
     layout->setSpacing(spacing);
     layout->addWidget(stringComparisonHbox);
     layout->addWidget(d->scanAtStart);
+    layout->addWidget(d->incrementalScanAtStart);
     layout->addWidget(d->cleanAtStart);
     layout->addWidget(d->showTrashDeleteDialogCheck);
     layout->addWidget(d->showPermanentDeleteDialogCheck);
@@ -386,6 +397,7 @@ void SetupMisc::applySettings()
     settings->setMinimumSimilarityBound(d->minimumSimilarityBound->value());
     settings->setApplySidebarChangesDirectly(d->sidebarApplyDirectlyCheck->isChecked());
     settings->setScanAtStart(d->scanAtStart->isChecked());
+    settings->setIncrementalScanAtStart(d->incrementalScanAtStart->isChecked());
     settings->setCleanAtStart(d->cleanAtStart->isChecked());
     settings->setUseNativeFileDialog(d->useNativeFileDialogCheck->isChecked());
     settings->setDrawFramesToGrouped(d->drawFramesToGroupedCheck->isChecked());
@@ -421,6 +433,8 @@ void SetupMisc::readSettings()
     d->sidebarApplyDirectlyCheck->setChecked(settings->getApplySidebarChangesDirectly());
     d->sidebarApplyDirectlyCheck->setChecked(settings->getApplySidebarChangesDirectly());
     d->scanAtStart->setChecked(settings->getScanAtStart());
+    d->incrementalScanAtStart->setChecked(settings->getIncrementalScanAtStart());
+    d->incrementalScanAtStart->setEnabled(d->scanAtStart->isChecked());
     d->cleanAtStart->setChecked(settings->getCleanAtStart());
     d->useNativeFileDialogCheck->setChecked(settings->getUseNativeFileDialog());
     d->drawFramesToGroupedCheck->setChecked(settings->getDrawFramesToGrouped());